@@ -0,0 +1,305 @@
+/** Arena [PawLIB]
+  * Version: 0.1
+  *
+  * A monotonic (bump-pointer) allocator for short-lived data, which is
+  * freed all at once with reset(), or back to a savepoint.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ARENA_HPP
+#define PAWLIB_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+/** A monotonic allocator over a chain of growing blocks. Allocating is a
+ * pointer bump, deallocating does nothing, and everything is freed at once
+ * by reset() or by rewinding to a savepoint. Blocks are kept for reuse
+ * until release() or destruction.
+ *
+ * Destructors are never called on memory in the arena, so it should only
+ * hold objects which are either trivially destructible or destroyed by
+ * their owner (such as the elements of a container) before a reset.
+ * Not thread-safe. */
+class Arena : public std::pmr::memory_resource
+{
+    private:
+        /// The header at the front of every block.
+        struct Block
+        {
+            Block* next;
+            size_t bytes;
+        };
+
+    public:
+        /** A savepoint, from mark(). */
+        class Marker
+        {
+            friend class Arena;
+
+            public:
+                Marker()
+                :block(nullptr), cursor(nullptr)
+                {}
+
+            private:
+                Marker(Block* block, char* cursor)
+                :block(block), cursor(cursor)
+                {}
+
+                /// The block in use when the savepoint was made.
+                Block* block;
+                /// The next free byte at the savepoint.
+                char* cursor;
+        };
+
+        /** Define a new Arena. No memory is allocated until first use.
+         * \param the size of the first block in bytes. Each new block
+         * doubles this, up to max_block_size.
+         * \param the resource blocks are allocated from */
+        explicit Arena(size_t block_size = 4096,
+                       std::pmr::memory_resource* upstream =
+                           std::pmr::new_delete_resource());
+
+        // Copy constructor and copy assignment don't make sense for Arena!
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /** Allocate uninitialized memory.
+         * \param the number of bytes
+         * \param the alignment, a power of two (optional)
+         * \return a pointer to the memory */
+        inline void* allocate(size_t size,
+                              size_t align = alignof(std::max_align_t))
+        {
+            uintptr_t start = (reinterpret_cast<uintptr_t>(cursor) + align - 1)
+                & ~(static_cast<uintptr_t>(align) - 1);
+            uintptr_t limit = reinterpret_cast<uintptr_t>(end);
+            // An empty arena has no block, so even 0 bytes must go slow.
+            if(start < limit && size <= limit - start)
+            {
+                cursor = reinterpret_cast<char*>(start + size);
+                return reinterpret_cast<void*>(start);
+            }
+            return allocate_slow(size, align);
+        }
+
+        /** Allocate uninitialized storage for n objects.
+         * \param the number of objects
+         * \return a pointer to the storage */
+        template<typename T>
+        T* allocate_array(size_t n)
+        {
+            if(n > std::numeric_limits<size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /** Does nothing. Memory is only reclaimed by reset() or rewind(). */
+        inline void deallocate(void*, size_t,
+                               size_t = alignof(std::max_align_t)) noexcept
+        {}
+
+        /** Get a savepoint, which rewind() can return to.
+         * \return the savepoint */
+        Marker mark() const noexcept
+        {
+            return Marker(current, cursor);
+        }
+
+        /** Free everything allocated since the savepoint, in constant time.
+         * Savepoints made after this one become invalid.
+         * \param the savepoint from mark() */
+        void rewind(const Marker& marker) noexcept;
+
+        /** Free everything in the arena, in constant time. The blocks are
+         * kept, to be reused by later allocations. All savepoints become
+         * invalid. */
+        void reset() noexcept;
+
+        /** Free everything, and return every block to the upstream
+         * resource. */
+        void release() noexcept;
+
+        /** Returns the number of bytes held from the upstream resource,
+         * including block headers. */
+        size_t capacity() const noexcept { return held; }
+
+        /// The largest size for a new block, unless a request needs more.
+        static const size_t max_block_size = 1 << 20;
+
+        ~Arena();
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other)
+            const noexcept override;
+
+    private:
+        /// The resource blocks are allocated from.
+        std::pmr::memory_resource* upstream;
+        /// The size of the next new block.
+        size_t next_size;
+        /// The total number of bytes held in blocks.
+        size_t held;
+
+        /// The first block in the chain.
+        Block* head;
+        /// The block allocations are coming from.
+        Block* current;
+        /// The next free byte in the current block.
+        char* cursor;
+        /// One past the last byte in the current block.
+        char* end;
+
+        /** Move to the next block which can fit the request, adding a new
+         * block if needed, and allocate from it.
+         * \param the number of bytes
+         * \param the alignment
+         * \return a pointer to the memory */
+        void* allocate_slow(size_t size, size_t align);
+
+        /** Make the given block current, with the cursor at its start.
+         * \param the block (may be nullptr) */
+        void enter(Block* block) noexcept;
+};
+
+/** Frees everything allocated from an Arena during its lifetime, when it
+ * goes out of scope. Scopes may be nested.
+ *
+ *     {
+ *         ArenaScope scope(arena);
+ *         // ...temporary work in arena...
+ *     }   // ...all of it is freed here.
+ */
+class ArenaScope
+{
+    public:
+        /** Make a savepoint in the arena.
+         * \param the arena */
+        explicit ArenaScope(Arena& arena) noexcept
+        :arena(arena), marker(arena.mark())
+        {}
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        /** Rewind the arena to the savepoint. */
+        ~ArenaScope()
+        {
+            arena.rewind(marker);
+        }
+
+    private:
+        /// The arena to rewind.
+        Arena& arena;
+        /// The savepoint to rewind to.
+        Arena::Marker marker;
+};
+
+/** A C++ Allocator which bumps from an Arena, without going through the
+ * virtual memory_resource interface. For use with the Flex data structures
+ * and standard containers. All rebound copies share the same Arena, which
+ * must outlive every container using it.
+ */
+template<typename T>
+class ArenaAllocator
+{
+    // Rebound allocators must be able to copy our arena.
+    template<typename U> friend class ArenaAllocator;
+
+    public:
+        typedef T value_type;
+
+        /** Define a new ArenaAllocator.
+         * \param the arena to allocate from */
+        explicit ArenaAllocator(Arena& arena) noexcept
+        :arena(&arena)
+        {}
+
+        /** Rebinding copy constructor.
+         * \param the allocator to share an arena with */
+        template<typename U>
+        // cppcheck-suppress noExplicitConstructor
+        ArenaAllocator(const ArenaAllocator<U>& cpy) noexcept
+        :arena(cpy.arena)
+        {}
+
+        /** Allocate uninitialized storage for n objects.
+         * \param the number of objects
+         * \return a pointer to the storage */
+        T* allocate(size_t n)
+        {
+            return arena->allocate_array<T>(n);
+        }
+
+        /** Does nothing; the arena reclaims memory all at once. */
+        void deallocate(T*, size_t) noexcept
+        {}
+
+        /** Returns the arena this allocator uses. */
+        Arena* get_arena() const noexcept
+        {
+            return arena;
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& rhs) const noexcept
+        {
+            return arena == rhs.arena;
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& rhs) const noexcept
+        {
+            return arena != rhs.arena;
+        }
+
+    private:
+        /// The arena we allocate from.
+        Arena* arena;
+};
+
+#endif // PAWLIB_ARENA_HPP
@@ -0,0 +1,354 @@
+/** Tests for Arena [PawLIB]
+  * Version: 0.1
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ARENA_TESTS_HPP
+#define PAWLIB_ARENA_TESTS_HPP
+
+#include <memory_resource>
+#include <vector>
+
+#include "pawlib/arena.hpp"
+#include "pawlib/flex_array.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+// P-tB1901
+class TestArena_Bump : public Test
+{
+    public:
+        TestArena_Bump(){}
+
+        testdoc_t get_title() override
+        {
+            return "Arena: Bump & Align";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure consecutive allocations are packed together, and every alignment from 1 to 4096 is honored.";
+        }
+
+        bool run() override
+        {
+            Arena arena(1024);
+            char* a = static_cast<char*>(arena.allocate(3, 1));
+            char* b = static_cast<char*>(arena.allocate(5, 1));
+            // Byte-aligned requests are packed back to back.
+            PL_ASSERT_TRUE(b == a + 3);
+
+            for(size_t align = 1; align <= 4096; align *= 2)
+            {
+                // Throw the cursor off alignment first.
+                arena.allocate(1, 1);
+                void* ptr = arena.allocate(align, align);
+                PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(ptr) % align, 0u);
+            }
+
+            // Requests larger than a block still work.
+            void* big = arena.allocate(100000);
+            PL_ASSERT_TRUE(big != nullptr);
+            PL_ASSERT_GREATER_EQUAL(arena.capacity(), 100000u);
+            return true;
+        }
+
+        ~TestArena_Bump(){}
+};
+
+// P-tB1902
+class TestArena_Reset : public Test
+{
+    public:
+        TestArena_Reset(){}
+
+        testdoc_t get_title() override
+        {
+            return "Arena: Reset";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill several blocks, reset, and ensure refilling reuses the same memory.";
+        }
+
+        bool run() override
+        {
+            Arena arena(256);
+            void* first = arena.allocate(16);
+            for(int i = 0; i < iters; ++i)
+            {
+                arena.allocate(24);
+            }
+            size_t held = arena.capacity();
+
+            for(int r = 0; r < 3; ++r)
+            {
+                arena.reset();
+                PL_ASSERT_TRUE(arena.allocate(16) == first);
+                for(int i = 0; i < iters; ++i)
+                {
+                    arena.allocate(24);
+                }
+                // Every block was reused, so no memory was added.
+                PL_ASSERT_EQUAL(arena.capacity(), held);
+            }
+
+            arena.release();
+            PL_ASSERT_EQUAL(arena.capacity(), 0u);
+            // The arena is still usable after release.
+            PL_ASSERT_TRUE(arena.allocate(16) != nullptr);
+            return true;
+        }
+
+        ~TestArena_Reset(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1903
+class TestArena_Savepoints : public Test
+{
+    public:
+        TestArena_Savepoints(){}
+
+        testdoc_t get_title() override
+        {
+            return "Arena: Savepoints";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Rewind to savepoints, both directly and with nested scopes, across block boundaries.";
+        }
+
+        bool run() override
+        {
+            Arena arena(256);
+
+            // A savepoint in an empty arena rewinds to the start.
+            Arena::Marker empty = arena.mark();
+            void* first = arena.allocate(8);
+            arena.rewind(empty);
+            PL_ASSERT_TRUE(arena.allocate(8) == first);
+
+            Arena::Marker outer = arena.mark();
+            void* after_outer = arena.allocate(32);
+            arena.rewind(outer);
+            PL_ASSERT_TRUE(arena.allocate(32) == after_outer);
+
+            arena.rewind(outer);
+            {
+                ArenaScope scope1(arena);
+                void* inner = arena.allocate(32);
+                {
+                    ArenaScope scope2(arena);
+                    // Spill into later blocks.
+                    for(int i = 0; i < 100; ++i)
+                    {
+                        arena.allocate(64);
+                    }
+                }
+                // The inner scope rewound back into the first block.
+                PL_ASSERT_TRUE(arena.allocate(16) ==
+                               static_cast<char*>(inner) + 32);
+            }
+            // Both scopes are gone, so we're back at the outer savepoint.
+            PL_ASSERT_TRUE(arena.allocate(32) == after_outer);
+            return true;
+        }
+
+        ~TestArena_Savepoints(){}
+};
+
+// P-tB1904
+class TestArena_Containers : public Test
+{
+    public:
+        TestArena_Containers(){}
+
+        testdoc_t get_title() override
+        {
+            return "Arena: Backing Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Back a FlexArray, a onestring, and a std::pmr::vector with an Arena, then rewind it.";
+        }
+
+        bool run() override
+        {
+            typedef ArenaAllocator<int> alloc_t;
+            Arena arena;
+            Arena::Marker start = arena.mark();
+            {
+                FlexArray<int, true, true, alloc_t> arr{alloc_t(arena)};
+                onestring str(&arena);
+                std::pmr::vector<int> vec(&arena);
+                for(int i = 0; i < iters; ++i)
+                {
+                    arr.push(i);
+                    vec.push_back(i);
+                    str.append('a');
+                }
+                PL_ASSERT_EQUAL(arr[iters - 1], iters - 1);
+                PL_ASSERT_EQUAL(vec[iters - 1], iters - 1);
+                PL_ASSERT_EQUAL(str.length(), static_cast<size_t>(iters));
+                PL_ASSERT_TRUE(arr.length() == vec.size());
+            }
+            size_t held = arena.capacity();
+            arena.rewind(start);
+            // Doing it all again fits in the memory we already have.
+            {
+                FlexArray<int, true, true, alloc_t> arr{alloc_t(arena)};
+                for(int i = 0; i < iters; ++i)
+                {
+                    arr.push(i);
+                }
+            }
+            PL_ASSERT_EQUAL(arena.capacity(), held);
+            return true;
+        }
+
+        ~TestArena_Containers(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1905*
+class TestArena_TemporariesHeap : public Test
+{
+    public:
+        TestArena_TemporariesHeap(){}
+
+        testdoc_t get_title() override
+        {
+            return "Heap: Temporary Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build and discard " + stdutils::itos(containers) + " temporary FlexArrays and onestrings on the heap.";
+        }
+
+        bool run() override
+        {
+            for(int c = 0; c < containers; ++c)
+            {
+                FlexArray<int, true> arr;
+                onestring str;
+                for(int i = 0; i < items; ++i)
+                {
+                    arr.push(i);
+                    str.append('a');
+                }
+            }
+            return true;
+        }
+
+        ~TestArena_TemporariesHeap(){}
+
+    private:
+        static const int containers = 20;
+        static const int items = 50;
+};
+
+// P-tB1905
+class TestArena_Temporaries : public Test
+{
+    public:
+        TestArena_Temporaries(){}
+
+        testdoc_t get_title() override
+        {
+            return "Arena: Temporary Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build and discard " + stdutils::itos(containers) + " temporary FlexArrays and onestrings in an Arena, then reset it.";
+        }
+
+        bool run() override
+        {
+            typedef ArenaAllocator<int> alloc_t;
+            for(int c = 0; c < containers; ++c)
+            {
+                FlexArray<int, true, true, alloc_t> arr{alloc_t(arena)};
+                onestring str(&arena);
+                for(int i = 0; i < items; ++i)
+                {
+                    arr.push(i);
+                    str.append('a');
+                }
+            }
+            arena.reset();
+            return true;
+        }
+
+        ~TestArena_Temporaries(){}
+
+    private:
+        static const int containers = 20;
+        static const int items = 50;
+        Arena arena;
+};
+
+class TestSuite_Arena : public TestSuite
+{
+    public:
+        explicit TestSuite_Arena(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: Arena Tests";
+        }
+
+        ~TestSuite_Arena(){}
+};
+
+#endif // PAWLIB_ARENA_TESTS_HPP
@@ -1,5 +1,5 @@
 /** AVL Tree [PawLIB]
-  * Version: 0.1 (Experimental)
+  * Version: 0.3 (Experimental)
   *
   * A binary search tree with a low dynamic allocation demand.
   *
@@ -44,101 +44,276 @@
 #ifndef PAWLIB_AVLTREE_HPP
 #define PAWLIB_AVLTREE_HPP
 
-#include "pawlib/flex_queue.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 #include "pawlib/iochannel.hpp"
-#include "pawlib/singly_linked_list.hpp"
 
-template<class Type>
+/// The order compact() lays the nodes of an AVL_Tree out in.
+enum class AVLLayout
+{
+    /// Level by level, from the root down.
+    breadth_first,
+    /// Recursively split into a top half and bottom subtrees, so that
+    /// nearby nodes share cache lines at every scale.
+    van_emde_boas
+};
+
+/* The number of nodes in a node's subtree, which AVL_Tree only stores when
+ * it keeps order statistics. Otherwise this is empty, and takes no room. */
+template<bool stored>
+struct AVLSubtreeSize
+{
+};
+
+template<>
+struct AVLSubtreeSize<true>
+{
+    uint32_t size;
+};
+
+/* AVL_Tree compares elements with operator< only. The probe-based
+ * functions (search, insert_unique, erase) instead take a callable which
+ * compares the target against a stored element, returning a negative
+ * number if the target belongs to the left, a positive number if it
+ * belongs to the right, and 0 if the element is the target. This lets
+ * a container look up elements by something other than a whole element,
+ * such as a Map looking up by key.
+ *
+ * All of the nodes live in one contiguous array, and refer to each other
+ * by 32-bit index. The array grows as needed, which moves the elements,
+ * so pointers to elements are only valid until the next insertion.
+ * Iterators hold an index instead, so they stay valid until their
+ * element is removed or the tree is compacted. Each node also links to
+ * its parent, so iterators step through the tree without recursion.
+ *
+ * With order_stats set, each node also stores the size of its subtree,
+ * which is kept up to date through every insertion, removal, and
+ * rotation. This allows rank(), select(), and count_range() in O(log n).
+ * Trees without it store nothing extra. */
+template<class Type, bool order_stats = false>
 class AVL_Tree
 {
     private:
+        //the index used for "no node"
+        static const uint32_t NIL = UINT32_MAX;
+
         //Node for a binary search tree
-        struct Node
+        struct Node : AVLSubtreeSize<order_stats>
         {
-            //Has a left and a right child
-            Node *left, *right;
+            //Has a left and a right child, and a parent, by index
+            uint32_t left, right, parent;
             //the height of a node is defined as the max height (between the left and right child) + 1
-            int height;
+            //an AVL tree of 2^32 nodes is less than 64 high
+            int8_t height;
+            //raw storage for the data, which is only constructed while the node is in the tree
+            alignas(Type) unsigned char storage[sizeof(Type)];
+
             //the data to be stored (should be comparable)
-            Type data;
-            //constructor
-            Node()
+            Type& data() { return *reinterpret_cast<Type*>(storage); }
+            const Type& data() const { return *reinterpret_cast<const Type*>(storage); }
+        };
+
+        //the array of nodes
+        Node* nodes;
+        //the number of nodes the array has room for
+        uint32_t _capacity;
+        //the number of nodes at the front of the array which have ever been used
+        uint32_t used;
+        //the index of the first node removed from the tree, whose right index links the rest
+        uint32_t notUsed;
+        //the root of the tree
+        uint32_t root;
+        //the number of elements in the tree
+        size_t count;
+
+        Node& node(uint32_t index) { return nodes[index]; }
+        const Node& node(uint32_t index) const { return nodes[index]; }
+
+        //moves the node array into a new array with the given capacity
+        void relocate(Node* grown, uint32_t newCapacity)
+        {
+            for(uint32_t i = 0; i < used; ++i)
             {
-                left = nullptr;
-                right = nullptr;
-                height = nullptr;
+                grown[i].left = nodes[i].left;
+                grown[i].right = nodes[i].right;
+                grown[i].parent = nodes[i].parent;
+                copyBalance(grown[i], nodes[i]);
             }
-        };
+            //only nodes in the tree have data to move
+            moveData(root, grown);
+            ::operator delete(nodes, std::align_val_t(alignof(Node)));
+            nodes = grown;
+            _capacity = newCapacity;
+        }
+
+        //moves the data of every node in the subtree into the same slot in the new array
+        void moveData(uint32_t curr, Node* grown)
+        {
+            if(curr == NIL)
+            {
+                return;
+            }
+            moveData(node(curr).left, grown);
+            new (grown[curr].storage) Type(std::move(node(curr).data()));
+            node(curr).data().~Type();
+            moveData(node(curr).right, grown);
+        }
+
+        //copies the height, and the subtree size if it is kept, from one node to another
+        static void copyBalance(Node& to, const Node& from)
+        {
+            to.height = from.height;
+            if constexpr(order_stats)
+            {
+                to.size = from.size;
+            }
+        }
+
+        static Node* allocateNodes(uint32_t capacity)
+        {
+            return static_cast<Node*>(::operator new(sizeof(Node) * capacity,
+                                                     std::align_val_t(alignof(Node))));
+        }
 
-        //a pointer to the list of nodes not currently in the tree
-        Node* notUsed;
-        //the number of nodes to make next time the list runs out
-        int nodesToMake;
-        //returns a new node with the data of what is passed in
-        Node* newNode(Type element)
+        //returns the index of a new node, constructing its data from the arguments passed in
+        template<typename... Args>
+        uint32_t newNode(Args&&... args)
         {
-            //temporary node used for creation/removal of a node from the list of nodes not in use
-            Node* temp;
-            //if all of the nodes are currently in use
-            if(notUsed == nullptr)
+            uint32_t index;
+            //reuse a node that was removed from the tree, if there is one
+            if(notUsed != NIL)
+            {
+                index = notUsed;
+                new (node(index).storage) Type(std::forward<Args>(args)...);
+                notUsed = node(index).right;
+            }
+            //use the next node in the array, if there is room
+            else if(used < _capacity)
             {
-                //loop through the number of nodes to make
-                for(int i = 0; i < nodesToMake; i++)
+                index = used;
+                new (node(index).storage) Type(std::forward<Args>(args)...);
+                ++used;
+            }
+            //otherwise, grow the array to twice the size
+            else
+            {
+                if(_capacity >= NIL / 2)
+                {
+                    throw std::length_error("AVL_Tree: too many nodes");
+                }
+                uint32_t newCapacity = (_capacity == 0) ? 8 : _capacity * 2;
+                Node* grown = allocateNodes(newCapacity);
+                index = used;
+                //construct the data before moving the old nodes, since the
+                //arguments may refer to an element in the tree
+                try
+                {
+                    new (grown[index].storage) Type(std::forward<Args>(args)...);
+                }
+                catch(...)
                 {
-                    //instantiate new nodes
-                    temp = new Node();
-                    //place them on the list of nodes not in use
-                    temp->right = notUsed;
-                    notUsed = temp;
+                    ::operator delete(grown, std::align_val_t(alignof(Node)));
+                    throw;
                 }
-                //next time make twice as many nodes
-                nodesToMake *= 2;
-            }
-            //get the node on the front of the list
-            temp = notUsed;
-            //remove the node form the list
-            notUsed = notUsed->right;
-            temp->right = nullptr;
-            //set the data of the node to the correct value
-            temp->data = element;
+                relocate(grown, newCapacity);
+                ++used;
+            }
+            node(index).left = NIL;
+            node(index).right = NIL;
+            node(index).parent = NIL;
+            node(index).height = 0;
+            if constexpr(order_stats)
+            {
+                node(index).size = 1;
+            }
+            ++count;
             //return the new node
-            return temp;
+            return index;
         }
 
-        //adds the current node onto the list of nodes not in use
-        void removeNode(Node* element)
+        //destroys the node's data and adds the node onto the list of nodes not in use
+        void removeNode(uint32_t element)
         {
-            //remove the left child
-            element->left = nullptr;
+            node(element).data().~Type();
+            node(element).left = NIL;
             //add the node onto the front of the list
-            element->right = notUsed;
+            node(element).right = notUsed;
             notUsed = element;
+            --count;
         }
 
-        Node* root;
-
         //returns the height of the desired element
-        int height(Node* element)
+        int height(uint32_t element) const
         {
-            return element ? element->height  : -1;
+            return (element != NIL) ? node(element).height : -1;
         }
 
-        //updates the height of the desired node
-        void updateHeight(Node* element)
+        //returns the number of nodes in the subtree
+        uint32_t subtreeSize(uint32_t element) const
+        {
+            return (element != NIL) ? node(element).size : 0;
+        }
+
+        //sets the left child of the node, and the child's parent
+        void setLeft(uint32_t element, uint32_t child)
+        {
+            node(element).left = child;
+            if(child != NIL)
+            {
+                node(child).parent = element;
+            }
+        }
+
+        //sets the right child of the node, and the child's parent
+        void setRight(uint32_t element, uint32_t child)
+        {
+            node(element).right = child;
+            if(child != NIL)
+            {
+                node(child).parent = element;
+            }
+        }
+
+        //sets the root of the tree, which has no parent
+        void setRoot(uint32_t element)
+        {
+            root = element;
+            if(root != NIL)
+            {
+                node(root).parent = NIL;
+            }
+        }
+
+        //updates the height of the desired node, and its subtree size if it is kept
+        //every change to a node's children ends with this, bottom up
+        void updateHeight(uint32_t element)
         {
             //set the nodes height to the max height between the left and right childs
-            element->height = height(element->left) - height(element->right) > 0? height(element->left) + 1 : height(element->right) + 1;
+            int l = height(node(element).left);
+            int r = height(node(element).right);
+            node(element).height = static_cast<int8_t>((l > r ? l : r) + 1);
+            if constexpr(order_stats)
+            {
+                node(element).size = 1 + subtreeSize(node(element).left) + subtreeSize(node(element).right);
+            }
         }
 
         //performs a left rotation on the current node
-        Node* leftRotate(Node* element)
+        uint32_t leftRotate(uint32_t element)
         {
             //the right child of the passed in node
-            Node* rightChild = element->right;
+            uint32_t rightChild = node(element).right;
             //set the passed in nodes right child equal to it's original right childs left child
-            element->right = rightChild->left;
+            setRight(element, node(rightChild).left);
             //set the original right child's left child equal to the passed in node
-            rightChild->left = element;
+            setLeft(rightChild, element);
             //update the height of the passed in element
             updateHeight(element);
             //update the height of the new root of this subtree (the original right child)
@@ -148,14 +323,14 @@ class AVL_Tree
         }
 
         //performs a right rotation on the current node
-        Node* rightRotate(Node* element)
+        uint32_t rightRotate(uint32_t element)
         {
             //the left child of the passed in node
-            Node* leftChild = element->left;
+            uint32_t leftChild = node(element).left;
             //set the passed in nodes left child equal to it's original left child's right child
-            element->left = leftChild->right;
+            setLeft(element, node(leftChild).right);
             //set the original left child's right child equal to the passed in node
-            leftChild->right = element;
+            setRight(leftChild, element);
             //update the height of the passed in node
             updateHeight(element);
             //update the height of the new root of this subtree (the original left child)
@@ -165,17 +340,17 @@ class AVL_Tree
         }
 
         //returns the current height difference between the two subtrees
-        //returns a positive number if the left child's height is greater than the left
+        //returns a positive number if the left child's height is greater than the right
         //returns 0 if the heights are the same
-        //returns a negative number if the right child's height is greater than the right
-        int checkBalance(Node* element)
+        //returns a negative number if the right child's height is greater than the left
+        int checkBalance(uint32_t element) const
         {
             //returns the difference in the heights
-            return height(element->left) - height(element->right);
+            return height(node(element).left) - height(node(element).right);
         }
 
         //balances the subtree that is passed in
-        Node* balance(Node* element)
+        uint32_t balance(uint32_t element)
         {
             //updates the height of the subtree
             updateHeight(element);
@@ -185,10 +360,10 @@ class AVL_Tree
             if(difference > 1)
             {
                 //if left child is right heavy
-                if(checkBalance(element->left) < 0)
+                if(checkBalance(node(element).left) < 0)
                 {
                     //perform a left rotation on the left child
-                    element->left = leftRotate(element->left);
+                    setLeft(element, leftRotate(node(element).left));
                 }
                 //perform a right rotation on the current element
                 return rightRotate(element);
@@ -197,10 +372,10 @@ class AVL_Tree
             else if(difference < -1)
             {
                 //if right child is left heavy
-                if(checkBalance(element->right) > 0)
+                if(checkBalance(node(element).right) > 0)
                 {
                     //perform a right rotation on the right child
-                    element->right = rightRotate(element->right);
+                    setRight(element, rightRotate(node(element).right));
                 }
                 //perform a left rotation on the current element
                 return leftRotate(element);
@@ -209,394 +384,1025 @@ class AVL_Tree
             return element;
         }
 
-        //inserts the passed in element into the tree
-        Node* insert(Node* curr, Type element)
+        //inserts a new node into the subtree, unless the probe finds a match
+        //result is set to the index of the new or matching node
+        //the array may grow, so nodes are always looked up again after recursing
+        template<typename Probe, typename... Args>
+        uint32_t insert(uint32_t curr, const Probe& probe, uint32_t& result,
+                        bool& inserted, Args&&... args)
         {
             //if the current node is null
-            if(curr == nullptr)
+            if(curr == NIL)
             {
                 //return a new node with the passed in data to be added to the tree
-                return newNode(element);
+                result = newNode(std::forward<Args>(args)...);
+                inserted = true;
+                return result;
             }
+            int direction = probe(node(curr).data());
             //if the element is less than the current node's data
-            else if(element < curr->data)
+            if(direction < 0)
             {
                 //set the current node's left child equal to the root that is returned from the balanced insertion into the left subtree
-                curr->left = insert(curr->left, element);
+                uint32_t child = insert(node(curr).left, probe, result, inserted,
+                                        std::forward<Args>(args)...);
+                setLeft(curr, child);
             }
             //if the element is greater than the current node's data
-            else if(element > curr->data)
+            else if(direction > 0)
             {
                 //set the current node's right child equal to the root that is returned from the balanced insertion into the right subtree
-                curr->right = insert(curr->right, element);
+                uint32_t child = insert(node(curr).right, probe, result, inserted,
+                                        std::forward<Args>(args)...);
+                setRight(curr, child);
+            }
+            //if the element is already in the tree, there is nothing to do
+            else
+            {
+                result = curr;
+                return curr;
             }
             //balance the current subtree and return the root
+            return inserted ? balance(curr) : curr;
+        }
+
+        //detaches the smallest node in the subtree, and returns the balanced remainder
+        uint32_t detachMin(uint32_t curr, uint32_t& min)
+        {
+            //if there is nothing smaller, this is the smallest node
+            if(node(curr).left == NIL)
+            {
+                min = curr;
+                return node(curr).right;
+            }
+            setLeft(curr, detachMin(node(curr).left, min));
             return balance(curr);
         }
 
-        Node* remove(Node* curr, Type element)
+        //removes the node the probe matches from the subtree, and returns the balanced remainder
+        template<typename Probe>
+        uint32_t remove(uint32_t curr, const Probe& probe, bool& removed)
         {
             //if the passed in node is null, return null
-            if(curr == nullptr)
+            if(curr == NIL)
             {
                 return curr;
             }
+            int direction = probe(node(curr).data());
             //if the element is less than the current node
-            else if(element < curr->data)
+            if(direction < 0)
             {
                 //set the left child equal to the balanced subtree that is returned from the removal of the node from the left subtree
-                curr->left = remove(curr->left, element);
+                setLeft(curr, remove(node(curr).left, probe, removed));
             }
             //if the element is greater than the current node
-            else if(element > curr->data)
+            else if(direction > 0)
             {
                 //set the right child equal to the balanced subtree that is returned from the removal of the node form the right subtree
-                curr->right = remove(curr->right, element);
+                setRight(curr, remove(node(curr).right, probe, removed));
             }
             //if the current node is the element to remove
             else
             {
-                //If the current node is a leaf
-                if(curr -> left == nullptr && curr->right == nullptr)
-                {
-                    //remove the node
-                    removeNode(curr);
-                    //return null
-                    return nullptr;
-                }
-                //if current node has a right child but not a left
-                else if(curr->left == nullptr && curr->right != nullptr)
-                {
-                    //get the right child
-                    Node* temp = curr->right;
-                    //remove the current node
-                    removeNode(curr);
-                    //return the balanced subtree with the right child as the root.
-                    //this sets the right child as the left or right child of the current node's parent
-                    return balance(temp);
-                }
-                //if the current node has a left child but not a right
-                else if(curr->left != nullptr && curr->right == nullptr)
+                removed = true;
+                //if the current node is missing a child, the other child (if any) takes its place
+                //that child is already balanced
+                if(node(curr).left == NIL || node(curr).right == NIL)
                 {
-                    //get the left child
-                    Node* temp = curr->left;
-                    //remove the current node
+                    uint32_t temp = (node(curr).left != NIL) ? node(curr).left : node(curr).right;
                     removeNode(curr);
-                    //return the balanced subtree with the left child as the root
-                    //this sets the left child as the left or right child of the current node's parent
-                    return balance(temp);
+                    return temp;
                 }
-                //if the current node has both a left and right child
-                else
+                //if the current node has both a left and right child, its successor takes its place
+                //we move the successor node itself, so the other data stays where it is
+                uint32_t successor;
+                uint32_t right = detachMin(node(curr).right, successor);
+                setLeft(successor, node(curr).left);
+                setRight(successor, right);
+                removeNode(curr);
+                curr = successor;
+            }
+            //return the balanced subtree
+            return removed ? balance(curr) : curr;
+        }
+
+        //finds the node the probe matches, or NIL
+        template<typename Probe>
+        uint32_t find(const Probe& probe) const
+        {
+            //The searching node
+            uint32_t temp = root;
+            //while the searching node is not null
+            while(temp != NIL)
+            {
+                int direction = probe(node(temp).data());
+                //if the element matches the current node's data
+                if(direction == 0)
                 {
-                    //The parent of the successor
-                    Node* parent;
-                    //get the current nodes successor
-                    Node* successor = getSuccessor(curr, &parent);
-                    //replace the current node with it's successor
-                    successor->left = curr->left;
-                    //the right child of the current node is not the current nodes successor
-                    if(curr->right != successor)
-                        //set the successor's right child to that of the current node's right child
-                        successor->right = curr->right;
-
-                    //if the left child of the parent is the successor
-                    if(parent->left == successor)
-                        //set the left child of the parent to be null
-                        parent->left = nullptr;
-                    //if the right child of the parent is the successor
-                    else if(parent->right == successor)
-                        //set the right child of the parent to be null
-                        parent->right = nullptr;
-                    //add the current node to the list of nodes not in use
-                    removeNode(curr);
-                    //return the balanced subtree with the successor as the root
-                    return balance(successor);
+                    break;
                 }
+                //continue searching down the left or right subtree
+                temp = (direction < 0) ? node(temp).left : node(temp).right;
             }
-            //return the balanced subtree
-            return balance(curr);
+            return temp;
         }
 
-        //get the successor of a node if that node does not have a right child
-        Node* getSuccessor(Node* curr, Type element, Node** parent)
+        //makes a copy of the subtree, with the same shape, so no rotations are needed
+        //the array must already have room for the whole subtree
+        uint32_t copy(const AVL_Tree& from, uint32_t curr)
         {
-            //if the passed in node is null, return null
-            if(curr == nullptr)
+            if(curr == NIL)
             {
-                return nullptr;
+                return NIL;
             }
-            //if the current node is the node for which we are finding the successor
-            else if(element == curr->data)
+            uint32_t temp = newNode(from.node(curr).data());
+            copyBalance(node(temp), from.node(curr));
+            uint32_t left = copy(from, from.node(curr).left);
+            setLeft(temp, left);
+            uint32_t right = copy(from, from.node(curr).right);
+            setRight(temp, right);
+            return temp;
+        }
+
+        //destroys the data of every node in the subtree
+        void destroy(uint32_t curr)
+        {
+            if(curr == NIL)
             {
-                //return null
-                return nullptr;
+                return;
             }
-            //else if node we are finding the successor for is to the left of the current node
-            else if(element < curr->data)
+            destroy(node(curr).left);
+            destroy(node(curr).right);
+            node(curr).data().~Type();
+        }
+
+        //calls the visitor on every element in the subtree, in order
+        template<typename Visitor>
+        void inOrder(uint32_t curr, Visitor& visitor) const
+        {
+            if(curr == NIL)
             {
-                //if we want to know the parent
-                if(parent != nullptr)
-                    //update the parent
-                    *parent = curr;
-                //Set temp equal to the whatever getSuccessor returns
-                Node* temp = getSuccessor(curr->left, element, parent);
-                //if temp returns null this means that the current node is the last parent that has a value greater than the value of the node we are finding the successor for
-                //So if temp returns null, we return this node, otherwise we return whatever was returned
-                return temp ? temp : curr;
+                return;
             }
-            else
+            inOrder(node(curr).left, visitor);
+            visitor(node(curr).data());
+            inOrder(node(curr).right, visitor);
+        }
+
+        //pre-order print
+        void printNode(uint32_t temp)
+        {
+            ioc << node(temp).data() << IOCtrl::endl;
+            if(node(temp).left != NIL)
+            {
+                printNode(node(temp).left);
+            }
+
+            if(node(temp).right != NIL)
             {
-                //if we want to know the parent
-                if(parent != nullptr)
-                    //update the parent
-                    *parent = curr;
-                //return the results of getSuccessor
-                return getSuccessor(curr->right, element, parent);
+                printNode(node(temp).right);
             }
         }
 
-        //get the predecessor of a node if that node does not have a left child
-        Node* getPredecessor(Node* curr, Type element, Node** parent)
+        //appends the subtree's nodes within the given number of levels to order, in van Emde Boas order
+        //the top half of the levels is laid out first, then each subtree hanging below it
+        void vebOrder(uint32_t curr, int levels, uint32_t* order, uint32_t& n) const
         {
-            //if the passed in node is null, return null
-            if(curr == nullptr)
+            if(curr == NIL)
             {
-                return nullptr;
+                return;
             }
-            //if the current node is the node for which we are finding the successor
-            else if(element == curr->data)
+            if(levels == 1)
             {
-                //return null
-                return nullptr;
+                order[n++] = curr;
+                return;
             }
-            //else if node we are finding the successor for is to the right of the current node
-            else if(element > curr->data)
+            int top = levels / 2;
+            vebOrder(curr, top, order, n);
+            vebBottoms(curr, top, levels - top, order, n);
+        }
+
+        //lays out each subtree rooted exactly depth levels below curr, from left to right
+        void vebBottoms(uint32_t curr, int depth, int levels, uint32_t* order, uint32_t& n) const
+        {
+            if(curr == NIL)
             {
-                //if we want to know the parent
-                if(parent != nullptr)
-                    //update the parent
-                    *parent = curr;
-                //Set temp equal to the whatever getSuccessor returns
-                Node* temp = getSuccessor(curr->right, element, parent);
-                //if temp returns null this means that the current node is the last parent that has a value greater than the value of the node we are finding the successor for
-                //So if temp returns null, we return this node, otherwise we return whatever was returned
-                return temp ? temp : curr;
+                return;
             }
-            else
+            if(depth == 0)
             {
-                //if we want to know the parent
-                if(parent != nullptr)
-                    //update the parent
-                    *parent = curr;
-                //return the results of getSuccessor
-                return getSuccessor(curr->right, element, parent);
+                vebOrder(curr, levels, order, n);
+                return;
             }
+            vebBottoms(node(curr).left, depth - 1, levels, order, n);
+            vebBottoms(node(curr).right, depth - 1, levels, order, n);
         }
 
-        //pre-order print
-        void printNode(Node* temp)
+        //builds a perfectly balanced subtree of n nodes, in order, into fresh slots
+        //emit constructs each element into the storage it is given
+        //since slots are handed out in order, the elements end up sorted in the array
+        //the array must already have room for all of them
+        template<typename Emit>
+        uint32_t buildBalanced(size_t n, Emit& emit)
         {
-            ioc << temp->data << IOCtrl::endl;
-            if(temp->left != nullptr)
+            if(n == 0)
             {
-                printNode(temp->left);
+                return NIL;
             }
+            //the left subtree gets the extra node, if there is one
+            size_t leftCount = n / 2;
+            uint32_t left = buildBalanced(leftCount, emit);
+            uint32_t curr = used;
+            emit(node(curr).storage);
+            ++used;
+            ++count;
+            uint32_t right = buildBalanced(n - leftCount - 1, emit);
+            setLeft(curr, left);
+            setRight(curr, right);
+            updateHeight(curr);
+            return curr;
+        }
 
-            if(temp->right != nullptr)
+        //replaces the (empty) tree with a balanced tree of n elements, built by emit
+        //if anything throws, every element built so far is destroyed
+        template<typename Emit>
+        void build(size_t n, Emit& emit)
+        {
+            reserve(n);
+            try
             {
-                printNode(temp->right);
+                setRoot(buildBalanced(n, emit));
+            }
+            catch(...)
+            {
+                //the slots are handed out in order, so the first ones are the constructed ones
+                for(uint32_t i = 0; i < used; ++i)
+                {
+                    node(i).data().~Type();
+                }
+                used = 0;
+                count = 0;
+                root = NIL;
+                throw;
             }
         }
 
-    public :
-        AVL_Tree()
+        //records the index of every node in the subtree, in order
+        void inOrderIndices(uint32_t curr, uint32_t* indices, uint32_t& n) const
         {
-            root = nullptr;
-            notUsed = nullptr;
-            nodesToMake = 8;
+            if(curr == NIL)
+            {
+                return;
+            }
+            inOrderIndices(node(curr).left, indices, n);
+            indices[n++] = curr;
+            inOrderIndices(node(curr).right, indices, n);
         }
 
-        //inserts the element into the tree
-        void insert(Type element)
+        //returns the smallest node in the subtree
+        uint32_t leftmost(uint32_t curr) const
         {
-            //call the helper function
-            root = insert(root, element);
+            while(node(curr).left != NIL)
+            {
+                curr = node(curr).left;
+            }
+            return curr;
         }
 
-        void remove(Type element)
+        //returns the largest node in the subtree
+        uint32_t rightmost(uint32_t curr) const
         {
-            //call the helper function
-            root = remove(root, element);
+            while(node(curr).right != NIL)
+            {
+                curr = node(curr).right;
+            }
+            return curr;
         }
 
-        //Searches the tree for the element
-        //returns true and sets the passed in return value equal to the desired node's data if desired node is in the tree
-        //returns false if the node does not exist
-        bool retrieve(Type element, Type* returnVal)
+        //returns the node after this one, in order, or NIL
+        uint32_t successor(uint32_t curr) const
         {
-            //The searching node
-            Node* temp = root;
-            //while the searching node is not null
-            while(temp != nullptr)
+            if(node(curr).right != NIL)
             {
-                //if the element matches the current node's data
-                if(element == temp->data)
+                return leftmost(node(curr).right);
+            }
+            //climb until we come up from a left child
+            uint32_t parent = node(curr).parent;
+            while(parent != NIL && curr == node(parent).right)
+            {
+                curr = parent;
+                parent = node(curr).parent;
+            }
+            return parent;
+        }
+
+        //returns the node before this one, in order, or NIL
+        uint32_t predecessor(uint32_t curr) const
+        {
+            if(node(curr).left != NIL)
+            {
+                return rightmost(node(curr).left);
+            }
+            //climb until we come up from a right child
+            uint32_t parent = node(curr).parent;
+            while(parent != NIL && curr == node(parent).left)
+            {
+                curr = parent;
+                parent = node(curr).parent;
+            }
+            return parent;
+        }
+
+        //returns the first node the probe does not place after, or NIL
+        //with strict set, returns the first node the probe places before
+        template<bool strict, typename Probe>
+        uint32_t bound(const Probe& probe) const
+        {
+            uint32_t result = NIL;
+            uint32_t curr = root;
+            while(curr != NIL)
+            {
+                int direction = probe(node(curr).data());
+                if(strict ? (direction < 0) : (direction <= 0))
                 {
-                    //break out and return
-                    break;
+                    result = curr;
+                    curr = node(curr).left;
+                }
+                else
+                {
+                    curr = node(curr).right;
+                }
+            }
+            return result;
+        }
+
+        //returns the number of elements the probe places after
+        template<typename Probe>
+        size_t countBefore(const Probe& probe) const
+        {
+            size_t before = 0;
+            uint32_t curr = root;
+            while(curr != NIL)
+            {
+                if(probe(node(curr).data()) <= 0)
+                {
+                    curr = node(curr).left;
                 }
-                //if the element is less than the current node's data
-                else if(element < temp->data)
+                else
+                {
+                    //this node and its whole left subtree come before the target
+                    before += subtreeSize(node(curr).left) + 1;
+                    curr = node(curr).right;
+                }
+            }
+            return before;
+        }
+
+        //returns the node at the given position, in order, or NIL
+        uint32_t selectIndex(size_t position) const
+        {
+            if(position >= count)
+            {
+                return NIL;
+            }
+            uint32_t curr = root;
+            while(true)
+            {
+                size_t left = subtreeSize(node(curr).left);
+                if(position < left)
+                {
+                    curr = node(curr).left;
+                }
+                else if(position == left)
                 {
-                    //continue searching down the left subtree
-                    temp = temp->left;
+                    return curr;
                 }
-                //if the element is greater than the current node's data
                 else
                 {
-                    //continue searching down the right subtree
-                    temp = temp->right;
+                    position -= left + 1;
+                    curr = node(curr).right;
+                }
+            }
+        }
+
+        //returns a probe which compares against the whole element
+        static auto elementProbe(const Type& element)
+        {
+            return [&element](const Type& data)
+            {
+                return (element < data) ? -1 : ((data < element) ? 1 : 0);
+            };
+        }
+
+    public :
+        //a bidirectional iterator over the elements, in order
+        template<bool is_const>
+        class basic_iterator
+        {
+            friend class AVL_Tree;
+
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Type value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef typename std::conditional<is_const, const Type*, Type*>::type pointer;
+                typedef typename std::conditional<is_const, const Type&, Type&>::type reference;
+
+                basic_iterator()
+                :tree(nullptr), index(NIL)
+                {}
+
+                //allows converting an iterator to a const_iterator
+                template<bool other, typename = typename std::enable_if<is_const && !other>::type>
+                // cppcheck-suppress noExplicitConstructor
+                basic_iterator(const basic_iterator<other>& it)
+                :tree(it.tree), index(it.index)
+                {}
+
+                reference operator*() const
+                {
+                    return tree->node(index).data();
+                }
+
+                pointer operator->() const
+                {
+                    return &(tree->node(index).data());
+                }
+
+                basic_iterator& operator++()
+                {
+                    index = tree->successor(index);
+                    return *this;
+                }
+
+                basic_iterator operator++(int)
+                {
+                    basic_iterator old = *this;
+                    ++(*this);
+                    return old;
+                }
+
+                //stepping back from the end goes to the last element
+                basic_iterator& operator--()
+                {
+                    index = (index == NIL) ? tree->rightmost(tree->root) : tree->predecessor(index);
+                    return *this;
+                }
+
+                basic_iterator operator--(int)
+                {
+                    basic_iterator old = *this;
+                    --(*this);
+                    return old;
+                }
+
+                bool operator==(const basic_iterator& rhs) const
+                {
+                    return index == rhs.index;
+                }
+
+                bool operator!=(const basic_iterator& rhs) const
+                {
+                    return !(*this == rhs);
                 }
+
+            private:
+                typedef typename std::conditional<is_const, const AVL_Tree*, AVL_Tree*>::type tree_ptr;
+
+                basic_iterator(tree_ptr of, uint32_t at)
+                :tree(of), index(at)
+                {}
+
+                tree_ptr tree;
+                uint32_t index;
+
+                template<bool> friend class basic_iterator;
+        };
+
+        typedef basic_iterator<false> iterator;
+        typedef basic_iterator<true> const_iterator;
+
+        AVL_Tree()
+        :nodes(nullptr), _capacity(0), used(0), notUsed(NIL), root(NIL), count(0)
+        {}
+
+        //copies the tree, node for node, into an array with no spare room
+        AVL_Tree(const AVL_Tree& cpy)
+        :nodes(nullptr), _capacity(0), used(0), notUsed(NIL), root(NIL), count(0)
+        {
+            reserve(cpy.count);
+            setRoot(copy(cpy, cpy.root));
+        }
+
+        //steals the contents of the tree
+        AVL_Tree(AVL_Tree&& mov)
+        :nodes(mov.nodes), _capacity(mov._capacity), used(mov.used),
+         notUsed(mov.notUsed), root(mov.root), count(mov.count)
+        {
+            mov.nodes = nullptr;
+            mov._capacity = 0;
+            mov.used = 0;
+            mov.notUsed = NIL;
+            mov.root = NIL;
+            mov.count = 0;
+        }
+
+        AVL_Tree& operator=(const AVL_Tree& rhs)
+        {
+            if(&rhs != this)
+            {
+                clear();
+                reserve(rhs.count);
+                setRoot(copy(rhs, rhs.root));
+            }
+            return *this;
+        }
+
+        AVL_Tree& operator=(AVL_Tree&& rhs)
+        {
+            if(&rhs != this)
+            {
+                std::swap(nodes, rhs.nodes);
+                std::swap(_capacity, rhs._capacity);
+                std::swap(used, rhs.used);
+                std::swap(notUsed, rhs.notUsed);
+                std::swap(root, rhs.root);
+                std::swap(count, rhs.count);
+            }
+            return *this;
+        }
+
+        //inserts the element into the tree, unless it is already there
+        //returns true if the element was inserted
+        bool insert(const Type& element)
+        {
+            uint32_t result;
+            bool inserted = false;
+            //call the helper function
+            setRoot(insert(root, elementProbe(element), result, inserted, element));
+            return inserted;
+        }
+
+        bool insert(Type&& element)
+        {
+            uint32_t result;
+            bool inserted = false;
+            //the probe only reads the element before it is moved into the new node
+            setRoot(insert(root, elementProbe(element), result, inserted,
+                           std::move(element)));
+            return inserted;
+        }
+
+        //inserts an element constructed from args, unless the probe finds a match
+        //the element is only constructed if it is inserted
+        //returns the new or matching element
+        template<typename Probe, typename... Args>
+        Type* insert_unique(const Probe& probe, bool* inserted, Args&&... args)
+        {
+            uint32_t result = NIL;
+            bool done = false;
+            setRoot(insert(root, probe, result, done, std::forward<Args>(args)...));
+            if(inserted != nullptr)
+            {
+                *inserted = done;
             }
+            return &(node(result).data());
+        }
+
+        //removes the element from the tree
+        //returns true if it was there
+        bool remove(const Type& element)
+        {
+            bool removed = false;
+            //call the helper function
+            setRoot(remove(root, elementProbe(element), removed));
+            return removed;
+        }
+
+        //removes the element the probe matches from the tree
+        //returns true if it was there
+        template<typename Probe>
+        bool erase(const Probe& probe)
+        {
+            bool removed = false;
+            setRoot(remove(root, probe, removed));
+            return removed;
+        }
+
+        //Searches the tree for the element
+        //returns true and sets the passed in return value equal to the desired node's data if desired node is in the tree
+        //returns false if the node does not exist
+        bool retrieve(const Type& element, Type* returnVal) const
+        {
+            uint32_t temp = find(elementProbe(element));
             //if node exists
-            if(temp)
+            if(temp != NIL)
             {
                 //set return value equal to the data
-                *returnVal = temp->data;
+                *returnVal = node(temp).data();
                 return true;
             }
             //otherwise return false
             return false;
         }
 
-        //gets the predecessor of the passed in element
-        //if parent is not null, will set that equal to the parent of the predecessor
-        Node* getPredecessor(Node* element, Node** parent = nullptr)
+        //returns the element the probe matches, or null, without copying anything
+        template<typename Probe>
+        Type* search(const Probe& probe)
+        {
+            uint32_t temp = find(probe);
+            return (temp != NIL) ? &(node(temp).data()) : nullptr;
+        }
+
+        template<typename Probe>
+        const Type* search(const Probe& probe) const
+        {
+            uint32_t temp = find(probe);
+            return (temp != NIL) ? &(node(temp).data()) : nullptr;
+        }
+
+        //calls the visitor on every element in the tree, in order
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            inOrder(root, visitor);
+        }
+
+        iterator begin()
+        {
+            return iterator(this, (root != NIL) ? leftmost(root) : NIL);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, (root != NIL) ? leftmost(root) : NIL);
+        }
+
+        iterator end()
+        {
+            return iterator(this, NIL);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, NIL);
+        }
+
+        //returns the first element the probe does not place after
+        //(the first element not less than the target)
+        template<typename Probe>
+        iterator lower_bound(const Probe& probe)
+        {
+            return iterator(this, bound<false>(probe));
+        }
+
+        template<typename Probe>
+        const_iterator lower_bound(const Probe& probe) const
+        {
+            return const_iterator(this, bound<false>(probe));
+        }
+
+        //returns the first element the probe places before
+        //(the first element greater than the target)
+        template<typename Probe>
+        iterator upper_bound(const Probe& probe)
+        {
+            return iterator(this, bound<true>(probe));
+        }
+
+        template<typename Probe>
+        const_iterator upper_bound(const Probe& probe) const
+        {
+            return const_iterator(this, bound<true>(probe));
+        }
+
+        //returns the range of elements the probe matches, which holds at most one
+        template<typename Probe>
+        std::pair<iterator, iterator> equal_range(const Probe& probe)
+        {
+            uint32_t first = bound<false>(probe);
+            uint32_t last = (first != NIL && probe(node(first).data()) == 0) ? successor(first) : first;
+            return std::pair<iterator, iterator>(iterator(this, first), iterator(this, last));
+        }
+
+        template<typename Probe>
+        std::pair<const_iterator, const_iterator> equal_range(const Probe& probe) const
+        {
+            uint32_t first = bound<false>(probe);
+            uint32_t last = (first != NIL && probe(node(first).data()) == 0) ? successor(first) : first;
+            return std::pair<const_iterator, const_iterator>(const_iterator(this, first),
+                                                             const_iterator(this, last));
+        }
+
+        //calls the visitor on every element from the first one low does not place after,
+        //up to but not including the first one high does not place after, in order
+        //only the path to the first element and the elements visited are touched
+        template<typename LowProbe, typename HighProbe, typename Visitor>
+        void for_each_in_range(const LowProbe& low, const HighProbe& high, Visitor visitor) const
         {
-            //if the node does not have a right child
-            if(element->left == nullptr)
+            for(uint32_t curr = bound<false>(low);
+                curr != NIL && high(node(curr).data()) > 0;
+                curr = successor(curr))
             {
-                //then we have to find the successor a different way
-                return getPredecessor(root, element->data, parent);
+                visitor(node(curr).data());
             }
-            //if the node has a right child
-            else
+        }
+
+        //returns the number of elements the probe places after
+        //(the number of elements less than the target)
+        //requires order_stats
+        template<typename Probe>
+        size_t rank(const Probe& probe) const
+        {
+            static_assert(order_stats, "AVL_Tree: rank() requires order_stats");
+            return countBefore(probe);
+        }
+
+        //returns the element at the given position, in order, counting from 0,
+        //or end() if there are not that many elements
+        //requires order_stats
+        iterator select(size_t position)
+        {
+            static_assert(order_stats, "AVL_Tree: select() requires order_stats");
+            return iterator(this, selectIndex(position));
+        }
+
+        const_iterator select(size_t position) const
+        {
+            static_assert(order_stats, "AVL_Tree: select() requires order_stats");
+            return const_iterator(this, selectIndex(position));
+        }
+
+        //returns the number of elements from the first one low does not place after,
+        //up to but not including the first one high does not place after,
+        //the same elements for_each_in_range() visits, without visiting them
+        //requires order_stats
+        template<typename LowProbe, typename HighProbe>
+        size_t count_range(const LowProbe& low, const HighProbe& high) const
+        {
+            static_assert(order_stats, "AVL_Tree: count_range() requires order_stats");
+            size_t first = countBefore(low);
+            size_t last = countBefore(high);
+            return (last > first) ? last - first : 0;
+        }
+
+        //returns the number of elements in the tree
+        size_t size() const
+        {
+            return count;
+        }
+
+        //returns true if the tree has no elements
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        //returns the number of nodes the tree has room for without growing
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        //makes room for at least the given number of elements
+        void reserve(size_t elements)
+        {
+            if(elements <= _capacity)
+            {
+                return;
+            }
+            if(elements >= NIL)
+            {
+                throw std::length_error("AVL_Tree: too many nodes");
+            }
+            relocate(allocateNodes(static_cast<uint32_t>(elements)),
+                     static_cast<uint32_t>(elements));
+        }
+
+        //replaces the contents of the tree with n elements, in a perfectly balanced
+        //tree, without any comparisons or rotations beyond checking the order
+        //source(i, place) is called for i from 0 to n - 1, in order, and must call
+        //place(args...) exactly once to construct the ith element from args
+        //throws std::invalid_argument, leaving the tree empty, unless the
+        //elements are in strictly increasing order
+        template<typename Source>
+        void assign_sorted(size_t n, Source source)
+        {
+            clear();
+            size_t i = 0;
+            auto emit = [this, &source, &i](unsigned char* storage)
             {
-                //set temp equal to the left child
-                Node* temp = element->left;
-                //if temp does not have a right child
-                if(temp->right == nullptr)
+                source(i++, [storage](auto&&... args)
                 {
-                    //if we want to know the parent
-                    if(parent != nullptr)
-                    {
-                        //update the parent
-                        *parent = element;
-                    }
-                    //this means that temp is the predecessor, so return temp
-                    return temp;
-                }
-                //while temp has a right child
-                while(temp->right != nullptr)
+                    new (storage) Type(std::forward<decltype(args)>(args)...);
+                });
+                //the previous element is always in the slot before
+                if(used > 0 && !(node(used - 1).data() < node(used).data()))
                 {
-                    //if we want to know the parent
-                    if(parent != nullptr)
-                        //update the parent
-                        *parent = temp;
-                    //update temp to it's right child
-                    temp = temp->right;
+                    node(used).data().~Type();
+                    throw std::invalid_argument("AVL_Tree: elements are not in strictly increasing order");
                 }
-                //return temp which is the successor of the passed in node
-                return temp;
-            }
+            };
+            build(n, emit);
         }
 
-        //gets the successor of the passed in element
-        //if parent is not null, will set that equal to the parent of the successor
-        Node* getSuccessor(Node* element, Node** parent = nullptr)
+        //merges n new elements into the tree, then rebuilds it perfectly balanced
+        //the new elements must be in strictly increasing order
+        //probe_at(i) returns a probe for the ith new element, which is used to
+        //merge it with the elements already in the tree
+        //source(i, place) constructs the ith new element, just as for assign_sorted()
+        //a new element is skipped if it matches one already in the tree
+        //returns the number of new elements inserted
+        //if constructing or probing a new element throws, the tree is left unchanged
+        template<typename ProbeAt, typename Source>
+        size_t merge_sorted(size_t n, ProbeAt probe_at, Source source)
         {
-            //if the node does not have a right child
-            if(element->right == nullptr)
+            uint32_t existingCount = static_cast<uint32_t>(count);
+            std::unique_ptr<uint32_t[]> existing(new uint32_t[existingCount]);
+            uint32_t filled = 0;
+            inOrderIndices(root, existing.get(), filled);
+
+            //the new elements to skip are only known by merging, so count them first
+            size_t total = count;
+            uint32_t e = 0;
+            for(size_t i = 0; i < n; )
             {
-                //then we have to find the successor a different way
-                return getSuccessor(root, element->data, parent);
+                int direction = (e < existingCount) ? probe_at(i)(node(existing[e]).data()) : -1;
+                if(direction > 0)
+                {
+                    ++e;
+                    continue;
+                }
+                if(direction < 0)
+                {
+                    ++total;
+                }
+                else
+                {
+                    ++e;
+                }
+                ++i;
             }
-            //if the node has a right child
-            else
+            size_t inserted = total - count;
+
+            AVL_Tree merged;
+            //where each existing element was moved to, so it can be moved back
+            std::unique_ptr<Type*[]> movedTo(new Type*[existingCount]);
+            size_t i = 0;
+            e = 0;
+            auto emit = [this, &probe_at, &source, &existing, existingCount, &movedTo, n, &i, &e](unsigned char* storage)
             {
-                //set temp equal to the right child
-                Node* temp = element->right;
-                //if temp does not have a left child
-                if(temp->left == nullptr)
+                try
                 {
-                    //if we want to know the parent
-                    if(parent != nullptr)
-                        //update the parent
-                        *parent = element;
-                    //this means that temp is the successor, so return temp
-                    return temp;
+                    while(true)
+                    {
+                        //take the next new element, unless an existing one comes first
+                        int direction = -1;
+                        if(i == n)
+                        {
+                            direction = 1;
+                        }
+                        else if(e < existingCount)
+                        {
+                            direction = probe_at(i)(node(existing[e]).data());
+                        }
+
+                        if(direction < 0)
+                        {
+                            source(i++, [storage](auto&&... args)
+                            {
+                                new (storage) Type(std::forward<decltype(args)>(args)...);
+                            });
+                            return;
+                        }
+                        if(direction > 0)
+                        {
+                            movedTo[e] = new (storage) Type(std::move(node(existing[e]).data()));
+                            ++e;
+                            return;
+                        }
+                        //the existing element wins, so skip the new one
+                        ++i;
+                    }
                 }
-                //while temp has a left child
-                while(temp->left != nullptr)
+                catch(...)
                 {
-                    //if we want to know the parent
-                    if(parent != nullptr)
-                        //update the parent
-                        *parent = temp;
-                    //update temp to it's left child
-                    temp = temp->left;
+                    //put the tree back as it was before build() destroys the new slots
+                    for(uint32_t k = 0; k < e; ++k)
+                    {
+                        Type& original = node(existing[k]).data();
+                        original.~Type();
+                        new (&original) Type(std::move(*movedTo[k]));
+                    }
+                    throw;
                 }
-                //return temp which is the successor of the passed in node
-                return temp;
-            }
+            };
+            merged.build(total, emit);
+            //the moved-from elements are destroyed along with the old array
+            *this = std::move(merged);
+            return inserted;
         }
 
-        //prints the tree with a pre-order traversal
-        void print()
+        //removes every element from the tree
+        //the array is kept to be reused
+        void clear()
         {
-            printNode(root);
+            destroy(root);
+            root = NIL;
+            used = 0;
+            notUsed = NIL;
+            count = 0;
         }
 
-        //creates a new tree by copying the nodes over via level order traversal
-        //do level order traversal so that there does not need to be any rotations to keep the tree balanced
-        AVL_Tree<Type>* clone()
+        //moves the nodes into a new array with no spare room, in the given order,
+        //so that searches touch fewer cache lines
+        //this also releases any unused capacity, including all of it if the tree is empty
+        void compact(AVLLayout layout = AVLLayout::van_emde_boas)
         {
-            //Create a new tree
-            AVL_Tree<Type>* daClone = new AVL_Tree<Type>();
-            //if there is something in this tree, copy it into the new tree
-            if(root != nullptr)
+            if(count == 0)
+            {
+                ::operator delete(nodes, std::align_val_t(alignof(Node)));
+                nodes = nullptr;
+                _capacity = 0;
+                used = 0;
+                notUsed = NIL;
+                return;
+            }
+
+            uint32_t n32 = static_cast<uint32_t>(count);
+            //the old index of each node, in the new order
+            uint32_t* order = new uint32_t[n32];
+            uint32_t n = 0;
+            if(layout == AVLLayout::breadth_first)
             {
-                //A FlexQueue to store the different nodes for the level order traversal
-                FlexQueue<Node*> q = new FlexQueue<Node*>();
-                //add the root node to the queue
-                q->add(root);
-                //to store the node we are currently looking at
-                // cppcheck-suppress variableScope
-                Node* temp;
-                //loop until there are no more nodes to be copied to the new tree
-                while(q->getSize() != 0)
+                //the order array doubles as the queue
+                order[n++] = root;
+                for(uint32_t i = 0; i < n; ++i)
                 {
-                    //remove the first element in the queue
-                    temp = q->poll();
-                    //if the current node has a left child
-                    if(temp->left != nullptr)
+                    if(node(order[i]).left != NIL)
                     {
-                        //add the child to the queue
-                        q->add(temp->left);
+                        order[n++] = node(order[i]).left;
                     }
-                    //if the current node has a right child
-                    if(temp->right != nullptr)
+                    if(node(order[i]).right != NIL)
                     {
-                        //add the child to the queue
-                        q->add(temp->right);
+                        order[n++] = node(order[i]).right;
                     }
-                    //insert the current node into the tree
-                    daClone->insert(temp);
                 }
             }
-            //return the copy
-            return daClone;
+            else
+            {
+                vebOrder(root, height(root) + 1, order, n);
+            }
+
+            //the new index of each old node
+            //nodes not in the tree are never looked up
+            uint32_t* renumber = new uint32_t[used];
+            for(uint32_t i = 0; i < n32; ++i)
+            {
+                renumber[order[i]] = i;
+            }
+
+            Node* packed = allocateNodes(n32);
+            for(uint32_t i = 0; i < n32; ++i)
+            {
+                Node& from = node(order[i]);
+                packed[i].left = (from.left != NIL) ? renumber[from.left] : NIL;
+                packed[i].right = (from.right != NIL) ? renumber[from.right] : NIL;
+                packed[i].parent = (from.parent != NIL) ? renumber[from.parent] : NIL;
+                copyBalance(packed[i], from);
+                new (packed[i].storage) Type(std::move(from.data()));
+                from.data().~Type();
+            }
+            root = renumber[root];
+
+            delete[] renumber;
+            delete[] order;
+            ::operator delete(nodes, std::align_val_t(alignof(Node)));
+            nodes = packed;
+            _capacity = n32;
+            used = n32;
+            notUsed = NIL;
+        }
+
+        //prints the tree with a pre-order traversal
+        void print()
+        {
+            if(root != NIL)
+            {
+                printNode(root);
+            }
+        }
+
+        //creates a new tree, with the same shape as this one, so that no rotations are needed
+        AVL_Tree* clone() const
+        {
+            return new AVL_Tree(*this);
+        }
+
+        ~AVL_Tree()
+        {
+            destroy(root);
+            ::operator delete(nodes, std::align_val_t(alignof(Node)));
         }
 };
 
@@ -47,12 +47,19 @@
 #define PAWLIB_BASEFLEXARRAY_HPP
 
 #include <math.h>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <stdlib.h>
+#include <type_traits>
 
 #include "pawlib/iochannel.hpp"
 
-template <typename type, bool raw_copy = false, bool factor_double = true>
+/* The allocator (alloc_t) is the hook for routing the internal array to
+ * another memory source, such as a PoolResource, via any type meeting the
+ * C++ Allocator requirements. The default allocates with `new`. */
+template <typename type, bool raw_copy = false, bool factor_double = true,
+          typename alloc_t = std::allocator<type>>
 class Base_FlexArr
 {
     public:
@@ -61,7 +68,7 @@ class Base_FlexArr
         Base_FlexArr()
         :internalArray(nullptr), internalArrayBound(nullptr),
             head(nullptr), tail(nullptr), resizable(true),
-            _elements(0), _capacity(0)
+            _elements(0), _capacity(0), allocator()
         {
             /* The call to resize() will sets the capacity to 8
                 * on initiation. */
@@ -70,14 +77,29 @@ class Base_FlexArr
             resize(8);
         }
 
+        /** Create a new base flex array, with the default starting size,
+         * which allocates its internal array from the given allocator.
+         * \param the allocator to use
+         */
+        explicit Base_FlexArr(const alloc_t& alloc)
+        :internalArray(nullptr), internalArrayBound(nullptr),
+            head(nullptr), tail(nullptr), resizable(true),
+            _elements(0), _capacity(0), allocator(alloc)
+        {
+            // Allocate the structure with an initial size.
+            resize(8);
+        }
+
         /** Create a new base flex array from another base flex array.
          * Copies the contents of the source array.
          * \param the source array
          */
-        Base_FlexArr(const Base_FlexArr<type>& cpy)
+        Base_FlexArr(const Base_FlexArr& cpy)
         :internalArray(nullptr), internalArrayBound(nullptr),
          head(nullptr), tail(nullptr), resizable(cpy.resizable),
-         _elements(0), _capacity(0)
+         _elements(0), _capacity(0),
+         allocator(std::allocator_traits<alloc_t>::
+            select_on_container_copy_construction(cpy.allocator))
         {
             // Resize to the reserved size of the old array (handles _capacity)
             resize(cpy._capacity);
@@ -89,11 +111,12 @@ class Base_FlexArr
          * Moves (steals) the contents of the source array.
          * \param the source array
          */
-        Base_FlexArr(Base_FlexArr<type>&& mov)
+        Base_FlexArr(Base_FlexArr&& mov)
         :internalArray(std::move(mov.internalArray)),
          internalArrayBound(mov.internalArrayBound),
          head(mov.head), tail(mov.tail), resizable(mov.resizable),
-         _elements(mov._elements), _capacity(mov._capacity)
+         _elements(mov._elements), _capacity(mov._capacity),
+         allocator(mov.allocator)
         {
             // Prevent double-free when source object is destroyed.
             mov.internalArray = nullptr;
@@ -102,11 +125,13 @@ class Base_FlexArr
         /** Create a new base flex array with room for the specified number
          * of elements.
          * \param the number of elements the structure can hold.
+         * \param the allocator to use (optional)
          */
         // cppcheck-suppress noExplicitConstructor
-        Base_FlexArr(size_t numElements)
-        :internalArray(nullptr), head(nullptr), tail(nullptr), resizable(true),
-         _elements(0), _capacity(0)
+        Base_FlexArr(size_t numElements, const alloc_t& alloc = alloc_t())
+        :internalArray(nullptr), internalArrayBound(nullptr),
+         head(nullptr), tail(nullptr), resizable(true),
+         _elements(0), _capacity(0), allocator(alloc)
         {
             // Never allow instantiating with a capacity less than 2.
             if(numElements > 1)
@@ -124,22 +149,16 @@ class Base_FlexArr
         /** Destructor. */
         ~Base_FlexArr()
         {
-            if(internalArray != nullptr)
-            {
-                delete[] internalArray;
-            }
+            releaseArray(internalArray, _capacity);
         }
 
-        Base_FlexArr<type>& operator=(const Base_FlexArr<type>& rhs)
+        Base_FlexArr& operator=(const Base_FlexArr& rhs)
         {
             // Don't copy from self.
             if (&rhs == this) { return *(this); }
 
             // Free original array
-            if(this->internalArray != nullptr)
-            {
-                delete[] this->internalArray;
-            }
+            releaseArray(this->internalArray, this->_capacity);
             this->internalArray = nullptr;
             this->internalArrayBound = nullptr;
             this->head = nullptr;
@@ -147,6 +166,8 @@ class Base_FlexArr
 
             // Redefine properties
             this->resizable = rhs.resizable;
+            this->_elements = 0;
+            this->_capacity = 0;
 
             // Resize to the reserved size of the old array (handles _capacity)
             resize(rhs._capacity);
@@ -156,15 +177,30 @@ class Base_FlexArr
             return *(this);
         }
 
-        Base_FlexArr<type>& operator=(Base_FlexArr&& rhs)
+        Base_FlexArr& operator=(Base_FlexArr&& rhs)
         {
             // Don't copy from self.
             if (&rhs == this) { return *(this); }
 
+            /* The stolen array must be freed by the allocator it came from,
+             * so unless the allocator moves with it, the array may only be
+             * stolen if our allocator is equal. */
+            typedef std::allocator_traits<alloc_t> traits;
+            if constexpr (!traits::propagate_on_container_move_assignment::value)
+            {
+                if (!(this->allocator == rhs.allocator))
+                {
+                    moveForeignMemory(rhs);
+                    return *(this);
+                }
+            }
+
             // Free original array
-            if(this->internalArray != nullptr)
+            releaseArray(this->internalArray, this->_capacity);
+
+            if constexpr (traits::propagate_on_container_move_assignment::value)
             {
-                delete[] this->internalArray;
+                this->allocator = std::move(rhs.allocator);
             }
 
             // Directly steal the contents of the source array.
@@ -344,6 +380,58 @@ class Base_FlexArr
          * in the structure without resizing. (1-based) */
         size_t _capacity;
 
+        /// The allocator for the internal array.
+        alloc_t allocator;
+
+        /** Allocate a new internal array, with every element
+         * default-initialized, just as `new type[n]` would.
+         * \param the number of elements
+         * \return the new array
+         */
+        type* allocateArray(size_t n)
+        {
+            type* arr = std::allocator_traits<alloc_t>::allocate(allocator, n);
+            if constexpr (!std::is_trivially_default_constructible<type>::value)
+            {
+                size_t i = 0;
+                try
+                {
+                    for(; i < n; ++i)
+                    {
+                        ::new (static_cast<void*>(arr + i)) type;
+                    }
+                }
+                catch(...)
+                {
+                    // Undo whatever we managed to construct.
+                    while(i > 0)
+                    {
+                        arr[--i].~type();
+                    }
+                    std::allocator_traits<alloc_t>::deallocate(allocator, arr, n);
+                    throw;
+                }
+            }
+            return arr;
+        }
+
+        /** Destroy and free an internal array from allocateArray().
+         * \param the array (may be nullptr)
+         * \param the number of elements it was allocated with
+         */
+        void releaseArray(type* arr, size_t n)
+        {
+            if(arr == nullptr) { return; }
+            if constexpr (!std::is_trivially_destructible<type>::value)
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    arr[i].~type();
+                }
+            }
+            std::allocator_traits<alloc_t>::deallocate(allocator, arr, n);
+        }
+
         /** Directly access a value in the internal array.
          * Does not check for bounds.
          * \param the internal index to access
@@ -587,7 +675,7 @@ class Base_FlexArr
         /** Copy elements from another Flex-based data structure
          * \param the source data structure
          */
-        void copyForeignMemory(const Base_FlexArr<type>& cpy)
+        void copyForeignMemory(const Base_FlexArr& cpy)
         {
             for (size_t i = 0; i < cpy._elements; ++i)
             {
@@ -598,6 +686,32 @@ class Base_FlexArr
             this->_elements = cpy._elements;
         }
 
+        /** Replace the contents with the elements of another Flex-based
+         * data structure, moved one by one into this structure's own
+         * allocation.
+         * \param the source data structure
+         */
+        void moveForeignMemory(Base_FlexArr& mov)
+        {
+            releaseArray(this->internalArray, this->_capacity);
+            this->internalArray = nullptr;
+            this->internalArrayBound = nullptr;
+            this->head = nullptr;
+            this->tail = nullptr;
+            this->resizable = true;
+            this->_elements = 0;
+            this->_capacity = 0;
+
+            resize(mov._capacity);
+            for (size_t i = 0; i < mov._elements; ++i)
+            {
+                *(this->tail) = std::move(mov.rawAt(i));
+                shiftTailForward();
+            }
+            this->_elements = mov._elements;
+            this->resizable = mov.resizable;
+        }
+
         /** Double the capacity of the structure.
          * \param the number of elements to reserve space for
          * \param whether we're allowed to non-destructively shrink.
@@ -652,7 +766,7 @@ class Base_FlexArr
             }
 
             /* Create the new structure with the new capacity.*/
-            type* tempArray = new type[this->_capacity];
+            type* tempArray = allocateArray(this->_capacity);
 
             // If there was an error allocating the new array...
             if(tempArray == nullptr)
@@ -704,7 +818,7 @@ class Base_FlexArr
                 }
 
                 // Delete the old structure.
-                delete[] this->internalArray;
+                releaseArray(this->internalArray, oldCapacity);
                 this->internalArray = nullptr;
             }
 
@@ -0,0 +1,706 @@
+/** BitStream [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * Bit-granular writing and reading, with variable-length integer codes.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_BITSTREAM_HPP
+#define PAWLIB_BITSTREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "pawlib/flex_bit.hpp"
+
+/* Bits are packed least significant first: the first bit written is the
+ * lowest bit of the first byte. Both classes move whole 64-bit words
+ * between memory and an accumulator, without branching on how many bits
+ * are written or read, so single bits and whole words cost about the same. */
+
+/** \return a signed integer mapped to an unsigned one, so that numbers
+  * near zero, positive or negative, stay small: 0, -1, 1, -2... become
+  * 0, 1, 2, 3... */
+inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/** \return the signed integer which zigzag_encode() mapped to value */
+inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/** Writes bits and variable-length integers into a byte buffer, which
+  * either grows as needed, or is supplied by the caller and fixed. */
+class BitWriter
+{
+    public:
+        /** Write into a buffer which grows as needed. */
+        BitWriter()
+        :buffer(nullptr), capacity(0), length(0), acc(0), fill(0), owned(true)
+        {}
+
+        /** Write into the caller's buffer, which must outlive the writer.
+          * Writing more than fits throws std::length_error.
+          * \param the buffer
+          * \param the size of the buffer in bytes */
+        BitWriter(uint8_t* buffer, size_t bytes)
+        :buffer(buffer), capacity(bytes), length(0), acc(0), fill(0), owned(false)
+        {}
+
+        BitWriter(const BitWriter&) = delete;
+        BitWriter& operator=(const BitWriter&) = delete;
+
+        ~BitWriter()
+        {
+            if(owned)
+            {
+                delete[] buffer;
+            }
+        }
+
+        /** Write the low bits of a value.
+          * \param the value, whose higher bits are ignored
+          * \param the number of bits, from 0 to 64 */
+        void write_bits(uint64_t value, unsigned int n)
+        {
+            emit([value, n](Cursor& c) { append64(c, value, n); });
+        }
+
+        void write_bit(bool bit)
+        {
+            write_bits(bit ? 1 : 0, 1);
+        }
+
+        /** Write an unsigned LEB128 varint: seven bits per byte, low groups
+          * first, with the high bit of every byte but the last set. */
+        void write_varint(uint64_t value)
+        {
+            emit([value](Cursor& c) { append_varint(c, value); });
+        }
+
+        /** Write a signed varint, zigzag-encoded so that small negative
+          * numbers stay short. */
+        void write_svarint(int64_t value)
+        {
+            write_varint(zigzag_encode(value));
+        }
+
+        /** Write an Elias-gamma code: for a value with N bits after its
+          * leading one, N zeros, a one, then those N bits.
+          * \param the value, at least 1
+          * \throws std::invalid_argument if the value is 0 */
+        void write_gamma(uint64_t value)
+        {
+            if(value == 0)
+            {
+                throw std::invalid_argument("BitWriter: Elias-gamma cannot encode 0");
+            }
+            emit([value](Cursor& c)
+            {
+                unsigned int n = 63 - static_cast<unsigned int>(__builtin_clzll(value));
+                uint64_t low = value ^ (uint64_t(1) << n);
+                if(n <= 31)
+                {
+                    append64(c, (uint64_t(1) << n) | (low << (n + 1)), 2 * n + 1);
+                    return;
+                }
+                append64(c, uint64_t(1) << n, n + 1);
+                append64(c, low, n);
+            });
+        }
+
+        /** Write a Golomb-Rice code: the value shifted right by k, in unary
+          * as that many zeros and a one, then the low k bits.
+          * \param the value
+          * \param k, from 0 to 63 */
+        void write_rice(uint64_t value, unsigned int k)
+        {
+            uint64_t quotient = value >> k;
+            uint64_t low = value & low_mask(k);
+            if(quotient < 63 - k)
+            {
+                unsigned int q = static_cast<unsigned int>(quotient);
+                emit([q, low, k](Cursor& c) { append64(c, (uint64_t(1) << q) | (low << (q + 1)), q + 1 + k); });
+                return;
+            }
+            for(; quotient >= 64; quotient -= 64)
+            {
+                write_bits(0, 64);
+            }
+            unsigned int q = static_cast<unsigned int>(quotient);
+            emit([q, low, k](Cursor& c)
+            {
+                append64(c, uint64_t(1) << q, q + 1);
+                append64(c, low, k);
+            });
+        }
+
+        /** Write an array of varints, reserving the space for them first,
+          * so that the loop needs no checks. */
+        void write_varint_array(const uint64_t* values, size_t count)
+        {
+            reserve(count * 10);
+            if(length + count * 10 + room > capacity)
+            {
+                // Only the caller's buffer can be short, and may still fit.
+                for(size_t i = 0; i < count; ++i)
+                {
+                    write_varint(values[i]);
+                }
+                return;
+            }
+            Cursor c{buffer, length, acc, fill};
+            for(size_t i = 0; i < count; ++i)
+            {
+                append_varint(c, values[i]);
+            }
+            commit(c);
+        }
+
+        /** Write an array of Golomb-Rice codes with the same k. */
+        void write_rice_array(const uint64_t* values, size_t count, unsigned int k)
+        {
+            reserve(count * (k + 2) / 8);
+            for(size_t i = 0; i < count; ++i)
+            {
+                write_rice(values[i], k);
+            }
+        }
+
+        /** Pad with zeros to the next byte boundary. */
+        void flush()
+        {
+            if(fill > 0)
+            {
+                // The partial byte is already stored.
+                ++length;
+                acc = 0;
+                fill = 0;
+            }
+        }
+
+        /** Flush, push every byte onto the back of a FlexBit, and start over. */
+        void drain_to(FlexBit& sink)
+        {
+            flush();
+            sink.push(buffer, static_cast<unsigned int>(length));
+            length = 0;
+        }
+
+        /** Ensure room for the given number of bytes past those written.
+          * Only a growable buffer is changed. */
+        void reserve(size_t bytes)
+        {
+            if(owned && length + bytes + room > capacity)
+            {
+                grow(length + bytes + room);
+            }
+        }
+
+        /** Discard everything written, keeping the buffer. */
+        void clear()
+        {
+            length = 0;
+            acc = 0;
+            fill = 0;
+        }
+
+        /** \return the written bytes, including a partial last byte */
+        const uint8_t* data() const
+        {
+            return buffer;
+        }
+
+        /** \return the number of bytes written, counting a partial last byte */
+        size_t size() const
+        {
+            return length + ((fill > 0) ? 1 : 0);
+        }
+
+        /** \return the number of bits written */
+        size_t size_bits() const
+        {
+            return length * 8 + fill;
+        }
+
+    private:
+        uint8_t* buffer;
+        size_t capacity;
+        // The complete bytes in the buffer.
+        size_t length;
+        // The bits of the partial last byte, in the low fill bits.
+        uint64_t acc;
+        unsigned int fill;
+        bool owned;
+
+        /* The writer's position, copied into locals while encoding. Stores
+         * through the byte buffer could alias the members, and would force
+         * the compiler to reload them after every store; locals it can keep
+         * in registers. */
+        struct Cursor
+        {
+            uint8_t* out;
+            size_t length;
+            uint64_t acc;
+            unsigned int fill;
+        };
+
+        // The most bytes one emit() may touch, including the slack for
+        // storing whole words.
+        static const size_t room = 32;
+
+        static uint64_t low_mask(unsigned int n)
+        {
+            return (n == 0) ? 0 : ~uint64_t(0) >> (64 - n);
+        }
+
+        /** Append up to 56 bits. */
+        static void append(Cursor& c, uint64_t value, unsigned int n)
+        {
+            // Read the cursor before storing, since a byte store may alias it.
+            uint64_t acc = c.acc | ((value & ((uint64_t(1) << n) - 1)) << c.fill);
+            unsigned int total = c.fill + n;
+            size_t length = c.length;
+            // Store the whole word, then advance past the complete bytes.
+            // The partial last byte stays in the accumulator, and is stored
+            // again, with more bits, by the next append.
+            store_word(c.out + length, acc);
+            c.length = length + (total >> 3);
+            c.acc = acc >> (total & ~7u);
+            c.fill = total & 7;
+        }
+
+        /** Append up to 64 bits. */
+        static void append64(Cursor& c, uint64_t value, unsigned int n)
+        {
+            if(n > 56)
+            {
+                append(c, value, 32);
+                append(c, value >> 32, n - 32);
+                return;
+            }
+            append(c, value, n);
+        }
+
+        static void append_varint(Cursor& c, uint64_t value)
+        {
+            unsigned int bits = 64 - static_cast<unsigned int>(__builtin_clzll(value | 1));
+            unsigned int groups = (bits + 6) / 7;
+            if(groups <= 7)
+            {
+                uint64_t continues = 0x8080808080808080ULL & ((uint64_t(1) << (8 * (groups - 1))) - 1);
+                append(c, spread7(value) | continues, 8 * groups);
+                return;
+            }
+            // Pass a copy, so that the caller's cursor can stay in registers.
+            Cursor spill = c;
+            append_long_varint(spill, value, groups);
+            c = spill;
+        }
+
+        /** Append a varint of eight to ten bytes. This is rare enough to
+          * keep out of line, so that append_varint() is small enough to inline. */
+        static void append_long_varint(Cursor& c, uint64_t value, unsigned int groups);
+
+        void commit(const Cursor& c)
+        {
+            length = c.length;
+            acc = c.acc;
+            fill = c.fill;
+        }
+
+        /** Run an encoder, which touches at most room bytes, on a cursor. */
+        template<typename Encode>
+        void emit(Encode encode)
+        {
+            if(length + room > capacity)
+            {
+                if(!owned)
+                {
+                    emit_tail(encode);
+                    return;
+                }
+                grow(length + room);
+            }
+            Cursor c{buffer, length, acc, fill};
+            encode(c);
+            commit(c);
+        }
+
+        /** Near the end of the caller's buffer, encode into scratch space,
+          * then copy only the bytes produced. */
+        template<typename Encode>
+        void emit_tail(Encode encode)
+        {
+            uint8_t scratch[room];
+            Cursor c{scratch, 0, acc, fill};
+            encode(c);
+            size_t bytes = c.length + ((c.fill > 0) ? 1 : 0);
+            if(length + bytes > capacity)
+            {
+                throw std::length_error("BitWriter: buffer full");
+            }
+            if(bytes > 0)
+            {
+                memcpy(buffer + length, scratch, bytes);
+            }
+            c.length += length;
+            commit(c);
+        }
+
+        /** \return the low 56 bits spread into the low seven bits of each byte */
+        static uint64_t spread7(uint64_t value)
+        {
+#if defined(__BMI2__)
+            return _pdep_u64(value, 0x7F7F7F7F7F7F7F7FULL);
+#else
+            uint64_t x = value & low_mask(56);
+            x = (x & 0x000000000FFFFFFFULL) | ((x & 0x00FFFFFFF0000000ULL) << 4);
+            x = (x & 0x00003FFF00003FFFULL) | ((x & 0x0FFFC0000FFFC000ULL) << 2);
+            x = (x & 0x007F007F007F007FULL) | ((x & 0x3F803F803F803F80ULL) << 1);
+            return x;
+#endif
+        }
+
+        static void store_word(uint8_t* p, uint64_t word)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            memcpy(p, &word, 8);
+#else
+            for(size_t i = 0; i < 8; ++i)
+            {
+                p[i] = static_cast<uint8_t>(word >> (8 * i));
+            }
+#endif
+        }
+
+        void grow(size_t needed)
+        {
+            size_t newCapacity = (capacity < 64) ? 64 : capacity * 2;
+            while(newCapacity < needed)
+            {
+                newCapacity *= 2;
+            }
+            uint8_t* newBuffer = new uint8_t[newCapacity];
+            if(length > 0)
+            {
+                memcpy(newBuffer, buffer, length);
+            }
+            delete[] buffer;
+            buffer = newBuffer;
+            capacity = newCapacity;
+        }
+};
+
+/** Reads bits and variable-length integers written by BitWriter, from a
+  * byte buffer or a FlexBit. Reading past the end throws std::out_of_range. */
+class BitReader
+{
+    public:
+        /** Read from the caller's buffer, which must outlive the reader.
+          * \param the buffer
+          * \param the size of the buffer in bytes */
+        BitReader(const uint8_t* data, size_t bytes)
+        :data(data), bytes(bytes), bits(bytes * 8), pos(0), owned(nullptr)
+        {}
+
+        /** Poll every byte from a FlexBit, and read from those. */
+        explicit BitReader(FlexBit& source)
+        :data(nullptr), bytes(source.getSize()), bits(bytes * 8), pos(0), owned(nullptr)
+        {
+            owned = new uint8_t[bytes];
+            source.poll(owned, static_cast<unsigned int>(bytes));
+            data = owned;
+        }
+
+        BitReader(const BitReader&) = delete;
+        BitReader& operator=(const BitReader&) = delete;
+
+        ~BitReader()
+        {
+            delete[] owned;
+        }
+
+        /** Read bits into the low bits of the result.
+          * \param the number of bits, from 0 to 64 */
+        uint64_t read_bits(unsigned int n)
+        {
+            uint64_t value = peek() & low_mask(n);
+            consume(n);
+            return value;
+        }
+
+        bool read_bit()
+        {
+            return read_bits(1) != 0;
+        }
+
+        /** Read an unsigned LEB128 varint.
+          * \throws std::invalid_argument if it runs past ten bytes */
+        uint64_t read_varint()
+        {
+            uint64_t word = peek();
+            uint64_t stops = ~word & 0x8080808080808080ULL;
+            if(stops != 0)
+            {
+                // The first byte without a continuation bit ends it.
+                unsigned int length = (static_cast<unsigned int>(__builtin_ctzll(stops)) >> 3) + 1;
+                uint64_t value = gather7(word & low_mask(8 * length));
+                consume(8 * length);
+                return value;
+            }
+            uint64_t value = gather7(word);
+            consume(64);
+            for(unsigned int shift = 56; shift <= 63; shift += 7)
+            {
+                uint64_t byte = read_bits(8);
+                value |= (byte & 0x7F) << shift;
+                if((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            throw std::invalid_argument("BitReader: varint longer than ten bytes");
+        }
+
+        /** Read a zigzag-encoded signed varint. */
+        int64_t read_svarint()
+        {
+            return zigzag_decode(read_varint());
+        }
+
+        /** Read an Elias-gamma code.
+          * \throws std::invalid_argument if there are more than 63 leading zeros */
+        uint64_t read_gamma()
+        {
+            uint64_t word = peek();
+            if(word == 0)
+            {
+                if(remaining() < 64)
+                {
+                    throw std::out_of_range("BitReader: read past the end");
+                }
+                throw std::invalid_argument("BitReader: malformed Elias-gamma code");
+            }
+            unsigned int n = static_cast<unsigned int>(__builtin_ctzll(word));
+            if(n <= 31)
+            {
+                uint64_t low = (word >> (n + 1)) & low_mask(n);
+                consume(2 * n + 1);
+                return (uint64_t(1) << n) | low;
+            }
+            consume(n + 1);
+            return (uint64_t(1) << n) | read_bits(n);
+        }
+
+        /** Read a Golomb-Rice code.
+          * \param k, from 0 to 63, as it was written */
+        uint64_t read_rice(unsigned int k)
+        {
+            uint64_t word = peek();
+            if(word != 0)
+            {
+                unsigned int q = static_cast<unsigned int>(__builtin_ctzll(word));
+                if(q + 1 + k < 64)
+                {
+                    uint64_t low = (word >> (q + 1)) & low_mask(k);
+                    consume(q + 1 + k);
+                    return (uint64_t(q) << k) | low;
+                }
+            }
+            // A long quotient, a word of zeros at a time.
+            uint64_t quotient = 0;
+            while((word = peek()) == 0)
+            {
+                consume(64);
+                quotient += 64;
+            }
+            unsigned int q = static_cast<unsigned int>(__builtin_ctzll(word));
+            consume(q + 1);
+            quotient += q;
+            return (quotient << k) | read_bits(k);
+        }
+
+        /** Read an array of varints. */
+        void read_varint_array(uint64_t* values, size_t count)
+        {
+            // Work on a local position, since the stores to values may alias
+            // the members. With nine bytes left, a varint of up to eight
+            // bytes needs no checks; anything else takes read_varint().
+            const uint8_t* const source = data;
+            const size_t end = bytes;
+            size_t at = pos;
+            for(size_t i = 0; i < count; ++i)
+            {
+                if((at >> 3) + 9 <= end)
+                {
+                    const uint8_t* p = source + (at >> 3);
+                    unsigned int shift = static_cast<unsigned int>(at & 7);
+                    uint64_t word = (load_word(p) >> shift) | ((uint64_t(p[8]) << 1) << (63 - shift));
+                    uint64_t stops = ~word & 0x8080808080808080ULL;
+                    if(stops != 0)
+                    {
+                        unsigned int length = (static_cast<unsigned int>(__builtin_ctzll(stops)) >> 3) + 1;
+                        values[i] = gather7(word & low_mask(8 * length));
+                        at += 8 * length;
+                        continue;
+                    }
+                }
+                pos = at;
+                values[i] = read_varint();
+                at = pos;
+            }
+            pos = at;
+        }
+
+        /** Read an array of Golomb-Rice codes with the same k. */
+        void read_rice_array(uint64_t* values, size_t count, unsigned int k)
+        {
+            for(size_t i = 0; i < count; ++i)
+            {
+                values[i] = read_rice(k);
+            }
+        }
+
+        /** Skip to the next byte boundary. */
+        void align()
+        {
+            pos = (pos + 7) & ~size_t(7);
+            if(pos > bits)
+            {
+                pos = bits;
+            }
+        }
+
+        /** \return the number of bits read */
+        size_t position() const
+        {
+            return pos;
+        }
+
+        /** \return the number of bits left */
+        size_t remaining() const
+        {
+            return bits - pos;
+        }
+
+    private:
+        const uint8_t* data;
+        size_t bytes;
+        size_t bits;
+        size_t pos;
+        // The bytes polled from a FlexBit, if any.
+        uint8_t* owned;
+
+        static uint64_t low_mask(unsigned int n)
+        {
+            return (n == 0) ? 0 : ~uint64_t(0) >> (64 - n);
+        }
+
+        static uint64_t load_word(const uint8_t* p)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            uint64_t word;
+            memcpy(&word, p, 8);
+            return word;
+#else
+            uint64_t word = 0;
+            for(size_t i = 0; i < 8; ++i)
+            {
+                word |= uint64_t(p[i]) << (8 * i);
+            }
+            return word;
+#endif
+        }
+
+        /** \return the low seven bits of each byte, packed together */
+        static uint64_t gather7(uint64_t word)
+        {
+#if defined(__BMI2__)
+            return _pext_u64(word, 0x7F7F7F7F7F7F7F7FULL);
+#else
+            uint64_t x = word & 0x7F7F7F7F7F7F7F7FULL;
+            x = (x & 0x007F007F007F007FULL) | ((x & 0x7F007F007F007F00ULL) >> 1);
+            x = (x & 0x00003FFF00003FFFULL) | ((x & 0x3FFF00003FFF0000ULL) >> 2);
+            x = (x & 0x000000000FFFFFFFULL) | ((x & 0x0FFFFFFF00000000ULL) >> 4);
+            return x;
+#endif
+        }
+
+        /** \return the next 64 bits, without moving; bits past the end are zero */
+        uint64_t peek() const
+        {
+            size_t at = pos >> 3;
+            unsigned int shift = static_cast<unsigned int>(pos & 7);
+            const uint8_t* p = data + at;
+            uint8_t tail[9];
+            if(at + 9 > bytes)
+            {
+                // Near the end, copy what there is into zeros.
+                memset(tail, 0, sizeof(tail));
+                if(at < bytes)
+                {
+                    memcpy(tail, p, bytes - at);
+                }
+                p = tail;
+            }
+            // The ninth byte supplies the bits the shift pushed out.
+            return (load_word(p) >> shift) | ((uint64_t(p[8]) << 1) << (63 - shift));
+        }
+
+        void consume(size_t n)
+        {
+            if(n > bits - pos)
+            {
+                throw std::out_of_range("BitReader: read past the end");
+            }
+            pos += n;
+        }
+};
+
+#endif // PAWLIB_BITSTREAM_HPP
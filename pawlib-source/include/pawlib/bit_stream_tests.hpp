@@ -0,0 +1,571 @@
+/** Tests for BitStream [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_BITSTREAM_TESTS_HPP
+#define PAWLIB_BITSTREAM_TESTS_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "pawlib/bit_stream.hpp"
+#include "pawlib/flex_bit.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** \return values of every bit length from 0 to 64, with the edges of
+  * each length, and some random ones, for exercising the codes */
+inline std::vector<uint64_t> bitstream_values(uint32_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> values{0, 1};
+    for(unsigned int bits = 2; bits <= 64; ++bits)
+    {
+        uint64_t top = uint64_t(1) << (bits - 1);
+        uint64_t mask = (bits == 64) ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        values.push_back(top);
+        values.push_back(mask);
+        values.push_back(top | (rng() & mask));
+    }
+    return values;
+}
+
+// P-tB8301
+class TestBitStream_Bits : public Test
+{
+    public:
+        TestBitStream_Bits(){}
+
+        testdoc_t get_title() override
+        {
+            return "BitStream: Write & Read Bits";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Write " + stdutils::itos(count) + " values of random widths from 0 to 64 bits, "
+                   "read them back, and check the ends of the stream and of a fixed buffer.";
+        }
+
+        bool run() override
+        {
+            std::mt19937_64 rng(8301);
+            std::vector<uint64_t> values(count);
+            std::vector<unsigned int> widths(count);
+            BitWriter writer;
+            size_t total = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                widths[i] = static_cast<unsigned int>(rng() % 65);
+                values[i] = rng();
+                writer.write_bits(values[i], widths[i]);
+                total += widths[i];
+            }
+            writer.write_bit(true);
+            PL_ASSERT_EQUAL(writer.size_bits(), total + 1);
+            writer.flush();
+            PL_ASSERT_EQUAL(writer.size(), (total + 8) / 8);
+
+            BitReader reader(writer.data(), writer.size());
+            for(int i = 0; i < count; ++i)
+            {
+                uint64_t mask = (widths[i] == 0) ? 0 : ~uint64_t(0) >> (64 - widths[i]);
+                PL_ASSERT_EQUAL(reader.read_bits(widths[i]), values[i] & mask);
+            }
+            PL_ASSERT_TRUE(reader.read_bit());
+            PL_ASSERT_EQUAL(reader.position(), total + 1);
+
+            // Only the padding is left.
+            reader.align();
+            PL_ASSERT_EQUAL(reader.remaining(), static_cast<size_t>(0));
+            try
+            {
+                reader.read_bits(1);
+                return false;
+            }
+            catch(std::out_of_range&) {}
+
+            // The first bit written is the lowest bit of the first byte.
+            uint8_t buffer[3];
+            BitWriter fixed(buffer, sizeof(buffer));
+            fixed.write_bits(1, 1);
+            fixed.write_bits(0x5A, 8);
+            fixed.write_bits(0x7FFF, 15);
+            fixed.flush();
+            PL_ASSERT_EQUAL(buffer[0], 0xB5);
+            PL_ASSERT_EQUAL(buffer[1], 0xFE);
+            PL_ASSERT_EQUAL(buffer[2], 0xFF);
+            try
+            {
+                fixed.write_bits(1, 1);
+                fixed.flush();
+                return false;
+            }
+            catch(std::length_error&) {}
+            return true;
+        }
+
+        ~TestBitStream_Bits(){}
+
+    private:
+        static const int count = 100000;
+};
+
+// P-tB8302
+class TestBitStream_Varint : public Test
+{
+    public:
+        TestBitStream_Varint(){}
+
+        testdoc_t get_title() override
+        {
+            return "BitStream: Varint & Zigzag";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Encode values of every length as LEB128 varints, signed values as zigzag "
+                   "varints, check known encodings, and reject overlong varints.";
+        }
+
+        bool run() override
+        {
+            // The example from the LEB128 specification.
+            BitWriter known;
+            known.write_varint(624485);
+            known.write_varint(0);
+            known.write_varint(127);
+            known.write_varint(128);
+            known.flush();
+            const uint8_t expected[] = {0xE5, 0x8E, 0x26, 0x00, 0x7F, 0x80, 0x01};
+            PL_ASSERT_EQUAL(known.size(), sizeof(expected));
+            for(size_t i = 0; i < sizeof(expected); ++i)
+            {
+                PL_ASSERT_EQUAL(known.data()[i], expected[i]);
+            }
+
+            // Misalign the varints, so none starts on a byte boundary.
+            std::vector<uint64_t> values = bitstream_values(8302);
+            BitWriter writer;
+            for(uint64_t value : values)
+            {
+                writer.write_bits(1, 3);
+                writer.write_varint(value);
+            }
+            writer.write_varint_array(values.data(), values.size());
+            writer.flush();
+            BitReader reader(writer.data(), writer.size());
+            for(uint64_t value : values)
+            {
+                PL_ASSERT_EQUAL(reader.read_bits(3), static_cast<uint64_t>(1));
+                PL_ASSERT_EQUAL(reader.read_varint(), value);
+            }
+            std::vector<uint64_t> decoded(values.size());
+            reader.read_varint_array(decoded.data(), decoded.size());
+            PL_ASSERT_TRUE(decoded == values);
+
+            // Zigzag keeps small magnitudes small.
+            PL_ASSERT_EQUAL(zigzag_encode(0), static_cast<uint64_t>(0));
+            PL_ASSERT_EQUAL(zigzag_encode(-1), static_cast<uint64_t>(1));
+            PL_ASSERT_EQUAL(zigzag_encode(1), static_cast<uint64_t>(2));
+            const int64_t signedValues[] = {0, -1, 1, -64, 64, -65, std::numeric_limits<int64_t>::min(),
+                                            std::numeric_limits<int64_t>::max()};
+            BitWriter signedWriter;
+            for(int64_t value : signedValues)
+            {
+                signedWriter.write_svarint(value);
+            }
+            signedWriter.flush();
+            BitReader signedReader(signedWriter.data(), signedWriter.size());
+            for(int64_t value : signedValues)
+            {
+                PL_ASSERT_EQUAL(signedReader.read_svarint(), value);
+            }
+
+            // Eleven continuation bytes.
+            const uint8_t overlong[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+            BitReader bad(overlong, sizeof(overlong));
+            try
+            {
+                bad.read_varint();
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+
+            // A varint cut short.
+            BitReader truncated(overlong, 3);
+            try
+            {
+                truncated.read_varint();
+                return false;
+            }
+            catch(std::out_of_range&) {}
+            return true;
+        }
+
+        ~TestBitStream_Varint(){}
+};
+
+// P-tB8303
+class TestBitStream_GammaRice : public Test
+{
+    public:
+        TestBitStream_GammaRice(){}
+
+        testdoc_t get_title() override
+        {
+            return "BitStream: Elias-Gamma & Golomb-Rice";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Encode values of every length with Elias-gamma and Golomb-Rice codes, "
+                   "including quotients longer than a word.";
+        }
+
+        bool run() override
+        {
+            std::vector<uint64_t> values = bitstream_values(8303);
+
+            BitWriter gammaWriter;
+            for(uint64_t value : values)
+            {
+                if(value > 0)
+                {
+                    gammaWriter.write_gamma(value);
+                }
+            }
+            gammaWriter.flush();
+            BitReader gammaReader(gammaWriter.data(), gammaWriter.size());
+            for(uint64_t value : values)
+            {
+                if(value > 0)
+                {
+                    PL_ASSERT_EQUAL(gammaReader.read_gamma(), value);
+                }
+            }
+            try
+            {
+                gammaWriter.write_gamma(0);
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+
+            // The gamma code of 5 (101) is 00, 1, then 01, lowest bits first.
+            BitWriter five;
+            five.write_gamma(5);
+            five.flush();
+            PL_ASSERT_EQUAL(five.data()[0], 0x0C);
+
+            for(unsigned int k = 0; k < 64; k += 7)
+            {
+                BitWriter riceWriter;
+                for(uint64_t value : values)
+                {
+                    // Keep the quotients to a few words.
+                    riceWriter.write_rice(value & (~uint64_t(0) >> (55 - (k < 55 ? k : 55))), k);
+                }
+                riceWriter.write_rice_array(values.data() + 1, 20, k);
+                riceWriter.flush();
+                BitReader riceReader(riceWriter.data(), riceWriter.size());
+                for(uint64_t value : values)
+                {
+                    PL_ASSERT_EQUAL(riceReader.read_rice(k), value & (~uint64_t(0) >> (55 - (k < 55 ? k : 55))));
+                }
+                std::vector<uint64_t> decoded(20);
+                riceReader.read_rice_array(decoded.data(), decoded.size(), k);
+                PL_ASSERT_TRUE(std::vector<uint64_t>(values.begin() + 1, values.begin() + 21) == decoded);
+            }
+            return true;
+        }
+
+        ~TestBitStream_GammaRice(){}
+};
+
+// P-tB8304
+class TestBitStream_FlexBit : public Test
+{
+    public:
+        TestBitStream_FlexBit(){}
+
+        testdoc_t get_title() override
+        {
+            return "BitStream: Through FlexBit";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Drain several batches of codes into a FlexBit, then read them back out of it.";
+        }
+
+        bool run() override
+        {
+            // Leave one byte queued partway along, so the batches wrap
+            // around the end of the FlexBit's buffer.
+            FlexBit queue;
+            for(int i = 0; i < 12; ++i)
+            {
+                queue.push(std::bitset<8>(i));
+            }
+            for(int i = 0; i < 11; ++i)
+            {
+                queue.poll();
+            }
+            BitWriter writer;
+            for(uint64_t batch = 0; batch < 50; ++batch)
+            {
+                for(uint64_t i = 0; i < 100; ++i)
+                {
+                    writer.write_varint(batch * 1000 + i);
+                    writer.write_rice(i, 3);
+                }
+                writer.drain_to(queue);
+                PL_ASSERT_EQUAL(writer.size(), static_cast<size_t>(0));
+            }
+            unsigned int queued = queue.getSize();
+
+            BitReader reader(queue);
+            PL_ASSERT_TRUE(queue.isEmpty());
+            PL_ASSERT_EQUAL(reader.remaining(), static_cast<size_t>(queued) * 8);
+            PL_ASSERT_EQUAL(reader.read_bits(8), static_cast<uint64_t>(11));
+            for(uint64_t batch = 0; batch < 50; ++batch)
+            {
+                for(uint64_t i = 0; i < 100; ++i)
+                {
+                    PL_ASSERT_EQUAL(reader.read_varint(), batch * 1000 + i);
+                    PL_ASSERT_EQUAL(reader.read_rice(3), i);
+                }
+                reader.align();
+            }
+            PL_ASSERT_EQUAL(reader.remaining(), static_cast<size_t>(0));
+            return true;
+        }
+
+        ~TestBitStream_FlexBit(){}
+};
+
+/** Byte-at-a-time LEB128 into a std::vector, for comparison with BitWriter
+  * and BitReader. */
+class BitStreamBenchBytes
+{
+    public:
+        void encode(const uint64_t* values, size_t count)
+        {
+            buffer.clear();
+            for(size_t i = 0; i < count; ++i)
+            {
+                uint64_t value = values[i];
+                while(value >= 0x80)
+                {
+                    buffer.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                buffer.push_back(static_cast<uint8_t>(value));
+            }
+        }
+
+        void decode(uint64_t* values, size_t count) const
+        {
+            size_t at = 0;
+            for(size_t i = 0; i < count; ++i)
+            {
+                uint64_t value = 0;
+                for(unsigned int shift = 0; ; shift += 7)
+                {
+                    uint8_t byte = buffer[at++];
+                    value |= uint64_t(byte & 0x7F) << shift;
+                    if((byte & 0x80) == 0)
+                    {
+                        break;
+                    }
+                }
+                values[i] = value;
+            }
+        }
+
+    private:
+        std::vector<uint8_t> buffer;
+};
+
+/** BitWriter and BitReader, through their bulk varint calls. */
+class BitStreamBenchWriter
+{
+    public:
+        void encode(const uint64_t* values, size_t count)
+        {
+            writer.clear();
+            writer.write_varint_array(values, count);
+            writer.flush();
+        }
+
+        void decode(uint64_t* values, size_t count) const
+        {
+            BitReader reader(writer.data(), writer.size());
+            reader.read_varint_array(values, count);
+        }
+
+    private:
+        BitWriter writer;
+};
+
+/** \return varints of mixed lengths, mostly short, like telemetry deltas */
+inline std::vector<uint64_t> bitstream_bench_values(size_t count)
+{
+    std::mt19937_64 rng(8305);
+    std::vector<uint64_t> values(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        values[i] = rng() >> (rng() % 64);
+    }
+    return values;
+}
+
+// P-tB8305, P-tB8305*
+template<typename codec_t>
+class TestBitStream_Encode : public Test
+{
+    public:
+        explicit TestBitStream_Encode(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Encode Varints";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Encode " + stdutils::itos(count) + " varints of mixed lengths with " + name + ".";
+        }
+
+        bool pre() override
+        {
+            if(values.empty())
+            {
+                values = bitstream_bench_values(count);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            codec.encode(values.data(), values.size());
+            return true;
+        }
+
+        ~TestBitStream_Encode(){}
+
+    private:
+        static const size_t count = 1000000;
+        testdoc_t name;
+        std::vector<uint64_t> values;
+        codec_t codec;
+};
+
+// P-tB8306, P-tB8306*
+template<typename codec_t>
+class TestBitStream_Decode : public Test
+{
+    public:
+        explicit TestBitStream_Decode(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Decode Varints";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Decode " + stdutils::itos(count) + " varints of mixed lengths with " + name + ".";
+        }
+
+        bool pre() override
+        {
+            if(values.empty())
+            {
+                values = bitstream_bench_values(count);
+                decoded.resize(count);
+                codec.encode(values.data(), values.size());
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            codec.decode(decoded.data(), decoded.size());
+            return decoded.back() == values.back();
+        }
+
+        ~TestBitStream_Decode(){}
+
+    private:
+        static const size_t count = 1000000;
+        testdoc_t name;
+        std::vector<uint64_t> values;
+        std::vector<uint64_t> decoded;
+        codec_t codec;
+};
+
+class TestSuite_BitStream : public TestSuite
+{
+    public:
+        explicit TestSuite_BitStream(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: BitStream Tests";
+        }
+
+        ~TestSuite_BitStream(){}
+};
+
+#endif // PAWLIB_BITSTREAM_TESTS_HPP
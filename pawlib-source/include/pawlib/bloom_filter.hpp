@@ -0,0 +1,622 @@
+/** BloomFilter [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * Probabilistic membership filters: a classic Bloom filter, and a
+  * blocked Bloom filter which keeps each key's bits in one cache line.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_BLOOMFILTER_HPP
+#define PAWLIB_BLOOMFILTER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "pawlib/flex_bitset.hpp"
+#include "pawlib/flex_hash_table.hpp"
+
+/** The parts BloomFilter and BlockedBloomFilter share: the bits, the number
+  * of hashes, sizing, and the serialized form.
+  *
+  * A key is hashed once with hash_t, and a second hash is mixed from the
+  * first, for double hashing. hash_t should mix its bits as well as FlexHash
+  * does, since a poor hash shows up directly as false positives. */
+template<typename hash_t>
+class BloomFilterBase
+{
+    public:
+        /** Remove every key. */
+        void clear()
+        {
+            bits.reset_all();
+            inserted = 0;
+        }
+
+        /** \return the number of bits in the filter */
+        size_t bit_count() const
+        {
+            return bits.size();
+        }
+
+        /** \return the number of bits set for each key */
+        unsigned int hash_count() const
+        {
+            return hashes;
+        }
+
+        /** \return the number of keys inserted, counting repeats */
+        size_t size() const
+        {
+            return inserted;
+        }
+
+        /** \return the false-positive rate expected from the fraction of
+          * bits set so far */
+        double estimated_fpr() const
+        {
+            double fill = static_cast<double>(bits.popcount()) / static_cast<double>(bits.size());
+            return std::pow(fill, static_cast<double>(hashes));
+        }
+
+        /** \return the number of bytes serialize() writes */
+        size_t serialized_size() const
+        {
+            return header_bytes + bits.words() * 8;
+        }
+
+        /** Write the filter in a little-endian form, which may be read on
+          * any platform, by a filter of the same type and hash.
+          * \param where to write, which must have room for serialized_size() bytes
+          * \return the number of bytes written */
+        size_t serialize(unsigned char* out) const
+        {
+            put32(out, magic);
+            put32(out + 4, hashes);
+            put64(out + 8, bits.size());
+            put64(out + 16, inserted);
+            const uint64_t* words = bits.data();
+            unsigned char* p = out + header_bytes;
+            for(size_t i = 0; i < bits.words(); ++i)
+            {
+                put64(p, words[i]);
+                p += 8;
+            }
+            return static_cast<size_t>(p - out);
+        }
+
+    protected:
+        // The magic number, the number of hashes, the number of bits, and
+        // the number of keys inserted.
+        static constexpr size_t header_bytes = 24;
+
+        // How many keys the batch functions hash and prefetch at once.
+        static constexpr size_t batch = 16;
+
+        BloomFilterBase(size_t bitCount, unsigned int hashes, uint32_t magic)
+        :bits(bitCount), hashes(hashes), inserted(0), magic(magic), hasher()
+        {}
+
+        /** Read a serialized filter.
+          * \param the buffer
+          * \param the size of the buffer in bytes
+          * \param the magic number of the filter type
+          * \param the number of bits must be a multiple of this
+          * \param the most hashes the filter type allows
+          * \throws std::invalid_argument if the buffer is not a valid filter */
+        BloomFilterBase(const unsigned char* data, size_t bytes, uint32_t magic,
+                        uint64_t granularity, unsigned int maxHashes)
+        :bits(), hashes(0), inserted(0), magic(magic), hasher()
+        {
+            if(bytes < header_bytes || get32(data) != magic)
+            {
+                throw std::invalid_argument("BloomFilter: not a serialized filter");
+            }
+            hashes = get32(data + 4);
+            uint64_t bitCount = get64(data + 8);
+            if(hashes == 0 || hashes > maxHashes || bitCount == 0 || bitCount % granularity != 0)
+            {
+                throw std::invalid_argument("BloomFilter: damaged header");
+            }
+            uint64_t words = (bitCount + 63) / 64;
+            if(words != (bytes - header_bytes) / 8 || (bytes - header_bytes) % 8 != 0)
+            {
+                throw std::invalid_argument("BloomFilter: buffer is the wrong size");
+            }
+            // Keep the bits past the end clear, as FlexBitset requires.
+            uint64_t last = get64(data + header_bytes + (words - 1) * 8);
+            if(bitCount % 64 != 0 && (last >> (bitCount % 64)) != 0)
+            {
+                throw std::invalid_argument("BloomFilter: bits set past the end");
+            }
+            bits.resize(static_cast<size_t>(bitCount));
+            inserted = static_cast<size_t>(get64(data + 16));
+            uint64_t* to = bits.data();
+            for(size_t i = 0; i < words; ++i)
+            {
+                to[i] = get64(data + header_bytes + i * 8);
+            }
+        }
+
+        /** Hash a key twice, for double hashing.
+          * \param the key
+          * \param the first hash
+          * \param the second hash, which is always odd */
+        template<typename K>
+        void hash_pair(const K& key, uint64_t& h1, uint64_t& h2) const
+        {
+            h1 = static_cast<uint64_t>(hasher(key));
+            h2 = static_cast<uint64_t>(FlexHash::mix(h1 ^ 0x9E3779B97F4A7C15ULL)) | 1;
+        }
+
+        /** \return a hash mapped fairly onto [0, range), without division */
+        static uint64_t reduce(uint64_t hash, uint64_t range)
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ typedef unsigned __int128 wide_t;
+            return static_cast<uint64_t>((static_cast<wide_t>(hash) * range) >> 64);
+#else
+            return hash % range;
+#endif
+        }
+
+        static void prefetch(const void* address, bool write)
+        {
+            if(write)
+            {
+                __builtin_prefetch(address, 1);
+            }
+            else
+            {
+                __builtin_prefetch(address, 0);
+            }
+        }
+
+        /** \throws std::invalid_argument if the rate is not between 0 and 1 */
+        static void check_rate(double fpr)
+        {
+            if(!(fpr > 0.0 && fpr < 1.0))
+            {
+                throw std::invalid_argument("BloomFilter: false-positive rate must be between 0 and 1");
+            }
+        }
+
+        /** \return the bits a classic Bloom filter needs for the given number
+          * of keys and false-positive rate, which is n ln(1/p) / (ln 2)^2 */
+        static double classic_bits(size_t capacity, double fpr)
+        {
+            check_rate(fpr);
+            double n = static_cast<double>(capacity > 0 ? capacity : 1);
+            double bitCount = std::ceil(-n * std::log(fpr) / (std::log(2.0) * std::log(2.0)));
+            // Far more than any machine could hold.
+            if(bitCount > 1e18)
+            {
+                throw std::length_error("BloomFilter: too large");
+            }
+            return bitCount;
+        }
+
+        /** \return the number of hashes which minimizes the false-positive
+          * rate of a well-sized filter, which is log2(1/p) */
+        static unsigned int classic_hashes(double fpr, unsigned int maxHashes)
+        {
+            check_rate(fpr);
+            double k = std::round(-std::log2(fpr));
+            if(k < 1.0)
+            {
+                return 1;
+            }
+            return (k > maxHashes) ? maxHashes : static_cast<unsigned int>(k);
+        }
+
+        static void put32(unsigned char* p, uint32_t value)
+        {
+            for(size_t i = 0; i < 4; ++i)
+            {
+                p[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+
+        static void put64(unsigned char* p, uint64_t value)
+        {
+            put32(p, static_cast<uint32_t>(value));
+            put32(p + 4, static_cast<uint32_t>(value >> 32));
+        }
+
+        static uint32_t get32(const unsigned char* p)
+        {
+            return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+        }
+
+        static uint64_t get64(const unsigned char* p)
+        {
+            return uint64_t(get32(p)) | (uint64_t(get32(p + 4)) << 32);
+        }
+
+        FlexBitset bits;
+        unsigned int hashes;
+        size_t inserted;
+        uint32_t magic;
+        hash_t hasher;
+};
+
+/** A classic Bloom filter: a set of keys which answers "definitely not
+  * present" or "probably present", in a fixed number of bits.
+  *
+  * Each key sets k bits, at h1 + i * h2 for i from 0 to k - 1, mapped onto
+  * the filter. Those bits are anywhere in the filter, so a lookup in a large
+  * filter may miss the cache up to k times; BlockedBloomFilter avoids that. */
+template<typename hash_t = FlexHash>
+class BloomFilter : public BloomFilterBase<hash_t>
+{
+    using Base = BloomFilterBase<hash_t>;
+
+    public:
+        /** Size a filter for a number of keys and a false-positive rate.
+          * \param the number of keys expected
+          * \param the false-positive rate wanted at that many keys, between
+          * 0 and 1, exclusive
+          * \throws std::invalid_argument if the rate is out of range */
+        BloomFilter(size_t capacity, double fpr)
+        :Base(static_cast<size_t>(Base::classic_bits(capacity, fpr)),
+              Base::classic_hashes(fpr, max_hashes), magic_number)
+        {}
+
+        /** Read a filter written by serialize().
+          * \param the buffer
+          * \param the size of the buffer in bytes
+          * \throws std::invalid_argument if the buffer is not a valid filter */
+        BloomFilter(const unsigned char* data, size_t bytes)
+        :Base(data, bytes, magic_number, 1, max_hashes)
+        {}
+
+        /** Add a key. */
+        template<typename K>
+        void insert(const K& key)
+        {
+            uint64_t h1, h2;
+            this->hash_pair(key, h1, h2);
+            set_bits(h1, h2);
+            ++this->inserted;
+        }
+
+        /** \return false if the key was never inserted, or true if it
+          * probably was */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            uint64_t h1, h2;
+            this->hash_pair(key, h1, h2);
+            return test_bits(h1, h2);
+        }
+
+        /** Add an array of keys, prefetching the bits of several keys
+          * before setting any of them. */
+        template<typename K>
+        void insert_many(const K* keys, size_t count)
+        {
+            uint64_t h1[Base::batch];
+            uint64_t h2[Base::batch];
+            for(size_t start = 0; start < count; start += Base::batch)
+            {
+                size_t n = (count - start < Base::batch) ? count - start : Base::batch;
+                hash_batch(keys + start, n, h1, h2, true);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    set_bits(h1[i], h2[i]);
+                }
+            }
+            this->inserted += count;
+        }
+
+        /** Look up an array of keys, prefetching the bits of several keys
+          * before testing any of them.
+          * \param the keys
+          * \param the number of keys
+          * \param where to store the result of contains() for each key
+          * \return the number of keys which were probably present */
+        template<typename K>
+        size_t contains_many(const K* keys, size_t count, bool* results) const
+        {
+            uint64_t h1[Base::batch];
+            uint64_t h2[Base::batch];
+            size_t found = 0;
+            for(size_t start = 0; start < count; start += Base::batch)
+            {
+                size_t n = (count - start < Base::batch) ? count - start : Base::batch;
+                hash_batch(keys + start, n, h1, h2, false);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    results[start + i] = test_bits(h1[i], h2[i]);
+                    found += results[start + i] ? 1 : 0;
+                }
+            }
+            return found;
+        }
+
+    private:
+        static constexpr uint32_t magic_number = 0x31464250;  // "PBF1"
+        static constexpr unsigned int max_hashes = 32;
+
+        void set_bits(uint64_t h1, uint64_t h2)
+        {
+            uint64_t* words = this->bits.data();
+            uint64_t range = this->bits.size();
+            for(unsigned int i = 0; i < this->hashes; ++i)
+            {
+                uint64_t bit = Base::reduce(h1, range);
+                words[bit >> 6] |= uint64_t(1) << (bit & 63);
+                h1 += h2;
+            }
+        }
+
+        bool test_bits(uint64_t h1, uint64_t h2) const
+        {
+            const uint64_t* words = this->bits.data();
+            uint64_t range = this->bits.size();
+            for(unsigned int i = 0; i < this->hashes; ++i)
+            {
+                uint64_t bit = Base::reduce(h1, range);
+                if(((words[bit >> 6] >> (bit & 63)) & 1) == 0)
+                {
+                    return false;
+                }
+                h1 += h2;
+            }
+            return true;
+        }
+
+        /** Hash a batch of keys, and prefetch the words they touch. A lookup
+          * of a missing key usually stops within two bits, so only those are
+          * prefetched for reading; prefetching the rest costs more than it
+          * saves. */
+        template<typename K>
+        void hash_batch(const K* keys, size_t n, uint64_t* h1, uint64_t* h2, bool write) const
+        {
+            const uint64_t* words = this->bits.data();
+            uint64_t range = this->bits.size();
+            unsigned int probes = (write || this->hashes < 2) ? this->hashes : 2;
+            for(size_t i = 0; i < n; ++i)
+            {
+                this->hash_pair(keys[i], h1[i], h2[i]);
+                uint64_t probe = h1[i];
+                for(unsigned int j = 0; j < probes; ++j)
+                {
+                    Base::prefetch(words + (Base::reduce(probe, range) >> 6), write);
+                    probe += h2[i];
+                }
+            }
+        }
+};
+
+/** A blocked Bloom filter, which keeps all the bits of a key within one
+  * 512-bit block, aligned to a 64-byte cache line, so that any lookup
+  * touches exactly one cache line.
+  *
+  * The first hash picks the block, and the second sets k bits within it.
+  * Some blocks fill up more than others, so a blocked filter needs somewhat
+  * more bits than a classic one for the same false-positive rate; it is
+  * sized for that. */
+template<typename hash_t = FlexHash>
+class BlockedBloomFilter : public BloomFilterBase<hash_t>
+{
+    using Base = BloomFilterBase<hash_t>;
+
+    public:
+        /** Size a filter for a number of keys and a false-positive rate.
+          * \param the number of keys expected
+          * \param the false-positive rate wanted at that many keys, between
+          * 0 and 1, exclusive
+          * \throws std::invalid_argument if the rate is out of range */
+        BlockedBloomFilter(size_t capacity, double fpr)
+        :Base(blocked_bits(capacity, fpr), Base::classic_hashes(fpr, max_hashes), magic_number)
+        {}
+
+        /** Read a filter written by serialize().
+          * \param the buffer
+          * \param the size of the buffer in bytes
+          * \throws std::invalid_argument if the buffer is not a valid filter */
+        BlockedBloomFilter(const unsigned char* data, size_t bytes)
+        :Base(data, bytes, magic_number, block_bits, max_hashes)
+        {}
+
+        /** Add a key. */
+        template<typename K>
+        void insert(const K& key)
+        {
+            uint64_t h1, h2;
+            this->hash_pair(key, h1, h2);
+            set_block(h1, h2);
+            ++this->inserted;
+        }
+
+        /** \return false if the key was never inserted, or true if it
+          * probably was */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            uint64_t h1, h2;
+            this->hash_pair(key, h1, h2);
+            return test_block(h1, h2);
+        }
+
+        /** Add an array of keys, prefetching the blocks of several keys
+          * before setting any of them. */
+        template<typename K>
+        void insert_many(const K* keys, size_t count)
+        {
+            uint64_t h1[Base::batch];
+            uint64_t h2[Base::batch];
+            for(size_t start = 0; start < count; start += Base::batch)
+            {
+                size_t n = (count - start < Base::batch) ? count - start : Base::batch;
+                hash_batch(keys + start, n, h1, h2, true);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    set_block(h1[i], h2[i]);
+                }
+            }
+            this->inserted += count;
+        }
+
+        /** Look up an array of keys, prefetching the blocks of several keys
+          * before testing any of them.
+          * \param the keys
+          * \param the number of keys
+          * \param where to store the result of contains() for each key
+          * \return the number of keys which were probably present */
+        template<typename K>
+        size_t contains_many(const K* keys, size_t count, bool* results) const
+        {
+            uint64_t h1[Base::batch];
+            uint64_t h2[Base::batch];
+            size_t found = 0;
+            for(size_t start = 0; start < count; start += Base::batch)
+            {
+                size_t n = (count - start < Base::batch) ? count - start : Base::batch;
+                hash_batch(keys + start, n, h1, h2, false);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    results[start + i] = test_block(h1[i], h2[i]);
+                    found += results[start + i] ? 1 : 0;
+                }
+            }
+            return found;
+        }
+
+    private:
+        static constexpr uint32_t magic_number = 0x31424250;  // "PBB1"
+        static constexpr unsigned int max_hashes = 16;
+        static constexpr size_t block_bits = 512;
+        static constexpr size_t block_words = block_bits / 64;
+
+        /** \return the bits a blocked filter needs for the given number of
+          * keys and false-positive rate, in whole blocks */
+        static size_t blocked_bits(size_t capacity, double fpr)
+        {
+            double n = static_cast<double>(capacity > 0 ? capacity : 1);
+            unsigned int k = Base::classic_hashes(fpr, max_hashes);
+            double blocks = std::ceil(Base::classic_bits(capacity, fpr) / block_bits);
+            // Grow by a sixteenth at a time until the blocks are sparse enough.
+            while(blocked_fpr(blocks, n, k) > fpr)
+            {
+                blocks = std::ceil(blocks * 1.0625);
+            }
+            return static_cast<size_t>(blocks) * block_bits;
+        }
+
+        /** \return the expected false-positive rate of a blocked filter.
+          * The keys per block follow a Poisson distribution, and each block
+          * acts as a small classic filter. */
+        static double blocked_fpr(double blocks, double n, unsigned int k)
+        {
+            double lambda = n / blocks;
+            double spread = 10.0 * std::sqrt(lambda) + 10.0;
+            double first = std::floor(lambda - spread);
+            double rate = 0.0;
+            for(double i = (first > 0.0) ? first : 0.0; i <= lambda + spread; i += 1.0)
+            {
+                double poisson = std::exp(i * std::log(lambda) - lambda - std::lgamma(i + 1.0));
+                double fill = 1.0 - std::pow(1.0 - 1.0 / block_bits, i * k);
+                rate += poisson * std::pow(fill, static_cast<double>(k));
+            }
+            return rate;
+        }
+
+        /** \return the index within its block of the i-th bit of a key.
+          * Each bit multiplies the seed by a different odd constant, and
+          * takes the top nine bits of the product, which pick one of 512. */
+        static unsigned int block_bit(uint32_t seed, unsigned int i)
+        {
+            static const uint32_t salts[max_hashes] = {
+                0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+                0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU,
+                0x165667b1U, 0xd3a2646dU, 0xfd7046c5U, 0xb55a4f09U};
+            return (seed * salts[i]) >> 23;
+        }
+
+        size_t block_of(uint64_t h1) const
+        {
+            return static_cast<size_t>(Base::reduce(h1, this->bits.size() / block_bits));
+        }
+
+        void set_block(uint64_t h1, uint64_t h2)
+        {
+            uint64_t* block = this->bits.data() + block_of(h1) * block_words;
+            uint32_t seed = static_cast<uint32_t>(h2 >> 32);
+            for(unsigned int i = 0; i < this->hashes; ++i)
+            {
+                unsigned int bit = block_bit(seed, i);
+                block[bit >> 6] |= uint64_t(1) << (bit & 63);
+            }
+        }
+
+        bool test_block(uint64_t h1, uint64_t h2) const
+        {
+            // Every bit is in the same cache line, so after the first, the
+            // rest are cheap; stop at the first clear one.
+            const uint64_t* block = this->bits.data() + block_of(h1) * block_words;
+            uint32_t seed = static_cast<uint32_t>(h2 >> 32);
+            for(unsigned int i = 0; i < this->hashes; ++i)
+            {
+                unsigned int bit = block_bit(seed, i);
+                if(((block[bit >> 6] >> (bit & 63)) & 1) == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /** Hash a batch of keys, and prefetch the block of each. */
+        template<typename K>
+        void hash_batch(const K* keys, size_t n, uint64_t* h1, uint64_t* h2, bool write) const
+        {
+            const uint64_t* words = this->bits.data();
+            for(size_t i = 0; i < n; ++i)
+            {
+                this->hash_pair(keys[i], h1[i], h2[i]);
+                Base::prefetch(words + block_of(h1[i]) * block_words, write);
+            }
+        }
+};
+
+#endif // PAWLIB_BLOOMFILTER_HPP
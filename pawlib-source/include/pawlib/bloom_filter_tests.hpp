@@ -0,0 +1,534 @@
+/** Tests for BloomFilter [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_BLOOMFILTER_TESTS_HPP
+#define PAWLIB_BLOOMFILTER_TESTS_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pawlib/bloom_filter.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/iochannel.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** \return the i-th key which the tests insert */
+inline uint64_t bloom_key(uint64_t i)
+{
+    return i * 2654435761ULL + 17;
+}
+
+/** \return the i-th key which the tests never insert */
+inline uint64_t bloom_absent_key(uint64_t i)
+{
+    return i * 2654435761ULL + 18;
+}
+
+/** \return the number of absent keys a filter reports as present */
+template<typename filter_t>
+uint64_t bloom_false_positives(const filter_t& filter, uint64_t lookups)
+{
+    uint64_t found = 0;
+    for(uint64_t i = 0; i < lookups; ++i)
+    {
+        found += filter.contains(bloom_absent_key(i)) ? 1 : 0;
+    }
+    return found;
+}
+
+// P-tB8401a, P-tB8401b
+template<typename filter_t>
+class TestBloomFilter_InsertContains : public Test
+{
+    public:
+        explicit TestBloomFilter_InsertContains(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Insert & Contains";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert integer and string keys, and ensure every one is found, "
+                   "then clear the filter and ensure none are.";
+        }
+
+        bool run() override
+        {
+            filter_t filter(10000, 0.01);
+            PL_ASSERT_EQUAL(filter.size(), static_cast<size_t>(0));
+            for(uint64_t i = 0; i < 10000; ++i)
+            {
+                filter.insert(bloom_key(i));
+            }
+            PL_ASSERT_EQUAL(filter.size(), static_cast<size_t>(10000));
+            bool all = true;
+            for(uint64_t i = 0; i < 10000; ++i)
+            {
+                all = all && filter.contains(bloom_key(i));
+            }
+            PL_ASSERT_TRUE(all);
+
+            // Strings and c-strings hash alike.
+            filter_t words(100, 0.01);
+            words.insert(std::string("pawlib"));
+            words.insert("goldilocks");
+            PL_ASSERT_TRUE(words.contains("pawlib"));
+            PL_ASSERT_TRUE(words.contains(std::string("goldilocks")));
+
+            filter.clear();
+            PL_ASSERT_EQUAL(filter.size(), static_cast<size_t>(0));
+            bool none = true;
+            for(uint64_t i = 0; i < 10000; ++i)
+            {
+                none = none && !filter.contains(bloom_key(i));
+            }
+            PL_ASSERT_TRUE(none);
+            return true;
+        }
+
+        ~TestBloomFilter_InsertContains(){}
+
+    private:
+        testdoc_t name;
+};
+
+// P-tB8402a, P-tB8402b
+template<typename filter_t>
+class TestBloomFilter_FalsePositives : public Test
+{
+    public:
+        explicit TestBloomFilter_FalsePositives(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": False Positives";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill filters sized for several false-positive rates, and ensure the "
+                   "measured rate of each is close to the one it was sized for.";
+        }
+
+        bool run() override
+        {
+            const double rates[] = {0.1, 0.01, 0.001};
+            for(double rate : rates)
+            {
+                filter_t filter(20000, rate);
+                for(uint64_t i = 0; i < 20000; ++i)
+                {
+                    filter.insert(bloom_key(i));
+                }
+                double measured = static_cast<double>(bloom_false_positives(filter, 200000)) / 200000;
+                PL_ASSERT_LESS(measured, rate * 1.25);
+                PL_ASSERT_GREATER(measured, rate * 0.5);
+                PL_ASSERT_LESS(filter.estimated_fpr(), rate * 1.25);
+            }
+
+            // Overfilling raises the rate.
+            filter_t full(1000, 0.01);
+            for(uint64_t i = 0; i < 10000; ++i)
+            {
+                full.insert(bloom_key(i));
+            }
+            PL_ASSERT_GREATER(bloom_false_positives(full, 10000), static_cast<uint64_t>(1000));
+
+            const double invalid[] = {0.0, 1.0, -0.5, 2.0};
+            for(double rate : invalid)
+            {
+                try
+                {
+                    filter_t bad(100, rate);
+                    return false;
+                }
+                catch(std::invalid_argument&) {}
+            }
+            return true;
+        }
+
+        ~TestBloomFilter_FalsePositives(){}
+
+    private:
+        testdoc_t name;
+};
+
+// P-tB8403a, P-tB8403b
+template<typename filter_t>
+class TestBloomFilter_Batch : public Test
+{
+    public:
+        explicit TestBloomFilter_Batch(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Batch Insert & Contains";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert and look up keys in batches of uneven length, and ensure the "
+                   "results match inserting and looking up one key at a time.";
+        }
+
+        bool run() override
+        {
+            std::vector<uint64_t> keys;
+            for(uint64_t i = 0; i < 5003; ++i)
+            {
+                keys.push_back(bloom_key(i));
+            }
+            filter_t single(5003, 0.02);
+            filter_t batched(5003, 0.02);
+            for(uint64_t key : keys)
+            {
+                single.insert(key);
+            }
+            batched.insert_many(keys.data(), keys.size());
+            PL_ASSERT_EQUAL(batched.size(), single.size());
+
+            std::vector<unsigned char> a(single.serialized_size());
+            std::vector<unsigned char> b(batched.serialized_size());
+            single.serialize(a.data());
+            batched.serialize(b.data());
+            PL_ASSERT_TRUE(a == b);
+
+            // Mix present and absent keys.
+            std::vector<uint64_t> lookups;
+            for(uint64_t i = 0; i < 10007; ++i)
+            {
+                lookups.push_back((i % 2 == 0) ? bloom_key(i / 2) : bloom_absent_key(i));
+            }
+            bool* results = new bool[lookups.size()];
+            size_t found = batched.contains_many(lookups.data(), lookups.size(), results);
+            size_t expected = 0;
+            bool matched = true;
+            for(size_t i = 0; i < lookups.size(); ++i)
+            {
+                matched = matched && (results[i] == batched.contains(lookups[i]));
+                expected += results[i] ? 1 : 0;
+            }
+            delete[] results;
+            PL_ASSERT_TRUE(matched);
+            PL_ASSERT_EQUAL(found, expected);
+            return true;
+        }
+
+        ~TestBloomFilter_Batch(){}
+
+    private:
+        testdoc_t name;
+};
+
+// P-tB8404a, P-tB8404b
+template<typename filter_t, typename other_t>
+class TestBloomFilter_Serialize : public Test
+{
+    public:
+        explicit TestBloomFilter_Serialize(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Serialize";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Serialize a filter, read it back, and ensure it answers the same, "
+                   "then reject damaged buffers and buffers of the other filter type.";
+        }
+
+        bool run() override
+        {
+            filter_t filter(3000, 0.01);
+            for(uint64_t i = 0; i < 3000; ++i)
+            {
+                filter.insert(bloom_key(i));
+            }
+            std::vector<unsigned char> buffer(filter.serialized_size());
+            PL_ASSERT_EQUAL(filter.serialize(buffer.data()), buffer.size());
+
+            filter_t copy(buffer.data(), buffer.size());
+            PL_ASSERT_EQUAL(copy.bit_count(), filter.bit_count());
+            PL_ASSERT_EQUAL(copy.hash_count(), filter.hash_count());
+            PL_ASSERT_EQUAL(copy.size(), filter.size());
+            bool same = true;
+            for(uint64_t i = 0; i < 3000; ++i)
+            {
+                same = same && copy.contains(bloom_key(i));
+                same = same && (copy.contains(bloom_absent_key(i)) == filter.contains(bloom_absent_key(i)));
+            }
+            PL_ASSERT_TRUE(same);
+
+            // Truncating or padding the buffer is caught.
+            const size_t lengths[] = {0, 4, 23, 24, buffer.size() - 8, buffer.size() - 1};
+            for(size_t length : lengths)
+            {
+                try
+                {
+                    filter_t bad(buffer.data(), length);
+                    return false;
+                }
+                catch(std::invalid_argument&) {}
+            }
+            std::vector<unsigned char> padded(buffer);
+            padded.resize(buffer.size() + 8);
+            try
+            {
+                filter_t bad(padded.data(), padded.size());
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+
+            // So is the other filter type.
+            try
+            {
+                other_t bad(buffer.data(), buffer.size());
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+            return true;
+        }
+
+        ~TestBloomFilter_Serialize(){}
+
+    private:
+        testdoc_t name;
+};
+
+// P-tB8405, P-tB8405*
+template<typename filter_t>
+class TestBloomFilter_Lookup : public Test
+{
+    public:
+        explicit TestBloomFilter_Lookup(const testdoc_t& name)
+        :name(name), filter(count, rate), falsePositives(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(lookups) + " absent keys, one at a time, in a " +
+                   name + " of " + stdutils::itos(count) + " keys sized for a 1% false-positive "
+                   "rate, and measure the rate.";
+        }
+
+        bool pre() override
+        {
+            if(filter.size() == 0)
+            {
+                for(uint64_t i = 0; i < count; ++i)
+                {
+                    filter.insert(bloom_key(i));
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            falsePositives = bloom_false_positives(filter, lookups);
+            return true;
+        }
+
+        bool verify() override
+        {
+            return static_cast<double>(falsePositives) < lookups * rate * 1.25;
+        }
+
+        bool post() override
+        {
+            ioc << IOCat::normal << name << ": " << falsePositives << " false positives in "
+                << lookups << " lookups" << IOCtrl::endl;
+            return true;
+        }
+
+        ~TestBloomFilter_Lookup(){}
+
+    private:
+        static constexpr uint64_t count = 4000000;
+        static constexpr uint64_t lookups = 100000;
+        static constexpr double rate = 0.01;
+        testdoc_t name;
+        filter_t filter;
+        uint64_t falsePositives;
+};
+
+/** Looks up keys in a BlockedBloomFilter one at a time, to compare with
+  * contains_many(). */
+class BloomBenchSingle
+{
+    public:
+        explicit BloomBenchSingle(const BlockedBloomFilter<>& filter)
+        :filter(filter)
+        {}
+
+        size_t contains_many(const uint64_t* keys, size_t count, bool* results) const
+        {
+            size_t found = 0;
+            for(size_t i = 0; i < count; ++i)
+            {
+                results[i] = filter.contains(keys[i]);
+                found += results[i] ? 1 : 0;
+            }
+            return found;
+        }
+
+    private:
+        const BlockedBloomFilter<>& filter;
+};
+
+/** Looks up keys in a BlockedBloomFilter with contains_many(). */
+class BloomBenchBatch
+{
+    public:
+        explicit BloomBenchBatch(const BlockedBloomFilter<>& filter)
+        :filter(filter)
+        {}
+
+        size_t contains_many(const uint64_t* keys, size_t count, bool* results) const
+        {
+            return filter.contains_many(keys, count, results);
+        }
+
+    private:
+        const BlockedBloomFilter<>& filter;
+};
+
+// P-tB8406, P-tB8406*
+template<typename lookup_t>
+class TestBloomFilter_BatchLookup : public Test
+{
+    public:
+        explicit TestBloomFilter_BatchLookup(const testdoc_t& name)
+        :name(name), filter(count, 0.01), results(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "BlockedBloomFilter: " + name;
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(lookups) + " keys, half of them present, in a "
+                   "BlockedBloomFilter of " + stdutils::itos(count) + " keys, " + name + ".";
+        }
+
+        bool pre() override
+        {
+            if(filter.size() == 0)
+            {
+                for(uint64_t i = 0; i < count; ++i)
+                {
+                    filter.insert(bloom_key(i));
+                }
+                for(uint64_t i = 0; i < lookups; ++i)
+                {
+                    keys.push_back((i % 2 == 0) ? bloom_key(i * 37 % count) : bloom_absent_key(i));
+                }
+            }
+            if(results == nullptr)
+            {
+                results = new bool[lookups];
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            lookup_t lookup(filter);
+            return lookup.contains_many(keys.data(), keys.size(), results) >= lookups / 2;
+        }
+
+        bool post() override
+        {
+            delete[] results;
+            results = nullptr;
+            return true;
+        }
+
+        ~TestBloomFilter_BatchLookup(){}
+
+    private:
+        static constexpr uint64_t count = 4000000;
+        static constexpr uint64_t lookups = 100000;
+        testdoc_t name;
+        BlockedBloomFilter<> filter;
+        std::vector<uint64_t> keys;
+        bool* results;
+};
+
+class TestSuite_BloomFilter : public TestSuite
+{
+    public:
+        explicit TestSuite_BloomFilter(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: BloomFilter Tests";
+        }
+
+        ~TestSuite_BloomFilter(){}
+};
+
+#endif // PAWLIB_BLOOMFILTER_TESTS_HPP
@@ -0,0 +1,308 @@
+/** ConcurrentMap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An ordered map for many readers and few writers, whose reads take no locks.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_CONCURRENTMAP_HPP
+#define PAWLIB_CONCURRENTMAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "pawlib/persistent_map.hpp"
+
+/** An ordered map which may be read by many threads at once, without locks,
+  * while writers update it. It suits maps which are read constantly and
+  * updated rarely, such as routing tables or configuration.
+  *
+  * The map is published as a PersistentMap version. A writer builds the next
+  * version from the current one, sharing every node it does not change, and
+  * swaps it in atomically, so readers always see a whole version, never a
+  * half-finished update. Writers are serialized by an internal mutex.
+  *
+  * Old versions are reclaimed RCU-style. Readers announce themselves on
+  * one of a set of counter stripes, each on its own cache line, and threads
+  * are spread across the stripes, so readers on different threads never
+  * write to the same line. After publishing, a writer advances the epoch and
+  * waits for the readers of the previous epoch to leave before freeing the
+  * old version. Reads therefore never wait; writes wait for at most one
+  * reader section on each thread.
+  *
+  * A writer must never be called from inside read(), since it would wait
+  * for its own reader to leave.
+  * \param the key type, which must be copyable
+  * \param the value type, which must be copyable */
+template<typename key_t, typename value_t>
+class ConcurrentMap
+{
+    public:
+        typedef PersistentMap<key_t, value_t> snapshot_t;
+
+    private:
+        static const size_t cacheLine = 64;
+        static const size_t stripeCount = 64;
+
+        /* One stripe of reader counters, one counter for each parity of
+         * the epoch, padded to fill a cache line. */
+        struct alignas(cacheLine) Stripe
+        {
+            std::atomic<uint32_t> readers[2];
+        };
+
+        /** \return this thread's stripe, assigned round-robin on first use */
+        static size_t threadStripe()
+        {
+            static std::atomic<size_t> next(0);
+            static thread_local size_t stripe = next.fetch_add(1, std::memory_order_relaxed) % stripeCount;
+            return stripe;
+        }
+
+        /* A reader section. While one exists, the version it loaded will
+         * not be freed. */
+        class ReadSection
+        {
+            public:
+                explicit ReadSection(const ConcurrentMap& map)
+                {
+                    Stripe& stripe = map.stripes[threadStripe()];
+                    while(true)
+                    {
+                        uint64_t epoch = map.epoch.load(std::memory_order_seq_cst);
+                        counter = &(stripe.readers[epoch & 1]);
+                        counter->fetch_add(1, std::memory_order_seq_cst);
+                        // If a writer advanced the epoch before we were
+                        // counted, it may not have seen us; try again on
+                        // the new epoch.
+                        if(map.epoch.load(std::memory_order_seq_cst) == epoch)
+                        {
+                            break;
+                        }
+                        counter->fetch_sub(1, std::memory_order_release);
+                    }
+                    version = map.current.load(std::memory_order_seq_cst);
+                }
+
+                ReadSection(const ReadSection&) = delete;
+                ReadSection& operator=(const ReadSection&) = delete;
+
+                ~ReadSection()
+                {
+                    counter->fetch_sub(1, std::memory_order_release);
+                }
+
+                const snapshot_t* version;
+
+            private:
+                std::atomic<uint32_t>* counter;
+        };
+
+        /** Publish a new version, and free the old one once no reader can
+          * still be using it. The writer mutex must be held. */
+        void publish(snapshot_t* next)
+        {
+            snapshot_t* old = current.exchange(next, std::memory_order_seq_cst);
+            uint64_t previous = epoch.fetch_add(1, std::memory_order_seq_cst);
+            // New readers count themselves under the new parity, and can only
+            // load the new version, so only the previous parity is waited on.
+            for(size_t i = 0; i < stripeCount; ++i)
+            {
+                while(stripes[i].readers[previous & 1].load(std::memory_order_seq_cst) != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            delete old;
+        }
+
+        mutable Stripe stripes[stripeCount];
+        alignas(cacheLine) std::atomic<uint64_t> epoch;
+        std::atomic<snapshot_t*> current;
+        alignas(cacheLine) std::mutex writer;
+
+    public:
+        ConcurrentMap()
+        :epoch(0), current(new snapshot_t())
+        {
+            for(size_t i = 0; i < stripeCount; ++i)
+            {
+                stripes[i].readers[0].store(0, std::memory_order_relaxed);
+                stripes[i].readers[1].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ConcurrentMap(const ConcurrentMap&) = delete;
+        ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+        /** Call the reader with the current version, as a const snapshot_t&,
+          * without taking any lock. The version cannot change or be freed
+          * until the reader returns, so any number of lookups made through
+          * it see the same, consistent map. Nothing found through it may be
+          * kept after the reader returns; use snapshot() for that.
+          * \param the reader, which takes (const snapshot_t&)
+          * \return whatever the reader returns */
+        template<typename Reader>
+        auto read(Reader reader) const -> decltype(reader(std::declval<const snapshot_t&>()))
+        {
+            ReadSection section(*this);
+            return reader(*(section.version));
+        }
+
+        /** \return true if the given key exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            ReadSection section(*this);
+            return section.version->contains(key);
+        }
+
+        /** Copy the value with the given key into returnVal.
+          * \return true if the key exists, else false, leaving returnVal alone */
+        template<typename K>
+        bool retrieve(const K& key, value_t* returnVal) const
+        {
+            ReadSection section(*this);
+            return section.version->retrieve(key, returnVal);
+        }
+
+        /** Call the visitor with each key and value of the current version,
+          * in key order.
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            ReadSection section(*this);
+            section.version->for_each(visitor);
+        }
+
+        /** \return the current version, which may be kept and read for as
+          * long as needed. Unlike the other reads, this writes to a shared
+          * reference count, so prefer read() for frequent lookups. */
+        snapshot_t snapshot() const
+        {
+            ReadSection section(*this);
+            return *(section.version);
+        }
+
+        /** \return the number of elements in the current version */
+        size_t size() const
+        {
+            ReadSection section(*this);
+            return section.version->size();
+        }
+
+        /** \return true if the current version has no elements */
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /** Make several changes as one update. The updater is given the
+          * current version, and returns the next; readers see either all of
+          * its changes or none. If it returns the same version, nothing is
+          * published.
+          * \param the updater, which takes (const snapshot_t&) and returns a snapshot_t */
+        template<typename Updater>
+        void update(Updater updater)
+        {
+            std::lock_guard<std::mutex> lock(writer);
+            const snapshot_t* old = current.load(std::memory_order_relaxed);
+            snapshot_t next = updater(*old);
+            if(!next.shares(*old))
+            {
+                publish(new snapshot_t(std::move(next)));
+            }
+        }
+
+        /** Insert a key and value, unless the key already exists.
+          * \return true if the element was inserted */
+        bool insert(const key_t& key, const value_t& value)
+        {
+            bool inserted = false;
+            update([&](const snapshot_t& map)
+            {
+                snapshot_t next = map.insert(key, value);
+                inserted = next.size() != map.size();
+                return next;
+            });
+            return inserted;
+        }
+
+        /** Insert a key and value, or assign the value if the key exists.
+          * \return true if the element was inserted, false if assigned */
+        bool insert_or_assign(const key_t& key, const value_t& value)
+        {
+            bool inserted = false;
+            update([&](const snapshot_t& map)
+            {
+                snapshot_t next = map.insert_or_assign(key, value);
+                inserted = next.size() != map.size();
+                return next;
+            });
+            return inserted;
+        }
+
+        /** Remove the element with the given key.
+          * \return true if the element existed */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            bool removed = false;
+            update([&](const snapshot_t& map)
+            {
+                snapshot_t next = map.remove(key);
+                removed = next.size() != map.size();
+                return next;
+            });
+            return removed;
+        }
+
+        /** Destroy the map. No thread may be reading it. */
+        ~ConcurrentMap()
+        {
+            delete current.load(std::memory_order_relaxed);
+        }
+};
+
+#endif // PAWLIB_CONCURRENTMAP_HPP
@@ -0,0 +1,423 @@
+/** Tests for ConcurrentMap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_CONCURRENTMAP_TESTS_HPP
+#define PAWLIB_CONCURRENTMAP_TESTS_HPP
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "pawlib/concurrent_map.hpp"
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Check that a ConcurrentMap holds exactly the same elements as a std::map.
+  * \param the concurrent map
+  * \param the model
+  * \return true if they match */
+template<typename key_t, typename value_t>
+bool concurrent_matches(const ConcurrentMap<key_t, value_t>& map, const std::map<key_t, value_t>& model)
+{
+    return map.read([&model](const PersistentMap<key_t, value_t>& version)
+    {
+        if(version.size() != model.size())
+        {
+            return false;
+        }
+        auto expected = model.begin();
+        bool matches = true;
+        version.for_each([&](const key_t& key, const value_t& value)
+        {
+            if(expected == model.end() || !(key == expected->first) || !(value == expected->second))
+            {
+                matches = false;
+                return;
+            }
+            ++expected;
+        });
+        return matches && expected == model.end();
+    });
+}
+
+// P-tB7401
+class TestConcurrentMap_InsertFind : public Test
+{
+    public:
+        TestConcurrentMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "ConcurrentMap: Insert, Find & Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Make " + stdutils::itos(count) + " random changes on one thread, and ensure each key is found.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(7401);
+            std::map<int, int> model;
+            ConcurrentMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = static_cast<int>(rng() % (count / 2));
+                switch(i % 3)
+                {
+                    case 0:
+                        PL_ASSERT_EQUAL(map.insert(key, i), model.emplace(key, i).second);
+                        break;
+                    case 1:
+                    {
+                        bool inserted = model.find(key) == model.end();
+                        model[key] = i;
+                        PL_ASSERT_EQUAL(map.insert_or_assign(key, i), inserted);
+                        break;
+                    }
+                    default:
+                        PL_ASSERT_EQUAL(map.remove(key), model.erase(key) == 1);
+                        break;
+                }
+            }
+            PL_ASSERT_TRUE(concurrent_matches(map, model));
+            PL_ASSERT_EQUAL(map.size(), model.size());
+
+            for(int key = 0; key < count / 2; ++key)
+            {
+                auto it = model.find(key);
+                int value = -1;
+                PL_ASSERT_EQUAL(map.retrieve(key, &value), it != model.end());
+                PL_ASSERT_EQUAL(map.contains(key), it != model.end());
+                if(it != model.end())
+                {
+                    PL_ASSERT_EQUAL(value, it->second);
+                }
+            }
+            return true;
+        }
+
+        ~TestConcurrentMap_InsertFind(){}
+
+    private:
+        static const int count = 2000;
+};
+
+// P-tB7402
+class TestConcurrentMap_Snapshot : public Test
+{
+    public:
+        TestConcurrentMap_Snapshot(){}
+
+        testdoc_t get_title() override
+        {
+            return "ConcurrentMap: Update & Snapshot";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Make several changes in one update, and ensure an earlier snapshot is unchanged.";
+        }
+
+        bool run() override
+        {
+            ConcurrentMap<onestring, int> map;
+            map.insert("one", 1);
+            map.insert("two", 2);
+            PersistentMap<onestring, int> before = map.snapshot();
+
+            map.update([](const PersistentMap<onestring, int>& version)
+            {
+                return version.insert_or_assign("one", 10).insert("six", 6).remove("two");
+            });
+
+            PL_ASSERT_EQUAL(before.size(), 2u);
+            PL_ASSERT_EQUAL(*before.find("one"), 1);
+            PL_ASSERT_TRUE(before.contains("two"));
+
+            PL_ASSERT_EQUAL(map.size(), 2u);
+            int value = 0;
+            PL_ASSERT_TRUE(map.retrieve("one", &value));
+            PL_ASSERT_EQUAL(value, 10);
+            PL_ASSERT_TRUE(map.contains("six"));
+            PL_ASSERT_FALSE(map.contains("two"));
+
+            // An update which changes nothing publishes nothing.
+            PersistentMap<onestring, int> after = map.snapshot();
+            map.update([](const PersistentMap<onestring, int>& version)
+            {
+                return version.remove("ten");
+            });
+            PersistentMap<onestring, int> same = map.snapshot();
+            PL_ASSERT_TRUE(same.shares(after));
+            return true;
+        }
+
+        ~TestConcurrentMap_Snapshot(){}
+};
+
+// P-tB7403
+class TestConcurrentMap_Readers : public Test
+{
+    public:
+        TestConcurrentMap_Readers(){}
+
+        testdoc_t get_title() override
+        {
+            return "ConcurrentMap: Readers During Updates";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Read from " + stdutils::itos(readers) + " threads while " + stdutils::itos(updates) +
+                   " updates each rewrite every key, and ensure no reader sees a partial update.";
+        }
+
+        bool run() override
+        {
+            ConcurrentMap<int, int> map;
+            map.update([](const PersistentMap<int, int>& version)
+            {
+                PersistentMap<int, int> next = version;
+                for(int key = 0; key < keys; ++key)
+                {
+                    next = next.insert(key, 0);
+                }
+                return next;
+            });
+
+            std::atomic<bool> done(false);
+            std::atomic<int> torn(0);
+            std::vector<std::thread> threads;
+            for(int t = 0; t < readers; ++t)
+            {
+                threads.emplace_back([&map, &done, &torn]()
+                {
+                    int lastGeneration = 0;
+                    while(!done.load())
+                    {
+                        int generation = map.read([](const PersistentMap<int, int>& version)
+                        {
+                            // Every value in one version shares a generation.
+                            int first = *version.find(0);
+                            bool same = version.size() == static_cast<size_t>(keys);
+                            version.for_each([&same, first](const int&, const int& value)
+                            {
+                                same = same && (value == first);
+                            });
+                            return same ? first : -1;
+                        });
+                        // Versions never go backwards for a single reader.
+                        if(generation < lastGeneration)
+                        {
+                            torn.fetch_add(1);
+                        }
+                        lastGeneration = generation;
+                        std::this_thread::yield();
+                    }
+                });
+            }
+
+            for(int generation = 1; generation <= updates; ++generation)
+            {
+                map.update([generation](const PersistentMap<int, int>& version)
+                {
+                    PersistentMap<int, int> next = version;
+                    for(int key = 0; key < keys; ++key)
+                    {
+                        next = next.insert_or_assign(key, generation);
+                    }
+                    return next;
+                });
+                std::this_thread::yield();
+            }
+            done.store(true);
+            for(auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            PL_ASSERT_EQUAL(torn.load(), 0);
+            int last = 0;
+            PL_ASSERT_TRUE(map.retrieve(keys - 1, &last));
+            PL_ASSERT_EQUAL(last, updates);
+            return true;
+        }
+
+        ~TestConcurrentMap_Readers(){}
+
+    private:
+        static const int keys = 64;
+        static const int readers = 4;
+        static const int updates = 200;
+};
+
+/** A Map behind a reader-writer lock, with the same insert(key, value) and
+  * contains() as ConcurrentMap. */
+class SharedMutexMap
+{
+    public:
+        bool insert(int key, int value)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            return map.insert(key, value);
+        }
+
+        bool insert_or_assign(int key, int value)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            return map.insert_or_assign(key, value).second;
+        }
+
+        bool contains(int key) const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return map.contains(key);
+        }
+
+        bool empty() const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return map.empty();
+        }
+
+    private:
+        mutable std::shared_mutex mutex;
+        Map<int, int> map;
+};
+
+// P-tB7404 to P-tB7407, and each counterpart
+template<typename map_t>
+class TestConcurrentMap_ReadScaling : public Test
+{
+    public:
+        TestConcurrentMap_ReadScaling(const testdoc_t& name, int readers)
+        :name(name), readers(readers)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Reads on " + stdutils::itos(readers) + " Threads";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(lookups) + " keys on each of " + stdutils::itos(readers) +
+                   " threads in a " + name + " of " + stdutils::itos(count) + " elements, while " +
+                   stdutils::itos(updates) + " updates are made.";
+        }
+
+        bool pre() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map.insert(((i * 7919) % count) * 2, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::atomic<int> found(0);
+            std::vector<std::thread> threads;
+            for(int t = 0; t < readers; ++t)
+            {
+                threads.emplace_back([this, t, &found]()
+                {
+                    int hits = 0;
+                    for(int i = 0; i < lookups; ++i)
+                    {
+                        hits += static_cast<int>(map.contains(((i + t) * 7) % (count * 2)));
+                    }
+                    found.fetch_add(hits);
+                });
+            }
+            for(int i = 0; i < updates; ++i)
+            {
+                map.insert_or_assign((i * 2) % (count * 2), i);
+                std::this_thread::yield();
+            }
+            for(auto& thread : threads)
+            {
+                thread.join();
+            }
+            return found.load() > 0;
+        }
+
+        ~TestConcurrentMap_ReadScaling(){}
+
+    private:
+        static const int count = 4096;
+        static const int lookups = 100000;
+        static const int updates = 4;
+        testdoc_t name;
+        int readers;
+        map_t map;
+};
+
+class TestSuite_ConcurrentMap : public TestSuite
+{
+    public:
+        explicit TestSuite_ConcurrentMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: ConcurrentMap Tests";
+        }
+
+        ~TestSuite_ConcurrentMap(){}
+};
+
+#endif // PAWLIB_CONCURRENTMAP_TESTS_HPP
@@ -65,30 +65,30 @@ class uncertainty
     public:
         /** Construct an uncertainty.
          * \param the initial value (default true) */
-        explicit uncertainty(bool u=true) noexcept
+        constexpr explicit uncertainty(bool u=true) noexcept
         :data(u)
         {}
 
         /** Returns TRUE if the certainty is MAYBE. */
-        friend bool operator~(const uncertainty&) noexcept;
+        friend constexpr bool operator~(const uncertainty&) noexcept;
 
-        friend bool operator==(const uncertainty&, const uncertainty&) noexcept;
-        friend bool operator!=(const uncertainty&, const uncertainty&) noexcept;
+        friend constexpr bool operator==(const uncertainty&, const uncertainty&) noexcept;
+        friend constexpr bool operator!=(const uncertainty&, const uncertainty&) noexcept;
 
-        friend bool operator==(const uncertainty&, const bool&) noexcept;
-        friend bool operator!=(const uncertainty&, const bool&) noexcept;
+        friend constexpr bool operator==(const uncertainty&, const bool&) noexcept;
+        friend constexpr bool operator!=(const uncertainty&, const bool&) noexcept;
 
-        friend bool operator==(const bool&, const uncertainty&) noexcept;
-        friend bool operator!=(const bool&, const uncertainty&) noexcept;
+        friend constexpr bool operator==(const bool&, const uncertainty&) noexcept;
+        friend constexpr bool operator!=(const bool&, const uncertainty&) noexcept;
 
         /* We see these again in the `tril` class. We're repeating the
             * declaration here to ensure these functions are friends of
             * BOTH classes. */
-        friend bool operator==(const tril&, const uncertainty&) noexcept;
-        friend bool operator!=(const tril&, const uncertainty&) noexcept;
+        friend constexpr bool operator==(const tril&, const uncertainty&) noexcept;
+        friend constexpr bool operator!=(const tril&, const uncertainty&) noexcept;
 
-        friend bool operator==(const uncertainty&, const tril&) noexcept;
-        friend bool operator!=(const uncertainty&, const tril&) noexcept;
+        friend constexpr bool operator==(const uncertainty&, const tril&) noexcept;
+        friend constexpr bool operator!=(const uncertainty&, const tril&) noexcept;
 
         friend std::ostream& operator<<(std::ostream&, const uncertainty&);
 
@@ -114,33 +114,33 @@ class tril
 
         /** Set the B (boolean) bit.
          * \param the new value for the boolean bit. */
-        void set_b(bool) noexcept;
+        constexpr void set_b(bool) noexcept;
 
         /** Set the U (uncertainty) bit.
          * \param the new value for the uncertainty bit. */
-        void set_u(bool) noexcept;
+        constexpr void set_u(bool) noexcept;
 
     public:
         /** Construct a new trilean with a default value of certain false. */
-        tril() noexcept
+        constexpr tril() noexcept
         :data(0)
         {}
 
         /** Construct a new trilean with the specified flag values.
          * \param the boolean bit (true/false)
          * \param the uncertainty bit */
-        tril(bool, bool=false) noexcept;
+        constexpr tril(bool, bool=false) noexcept;
 
         /** Trilean copy constructor.
          * \param the trilean to copy */
-        tril(const tril& in) noexcept
+        constexpr tril(const tril& in) noexcept
         :data(in.data)
         {}
 
         /** Construct a new trilean with an uncertainty variable.
          * \param the uncertainty to copy */
         // cppcheck-suppress noExplicitConstructor
-        tril(const uncertainty& in) noexcept
+        constexpr tril(const uncertainty& in) noexcept
         :data(0)
         {
             set_u(in.data);
@@ -149,36 +149,36 @@ class tril
         /** Return last certain state of the trilean. Does not modify
              * the trilean itself.
              * \return the last certain state */
-        bool certain() const noexcept;
+        constexpr bool certain() const noexcept;
 
         /** Boolean cast, following the Safe Bool Idiom.
              * Returns TRUE if the trilean is CERTAIN TRUE. */
-        operator bool_type() const noexcept;
+        constexpr operator bool_type() const noexcept;
 
         /** Returns TRUE if the trilean is CERTAIN FALSE. */
-        friend bool operator!(const tril&) noexcept;
+        friend constexpr bool operator!(const tril&) noexcept;
         /** Returns TRUE if the trilean is MAYBE. */
-        friend bool operator~(const tril&) noexcept;
+        friend constexpr bool operator~(const tril&) noexcept;
 
         /** Assign a boolean (true/false) to this trilean. */
-        tril& operator=(const bool&) noexcept;
+        constexpr tril& operator=(const bool&) noexcept;
         /** Assign a trilean (true/false/maybe) to this trilean. */
-        tril& operator=(const tril&) noexcept;
+        constexpr tril& operator=(const tril&) noexcept;
         /** Assign an uncertainty to this trilean, only modifying the
          * uncertainty bit without modifying the boolean bit. */
-        tril& operator=(const uncertainty&) noexcept;
+        constexpr tril& operator=(const uncertainty&) noexcept;
 
         /* Valid comparisons. All unspecified comparisons trigger compiler
             * errors, thanks to the Safe Bool Idiom. */
-        friend bool operator==(const tril&, const bool&) noexcept;
-        friend bool operator==(const bool&, const tril&) noexcept;
-        friend bool operator==(const tril&, const tril&) noexcept;
-        friend bool operator==(const tril&, const uncertainty&) noexcept;
+        friend constexpr bool operator==(const tril&, const bool&) noexcept;
+        friend constexpr bool operator==(const bool&, const tril&) noexcept;
+        friend constexpr bool operator==(const tril&, const tril&) noexcept;
+        friend constexpr bool operator==(const tril&, const uncertainty&) noexcept;
 
-        friend bool operator!=(const tril&, const bool&) noexcept;
-        friend bool operator!=(const bool&, const tril&) noexcept;
-        friend bool operator!=(const tril&, const tril&) noexcept;
-        friend bool operator!=(const tril&, const uncertainty&) noexcept;
+        friend constexpr bool operator!=(const tril&, const bool&) noexcept;
+        friend constexpr bool operator!=(const bool&, const tril&) noexcept;
+        friend constexpr bool operator!=(const tril&, const tril&) noexcept;
+        friend constexpr bool operator!=(const tril&, const uncertainty&) noexcept;
 
         friend std::ostream& operator<<(std::ostream&, const tril&);
 
@@ -186,6 +186,255 @@ class tril
 };
 
 // We offer this constant to go alongside "true" and "false".
-const uncertainty maybe = uncertainty();
+constexpr uncertainty maybe = uncertainty();
+
+/* The operators are constexpr, so that expressions of constant trileans
+    * are folded at compile time. */
+
+// UNCERTAINTY
+
+constexpr bool operator~(const uncertainty& rhs) noexcept
+{
+    // Return the certainty of rhs.
+    return (rhs.data);
+}
+
+constexpr bool operator==(const uncertainty& lhs, const uncertainty& rhs) noexcept
+{
+    return (lhs.data == rhs.data);
+}
+
+constexpr bool operator!=(const uncertainty& lhs, const uncertainty& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+constexpr bool operator==(const uncertainty&, const bool&) noexcept
+{
+    return false;
+}
+
+constexpr bool operator!=(const uncertainty&, const bool&) noexcept
+{
+    return false;
+}
+
+constexpr bool operator==(const bool& lhs, const uncertainty& rhs) noexcept
+{
+    return (rhs == lhs);
+}
+
+constexpr bool operator!=(const bool& lhs, const uncertainty& rhs) noexcept
+{
+    return !(rhs == lhs);
+}
+
+constexpr bool operator==(const uncertainty& lhs, const tril& rhs) noexcept
+{
+    return (rhs == lhs);
+}
+
+constexpr bool operator!=(const uncertainty& lhs, const tril& rhs) noexcept
+{
+    return (rhs != lhs);
+}
+
+// TRIL
+
+constexpr tril::tril(bool in_b, bool in_u) noexcept
+:data(0)
+{
+    set_b(in_b);
+    set_u(in_u);
+}
+
+constexpr void tril::set_b(bool b) noexcept
+{
+    data = (b ? (data | B) : (data & ~B));
+}
+
+constexpr void tril::set_u(bool u) noexcept
+{
+    data = (u ? (data | U) : (data & ~U));
+}
+
+constexpr tril::operator bool_type() const noexcept
+{
+    if(~(*this))
+    {
+        return 0;
+    }
+    else
+    {
+        return (!!(*this)) ?
+            &tril::this_type_does_not_support_some_comparisons : 0;
+    }
+}
+
+constexpr bool operator!(const tril& rhs) noexcept
+{
+    // Get the boolean bit of rhs.
+    bool b = (rhs.data & tril::B);
+    // Get the uncertainty bit of rhs.
+    bool u = (rhs.data & tril::U);
+
+    /* If uncertain, return false. Otherwise, return inverse (NOT) of
+        * the boolean flag. */
+    return (u ? false : !b);
+}
+
+constexpr bool operator~(const tril& rhs) noexcept
+{
+    // Return just the uncertainty bit of rhs.
+    return (rhs.data & tril::U);
+}
+
+constexpr tril& tril::operator=(const bool& rhs) noexcept
+{
+    set_b(rhs);
+    set_u(false);
+    return *this;
+}
+
+constexpr tril& tril::operator=(const tril& rhs) noexcept
+{
+    // We just copy all the data from one tril to the other.
+    data = rhs.data;
+
+    return *this;
+}
+
+constexpr tril& tril::operator=(const uncertainty& rhs) noexcept
+{
+    /* We only copy the uncertainty state, so as to preserve the
+        * boolean bit and allow reverting with `certain()`. */
+    set_u(rhs.data);
+
+    return *this;
+}
+
+constexpr bool tril::certain() const noexcept
+{
+    // Return the boolean bit, ignoring the uncertainty bit.
+    return (data & tril::B);
+}
+
+constexpr bool operator==(const tril& lhs, const bool& rhs) noexcept
+{
+    // Get the boolean bit of the left side.
+    bool b = (lhs.data & tril::B);
+    // Get the uncertainty bit of the right side.
+    bool u = (lhs.data & tril::U);
+
+    // If uncertain, return FALSE. Else, return whether boolean values match.
+    return (u ? false : rhs == b);
+}
+
+constexpr bool operator==(const bool& lhs, const tril& rhs) noexcept
+{
+    // We'll use operator!=(tril, bool), since the logic is the same.
+    return (rhs == lhs);
+}
+
+constexpr bool operator==(const tril& lhs, const tril& rhs) noexcept
+{
+    // Get the boolean bit of the left side.
+    bool lb = (lhs.data & tril::B);
+    // Get the uncertainty bit of the left side.
+    bool lu = (lhs.data & tril::U);
+
+    // Get the boolean bit of the right side.
+    bool rb = (rhs.data & tril::B);
+    // Get the uncertainty bit of the right side.
+    bool ru = (rhs.data & tril::U);
+
+    /* Return TRUE if both are uncertain
+        * OR if they are both certain and have same boolean value. */
+    return ( (lu && ru) || (!lu && !ru && lb == rb) );
+}
+
+constexpr bool operator==(const tril& lhs, const uncertainty& rhs) noexcept
+{
+    /* When comparing a tril and a pure tril, the boolean bit is irrelevant.
+        * Only the uncertainty flag matters in a pure tril. */
+
+    // Get the uncertainty bit of the left side.
+    bool u = (lhs.data & tril::U);
+
+    // Return TRUE if both certainty flags match.
+    return (u == rhs.data);
+}
+
+constexpr bool operator!=(const tril& lhs, const bool& rhs) noexcept
+{
+    // Get the boolean bit of the left side.
+    bool b = (lhs.data & tril::B);
+    // Get the uncertainty bit of the right side.
+    bool u = (lhs.data & tril::U);
+
+    // If uncertain, return FALSE. Else, return whether boolean values match.
+    return (u ? true : rhs != b);
+}
+
+constexpr bool operator!=(const bool& lhs, const tril& rhs) noexcept
+{
+    // We'll use operator!=(tril, bool), since the logic is the same.
+    return (rhs != lhs);
+}
+
+constexpr bool operator!=(const tril& lhs, const tril& rhs) noexcept
+{
+    // Get the boolean bit of the left side.
+    bool lb = (lhs.data & tril::B);
+    // Get the uncertainty bit of the left side.
+    bool lu = (lhs.data & tril::U);
+
+    // Get the boolean bit of the right side.
+    bool rb = (rhs.data & tril::B);
+
+    // Get the uncertainty bit of the right side.
+    bool ru = (rhs.data & tril::U);
+
+    /* If one (not both) is uncertain
+        * OR if they're both certain and the boolean types don't match. */
+    return ( (lu && !ru) || (!lu && ru) || (!lu && !ru && lb != rb));
+}
+
+constexpr bool operator!=(const tril& lhs, const uncertainty& rhs) noexcept
+{
+    /* When comparing a tril and a pure tril, the boolean bit is irrelevant.
+        * Only the uncertainty flag matters in a pure tril. */
+
+    // Get the uncertainty bit of the left side.
+    bool u = (lhs.data & tril::U);
+
+    // Return FALSE if both certainty flags match.
+    return (u != rhs.data);
+}
+
+// KLEENE LOGIC
+
+/** Kleene AND: certain false if either is certain false, certain true if
+ * both are certain true, and maybe otherwise.
+ * \return the conjunction of the two trileans */
+constexpr tril kleene_and(const tril& lhs, const tril& rhs) noexcept
+{
+    return (!lhs || !rhs) ? tril(false) : ((~lhs || ~rhs) ? tril(maybe) : tril(true));
+}
+
+/** Kleene OR: certain true if either is certain true, certain false if
+ * both are certain false, and maybe otherwise.
+ * \return the disjunction of the two trileans */
+constexpr tril kleene_or(const tril& lhs, const tril& rhs) noexcept
+{
+    return (lhs == true || rhs == true) ? tril(true) : ((~lhs || ~rhs) ? tril(maybe) : tril(false));
+}
+
+/** Kleene NOT: swaps certain true and certain false, and leaves maybe.
+ * \return the negation of the trilean */
+constexpr tril kleene_not(const tril& rhs) noexcept
+{
+    return ~rhs ? tril(maybe) : tril(!rhs);
+}
 
 #endif // PAWLIB_CORETYPES_HPP
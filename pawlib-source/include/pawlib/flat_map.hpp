@@ -0,0 +1,874 @@
+/** FlatMap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An ordered map, stored in sorted contiguous arrays.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLATMAP_HPP
+#define PAWLIB_FLATMAP_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "pawlib/iochannel.hpp"
+#include "pawlib/pawsort.hpp"
+
+/** An ordered map, with the same interface as Map, stored in two sorted
+  * arrays: one of keys, and one of values. Searches are branchless binary
+  * searches over the keys alone, so a search touches as few cache lines as
+  * possible, and the map has no per-element overhead at all.
+  *
+  * Inserting or removing shifts every later element, so FlatMap suits maps
+  * of up to a few thousand elements, or maps which are built once (ideally
+  * with from_sorted() or bulk_insert()) and then mostly read.
+  *
+  * Like Map, lookups take any key type which can be compared with key_t
+  * using operator< in both directions. Pointers to values and iterators are
+  * only valid until the next insertion or removal.
+  * \param the key type
+  * \param the value type */
+template<typename key_t, typename value_t>
+class FlatMap
+{
+    private:
+        key_t* _keys;
+        value_t* _values;
+        size_t _size;
+        size_t _capacity;
+
+        /* The arrays are raw storage, with only the first _size slots live.
+         * These helpers construct, move, and destroy elements in them, using
+         * memmove for types which allow it. */
+
+        template<typename T>
+        static T* allocate(size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        template<typename T>
+        static void deallocate(T* arr)
+        {
+            ::operator delete(arr, std::align_val_t(alignof(T)));
+        }
+
+        /** Move n live elements from src into raw dst, leaving src raw. */
+        template<typename T>
+        static void relocate(T* dst, T* src, size_t n)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                if(n > 0)
+                {
+                    memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                }
+            }
+            else
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    new (dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+        }
+
+        /** Open a raw slot at pos, in an array of count live elements. */
+        template<typename T>
+        static void open_hole(T* arr, size_t count, size_t pos)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                memmove(static_cast<void*>(arr + pos + 1),
+                        static_cast<const void*>(arr + pos), (count - pos) * sizeof(T));
+            }
+            else
+            {
+                if(pos == count)
+                {
+                    return;
+                }
+                new (arr + count) T(std::move(arr[count - 1]));
+                for(size_t i = count - 1; i > pos; --i)
+                {
+                    arr[i] = std::move(arr[i - 1]);
+                }
+                arr[pos].~T();
+            }
+        }
+
+        /** Destroy the element at pos, in an array of count live elements,
+          * and close the gap. */
+        template<typename T>
+        static void erase_at(T* arr, size_t count, size_t pos)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                memmove(static_cast<void*>(arr + pos),
+                        static_cast<const void*>(arr + pos + 1), (count - pos - 1) * sizeof(T));
+            }
+            else
+            {
+                for(size_t i = pos; i + 1 < count; ++i)
+                {
+                    arr[i] = std::move(arr[i + 1]);
+                }
+                arr[count - 1].~T();
+            }
+        }
+
+        template<typename T>
+        static void destroy(T* arr, size_t n)
+        {
+            if constexpr(!std::is_trivially_destructible<T>::value)
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    arr[i].~T();
+                }
+            }
+        }
+
+        /** Move the elements into new arrays with room for the given number. */
+        void reallocate(size_t capacity)
+        {
+            key_t* keys = allocate<key_t>(capacity);
+            value_t* values = allocate<value_t>(capacity);
+            relocate(keys, _keys, _size);
+            relocate(values, _values, _size);
+            deallocate(_keys);
+            deallocate(_values);
+            _keys = keys;
+            _values = values;
+            _capacity = capacity;
+        }
+
+        /** \return the index of the first key not less than the given key
+          * The loop has no data-dependent branch: the comparison only picks
+          * which base to keep, which compiles to a conditional move. */
+        template<typename K>
+        size_t lower(const K& key) const
+        {
+            if(_size == 0)
+            {
+                return 0;
+            }
+            const key_t* base = _keys;
+            size_t n = _size;
+            while(n > 1)
+            {
+                size_t half = n / 2;
+                base = (base[half] < key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<size_t>(base - _keys) + ((*base < key) ? 1 : 0);
+        }
+
+        /** \return the index of the first key greater than the given key */
+        template<typename K>
+        size_t upper(const K& key) const
+        {
+            if(_size == 0)
+            {
+                return 0;
+            }
+            const key_t* base = _keys;
+            size_t n = _size;
+            while(n > 1)
+            {
+                size_t half = n / 2;
+                base = (key < base[half]) ? base : base + half;
+                n -= half;
+            }
+            return static_cast<size_t>(base - _keys) + ((key < *base) ? 0 : 1);
+        }
+
+        /** \return the index of the given key, or _size if there is none */
+        template<typename K>
+        size_t index_of(const K& key) const
+        {
+            size_t pos = lower(key);
+            return (pos < _size && !(key < _keys[pos])) ? pos : _size;
+        }
+
+        /** Insert the key and a value constructed from args, unless the key
+          * exists. The value is never constructed if the key exists.
+          * \return the value with that key, and whether it was inserted */
+        template<typename K, typename... Args>
+        std::pair<value_t*, bool> emplace_key(K&& key, Args&&... args)
+        {
+            size_t pos = lower(key);
+            if(pos < _size && !(key < _keys[pos]))
+            {
+                return std::pair<value_t*, bool>(_values + pos, false);
+            }
+            // Build the element first, since the arguments may refer to
+            // elements which are about to move.
+            key_t new_key(std::forward<K>(key));
+            value_t new_value(std::forward<Args>(args)...);
+            if(_size == _capacity)
+            {
+                reallocate((_capacity == 0) ? 8 : _capacity * 2);
+            }
+            open_hole(_keys, _size, pos);
+            new (_keys + pos) key_t(std::move(new_key));
+            open_hole(_values, _size, pos);
+            new (_values + pos) value_t(std::move(new_value));
+            ++_size;
+            return std::pair<value_t*, bool>(_values + pos, true);
+        }
+
+    public:
+        /** A key and a reference to its value, as returned by iterators. */
+        template<bool is_const>
+        struct basic_entry
+        {
+            const key_t& key;
+            typename std::conditional<is_const, const value_t&, value_t&>::type value;
+        };
+
+        /** A bidirectional iterator over the elements, in key order. */
+        template<bool is_const>
+        class basic_iterator
+        {
+            friend class FlatMap;
+
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef basic_entry<is_const> value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef void pointer;
+                typedef basic_entry<is_const> reference;
+
+                basic_iterator()
+                :keys(nullptr), values(nullptr)
+                {}
+
+                /// Allows converting an iterator to a const_iterator.
+                template<bool other, typename = typename std::enable_if<is_const && !other>::type>
+                // cppcheck-suppress noExplicitConstructor
+                basic_iterator(const basic_iterator<other>& it)
+                :keys(it.keys), values(it.values)
+                {}
+
+                const key_t& key() const
+                {
+                    return *keys;
+                }
+
+                typename std::conditional<is_const, const value_t&, value_t&>::type value() const
+                {
+                    return *values;
+                }
+
+                reference operator*() const
+                {
+                    return reference{key(), value()};
+                }
+
+                basic_iterator& operator++()
+                {
+                    ++keys;
+                    ++values;
+                    return *this;
+                }
+
+                basic_iterator operator++(int)
+                {
+                    basic_iterator old = *this;
+                    ++(*this);
+                    return old;
+                }
+
+                basic_iterator& operator--()
+                {
+                    --keys;
+                    --values;
+                    return *this;
+                }
+
+                basic_iterator operator--(int)
+                {
+                    basic_iterator old = *this;
+                    --(*this);
+                    return old;
+                }
+
+                bool operator==(const basic_iterator& rhs) const
+                {
+                    return keys == rhs.keys;
+                }
+
+                bool operator!=(const basic_iterator& rhs) const
+                {
+                    return keys != rhs.keys;
+                }
+
+            private:
+                typedef typename std::conditional<is_const, const value_t*, value_t*>::type value_ptr;
+
+                basic_iterator(const key_t* at_key, value_ptr at_value)
+                :keys(at_key), values(at_value)
+                {}
+
+                const key_t* keys;
+                value_ptr values;
+
+                template<bool> friend class basic_iterator;
+        };
+
+        typedef basic_iterator<false> iterator;
+        typedef basic_iterator<true> const_iterator;
+
+        FlatMap()
+        :_keys(nullptr), _values(nullptr), _size(0), _capacity(0)
+        {}
+
+        /** Create an empty map with room for the given number of elements. */
+        explicit FlatMap(size_t capacity)
+        :FlatMap()
+        {
+            reserve(capacity);
+        }
+
+        FlatMap(const FlatMap& cpy)
+        :FlatMap()
+        {
+            reserve(cpy._size);
+            for(; _size < cpy._size; ++_size)
+            {
+                new (_keys + _size) key_t(cpy._keys[_size]);
+                try
+                {
+                    new (_values + _size) value_t(cpy._values[_size]);
+                }
+                catch(...)
+                {
+                    _keys[_size].~key_t();
+                    throw;
+                }
+            }
+        }
+
+        FlatMap(FlatMap&& mov)
+        :_keys(mov._keys), _values(mov._values), _size(mov._size), _capacity(mov._capacity)
+        {
+            mov._keys = nullptr;
+            mov._values = nullptr;
+            mov._size = 0;
+            mov._capacity = 0;
+        }
+
+        FlatMap& operator=(const FlatMap& rhs)
+        {
+            if(&rhs != this)
+            {
+                FlatMap copy(rhs);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        FlatMap& operator=(FlatMap&& rhs)
+        {
+            if(&rhs != this)
+            {
+                std::swap(_keys, rhs._keys);
+                std::swap(_values, rhs._values);
+                std::swap(_size, rhs._size);
+                std::swap(_capacity, rhs._capacity);
+            }
+            return *this;
+        }
+
+        /** Build a map from a range of pairs (anything with first and
+          * second), which must be sorted by strictly increasing key.
+          * \throws std::invalid_argument if the keys are not strictly increasing */
+        template<typename ForwardIt>
+        static FlatMap from_sorted(ForwardIt first, ForwardIt last)
+        {
+            FlatMap map(static_cast<size_t>(std::distance(first, last)));
+            for(; first != last; ++first)
+            {
+                key_t* at = map._keys + map._size;
+                new (at) key_t(first->first);
+                if(map._size > 0 && !(at[-1] < at[0]))
+                {
+                    at->~key_t();
+                    throw std::invalid_argument("FlatMap: keys are not in strictly increasing order");
+                }
+                try
+                {
+                    new (map._values + map._size) value_t(first->second);
+                }
+                catch(...)
+                {
+                    at->~key_t();
+                    throw;
+                }
+                ++map._size;
+            }
+            return map;
+        }
+
+        template<typename Range>
+        static FlatMap from_sorted(const Range& range)
+        {
+            return from_sorted(std::begin(range), std::end(range));
+        }
+
+        /** Insert the key and value, unless the key already exists.
+          * \return true if the element was inserted */
+        bool insert(const key_t& key, const value_t& value)
+        {
+            return emplace_key(key, value).second;
+        }
+
+        bool insert(key_t&& key, value_t&& value)
+        {
+            return emplace_key(std::move(key), std::move(value)).second;
+        }
+
+        /** Construct the value from args in place, unless the key already
+          * exists, in which case nothing is constructed or moved from.
+          * \return the value with that key, and whether it was inserted */
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(const key_t& key, Args&&... args)
+        {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(key_t&& key, Args&&... args)
+        {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        /** Insert the key and value, or assign the value if the key exists.
+          * \return the value with that key, and whether it was inserted */
+        template<typename M>
+        std::pair<value_t*, bool> insert_or_assign(const key_t& key, M&& value)
+        {
+            size_t pos = index_of(key);
+            if(pos < _size)
+            {
+                _values[pos] = std::forward<M>(value);
+                return std::pair<value_t*, bool>(_values + pos, false);
+            }
+            return emplace_key(key, std::forward<M>(value));
+        }
+
+        template<typename M>
+        std::pair<value_t*, bool> insert_or_assign(key_t&& key, M&& value)
+        {
+            size_t pos = index_of(key);
+            if(pos < _size)
+            {
+                _values[pos] = std::forward<M>(value);
+                return std::pair<value_t*, bool>(_values + pos, false);
+            }
+            return emplace_key(std::move(key), std::forward<M>(value));
+        }
+
+        /** \return the value with the given key, default-constructing it
+          * first if the key does not exist */
+        value_t& operator[](const key_t& key)
+        {
+            return *(emplace_key(key).first);
+        }
+
+        value_t& operator[](key_t&& key)
+        {
+            return *(emplace_key(std::move(key)).first);
+        }
+
+        /** Insert every pair (anything with first and second) in the range,
+          * in any order, unless its key already exists. The pairs are sorted
+          * and merged with the map in one pass. If the range repeats a key,
+          * the first pair with that key is the one inserted.
+          * \return the number of pairs inserted */
+        template<typename ForwardIt>
+        size_t bulk_insert(ForwardIt first, ForwardIt last)
+        {
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            if(n == 0)
+            {
+                return 0;
+            }
+
+            // Sort the pairs by key, breaking ties by position so the first one wins.
+            struct Entry
+            {
+                ForwardIt it;
+                size_t position;
+            };
+            std::unique_ptr<Entry[]> entries(new Entry[n]);
+            for(size_t i = 0; i < n; ++i, ++first)
+            {
+                entries[i].it = first;
+                entries[i].position = i;
+            }
+            if(n > 1)
+            {
+                pawsort::sort(entries.get(), entries.get() + n,
+                    [](const Entry& lhs, const Entry& rhs)
+                    {
+                        if(lhs.it->first < rhs.it->first) { return true; }
+                        if(rhs.it->first < lhs.it->first) { return false; }
+                        return lhs.position < rhs.position;
+                    });
+            }
+
+            // Drop all but the first pair with each key, and those already in the map.
+            size_t unique = 0;
+            size_t e = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                const auto& key = entries[i].it->first;
+                if(unique > 0 && !(entries[unique - 1].it->first < key))
+                {
+                    continue;
+                }
+                while(e < _size && _keys[e] < key)
+                {
+                    ++e;
+                }
+                if(e < _size && !(key < _keys[e]))
+                {
+                    continue;
+                }
+                entries[unique++] = entries[i];
+            }
+            if(unique == 0)
+            {
+                return 0;
+            }
+
+            // Merge into new arrays. The old elements are only destroyed once
+            // every element is in place, so a throwing constructor loses nothing.
+            size_t total = _size + unique;
+            key_t* keys = allocate<key_t>(total);
+            value_t* values = allocate<value_t>(total);
+            size_t built = 0;
+            try
+            {
+                size_t i = 0;
+                e = 0;
+                for(; built < total; ++built)
+                {
+                    if(e < _size && (i == unique || _keys[e] < entries[i].it->first))
+                    {
+                        new (keys + built) key_t(std::move(_keys[e]));
+                        try
+                        {
+                            new (values + built) value_t(std::move(_values[e]));
+                        }
+                        catch(...)
+                        {
+                            keys[built].~key_t();
+                            throw;
+                        }
+                        ++e;
+                    }
+                    else
+                    {
+                        new (keys + built) key_t(entries[i].it->first);
+                        try
+                        {
+                            new (values + built) value_t(entries[i].it->second);
+                        }
+                        catch(...)
+                        {
+                            keys[built].~key_t();
+                            throw;
+                        }
+                        ++i;
+                    }
+                }
+            }
+            catch(...)
+            {
+                destroy(keys, built);
+                destroy(values, built);
+                deallocate(keys);
+                deallocate(values);
+                throw;
+            }
+
+            destroy(_keys, _size);
+            destroy(_values, _size);
+            deallocate(_keys);
+            deallocate(_values);
+            _keys = keys;
+            _values = values;
+            _size = total;
+            _capacity = total;
+            return unique;
+        }
+
+        template<typename Range>
+        size_t bulk_insert(const Range& range)
+        {
+            return bulk_insert(std::begin(range), std::end(range));
+        }
+
+        /** \return a pointer to the value with the given key, or nullptr
+          * The pointer is valid until the next insertion or removal. */
+        template<typename K>
+        value_t* find(const K& key)
+        {
+            size_t pos = index_of(key);
+            return (pos < _size) ? _values + pos : nullptr;
+        }
+
+        template<typename K>
+        const value_t* find(const K& key) const
+        {
+            size_t pos = index_of(key);
+            return (pos < _size) ? _values + pos : nullptr;
+        }
+
+        /** \return true if the given key exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return index_of(key) < _size;
+        }
+
+        /** Copy the value with the given key into returnVal.
+          * \return true if the key exists, else false, leaving returnVal alone */
+        template<typename K>
+        bool retrieve(const K& key, value_t* returnVal) const
+        {
+            const value_t* value = find(key);
+            if(value != nullptr)
+            {
+                *returnVal = *value;
+                return true;
+            }
+            return false;
+        }
+
+        /** Remove the element with the given key.
+          * \return true if the key existed */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            size_t pos = index_of(key);
+            if(pos == _size)
+            {
+                return false;
+            }
+            erase_at(_keys, _size, pos);
+            erase_at(_values, _size, pos);
+            --_size;
+            return true;
+        }
+
+        iterator begin()
+        {
+            return iterator(_keys, _values);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(_keys, _values);
+        }
+
+        iterator end()
+        {
+            return iterator(_keys + _size, _values + _size);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(_keys + _size, _values + _size);
+        }
+
+        /** \return an iterator to the first element not less than the key */
+        template<typename K>
+        iterator lower_bound(const K& key)
+        {
+            size_t pos = lower(key);
+            return iterator(_keys + pos, _values + pos);
+        }
+
+        template<typename K>
+        const_iterator lower_bound(const K& key) const
+        {
+            size_t pos = lower(key);
+            return const_iterator(_keys + pos, _values + pos);
+        }
+
+        /** \return an iterator to the first element greater than the key */
+        template<typename K>
+        iterator upper_bound(const K& key)
+        {
+            size_t pos = upper(key);
+            return iterator(_keys + pos, _values + pos);
+        }
+
+        template<typename K>
+        const_iterator upper_bound(const K& key) const
+        {
+            size_t pos = upper(key);
+            return const_iterator(_keys + pos, _values + pos);
+        }
+
+        /** \return the range of elements with the given key, which holds at most one */
+        template<typename K>
+        std::pair<iterator, iterator> equal_range(const K& key)
+        {
+            size_t pos = lower(key);
+            size_t end = (pos < _size && !(key < _keys[pos])) ? pos + 1 : pos;
+            return std::pair<iterator, iterator>(iterator(_keys + pos, _values + pos),
+                                                 iterator(_keys + end, _values + end));
+        }
+
+        template<typename K>
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+        {
+            size_t pos = lower(key);
+            size_t end = (pos < _size && !(key < _keys[pos])) ? pos + 1 : pos;
+            return std::pair<const_iterator, const_iterator>(
+                const_iterator(_keys + pos, _values + pos),
+                const_iterator(_keys + end, _values + end));
+        }
+
+        /** Call the visitor with each key and value, in key order.
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            for(size_t i = 0; i < _size; ++i)
+            {
+                visitor(_keys[i], _values[i]);
+            }
+        }
+
+        /** Call the visitor with each key and value in [low, high), in key order.
+          * \param the lowest key to visit
+          * \param the key to stop before
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename K1, typename K2, typename Visitor>
+        void for_each_in_range(const K1& low, const K2& high, Visitor visitor) const
+        {
+            for(size_t i = lower(low); i < _size && _keys[i] < high; ++i)
+            {
+                visitor(_keys[i], _values[i]);
+            }
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return true if there are no elements */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** \return the number of elements there is room for without growing */
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        /** Make room for at least the given number of elements. */
+        void reserve(size_t capacity)
+        {
+            if(capacity > _capacity)
+            {
+                reallocate(capacity);
+            }
+        }
+
+        /** Release any unused capacity. */
+        void compact()
+        {
+            if(_size == 0)
+            {
+                deallocate(_keys);
+                deallocate(_values);
+                _keys = nullptr;
+                _values = nullptr;
+                _capacity = 0;
+            }
+            else if(_size < _capacity)
+            {
+                reallocate(_size);
+            }
+        }
+
+        /** Remove every element, keeping the arrays to be reused. */
+        void clear()
+        {
+            destroy(_keys, _size);
+            destroy(_values, _size);
+            _size = 0;
+        }
+
+        /** Print each key and value, in key order. */
+        void print() const
+        {
+            for_each([](const key_t& key, const value_t& value)
+            {
+                ioc << key << ": " << value << IOCtrl::endl;
+            });
+        }
+
+        ~FlatMap()
+        {
+            clear();
+            deallocate(_keys);
+            deallocate(_values);
+        }
+};
+
+#endif // PAWLIB_FLATMAP_HPP
@@ -0,0 +1,530 @@
+/** Tests for FlatMap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLATMAP_TESTS_HPP
+#define PAWLIB_FLATMAP_TESTS_HPP
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "pawlib/flat_map.hpp"
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Check that a FlatMap holds exactly the same elements as a std::map.
+  * \param the flat map
+  * \param the model
+  * \return true if they match */
+template<typename key_t, typename value_t>
+bool flat_matches(const FlatMap<key_t, value_t>& map, const std::map<key_t, value_t>& model)
+{
+    if(map.size() != model.size())
+    {
+        return false;
+    }
+    auto expected = model.begin();
+    for(auto entry : map)
+    {
+        if(expected == model.end() || !(entry.key == expected->first)
+           || !(entry.value == expected->second))
+        {
+            return false;
+        }
+        ++expected;
+    }
+    return expected == model.end();
+}
+
+// P-tB7201
+class TestFlatMap_InsertFind : public Test
+{
+    public:
+        TestFlatMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Insert & Find";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " random keys, and ensure each is found and the elements come out in order.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(7201);
+            std::map<int, int> model;
+            FlatMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = static_cast<int>(rng() % (count * 4)) - count;
+                bool inserted = model.emplace(key, i).second;
+                PL_ASSERT_EQUAL(map.insert(key, i), inserted);
+            }
+            PL_ASSERT_TRUE(flat_matches(map, model));
+
+            for(int key = -count; key < count * 3; ++key)
+            {
+                auto it = model.find(key);
+                int* value = map.find(key);
+                if(it == model.end())
+                {
+                    PL_ASSERT_TRUE(value == nullptr);
+                    PL_ASSERT_FALSE(map.contains(key));
+                }
+                else
+                {
+                    PL_ASSERT_TRUE(value != nullptr);
+                    PL_ASSERT_EQUAL(*value, it->second);
+                }
+            }
+            return true;
+        }
+
+        ~TestFlatMap_InsertFind(){}
+
+    private:
+        static const int count = 2000;
+};
+
+// P-tB7202
+class TestFlatMap_Remove : public Test
+{
+    public:
+        TestFlatMap_Remove(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Interleave random insertions and removals of onestring values, checking against std::map.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(7202);
+            std::map<int, onestring> model;
+            FlatMap<int, onestring> map;
+            for(int i = 0; i < 5000; ++i)
+            {
+                int key = static_cast<int>(rng() % 1000);
+                if(rng() % 3 == 0)
+                {
+                    PL_ASSERT_EQUAL(map.remove(key), model.erase(key) == 1);
+                }
+                else
+                {
+                    onestring value(stdutils::itos(i));
+                    PL_ASSERT_EQUAL(map.insert(key, value), model.emplace(key, value).second);
+                }
+            }
+            PL_ASSERT_TRUE(flat_matches(map, model));
+
+            map.clear();
+            PL_ASSERT_TRUE(map.empty());
+            PL_ASSERT_FALSE(map.remove(1));
+            PL_ASSERT_TRUE(map.begin() == map.end());
+            return true;
+        }
+
+        ~TestFlatMap_Remove(){}
+};
+
+// P-tB7203
+class TestFlatMap_Range : public Test
+{
+    public:
+        TestFlatMap_Range(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Bounds & Range";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure lower_bound(), upper_bound(), equal_range(), and for_each_in_range() agree with std::map.";
+        }
+
+        bool run() override
+        {
+            std::map<int, int> model;
+            FlatMap<int, int> map;
+            for(int i = 0; i < 500; ++i)
+            {
+                model.emplace(i * 3, i);
+                map.insert(i * 3, i);
+            }
+
+            for(int key = -2; key < 1505; ++key)
+            {
+                auto lower = map.lower_bound(key);
+                auto model_lower = model.lower_bound(key);
+                PL_ASSERT_EQUAL(lower == map.end(), model_lower == model.end());
+                if(model_lower != model.end())
+                {
+                    PL_ASSERT_EQUAL(lower.key(), model_lower->first);
+                }
+
+                auto upper = map.upper_bound(key);
+                auto model_upper = model.upper_bound(key);
+                PL_ASSERT_EQUAL(upper == map.end(), model_upper == model.end());
+                if(model_upper != model.end())
+                {
+                    PL_ASSERT_EQUAL(upper.key(), model_upper->first);
+                }
+
+                auto range = map.equal_range(key);
+                PL_ASSERT_TRUE(range.first == lower);
+                PL_ASSERT_TRUE(range.second == upper);
+            }
+
+            int expected = 102;
+            map.for_each_in_range(100, 200, [&expected](const int& key, const int& value)
+            {
+                if(key == expected && value == key / 3)
+                {
+                    expected += 3;
+                }
+            });
+            PL_ASSERT_EQUAL(expected, 201);
+
+            // Walk backwards from the end.
+            int previous = 1500;
+            size_t visited = 0;
+            for(auto it = map.end(); it != map.begin(); ++visited)
+            {
+                --it;
+                PL_ASSERT_EQUAL(it.key(), previous - 3);
+                previous = it.key();
+            }
+            PL_ASSERT_EQUAL(visited, map.size());
+            return true;
+        }
+
+        ~TestFlatMap_Range(){}
+};
+
+// P-tB7204
+class TestFlatMap_Bulk : public Test
+{
+    public:
+        TestFlatMap_Bulk(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Bulk Building";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure from_sorted() and bulk_insert() build the same map as inserting one at a time.";
+        }
+
+        bool run() override
+        {
+            std::vector<std::pair<int, onestring>> sorted;
+            for(int i = 0; i < 1000; ++i)
+            {
+                sorted.emplace_back(i * 2, onestring(stdutils::itos(i)));
+            }
+            FlatMap<int, onestring> map = FlatMap<int, onestring>::from_sorted(sorted);
+            PL_ASSERT_EQUAL(map.size(), 1000u);
+            PL_ASSERT_EQUAL(*(map.find(500)), "250");
+
+            // Scrambled keys, each twice; only the first of each is new.
+            std::vector<std::pair<int, onestring>> pairs;
+            std::map<int, onestring> model(sorted.begin(), sorted.end());
+            for(int i = 0; i < 6000; ++i)
+            {
+                pairs.emplace_back((i * 7) % 3000, onestring(stdutils::itos(i)));
+            }
+            size_t inserted = 0;
+            for(const auto& pair : pairs)
+            {
+                inserted += model.insert(pair).second ? 1 : 0;
+            }
+            PL_ASSERT_EQUAL(map.bulk_insert(pairs), inserted);
+            PL_ASSERT_TRUE(flat_matches(map, model));
+            PL_ASSERT_EQUAL(map.bulk_insert(pairs), 0u);
+
+            std::swap(sorted[10], sorted[11]);
+            bool threw = false;
+            try
+            {
+                FlatMap<int, onestring>::from_sorted(sorted);
+            }
+            catch(std::invalid_argument&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            return true;
+        }
+
+        ~TestFlatMap_Bulk(){}
+};
+
+// P-tB7205
+class TestFlatMap_Strings : public Test
+{
+    public:
+        TestFlatMap_Strings(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Strings";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a FlatMap of onestring keys can be searched by const char*.";
+        }
+
+        bool run() override
+        {
+            FlatMap<onestring, int> map;
+            for(int i = 0; i < 200; ++i)
+            {
+                map.insert(onestring(stdutils::itos(i)), i);
+            }
+            PL_ASSERT_EQUAL(*(map.find("42")), 42);
+            PL_ASSERT_TRUE(map.contains("199"));
+            PL_ASSERT_FALSE(map.contains("200"));
+            PL_ASSERT_TRUE(map.remove("0"));
+            PL_ASSERT_EQUAL(map.size(), 199u);
+
+            int value = 0;
+            PL_ASSERT_TRUE(map.retrieve("7", &value));
+            PL_ASSERT_EQUAL(value, 7);
+            PL_ASSERT_FALSE(map.retrieve("0", &value));
+            return true;
+        }
+
+        ~TestFlatMap_Strings(){}
+};
+
+// P-tB7206
+class TestFlatMap_Emplace : public Test
+{
+    public:
+        TestFlatMap_Emplace(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlatMap: Emplace & Copy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure try_emplace(), insert_or_assign(), operator[], and copying behave like Map.";
+        }
+
+        bool run() override
+        {
+            FlatMap<int, onestring> map;
+            auto result = map.try_emplace(1, "one");
+            PL_ASSERT_TRUE(result.second);
+            PL_ASSERT_EQUAL(*result.first, "one");
+            result = map.try_emplace(1, "uno");
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_EQUAL(*result.first, "one");
+
+            result = map.insert_or_assign(1, onestring("uno"));
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_EQUAL(*(map.find(1)), "uno");
+            result = map.insert_or_assign(2, onestring("dos"));
+            PL_ASSERT_TRUE(result.second);
+
+            map[3] = "tres";
+            PL_ASSERT_EQUAL(map.size(), 3u);
+            PL_ASSERT_TRUE(map[4].empty());
+
+            FlatMap<int, onestring> copy(map);
+            copy[1] = "changed";
+            copy.remove(2);
+            PL_ASSERT_EQUAL(*(map.find(1)), "uno");
+            PL_ASSERT_TRUE(map.contains(2));
+
+            map = copy;
+            PL_ASSERT_EQUAL(map.size(), 3u);
+            PL_ASSERT_EQUAL(*(map.find(1)), "changed");
+
+            map.reserve(100);
+            PL_ASSERT_EQUAL(map.capacity(), 100u);
+            map.compact();
+            PL_ASSERT_EQUAL(map.capacity(), 3u);
+            return true;
+        }
+
+        ~TestFlatMap_Emplace(){}
+};
+
+/** A std::map with the insert(key, value) and contains() of the PawLIB maps. */
+class FlatBenchStdMap : public std::map<int, int>
+{
+    public:
+        bool insert(int key, int value)
+        {
+            return emplace(key, value).second;
+        }
+
+        bool contains(int key) const
+        {
+            return find(key) != end();
+        }
+};
+
+// P-tB7207 to P-tB7214, and each counterpart
+template<typename map_t>
+class TestFlatMap_Lookup : public Test
+{
+    public:
+        TestFlatMap_Lookup(const testdoc_t& name, int count)
+        :name(name), count(count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Lookup in " + stdutils::itos(count);
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(lookups) + " present and missing keys in a " +
+                   name + " of " + stdutils::itos(count) + " elements.";
+        }
+
+        bool pre() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map.insert(((i * 7919) % count) * 2, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < lookups; ++i)
+            {
+                found += static_cast<int>(map.contains((i * 7) % (count * 2)));
+            }
+            return found > 0;
+        }
+
+        ~TestFlatMap_Lookup(){}
+
+    private:
+        static const int lookups = 100000;
+        testdoc_t name;
+        int count;
+        map_t map;
+};
+
+// P-tB7215, P-tB7215*
+template<typename map_t>
+class TestFlatMap_Insert : public Test
+{
+    public:
+        explicit TestFlatMap_Insert(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " keys into a " + name + ", in scrambled order.";
+        }
+
+        bool run() override
+        {
+            map_t map;
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert((i * 7919) % count, i);
+            }
+            return map.size() == static_cast<size_t>(count);
+        }
+
+        ~TestFlatMap_Insert(){}
+
+    private:
+        static const int count = 4096;
+        testdoc_t name;
+};
+
+class TestSuite_FlatMap : public TestSuite
+{
+    public:
+        explicit TestSuite_FlatMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: FlatMap Tests";
+        }
+
+        ~TestSuite_FlatMap(){}
+};
+
+#endif // PAWLIB_FLATMAP_TESTS_HPP
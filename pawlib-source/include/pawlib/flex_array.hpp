@@ -54,22 +54,31 @@
 #include "pawlib/constants.hpp"
 #include "pawlib/iochannel.hpp"
 
-template <typename type, bool raw_copy = false, bool factor_double = true>
-class FlexArray : public Base_FlexArr<type, raw_copy, factor_double>
+template <typename type, bool raw_copy = false, bool factor_double = true,
+          typename alloc_t = std::allocator<type>>
+class FlexArray : public Base_FlexArr<type, raw_copy, factor_double, alloc_t>
 {
     public:
         /** Create a new FlexArray with the default capacity.
          */
         FlexArray()
-        :Base_FlexArr<type, raw_copy, factor_double>()
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>()
         {}
 
         /** Create a new FlexArray with the specified minimum capacity.
          * \param the minimum number of elements that the FlexArray can contain.
          */
         // cppcheck-suppress noExplicitConstructor
-        FlexArray(size_t numElements)
-        :Base_FlexArr<type, raw_copy, factor_double>(numElements)
+        FlexArray(size_t numElements, const alloc_t& alloc = alloc_t())
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(numElements, alloc)
+        {}
+
+        /** Create a new FlexArray with the default capacity, which allocates
+         * from the given allocator.
+         * \param the allocator to use
+         */
+        explicit FlexArray(const alloc_t& alloc)
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(alloc)
         {}
 
         /** Insert an element into the FlexArray at the given index.
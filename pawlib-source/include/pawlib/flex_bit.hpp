@@ -46,36 +46,82 @@
 #define PAWLIB_FLEXBIT_HPP
 
 #include <bitset>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <string>
 
-#include "pawlib/base_flex_array.hpp"
-#include "pawlib/flex_array.hpp"
 #include "pawlib/iochannel.hpp"
 
 using std::bitset;
 
-/* Must use startIndex to point to the beginning of the FlexBit! */
-
 typedef bitset<8> byte;
+
+/* FlexBit is a queue of bytes in a circular buffer, like Base_FlexArr.
+ * The head wraps around the end of the buffer, so poll() never moves or
+ * reallocates anything. The buffer only grows when it is full, and only
+ * shrinks when shrink() is called. The capacity is always a power of two,
+ * so wrapping is a mask instead of a division. */
 class FlexBit
 {
     public:
 
         //Default constructor.
         FlexBit()
-        :startIndex(0), totalSize(10), size(0)
+        :startIndex(0), totalSize(minimumSize), size(0)
         {
-            container = new byte[totalSize];
+            container = new uint8_t[totalSize];
         }
 
         //Copy constructor.
         FlexBit(const FlexBit& other)
+        :startIndex(0), totalSize(other.totalSize), size(other.size)
+        {
+            container = new uint8_t[totalSize];
+            other.copyTo(container, other.size);
+        }
+
+        //Move constructor.
+        FlexBit(FlexBit&& other)
+        :startIndex(other.startIndex), totalSize(other.totalSize),
+         size(other.size), container(other.container)
+        {
+            other.container = nullptr;
+            other.startIndex = 0;
+            other.totalSize = 0;
+            other.size = 0;
+        }
+
+        FlexBit& operator=(const FlexBit& other)
+        {
+            if (this != &other)
+            {
+                uint8_t* tempContainer = new uint8_t[other.totalSize];
+                other.copyTo(tempContainer, other.size);
+                delete[] container;
+                container = tempContainer;
+                startIndex = 0;
+                totalSize = other.totalSize;
+                size = other.size;
+            }
+            return *this;
+        }
+
+        FlexBit& operator=(FlexBit&& other)
         {
-            startIndex = other.startIndex;
-            totalSize = other.totalSize;
-            size = other.size;
-            container = new byte[other.totalSize];
-            container = other.container;
+            if (this != &other)
+            {
+                delete[] container;
+                container = other.container;
+                startIndex = other.startIndex;
+                totalSize = other.totalSize;
+                size = other.size;
+                other.container = nullptr;
+                other.startIndex = 0;
+                other.totalSize = 0;
+                other.size = 0;
+            }
+            return *this;
         }
 
         //Destructor
@@ -85,112 +131,151 @@ class FlexBit
         }
 
         //Getters
-        unsigned int getSize() {return size;}
-        unsigned int getTotalSize() {return totalSize;}
-        unsigned int getStartIndex() {return startIndex;}
+        unsigned int getSize() const {return size;}
+        unsigned int getTotalSize() const {return totalSize;}
+        unsigned int getStartIndex() const {return startIndex;}
+        bool isEmpty() const {return size == 0;}
 
-        //Appends a byte to the end of FlexArray.
+        //Appends a byte to the end of FlexBit.
         inline void push(byte b)
         {
             addLast(b);
         }
 
+        //Appends the given bytes to the end of FlexBit, growing at most once.
+        void push(const uint8_t* bytes, unsigned int count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            reserve(size + count);
+
+            //The free space may wrap around the end of the buffer.
+            unsigned int tail = (startIndex + size) & (totalSize - 1);
+            unsigned int first = totalSize - tail;
+            if (first > count)
+            {
+                first = count;
+            }
+            memcpy(container + tail, bytes, first);
+            memcpy(container, bytes + first, count - first);
+            size += count;
+        }
+
         //Retrieves, but does not remove, the first element in the queue.
-        inline byte peek()
+        inline byte peek() const
         {
             //Throws out_of_range exception.
-            return at(startIndex);
+            return at(0);
         }
 
         /*Retrieves and removes the first element in the queue.
-            Only shifting the contents of FlexBit when they make up less
-            than 25% of the total space, will also copy contents into a smaller
-            space in memory deallocating the old FlexBit. */
+            This only advances the head, so it never allocates or copies,
+            however much of the buffer is left unused. Call shrink() to
+            release the space. */
         byte poll()
         {
             //If the queue is not empty,
             //otherwise throw an exception.
-            if (size > 0)
-            {
-                //Getting the first element in the queue.
-                byte head = container[startIndex];
-
-                //Checking if there is less than approximately 25% total space being used.
-                //Depending on the lost of precision when the value is calculated and then cast into
-                //an integer value. So anything that yields a value between 4 and 5 will be considered 4. eg. 4.99999 will be casted to 4.
-                //Let totalSize/size = n.
-                //If n > 4, that means that the current size of
-                //FlexBit can fit equally into the total size of the container
-                //n times, so the greater n is the more space that is not being used.
-                if (totalSize / size > 4)
-                {
-
-                    ++startIndex;
-                    if (--size == 0)
-                    {
-                        totalSize = 10;
-                    }
-                    else
-                    {
-                        totalSize = size * 2;
-
-                    }
-                    byte* tempContainer = new byte[totalSize];
-
-                    //Copy elements into the new container.
-                    if (container && size > 0)
-                    {
-                        //Copy elements into the new container.
-                        memcpy(tempContainer, &container[startIndex], size * sizeof(byte));
-                    }
-                    delete[] container;
-                    container = tempContainer;
-                    startIndex = 0;
-                }
-                else
-                {
-                    --size;
-                    ++startIndex;
-                }
+            if (size == 0)
+            {
+                throw std::length_error("Empty FlexBit");
+            }
 
-                return head;
+            byte head(container[startIndex]);
+            startIndex = (startIndex + 1) & (totalSize - 1);
+            if (--size == 0)
+            {
+                //Starting over at the front keeps the next pushes contiguous.
+                startIndex = 0;
+            }
+            return head;
+        }
 
+        /*Retrieves and removes up to the given number of bytes from the
+            front, returning how many there were. */
+        unsigned int poll(uint8_t* out, unsigned int count)
+        {
+            if (count > size)
+            {
+                count = size;
             }
-            else
+            if (count == 0)
             {
-                throw std::length_error("Empty FlexBit");
+                return 0;
+            }
+            copyTo(out, count);
+            startIndex = (startIndex + count) & (totalSize - 1);
+            size -= count;
+            if (size == 0)
+            {
+                startIndex = 0;
             }
+            return count;
+        }
 
+        //Removes every byte, keeping the buffer.
+        void clear()
+        {
+            startIndex = 0;
+            size = 0;
         }
 
-        //Prints the FlexBit to the screen.
-        std::string toString()
+        /*Ensures room for at least the given number of bytes, so that
+            pushing up to that many never reallocates. */
+        void reserve(unsigned int bytes)
         {
-            std::string str = "";
-            std::string cur = "";
-            if (size > 0)
+            if (bytes > totalSize)
             {
-                for (unsigned int i = startIndex; i < (size + startIndex) - 1; i++)
-                {
-                    cur = at(i).to_string();
-                    str += cur + ", ";
-                }
-
-                cur = at((size + startIndex) - 1).to_string();
-                str += cur + "\n";
-                return str;
+                resize(roundUp(bytes));
+            }
+        }
 
+        /*Releases unused space, reallocating to the smallest buffer which
+            holds the current bytes. Returns true if it reallocated. */
+        bool shrink()
+        {
+            unsigned int fitted = roundUp(size);
+            if (fitted >= totalSize)
+            {
+                return false;
             }
-            else
+            resize(fitted);
+            return true;
+        }
+
+        //Prints the FlexBit to the screen.
+        std::string toString() const
+        {
+            if (size == 0)
             {
                 throw std::length_error("Empty FlexBit");
             }
 
-
+            //Every byte takes eight digits and a separator of two
+            //characters, except the last, which ends in a newline.
+            std::string str(size * 10 - 1, ' ');
+            char* out = &str[0];
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                uint8_t value = container[(startIndex + i) & (totalSize - 1)];
+                for (int bit = 7; bit >= 0; --bit)
+                {
+                    *out++ = static_cast<char>('0' + ((value >> bit) & 1));
+                }
+                if (i + 1 < size)
+                {
+                    *out++ = ',';
+                    *out++ = ' ';
+                }
+            }
+            *out = '\n';
+            return str;
         }
 
         //Prints the first byte in the FlexBit.
-        void printPeek()
+        void printPeek() const
         {
             ioc << peek().to_string() << IOCtrl::endl;
         }
@@ -201,53 +286,76 @@ class FlexBit
             "totalSize" is the total size in the array of bytes.
             "size" is the number of bytes in FlexBit. */
         unsigned int startIndex, totalSize, size;
-        byte* container;
+        uint8_t* container;
+
+        //The smallest buffer; a power of two, like every size.
+        static const unsigned int minimumSize = 16;
 
-        /* Idea taken from flex_array, where we double the size
-            of the array container which will be used by the push function. */
-        void doubleSize()
+        //Returns the smallest power of two that is at least n, and at least minimumSize.
+        static unsigned int roundUp(unsigned int n)
         {
-            totalSize *= 2;
+            unsigned int rounded = minimumSize;
+            while (rounded < n)
+            {
+                rounded *= 2;
+            }
+            return rounded;
+        }
 
-            byte* tempContainer = new byte[totalSize];
+        //Copies the first count bytes, in order, to the given buffer.
+        void copyTo(uint8_t* destination, unsigned int count) const
+        {
+            //The bytes may wrap around the end of the buffer.
+            unsigned int first = totalSize - startIndex;
+            if (first > count)
+            {
+                first = count;
+            }
+            if (first > 0)
+            {
+                memcpy(destination, container + startIndex, first);
+            }
+            if (count > first)
+            {
+                memcpy(destination + first, container, count - first);
+            }
+        }
 
-            //If container pointer is not null.
+        //Moves the bytes into a new buffer of the given power-of-two size.
+        void resize(unsigned int newSize)
+        {
+            uint8_t* tempContainer = new uint8_t[newSize];
             if (container)
             {
-                //Copy elements into the new container.
-                memcpy(&tempContainer[0], &container[startIndex], size * sizeof(byte));
-
+                copyTo(tempContainer, size);
             }
             delete[] container;
             container = tempContainer;
             startIndex = 0;
-
+            totalSize = newSize;
         }
 
         //Adds the new byte at the end of the FlexBit.
         void addLast(byte b)
         {
-            //If current size is >= totalSize then double totalSize.
-            if (size + startIndex >= totalSize - 1)
+            //Only grow when every slot is in use.
+            if (size == totalSize)
             {
-                doubleSize();
+                resize(roundUp(totalSize + 1));
             }
 
-            container[startIndex + size] = b;
+            container[(startIndex + size) & (totalSize - 1)] = static_cast<uint8_t>(b.to_ulong());
             ++size;
         }
 
-        //Retrieves byte at given index.
-        byte at(unsigned int index)
+        //Retrieves the byte at the given position from the front.
+        byte at(unsigned int index) const
         {
-            if (index > (size + startIndex) - 1 || index < startIndex)
+            if (index >= size)
             {
                 throw std::out_of_range("Index out of bounds.");
             }
-            else
-            {
-                return container[index];
-            }
+            return byte(container[(startIndex + index) & (totalSize - 1)]);
         }
 
 };
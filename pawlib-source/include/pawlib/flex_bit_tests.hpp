@@ -48,6 +48,7 @@
 
 #include "pawlib/flex_bit.hpp"
 #include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
 #include "pawlib/iochannel.hpp"
 #include "pawlib/stdutils.hpp"
 
@@ -201,7 +202,7 @@ class TestFlexBit_Peek : public Test
         //Clean up.
         bool post() override
         {
-            testFlexBit.~FlexBit();
+            testFlexBit.clear();
 
             return true;
         }
@@ -295,7 +296,7 @@ class TestFlexBit_Poll : public Test
         //Clean up.
         bool post() override
         {
-            testFlexBit.~FlexBit();
+            testFlexBit.clear();
 
             return true;
         }
@@ -400,7 +401,7 @@ class TestFlexBit_ToString : public Test
         //Clean up.
         bool post() override
         {
-            testFlexBit.~FlexBit();
+            testFlexBit.clear();
 
             return true;
         }
@@ -410,6 +411,162 @@ class TestFlexBit_ToString : public Test
         unsigned int iters;
 };
 
+//Testing a steady stream of pushes and polls through FlexBit.
+class TestFlexBit_Stream : public Test
+{
+    public:
+
+        //Constructor.
+        explicit TestFlexBit_Stream(unsigned int iterations): iters(iterations) {}
+
+        //Destructor
+        ~TestFlexBit_Stream() {}
+
+        //Test title.
+        testdoc_t get_title() override
+        {
+            return "FlexBit: Stream " + stdutils::itos(iters, 10) + " bytes.";
+        }
+
+        //Test description.
+        testdoc_t get_docs() override
+        {
+            return "Push and poll " + stdutils::itos(iters, 10) + " bytes, keeping "
+                   "a window of bytes queued, and ensure they come out in order "
+                   "without the buffer ever reallocating.";
+        }
+
+        //Running the stream, checking each byte as it leaves.
+        bool run() override
+        {
+            FlexBit flexbit;
+            unsigned int pushed = 0;
+            unsigned int polled = 0;
+
+            //Fill the window, which sets the only size the buffer needs.
+            for (; pushed < window; ++pushed)
+            {
+                flexbit.push(std::bitset<8>(pushed % 251));
+            }
+            unsigned int totalSize = flexbit.getTotalSize();
+
+            //Each round moves the head and tail around the buffer, so
+            //they wrap many times.
+            while (polled < iters)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    PL_ASSERT_EQUAL(flexbit.poll().to_ulong(), static_cast<unsigned long>(polled % 251));
+                    ++polled;
+                }
+                for (int i = 0; i < 3; ++i)
+                {
+                    flexbit.push(std::bitset<8>(pushed % 251));
+                    ++pushed;
+                }
+                PL_ASSERT_EQUAL(flexbit.getSize(), window);
+            }
+            PL_ASSERT_EQUAL(flexbit.getTotalSize(), totalSize);
+            PL_ASSERT_EQUAL(flexbit.peek().to_ulong(), static_cast<unsigned long>(polled % 251));
+
+            //Draining the queue leaves the buffer alone.
+            while (!flexbit.isEmpty())
+            {
+                flexbit.poll();
+            }
+            PL_ASSERT_EQUAL(flexbit.getTotalSize(), totalSize);
+
+            try
+            {
+                flexbit.poll();
+                return false;
+            }
+            catch (const std::length_error&) {}
+
+            return true;
+        }
+
+    private:
+        static const unsigned int window = 1000;
+        unsigned int iters;
+};
+
+//Testing copying, reserving, and shrinking FlexBit.
+class TestFlexBit_CopyShrink : public Test
+{
+    public:
+
+        //Default constructor.
+        TestFlexBit_CopyShrink() {}
+
+        //Destructor
+        ~TestFlexBit_CopyShrink() {}
+
+        //Test title.
+        testdoc_t get_title() override
+        {
+            return "FlexBit: Copy & Shrink";
+        }
+
+        //Test description.
+        testdoc_t get_docs() override
+        {
+            return "Copy, move, reserve, and shrink a flex bit whose bytes "
+                   "wrap around the end of its buffer.";
+        }
+
+        //Running the test.
+        bool run() override
+        {
+            FlexBit flexbit;
+            flexbit.reserve(100);
+            unsigned int totalSize = flexbit.getTotalSize();
+            PL_ASSERT_FALSE(totalSize < 100);
+
+            //Leave the bytes wrapped around the end of the buffer.
+            for (unsigned int i = 0; i < 90; ++i)
+            {
+                flexbit.push(std::bitset<8>(i));
+            }
+            for (unsigned int i = 0; i < 80; ++i)
+            {
+                flexbit.poll();
+            }
+            for (unsigned int i = 90; i < 120; ++i)
+            {
+                flexbit.push(std::bitset<8>(i));
+            }
+            PL_ASSERT_EQUAL(flexbit.getTotalSize(), totalSize);
+
+            //Copies are independent.
+            FlexBit copy(flexbit);
+            FlexBit assigned;
+            assigned = flexbit;
+            PL_ASSERT_EQUAL(copy.getSize(), 40u);
+            copy.poll();
+            PL_ASSERT_EQUAL(flexbit.peek().to_ulong(), 80ul);
+            PL_ASSERT_EQUAL(copy.peek().to_ulong(), 81ul);
+            PL_ASSERT_EQUAL(assigned.toString(), flexbit.toString());
+
+            //Shrinking keeps the bytes, in order.
+            std::string before = flexbit.toString();
+            PL_ASSERT_TRUE(flexbit.shrink());
+            PL_ASSERT_LESS(flexbit.getTotalSize(), totalSize);
+            PL_ASSERT_FALSE(flexbit.shrink());
+            PL_ASSERT_EQUAL(flexbit.toString(), before);
+
+            FlexBit moved(std::move(flexbit));
+            PL_ASSERT_EQUAL(moved.toString(), before);
+            for (unsigned int i = 80; i < 120; ++i)
+            {
+                PL_ASSERT_EQUAL(moved.poll().to_ulong(), static_cast<unsigned long>(i));
+            }
+            PL_ASSERT_TRUE(moved.isEmpty());
+
+            return true;
+        }
+};
+
 
 class TestSuite_FlexBit : public TestSuite
 {
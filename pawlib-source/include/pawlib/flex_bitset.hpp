@@ -0,0 +1,591 @@
+/** FlexBitset [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * A dynamic, bit-addressable bitset, packed into 64-bit words.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXBITSET_HPP
+#define PAWLIB_FLEXBITSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/** A dynamic bitset, stored in 64-bit words, which can set, test, and count
+  * individual bits and ranges of bits at scale. Unlike FlexBit, which is a
+  * queue of whole bytes, every bit is addressable.
+  *
+  * Bitwise operations between bitsets, counting, and searching all work a
+  * whole word at a time. When compiled with AVX2, the bitwise operations
+  * work on four words at a time. The bits past size() in the last word are
+  * always kept clear, so they never show up in a count or search.
+  *
+  * Single-bit operations do not check their index, like operator[] on the
+  * standard containers; the index must be less than size(). */
+class FlexBitset
+{
+    public:
+        /// Returned by the searches when there is no set bit to find.
+        static constexpr size_t npos = SIZE_MAX;
+
+        FlexBitset()
+        :_words(nullptr), _size(0), _capacity(0)
+        {}
+
+        /** Create a bitset of the given number of bits.
+          * \param the number of bits
+          * \param the value of every bit */
+        explicit FlexBitset(size_t bits, bool value = false)
+        :_words(nullptr), _size(0), _capacity(0)
+        {
+            resize(bits, value);
+        }
+
+        FlexBitset(const FlexBitset& cpy)
+        :_words(allocate(word_count(cpy._size))), _size(cpy._size), _capacity(word_count(cpy._size))
+        {
+            copy_words(_words, cpy._words, _capacity);
+        }
+
+        FlexBitset(FlexBitset&& mov)
+        :_words(mov._words), _size(mov._size), _capacity(mov._capacity)
+        {
+            mov._words = nullptr;
+            mov._size = 0;
+            mov._capacity = 0;
+        }
+
+        FlexBitset& operator=(const FlexBitset& rhs)
+        {
+            if(&rhs != this)
+            {
+                FlexBitset copied(rhs);
+                swap(copied);
+            }
+            return *this;
+        }
+
+        FlexBitset& operator=(FlexBitset&& rhs)
+        {
+            if(&rhs != this)
+            {
+                swap(rhs);
+            }
+            return *this;
+        }
+
+        void swap(FlexBitset& other)
+        {
+            std::swap(_words, other._words);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        }
+
+        /** \return the value of the bit at the given index */
+        bool test(size_t index) const
+        {
+            return (_words[index >> 6] >> (index & 63)) & 1;
+        }
+
+        bool operator[](size_t index) const
+        {
+            return test(index);
+        }
+
+        /** Set the bit at the given index to 1. */
+        void set(size_t index)
+        {
+            _words[index >> 6] |= bit(index);
+        }
+
+        /** Set the bit at the given index to the given value. */
+        void set(size_t index, bool value)
+        {
+            // Clear the bit, then or in the value, without branching.
+            uint64_t& word = _words[index >> 6];
+            word = (word & ~bit(index)) | (static_cast<uint64_t>(value) << (index & 63));
+        }
+
+        /** Set the bit at the given index to 0. */
+        void reset(size_t index)
+        {
+            _words[index >> 6] &= ~bit(index);
+        }
+
+        /** Invert the bit at the given index. */
+        void flip(size_t index)
+        {
+            _words[index >> 6] ^= bit(index);
+        }
+
+        /** Set every bit in [first, last) to 1.
+          * \throws std::out_of_range if the range runs past size() */
+        void set_range(size_t first, size_t last)
+        {
+            apply_range(first, last, [this](size_t i, uint64_t mask) { _words[i] |= mask; });
+        }
+
+        /** Set every bit in [first, last) to 0.
+          * \throws std::out_of_range if the range runs past size() */
+        void reset_range(size_t first, size_t last)
+        {
+            apply_range(first, last, [this](size_t i, uint64_t mask) { _words[i] &= ~mask; });
+        }
+
+        /** Invert every bit in [first, last).
+          * \throws std::out_of_range if the range runs past size() */
+        void flip_range(size_t first, size_t last)
+        {
+            apply_range(first, last, [this](size_t i, uint64_t mask) { _words[i] ^= mask; });
+        }
+
+        /** Set every bit to 1. */
+        void set_all()
+        {
+            set_range(0, _size);
+        }
+
+        /** Set every bit to 0. */
+        void reset_all()
+        {
+            if(_size > 0)
+            {
+                std::memset(_words, 0, word_count(_size) * sizeof(uint64_t));
+            }
+        }
+
+        /** Invert every bit. */
+        void flip_all()
+        {
+            flip_range(0, _size);
+        }
+
+        /** \return the number of bits set to 1 */
+        size_t popcount() const
+        {
+            size_t total = 0;
+            size_t words = word_count(_size);
+            for(size_t i = 0; i < words; ++i)
+            {
+                total += static_cast<size_t>(__builtin_popcountll(_words[i]));
+            }
+            return total;
+        }
+
+        /** \return the number of bits set to 1 in [first, last)
+          * \throws std::out_of_range if the range runs past size() */
+        size_t popcount(size_t first, size_t last) const
+        {
+            size_t total = 0;
+            apply_range(first, last, [this, &total](size_t i, uint64_t mask)
+            {
+                total += static_cast<size_t>(__builtin_popcountll(_words[i] & mask));
+            });
+            return total;
+        }
+
+        /** \return true if any bit is set */
+        bool any() const
+        {
+            size_t words = word_count(_size);
+            for(size_t i = 0; i < words; ++i)
+            {
+                if(_words[i] != 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /** \return true if no bit is set */
+        bool none() const
+        {
+            return !any();
+        }
+
+        /** \return true if every bit is set, including when there are no bits */
+        bool all() const
+        {
+            return popcount() == _size;
+        }
+
+        /** \return the index of the first set bit, or npos */
+        size_t find_first() const
+        {
+            return (_size > 0) ? find_from(0) : npos;
+        }
+
+        /** \return the index of the first set bit after the given index, or npos */
+        size_t find_next(size_t index) const
+        {
+            return (index + 1 < _size) ? find_from(index + 1) : npos;
+        }
+
+        /** Keep only the bits which are also set in other.
+          * \throws std::invalid_argument if the sizes differ */
+        FlexBitset& operator&=(const FlexBitset& other)
+        {
+            combine<Op::and_op>(other);
+            return *this;
+        }
+
+        /** Set every bit which is set in other.
+          * \throws std::invalid_argument if the sizes differ */
+        FlexBitset& operator|=(const FlexBitset& other)
+        {
+            combine<Op::or_op>(other);
+            return *this;
+        }
+
+        /** Invert every bit which is set in other.
+          * \throws std::invalid_argument if the sizes differ */
+        FlexBitset& operator^=(const FlexBitset& other)
+        {
+            combine<Op::xor_op>(other);
+            return *this;
+        }
+
+        /** Clear every bit which is set in other.
+          * \throws std::invalid_argument if the sizes differ */
+        FlexBitset& and_not(const FlexBitset& other)
+        {
+            combine<Op::and_not_op>(other);
+            return *this;
+        }
+
+        bool operator==(const FlexBitset& other) const
+        {
+            // The spare bits are always clear, so whole words can be compared.
+            return _size == other._size &&
+                   (_size == 0 || std::memcmp(_words, other._words, word_count(_size) * sizeof(uint64_t)) == 0);
+        }
+
+        bool operator!=(const FlexBitset& other) const
+        {
+            return !(*this == other);
+        }
+
+        /** Append a bit, growing the storage by doubling as needed. */
+        void push_back(bool value)
+        {
+            if(_size == _capacity * 64)
+            {
+                reserve((_capacity == 0) ? 64 : _capacity * 128);
+            }
+            set(_size++, value);
+        }
+
+        /** Change the number of bits. New bits take the given value, and
+          * removed bits are cleared.
+          * \param the new number of bits
+          * \param the value of any new bits */
+        void resize(size_t bits, bool value = false)
+        {
+            size_t old = _size;
+            if(bits > old)
+            {
+                reserve(bits);
+                _size = bits;
+                if(value)
+                {
+                    set_range(old, bits);
+                }
+            }
+            else
+            {
+                // Clear the bits being removed, to keep the spare bits clear.
+                reset_range(bits, old);
+                _size = bits;
+            }
+        }
+
+        /** Make room for at least the given number of bits. */
+        void reserve(size_t bits)
+        {
+            size_t words = word_count(bits);
+            if(words <= _capacity)
+            {
+                return;
+            }
+            uint64_t* grown = allocate(words);
+            size_t filled = word_count(_size);
+            copy_words(grown, _words, filled);
+            std::memset(grown + filled, 0, (words - filled) * sizeof(uint64_t));
+            deallocate(_words);
+            _words = grown;
+            _capacity = words;
+        }
+
+        /** Remove every bit, keeping the storage. */
+        void clear()
+        {
+            reset_all();
+            _size = 0;
+        }
+
+        /** \return the number of bits */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return true if there are no bits */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** \return the number of bits there is room for without growing */
+        size_t capacity() const
+        {
+            return _capacity * 64;
+        }
+
+        /** \return the words holding the bits, with bit i in bit (i % 64) of
+          * word (i / 64). The bits past size() are always clear. */
+        const uint64_t* data() const
+        {
+            return _words;
+        }
+
+        /** \return the words holding the bits, to change a whole word at a
+          * time. The bits past size() must be left clear. */
+        uint64_t* data()
+        {
+            return _words;
+        }
+
+        /** \return the number of words holding the bits */
+        size_t words() const
+        {
+            return word_count(_size);
+        }
+
+        ~FlexBitset()
+        {
+            deallocate(_words);
+        }
+
+    private:
+        enum class Op
+        {
+            and_op,
+            or_op,
+            xor_op,
+            and_not_op
+        };
+
+        // Words are aligned to a 64-byte cache line, which also suits the
+        // AVX2 loads.
+        static const size_t alignment = 64;
+
+        static uint64_t* allocate(size_t words)
+        {
+            if(words == 0)
+            {
+                return nullptr;
+            }
+            return static_cast<uint64_t*>(::operator new(words * sizeof(uint64_t), std::align_val_t(alignment)));
+        }
+
+        static void deallocate(uint64_t* words)
+        {
+            if(words != nullptr)
+            {
+                ::operator delete(words, std::align_val_t(alignment));
+            }
+        }
+
+        static void copy_words(uint64_t* to, const uint64_t* from, size_t words)
+        {
+            if(words > 0)
+            {
+                std::memcpy(to, from, words * sizeof(uint64_t));
+            }
+        }
+
+        /** \return the number of words needed to hold the given number of bits */
+        static size_t word_count(size_t bits)
+        {
+            return (bits + 63) / 64;
+        }
+
+        /** \return a word with only the given index's bit set */
+        static uint64_t bit(size_t index)
+        {
+            return uint64_t(1) << (index & 63);
+        }
+
+        /** Call action(i, mask) for each word i overlapping [first, last),
+          * with the mask selecting the bits of the word in the range. */
+        template<typename Action>
+        void apply_range(size_t first, size_t last, Action action) const
+        {
+            if(first > last || last > _size)
+            {
+                throw std::out_of_range("FlexBitset: range out of bounds");
+            }
+            if(first == last)
+            {
+                return;
+            }
+            size_t firstWord = first >> 6;
+            size_t lastWord = (last - 1) >> 6;
+            uint64_t firstMask = ~uint64_t(0) << (first & 63);
+            uint64_t lastMask = ~uint64_t(0) >> (63 - ((last - 1) & 63));
+            if(firstWord == lastWord)
+            {
+                action(firstWord, firstMask & lastMask);
+                return;
+            }
+            action(firstWord, firstMask);
+            for(size_t i = firstWord + 1; i < lastWord; ++i)
+            {
+                action(i, ~uint64_t(0));
+            }
+            action(lastWord, lastMask);
+        }
+
+        /** \return the index of the first set bit at or after the given index, or npos */
+        size_t find_from(size_t index) const
+        {
+            size_t words = word_count(_size);
+            size_t i = index >> 6;
+            uint64_t word = _words[i] & (~uint64_t(0) << (index & 63));
+            while(word == 0)
+            {
+                if(++i == words)
+                {
+                    return npos;
+                }
+                word = _words[i];
+            }
+            return (i << 6) + static_cast<size_t>(__builtin_ctzll(word));
+        }
+
+        /** Combine the words of another bitset of the same size into these. */
+        template<Op op>
+        void combine(const FlexBitset& other)
+        {
+            if(other._size != _size)
+            {
+                throw std::invalid_argument("FlexBitset: sizes differ");
+            }
+            combine_words<op>(other._words);
+        }
+
+        template<Op op>
+        static uint64_t combine_word(uint64_t a, uint64_t b)
+        {
+            if constexpr(op == Op::and_op) { return a & b; }
+            else if constexpr(op == Op::or_op) { return a | b; }
+            else if constexpr(op == Op::xor_op) { return a ^ b; }
+            else { return a & ~b; }
+        }
+
+#if defined(__AVX2__)
+        template<Op op>
+        static __m256i combine_vector(__m256i a, __m256i b)
+        {
+            if constexpr(op == Op::and_op) { return _mm256_and_si256(a, b); }
+            else if constexpr(op == Op::or_op) { return _mm256_or_si256(a, b); }
+            else if constexpr(op == Op::xor_op) { return _mm256_xor_si256(a, b); }
+            // andnot inverts its first argument.
+            else { return _mm256_andnot_si256(b, a); }
+        }
+#endif
+
+        template<Op op>
+        void combine_words(const uint64_t* other)
+        {
+            size_t words = word_count(_size);
+            size_t i = 0;
+#if defined(__AVX2__)
+            for(; i + 4 <= words; i += 4)
+            {
+                __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(_words + i));
+                __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(other + i));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(_words + i), combine_vector<op>(a, b));
+            }
+#endif
+            // Without AVX2, the compiler vectorizes this loop for the baseline
+            // instruction set on its own.
+            for(; i < words; ++i)
+            {
+                _words[i] = combine_word<op>(_words[i], other[i]);
+            }
+        }
+
+        uint64_t* _words;
+        size_t _size;
+        // The number of words allocated.
+        size_t _capacity;
+};
+
+/** \return the bits set in both */
+inline FlexBitset operator&(FlexBitset lhs, const FlexBitset& rhs)
+{
+    lhs &= rhs;
+    return lhs;
+}
+
+/** \return the bits set in either */
+inline FlexBitset operator|(FlexBitset lhs, const FlexBitset& rhs)
+{
+    lhs |= rhs;
+    return lhs;
+}
+
+/** \return the bits set in exactly one */
+inline FlexBitset operator^(FlexBitset lhs, const FlexBitset& rhs)
+{
+    lhs ^= rhs;
+    return lhs;
+}
+
+#endif // PAWLIB_FLEXBITSET_HPP
@@ -0,0 +1,566 @@
+/** Tests for FlexBitset [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXBITSET_TESTS_HPP
+#define PAWLIB_FLEXBITSET_TESTS_HPP
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "pawlib/flex_bitset.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Check that a FlexBitset holds exactly the same bits as a std::vector<bool>,
+  * and that its count and searches agree.
+  * \param the bitset
+  * \param the model
+  * \return true if they match */
+inline bool bitset_matches(const FlexBitset& bits, const std::vector<bool>& model)
+{
+    if(bits.size() != model.size())
+    {
+        return false;
+    }
+    size_t count = 0;
+    size_t next = bits.find_first();
+    for(size_t i = 0; i < model.size(); ++i)
+    {
+        if(bits.test(i) != model[i])
+        {
+            return false;
+        }
+        if(model[i])
+        {
+            if(next != i)
+            {
+                return false;
+            }
+            next = bits.find_next(i);
+            ++count;
+        }
+    }
+    return next == FlexBitset::npos && bits.popcount() == count &&
+           bits.any() == (count > 0) && bits.all() == (count == model.size());
+}
+
+// P-tB8001
+class TestFlexBitset_Bits : public Test
+{
+    public:
+        TestFlexBitset_Bits(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBitset: Set, Reset, Flip & Test";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Change " + stdutils::itos(changes) + " random bits of " + stdutils::itos(count) +
+                   ", and ensure every bit, the count, and the searches match.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(8001);
+            FlexBitset bits(count);
+            std::vector<bool> model(count, false);
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+            for(int i = 0; i < changes; ++i)
+            {
+                size_t index = rng() % count;
+                switch(i % 4)
+                {
+                    case 0:
+                        bits.set(index);
+                        model[index] = true;
+                        break;
+                    case 1:
+                        bits.reset(index);
+                        model[index] = false;
+                        break;
+                    case 2:
+                        bits.flip(index);
+                        model[index] = !model[index];
+                        break;
+                    default:
+                        bits.set(index, (i & 8) != 0);
+                        model[index] = (i & 8) != 0;
+                        break;
+                }
+            }
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+
+            bits.set_all();
+            PL_ASSERT_TRUE(bits.all());
+            PL_ASSERT_EQUAL(bits.popcount(), static_cast<size_t>(count));
+            bits.flip_all();
+            PL_ASSERT_TRUE(bits.none());
+            PL_ASSERT_EQUAL(bits.find_first(), FlexBitset::npos);
+            return true;
+        }
+
+        ~TestFlexBitset_Bits(){}
+
+    private:
+        // Not a multiple of 64, so the last word is partly used.
+        static const int count = 10007;
+        static const int changes = 20000;
+};
+
+// P-tB8002
+class TestFlexBitset_Ranges : public Test
+{
+    public:
+        TestFlexBitset_Ranges(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBitset: Ranges";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Set, reset, flip, and count random ranges, including ones within and across word boundaries.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(8002);
+            FlexBitset bits(count);
+            std::vector<bool> model(count, false);
+            for(int i = 0; i < 500; ++i)
+            {
+                size_t first = rng() % (count + 1);
+                // Alternate short ranges, which stay in one or two words, with long ones.
+                size_t span = (i % 2 == 0) ? rng() % 70 : rng() % count;
+                size_t last = std::min(first + span, static_cast<size_t>(count));
+
+                size_t expected = static_cast<size_t>(std::count(model.begin() + first, model.begin() + last, true));
+                PL_ASSERT_EQUAL(bits.popcount(first, last), expected);
+
+                switch(i % 3)
+                {
+                    case 0:
+                        bits.set_range(first, last);
+                        std::fill(model.begin() + first, model.begin() + last, true);
+                        break;
+                    case 1:
+                        bits.reset_range(first, last);
+                        std::fill(model.begin() + first, model.begin() + last, false);
+                        break;
+                    default:
+                        bits.flip_range(first, last);
+                        for(size_t b = first; b < last; ++b)
+                        {
+                            model[b] = !model[b];
+                        }
+                        break;
+                }
+                if(!bitset_matches(bits, model))
+                {
+                    return false;
+                }
+            }
+
+            bool threw = false;
+            try
+            {
+                bits.set_range(10, count + 1);
+            }
+            catch(const std::out_of_range&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            return true;
+        }
+
+        ~TestFlexBitset_Ranges(){}
+
+    private:
+        static const int count = 1000;
+};
+
+// P-tB8003
+class TestFlexBitset_Bitwise : public Test
+{
+    public:
+        TestFlexBitset_Bitwise(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBitset: Bitwise Operations";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Combine random bitsets with and, or, xor, and and_not, and ensure mismatched sizes are rejected.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(8003);
+            FlexBitset a(count);
+            FlexBitset b(count);
+            std::vector<bool> ma(count), mb(count);
+            for(size_t i = 0; i < count; ++i)
+            {
+                ma[i] = (rng() % 3 == 0);
+                mb[i] = (rng() % 2 == 0);
+                a.set(i, ma[i]);
+                b.set(i, mb[i]);
+            }
+
+            std::vector<bool> expected(count);
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = ma[i] && mb[i];
+            }
+            PL_ASSERT_TRUE(bitset_matches(a & b, expected));
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = ma[i] || mb[i];
+            }
+            PL_ASSERT_TRUE(bitset_matches(a | b, expected));
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = ma[i] != mb[i];
+            }
+            PL_ASSERT_TRUE(bitset_matches(a ^ b, expected));
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = ma[i] && !mb[i];
+            }
+            FlexBitset difference = a;
+            difference.and_not(b);
+            PL_ASSERT_TRUE(bitset_matches(difference, expected));
+            PL_ASSERT_TRUE(difference != a);
+
+            bool threw = false;
+            FlexBitset shorter(count - 1);
+            try
+            {
+                a &= shorter;
+            }
+            catch(const std::invalid_argument&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            return true;
+        }
+
+        ~TestFlexBitset_Bitwise(){}
+
+    private:
+        // Enough words to use the four-word path, with some left over.
+        static const size_t count = 64 * 23 + 5;
+};
+
+// P-tB8004
+class TestFlexBitset_Resize : public Test
+{
+    public:
+        TestFlexBitset_Resize(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBitset: Push, Resize & Copy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Grow a bitset by pushing and resizing, shrink it, and copy it, ensuring removed bits never come back.";
+        }
+
+        bool run() override
+        {
+            FlexBitset bits;
+            std::vector<bool> model;
+            PL_ASSERT_EQUAL(bits.find_first(), FlexBitset::npos);
+            for(int i = 0; i < 1000; ++i)
+            {
+                bits.push_back(i % 7 == 0);
+                model.push_back(i % 7 == 0);
+            }
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+
+            bits.resize(1500, true);
+            model.resize(1500, true);
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+
+            // Shrinking clears the removed bits, so growing again brings back zeros.
+            bits.resize(700);
+            model.resize(700);
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+            bits.resize(1200);
+            model.resize(1200, false);
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+
+            FlexBitset copied = bits;
+            PL_ASSERT_TRUE(copied == bits);
+            copied.flip(3);
+            PL_ASSERT_TRUE(copied != bits);
+            PL_ASSERT_TRUE(bitset_matches(bits, model));
+
+            FlexBitset moved = std::move(copied);
+            PL_ASSERT_TRUE(copied.empty());
+            PL_ASSERT_EQUAL(moved.size(), 1200u);
+
+            bits.clear();
+            PL_ASSERT_TRUE(bits.empty());
+            bits.resize(64);
+            PL_ASSERT_TRUE(bits.none());
+            return true;
+        }
+
+        ~TestFlexBitset_Resize(){}
+};
+
+/** A std::vector<bool> with the operations the FlexBitset benchmarks use,
+  * done a bit at a time. */
+class BitsetBenchVector : public std::vector<bool>
+{
+    public:
+        explicit BitsetBenchVector(size_t bits)
+        :std::vector<bool>(bits, false)
+        {}
+
+        void set(size_t index)
+        {
+            (*this)[index] = true;
+        }
+
+        BitsetBenchVector& operator&=(const BitsetBenchVector& other)
+        {
+            for(size_t i = 0; i < size(); ++i)
+            {
+                (*this)[i] = (*this)[i] && other[i];
+            }
+            return *this;
+        }
+
+        size_t popcount() const
+        {
+            return static_cast<size_t>(std::count(begin(), end(), true));
+        }
+
+        size_t find_first() const
+        {
+            return find_next_from(0);
+        }
+
+        size_t find_next(size_t index) const
+        {
+            return find_next_from(index + 1);
+        }
+
+    private:
+        size_t find_next_from(size_t index) const
+        {
+            for(; index < size(); ++index)
+            {
+                if((*this)[index])
+                {
+                    return index;
+                }
+            }
+            return FlexBitset::npos;
+        }
+};
+
+// P-tB8005, P-tB8005*
+template<typename bits_t>
+class TestFlexBitset_And : public Test
+{
+    public:
+        explicit TestFlexBitset_And(const testdoc_t& name)
+        :name(name), a(count), b(count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": And";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "And together two " + name + "s of " + stdutils::itos(count) + " bits.";
+        }
+
+        bool janitor() override
+        {
+            for(size_t i = 0; i < count; i += 3)
+            {
+                a.set(i);
+            }
+            for(size_t i = 0; i < count; i += 2)
+            {
+                b.set(i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            a &= b;
+            return true;
+        }
+
+        ~TestFlexBitset_And(){}
+
+    private:
+        static const size_t count = 1 << 22;
+        testdoc_t name;
+        bits_t a;
+        bits_t b;
+};
+
+// P-tB8006, P-tB8006*
+template<typename bits_t>
+class TestFlexBitset_Popcount : public Test
+{
+    public:
+        explicit TestFlexBitset_Popcount(const testdoc_t& name)
+        :name(name), bits(count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Popcount";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Count the set bits of a " + name + " of " + stdutils::itos(count) + " bits.";
+        }
+
+        bool pre() override
+        {
+            for(size_t i = 0; i < count; i += 5)
+            {
+                bits.set(i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            return bits.popcount() == (count + 4) / 5;
+        }
+
+        ~TestFlexBitset_Popcount(){}
+
+    private:
+        static const size_t count = 1 << 22;
+        testdoc_t name;
+        bits_t bits;
+};
+
+// P-tB8007, P-tB8007*
+template<typename bits_t>
+class TestFlexBitset_FindNext : public Test
+{
+    public:
+        explicit TestFlexBitset_FindNext(const testdoc_t& name)
+        :name(name), bits(count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Find Next";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Visit every set bit of a sparse " + name + " of " + stdutils::itos(count) + " bits, one bit in 1000.";
+        }
+
+        bool pre() override
+        {
+            for(size_t i = 0; i < count; i += 1000)
+            {
+                bits.set(i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            size_t found = 0;
+            for(size_t i = bits.find_first(); i != FlexBitset::npos; i = bits.find_next(i))
+            {
+                ++found;
+            }
+            return found == (count + 999) / 1000;
+        }
+
+        ~TestFlexBitset_FindNext(){}
+
+    private:
+        static const size_t count = 1 << 22;
+        testdoc_t name;
+        bits_t bits;
+};
+
+class TestSuite_FlexBitset : public TestSuite
+{
+    public:
+        explicit TestSuite_FlexBitset(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: FlexBitset Tests";
+        }
+
+        ~TestSuite_FlexBitset(){}
+};
+
+#endif // PAWLIB_FLEXBITSET_TESTS_HPP
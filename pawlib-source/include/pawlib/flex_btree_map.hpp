@@ -0,0 +1,1208 @@
+/** FlexBTreeMap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An ordered map, stored in a B+ tree whose nodes span a few cache lines.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXBTREEMAP_HPP
+#define PAWLIB_FLEXBTREEMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "pawlib/flex_array.hpp"
+#include "pawlib/iochannel.hpp"
+
+/** An ordered map, similar to std::map, stored in a B+ tree.
+  * Every element lives in a leaf, and the leaves are chained in key order,
+  * so ordered scans walk straight through contiguous arrays. Each node
+  * holds as many keys as fit in node_bytes (at least four), and its keys
+  * are stored together, so searching a node touches only a few cache
+  * lines. Nodes of 32-bit integer keys are searched with SSE2.
+  *
+  * Like Map, lookups take any key type which can be compared with key_t
+  * using operator< in both directions. Elements move between nodes as the
+  * tree changes, so pointers to values are only valid until the next
+  * insertion or removal.
+  * \param the key type
+  * \param the value type
+  * \param the target size of the keys in a node, in bytes */
+template<typename key_t, typename value_t, size_t node_bytes = 256>
+class FlexBTreeMap
+{
+    private:
+        static constexpr size_t fit(size_t each)
+        {
+            return (node_bytes / each < 4) ? 4 : node_bytes / each;
+        }
+
+    public:
+        /// The most elements a leaf holds.
+        static constexpr size_t LEAF_CAP = fit(sizeof(key_t));
+        /// The most keys an inner node holds. It has one more child than keys.
+        static constexpr size_t INNER_CAP = fit(sizeof(key_t) + sizeof(void*));
+
+    private:
+        static_assert(LEAF_CAP < 65536 && INNER_CAP < 65536,
+                      "FlexBTreeMap: node_bytes is too large.");
+
+        /// The fewest elements a leaf other than the root may hold.
+        static constexpr size_t LEAF_MIN = LEAF_CAP / 2;
+        /// The fewest keys an inner node other than the root may hold.
+        static constexpr size_t INNER_MIN = INNER_CAP / 2;
+
+        struct alignas(64) Node
+        {
+            uint16_t count;
+            bool leaf;
+
+            explicit Node(bool is_leaf)
+            :count(0), leaf(is_leaf)
+            {}
+        };
+
+        struct Leaf : Node
+        {
+            Leaf* prev;
+            Leaf* next;
+            alignas(key_t) unsigned char key_storage[LEAF_CAP * sizeof(key_t)];
+            alignas(value_t) unsigned char value_storage[LEAF_CAP * sizeof(value_t)];
+
+            Leaf()
+            :Node(true), prev(nullptr), next(nullptr)
+            {}
+
+            key_t* keys() { return reinterpret_cast<key_t*>(key_storage); }
+            const key_t* keys() const { return reinterpret_cast<const key_t*>(key_storage); }
+            value_t* values() { return reinterpret_cast<value_t*>(value_storage); }
+            const value_t* values() const { return reinterpret_cast<const value_t*>(value_storage); }
+        };
+
+        struct Inner : Node
+        {
+            Node* children[INNER_CAP + 1];
+            alignas(key_t) unsigned char key_storage[INNER_CAP * sizeof(key_t)];
+
+            Inner()
+            :Node(false)
+            {}
+
+            key_t* keys() { return reinterpret_cast<key_t*>(key_storage); }
+            const key_t* keys() const { return reinterpret_cast<const key_t*>(key_storage); }
+        };
+
+        /// Carries a new right sibling, and the key separating it, up the tree.
+        struct Split
+        {
+            Node* right;
+            alignas(key_t) unsigned char storage[sizeof(key_t)];
+
+            Split()
+            :right(nullptr)
+            {}
+
+            key_t& key() { return *reinterpret_cast<key_t*>(storage); }
+        };
+
+        Node* root;
+        /// The first and last leaves, in key order.
+        Leaf* head;
+        Leaf* tail;
+        size_t _size;
+
+        /* The node arrays are raw storage. These helpers construct, move,
+         * and destroy elements in them, using memmove for types which
+         * allow it. */
+
+        /** Move n live elements from src into raw dst, leaving src raw. */
+        template<typename T>
+        static void relocate(T* dst, T* src, size_t n)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                if(n > 0)
+                {
+                    memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                }
+            }
+            else
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    new (dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+        }
+
+        /** Open a raw slot at pos, in an array of count live elements. */
+        template<typename T>
+        static void open_hole(T* arr, size_t count, size_t pos)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                memmove(static_cast<void*>(arr + pos + 1),
+                        static_cast<const void*>(arr + pos), (count - pos) * sizeof(T));
+            }
+            else
+            {
+                if(pos == count)
+                {
+                    return;
+                }
+                new (arr + count) T(std::move(arr[count - 1]));
+                for(size_t i = count - 1; i > pos; --i)
+                {
+                    arr[i] = std::move(arr[i - 1]);
+                }
+                arr[pos].~T();
+            }
+        }
+
+        /** Close the raw slot at pos, in an array of count slots. */
+        template<typename T>
+        static void close_hole(T* arr, size_t count, size_t pos)
+        {
+            if constexpr(std::is_trivially_copyable<T>::value)
+            {
+                memmove(static_cast<void*>(arr + pos),
+                        static_cast<const void*>(arr + pos + 1), (count - pos - 1) * sizeof(T));
+            }
+            else
+            {
+                if(pos + 1 == count)
+                {
+                    return;
+                }
+                new (arr + pos) T(std::move(arr[pos + 1]));
+                for(size_t i = pos + 1; i < count - 1; ++i)
+                {
+                    arr[i] = std::move(arr[i + 1]);
+                }
+                arr[count - 1].~T();
+            }
+        }
+
+        /** Destroy the element at pos, in an array of count live elements. */
+        template<typename T>
+        static void erase_at(T* arr, size_t count, size_t pos)
+        {
+            arr[pos].~T();
+            close_hole(arr, count, pos);
+        }
+
+        template<typename T>
+        static void destroy(T* arr, size_t n)
+        {
+            if constexpr(!std::is_trivially_destructible<T>::value)
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    arr[i].~T();
+                }
+            }
+        }
+
+        /** Count the keys less than (or, if or_equal, not greater than) the
+          * given key. Since keys are sorted, that is also the index of the
+          * lower (or upper) bound. */
+        template<bool or_equal, typename K>
+        static size_t count_before(const key_t* keys, size_t n, const K& key)
+        {
+            if constexpr(std::is_same<K, key_t>::value && std::is_arithmetic<key_t>::value)
+            {
+                size_t i = 0;
+                size_t count = 0;
+#if defined(__SSE2__)
+                if constexpr(std::is_integral<key_t>::value && sizeof(key_t) == 4)
+                {
+                    // Flipping the sign bit lets a signed compare order unsigned keys.
+                    const __m128i flip = _mm_set1_epi32(
+                        std::is_signed<key_t>::value ? 0 : INT32_MIN);
+                    const __m128i target = _mm_xor_si128(
+                        _mm_set1_epi32(static_cast<int32_t>(key)), flip);
+                    __m128i acc = _mm_setzero_si128();
+                    for(; i + 4 <= n; i += 4)
+                    {
+                        __m128i v = _mm_xor_si128(_mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(keys + i)), flip);
+                        // Matching lanes are -1, so subtracting counts them.
+                        acc = _mm_sub_epi32(acc, or_equal
+                            ? _mm_cmpgt_epi32(v, target)
+                            : _mm_cmpgt_epi32(target, v));
+                    }
+                    int32_t lanes[4];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+                    count = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+                    // For or_equal, we counted the greater keys instead.
+                    if(or_equal)
+                    {
+                        count = i - count;
+                    }
+                }
+#endif
+                // A branchless scan, which the compiler may vectorize itself.
+                for(; i < n; ++i)
+                {
+                    count += or_equal ? !(key < keys[i]) : (keys[i] < key);
+                }
+                return count;
+            }
+            else
+            {
+                size_t low = 0;
+                size_t high = n;
+                while(low < high)
+                {
+                    size_t mid = (low + high) / 2;
+                    if(or_equal ? !(key < keys[mid]) : (keys[mid] < key))
+                    {
+                        low = mid + 1;
+                    }
+                    else
+                    {
+                        high = mid;
+                    }
+                }
+                return low;
+            }
+        }
+
+        /** \return the index of the first key not less than the given key */
+        template<typename K>
+        static size_t lower(const key_t* keys, size_t n, const K& key)
+        {
+            return count_before<false>(keys, n, key);
+        }
+
+        /** \return the index of the first key greater than the given key */
+        template<typename K>
+        static size_t upper(const key_t* keys, size_t n, const K& key)
+        {
+            return count_before<true>(keys, n, key);
+        }
+
+        /** \return the leaf whose range covers the given key */
+        template<typename K>
+        Leaf* find_leaf(const K& key) const
+        {
+            Node* node = root;
+            while(!node->leaf)
+            {
+                Inner* inner = static_cast<Inner*>(node);
+                node = inner->children[upper(inner->keys(), inner->count, key)];
+            }
+            return static_cast<Leaf*>(node);
+        }
+
+        /** Move the upper half of a full leaf into a new leaf after it.
+          * \return the new leaf */
+        Leaf* split_leaf(Leaf* leaf)
+        {
+            Leaf* right = new Leaf();
+            size_t keep = LEAF_CAP / 2;
+            relocate(right->keys(), leaf->keys() + keep, LEAF_CAP - keep);
+            relocate(right->values(), leaf->values() + keep, LEAF_CAP - keep);
+            right->count = static_cast<uint16_t>(LEAF_CAP - keep);
+            leaf->count = static_cast<uint16_t>(keep);
+
+            right->prev = leaf;
+            right->next = leaf->next;
+            if(leaf->next != nullptr)
+            {
+                leaf->next->prev = right;
+            }
+            else
+            {
+                tail = right;
+            }
+            leaf->next = right;
+            return right;
+        }
+
+        /** Move the upper half of a full inner node into a new node, and its
+          * middle key into the split. */
+        void split_inner(Inner* inner, Split& split)
+        {
+            Inner* right = new Inner();
+            size_t mid = INNER_CAP / 2;
+            new (split.storage) key_t(std::move(inner->keys()[mid]));
+            inner->keys()[mid].~key_t();
+            relocate(right->keys(), inner->keys() + mid + 1, INNER_CAP - mid - 1);
+            relocate(right->children, inner->children + mid + 1, INNER_CAP - mid);
+            right->count = static_cast<uint16_t>(INNER_CAP - mid - 1);
+            inner->count = static_cast<uint16_t>(mid);
+            split.right = right;
+        }
+
+        /** Insert the key, unless it exists, constructing its value from
+          * the arguments. If the node splits, the split is filled in.
+          * \return the value with that key, and whether it was inserted */
+        template<typename P, typename K, typename... Args>
+        std::pair<value_t*, bool> insert_into(Node* node, Split& split,
+            const P& probe, K&& key, Args&&... args)
+        {
+            if(node->leaf)
+            {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                size_t pos = lower(leaf->keys(), leaf->count, probe);
+                if(pos < leaf->count && !(probe < leaf->keys()[pos]))
+                {
+                    return std::pair<value_t*, bool>(leaf->values() + pos, false);
+                }
+
+                // Build the element before changing anything, in case it throws.
+                key_t new_key(std::forward<K>(key));
+                value_t new_value(std::forward<Args>(args)...);
+
+                if(leaf->count == LEAF_CAP)
+                {
+                    Leaf* right = split_leaf(leaf);
+                    // A new key at the very end of the left half stays there,
+                    // so the right leaf's first key is unchanged.
+                    if(pos > leaf->count)
+                    {
+                        pos -= leaf->count;
+                        leaf = right;
+                    }
+                    split.right = right;
+                    new (split.storage) key_t(right->keys()[0]);
+                }
+
+                open_hole(leaf->keys(), leaf->count, pos);
+                new (leaf->keys() + pos) key_t(std::move(new_key));
+                open_hole(leaf->values(), leaf->count, pos);
+                new (leaf->values() + pos) value_t(std::move(new_value));
+                ++leaf->count;
+                ++_size;
+                return std::pair<value_t*, bool>(leaf->values() + pos, true);
+            }
+
+            Inner* inner = static_cast<Inner*>(node);
+            size_t index = upper(inner->keys(), inner->count, probe);
+            Split child_split;
+            std::pair<value_t*, bool> result = insert_into(inner->children[index],
+                child_split, probe, std::forward<K>(key), std::forward<Args>(args)...);
+            if(child_split.right == nullptr)
+            {
+                return result;
+            }
+
+            if(inner->count == INNER_CAP)
+            {
+                split_inner(inner, split);
+                if(index > inner->count)
+                {
+                    index -= inner->count + 1;
+                    inner = static_cast<Inner*>(split.right);
+                }
+            }
+            open_hole(inner->keys(), inner->count, index);
+            new (inner->keys() + index) key_t(std::move(child_split.key()));
+            child_split.key().~key_t();
+            open_hole(inner->children, inner->count + 1, index + 1);
+            inner->children[index + 1] = child_split.right;
+            ++inner->count;
+            return result;
+        }
+
+        /** Insert the key, unless it exists, growing a new root if needed. */
+        template<typename K, typename... Args>
+        std::pair<value_t*, bool> emplace_key(K&& key, Args&&... args)
+        {
+            if(root == nullptr)
+            {
+                Leaf* leaf = new Leaf();
+                root = leaf;
+                head = leaf;
+                tail = leaf;
+            }
+            Split split;
+            // The probe only reads the key before it is forwarded on.
+            std::pair<value_t*, bool> result = insert_into(root, split, key,
+                std::forward<K>(key), std::forward<Args>(args)...);
+            if(split.right != nullptr)
+            {
+                Inner* top = new Inner();
+                new (top->keys()) key_t(std::move(split.key()));
+                split.key().~key_t();
+                top->children[0] = root;
+                top->children[1] = split.right;
+                top->count = 1;
+                root = top;
+            }
+            return result;
+        }
+
+        /** Move the last element of the left sibling to the front of
+          * parent->children[index]. */
+        void borrow_left(Inner* parent, size_t index)
+        {
+            Node* child = parent->children[index];
+            Node* left = parent->children[index - 1];
+            size_t last = left->count - 1;
+            if(child->leaf)
+            {
+                Leaf* to = static_cast<Leaf*>(child);
+                Leaf* from = static_cast<Leaf*>(left);
+                open_hole(to->keys(), to->count, 0);
+                relocate(to->keys(), from->keys() + last, 1);
+                open_hole(to->values(), to->count, 0);
+                relocate(to->values(), from->values() + last, 1);
+                parent->keys()[index - 1] = to->keys()[0];
+            }
+            else
+            {
+                Inner* to = static_cast<Inner*>(child);
+                Inner* from = static_cast<Inner*>(left);
+                // The separator comes down, and the sibling's last key goes up.
+                open_hole(to->keys(), to->count, 0);
+                new (to->keys()) key_t(std::move(parent->keys()[index - 1]));
+                open_hole(to->children, to->count + 1, 0);
+                to->children[0] = from->children[last + 1];
+                parent->keys()[index - 1] = std::move(from->keys()[last]);
+                from->keys()[last].~key_t();
+            }
+            --left->count;
+            ++child->count;
+        }
+
+        /** Move the first element of the right sibling to the end of
+          * parent->children[index]. */
+        void borrow_right(Inner* parent, size_t index)
+        {
+            Node* child = parent->children[index];
+            Node* right = parent->children[index + 1];
+            if(child->leaf)
+            {
+                Leaf* to = static_cast<Leaf*>(child);
+                Leaf* from = static_cast<Leaf*>(right);
+                relocate(to->keys() + to->count, from->keys(), 1);
+                close_hole(from->keys(), from->count, 0);
+                relocate(to->values() + to->count, from->values(), 1);
+                close_hole(from->values(), from->count, 0);
+                parent->keys()[index] = from->keys()[0];
+            }
+            else
+            {
+                Inner* to = static_cast<Inner*>(child);
+                Inner* from = static_cast<Inner*>(right);
+                new (to->keys() + to->count) key_t(std::move(parent->keys()[index]));
+                to->children[to->count + 1] = from->children[0];
+                parent->keys()[index] = std::move(from->keys()[0]);
+                erase_at(from->keys(), from->count, 0);
+                close_hole(from->children, from->count + 1, 0);
+            }
+            --right->count;
+            ++child->count;
+        }
+
+        /** Merge parent->children[index + 1] into parent->children[index]. */
+        void merge(Inner* parent, size_t index)
+        {
+            Node* left = parent->children[index];
+            Node* right = parent->children[index + 1];
+            if(left->leaf)
+            {
+                Leaf* to = static_cast<Leaf*>(left);
+                Leaf* from = static_cast<Leaf*>(right);
+                relocate(to->keys() + to->count, from->keys(), from->count);
+                relocate(to->values() + to->count, from->values(), from->count);
+                to->count = static_cast<uint16_t>(to->count + from->count);
+                to->next = from->next;
+                if(from->next != nullptr)
+                {
+                    from->next->prev = to;
+                }
+                else
+                {
+                    tail = to;
+                }
+                delete from;
+            }
+            else
+            {
+                Inner* to = static_cast<Inner*>(left);
+                Inner* from = static_cast<Inner*>(right);
+                new (to->keys() + to->count) key_t(std::move(parent->keys()[index]));
+                relocate(to->keys() + to->count + 1, from->keys(), from->count);
+                relocate(to->children + to->count + 1, from->children, from->count + 1);
+                to->count = static_cast<uint16_t>(to->count + from->count + 1);
+                delete from;
+            }
+            erase_at(parent->keys(), parent->count, index);
+            close_hole(parent->children, parent->count + 1, index + 1);
+            --parent->count;
+        }
+
+        /** Refill parent->children[index], which has too few elements,
+          * from a sibling, or merge it with one. */
+        void rebalance(Inner* parent, size_t index)
+        {
+            Node* child = parent->children[index];
+            size_t min = child->leaf ? LEAF_MIN : INNER_MIN;
+            if(index > 0 && parent->children[index - 1]->count > min)
+            {
+                borrow_left(parent, index);
+            }
+            else if(index < parent->count && parent->children[index + 1]->count > min)
+            {
+                borrow_right(parent, index);
+            }
+            else if(index > 0)
+            {
+                merge(parent, index - 1);
+            }
+            else
+            {
+                merge(parent, index);
+            }
+        }
+
+        /** Remove the key from the subtree.
+          * \return true if the key was found */
+        template<typename K>
+        bool remove_from(Node* node, const K& key)
+        {
+            if(node->leaf)
+            {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                size_t pos = lower(leaf->keys(), leaf->count, key);
+                if(pos == leaf->count || key < leaf->keys()[pos])
+                {
+                    return false;
+                }
+                erase_at(leaf->keys(), leaf->count, pos);
+                erase_at(leaf->values(), leaf->count, pos);
+                --leaf->count;
+                return true;
+            }
+
+            Inner* inner = static_cast<Inner*>(node);
+            size_t index = upper(inner->keys(), inner->count, key);
+            if(!remove_from(inner->children[index], key))
+            {
+                return false;
+            }
+            Node* child = inner->children[index];
+            if(child->count < (child->leaf ? LEAF_MIN : INNER_MIN))
+            {
+                rebalance(inner, index);
+            }
+            return true;
+        }
+
+        /** Destroy a subtree. */
+        static void free_node(Node* node)
+        {
+            if(node->leaf)
+            {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                destroy(leaf->keys(), leaf->count);
+                destroy(leaf->values(), leaf->count);
+                delete leaf;
+            }
+            else
+            {
+                Inner* inner = static_cast<Inner*>(node);
+                for(size_t i = 0; i <= inner->count; ++i)
+                {
+                    free_node(inner->children[i]);
+                }
+                destroy(inner->keys(), inner->count);
+                delete inner;
+            }
+        }
+
+        /** Copy a subtree, chaining its leaves after last. */
+        Node* copy(const Node* node, Leaf*& last)
+        {
+            if(node->leaf)
+            {
+                const Leaf* from = static_cast<const Leaf*>(node);
+                Leaf* leaf = new Leaf();
+                for(size_t i = 0; i < from->count; ++i)
+                {
+                    new (leaf->keys() + i) key_t(from->keys()[i]);
+                    new (leaf->values() + i) value_t(from->values()[i]);
+                }
+                leaf->count = from->count;
+                leaf->prev = last;
+                if(last != nullptr)
+                {
+                    last->next = leaf;
+                }
+                else
+                {
+                    head = leaf;
+                }
+                last = leaf;
+                return leaf;
+            }
+            const Inner* from = static_cast<const Inner*>(node);
+            Inner* inner = new Inner();
+            for(size_t i = 0; i < from->count; ++i)
+            {
+                new (inner->keys() + i) key_t(from->keys()[i]);
+            }
+            for(size_t i = 0; i <= from->count; ++i)
+            {
+                inner->children[i] = copy(from->children[i], last);
+            }
+            inner->count = from->count;
+            return inner;
+        }
+
+        /** \return the smallest key in the subtree */
+        static const key_t& min_key(const Node* node)
+        {
+            while(!node->leaf)
+            {
+                node = static_cast<const Inner*>(node)->children[0];
+            }
+            return static_cast<const Leaf*>(node)->keys()[0];
+        }
+
+    public:
+        /** A key and a reference to its value, as returned by iterators. */
+        template<bool is_const>
+        struct basic_entry
+        {
+            const key_t& key;
+            typename std::conditional<is_const, const value_t&, value_t&>::type value;
+        };
+
+        /** A forward iterator over the elements, in key order. */
+        template<bool is_const>
+        class basic_iterator
+        {
+            friend class FlexBTreeMap;
+
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef basic_entry<is_const> value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef void pointer;
+                typedef basic_entry<is_const> reference;
+
+                basic_iterator()
+                :leaf(nullptr), index(0)
+                {}
+
+                /// Allows converting an iterator to a const_iterator.
+                template<bool other, typename = typename std::enable_if<is_const && !other>::type>
+                // cppcheck-suppress noExplicitConstructor
+                basic_iterator(const basic_iterator<other>& it)
+                :leaf(it.leaf), index(it.index)
+                {}
+
+                const key_t& key() const
+                {
+                    return leaf->keys()[index];
+                }
+
+                typename std::conditional<is_const, const value_t&, value_t&>::type value() const
+                {
+                    return leaf->values()[index];
+                }
+
+                reference operator*() const
+                {
+                    return reference{key(), value()};
+                }
+
+                basic_iterator& operator++()
+                {
+                    if(++index == leaf->count)
+                    {
+                        leaf = leaf->next;
+                        index = 0;
+                    }
+                    return *this;
+                }
+
+                basic_iterator operator++(int)
+                {
+                    basic_iterator old = *this;
+                    ++(*this);
+                    return old;
+                }
+
+                bool operator==(const basic_iterator& rhs) const
+                {
+                    return leaf == rhs.leaf && index == rhs.index;
+                }
+
+                bool operator!=(const basic_iterator& rhs) const
+                {
+                    return !(*this == rhs);
+                }
+
+            private:
+                typedef typename std::conditional<is_const, const Leaf*, Leaf*>::type leaf_ptr;
+
+                basic_iterator(leaf_ptr at, size_t pos)
+                :leaf(at), index(pos)
+                {
+                    // Past the end of a leaf is the start of the next.
+                    if(leaf != nullptr && index == leaf->count)
+                    {
+                        leaf = leaf->next;
+                        index = 0;
+                    }
+                }
+
+                leaf_ptr leaf;
+                size_t index;
+
+                template<bool> friend class basic_iterator;
+        };
+
+        typedef basic_iterator<false> iterator;
+        typedef basic_iterator<true> const_iterator;
+
+        FlexBTreeMap()
+        :root(nullptr), head(nullptr), tail(nullptr), _size(0)
+        {}
+
+        FlexBTreeMap(const FlexBTreeMap& cpy)
+        :root(nullptr), head(nullptr), tail(nullptr), _size(0)
+        {
+            if(cpy.root != nullptr)
+            {
+                Leaf* last = nullptr;
+                root = copy(cpy.root, last);
+                tail = last;
+                _size = cpy._size;
+            }
+        }
+
+        FlexBTreeMap(FlexBTreeMap&& mov)
+        :root(mov.root), head(mov.head), tail(mov.tail), _size(mov._size)
+        {
+            mov.root = nullptr;
+            mov.head = nullptr;
+            mov.tail = nullptr;
+            mov._size = 0;
+        }
+
+        FlexBTreeMap& operator=(FlexBTreeMap rhs)
+        {
+            std::swap(root, rhs.root);
+            std::swap(head, rhs.head);
+            std::swap(tail, rhs.tail);
+            std::swap(_size, rhs._size);
+            return *this;
+        }
+
+        /** Replace the contents of the map with the given elements, building
+          * the tree bottom-up with every node as full as it can be.
+          * \param the first element, which has .first (the key) and .second
+          * \param one past the last element. The keys must be sorted and unique.
+          * \throw std::invalid_argument if the keys aren't sorted and unique */
+        template<typename Iter>
+        void bulk_load(Iter first, Iter last)
+        {
+            clear();
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            if(n == 0)
+            {
+                return;
+            }
+
+            // Spread the elements evenly over the fewest leaves, so none underflow.
+            FlexArray<Node*> level;
+            size_t leaves = (n + LEAF_CAP - 1) / LEAF_CAP;
+            const key_t* previous = nullptr;
+            for(size_t l = 0; l < leaves; ++l)
+            {
+                Leaf* leaf = new Leaf();
+                leaf->prev = tail;
+                if(tail != nullptr)
+                {
+                    tail->next = leaf;
+                }
+                else
+                {
+                    head = leaf;
+                }
+                tail = leaf;
+                Node* node = leaf;
+                level.push(node);
+
+                size_t take = n / leaves + ((l < n % leaves) ? 1 : 0);
+                for(size_t i = 0; i < take; ++i, ++first)
+                {
+                    if(previous != nullptr && !(*previous < first->first))
+                    {
+                        free_leaves();
+                        throw std::invalid_argument("FlexBTreeMap::bulk_load(): keys must be sorted and unique");
+                    }
+                    new (leaf->keys() + i) key_t(first->first);
+                    new (leaf->values() + i) value_t(first->second);
+                    ++leaf->count;
+                    previous = leaf->keys() + i;
+                }
+            }
+            _size = n;
+
+            // Build each level of inner nodes over the one below it.
+            while(level.length() > 1)
+            {
+                FlexArray<Node*> parents;
+                size_t count = level.length();
+                size_t nodes = (count + INNER_CAP) / (INNER_CAP + 1);
+                size_t c = 0;
+                for(size_t p = 0; p < nodes; ++p)
+                {
+                    Inner* inner = new Inner();
+                    inner->children[0] = level[c++];
+                    size_t take = count / nodes + ((p < count % nodes) ? 1 : 0);
+                    for(size_t i = 1; i < take; ++i)
+                    {
+                        Node* child = level[c++];
+                        new (inner->keys() + inner->count) key_t(min_key(child));
+                        inner->children[++inner->count] = child;
+                    }
+                    Node* node = inner;
+                    parents.push(node);
+                }
+                level = parents;
+            }
+            root = level[0];
+        }
+
+        /** Insert the key and value, unless the key already exists.
+          * \param the key
+          * \param the value
+          * \return true if inserted */
+        bool insert(const key_t& key, const value_t& data)
+        {
+            return emplace_key(key, data).second;
+        }
+
+        bool insert(key_t&& key, value_t&& data)
+        {
+            return emplace_key(std::move(key), std::move(data)).second;
+        }
+
+        /** Construct the value from the given arguments, unless the key
+          * already exists, in which case nothing is constructed.
+          * \param the key
+          * \param the arguments to construct the value from
+          * \return the value with that key, and whether it was inserted */
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(const key_t& key, Args&&... args)
+        {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(key_t&& key, Args&&... args)
+        {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        /** Insert the key and value, or assign the value if the key exists.
+          * \param the key
+          * \param the value
+          * \return the value with that key, and whether it was inserted */
+        template<typename M>
+        std::pair<value_t*, bool> insert_or_assign(const key_t& key, M&& data)
+        {
+            value_t* value = find(key);
+            if(value != nullptr)
+            {
+                *value = std::forward<M>(data);
+                return std::pair<value_t*, bool>(value, false);
+            }
+            return emplace_key(key, std::forward<M>(data));
+        }
+
+        /** Access the value with the given key, default-constructing
+          * it first if the key doesn't exist.
+          * \param the key
+          * \return a reference to the value */
+        value_t& operator[](const key_t& key)
+        {
+            return *(emplace_key(key).first);
+        }
+
+        /** Find the value with the given key.
+          * \param the key
+          * \return a pointer to the value, or nullptr if there is none */
+        template<typename K>
+        value_t* find(const K& key)
+        {
+            if(root == nullptr)
+            {
+                return nullptr;
+            }
+            Leaf* leaf = find_leaf(key);
+            size_t pos = lower(leaf->keys(), leaf->count, key);
+            if(pos == leaf->count || key < leaf->keys()[pos])
+            {
+                return nullptr;
+            }
+            return leaf->values() + pos;
+        }
+
+        template<typename K>
+        const value_t* find(const K& key) const
+        {
+            return const_cast<FlexBTreeMap*>(this)->find(key);
+        }
+
+        /** \return true if the given key exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        /** Copy the value with the given key into returnVal.
+          * \param the key
+          * \param the variable to copy the value into
+          * \return true if the key exists */
+        template<typename K>
+        bool retrieve(const K& key, value_t* returnVal) const
+        {
+            const value_t* value = find(key);
+            if(value != nullptr)
+            {
+                *returnVal = *value;
+                return true;
+            }
+            return false;
+        }
+
+        /** Remove the element with the given key.
+          * \param the key
+          * \return true if the key existed */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            if(root == nullptr || !remove_from(root, key))
+            {
+                return false;
+            }
+            --_size;
+            // Shrink the tree when the root runs out of keys.
+            if(root->count == 0)
+            {
+                if(root->leaf)
+                {
+                    delete static_cast<Leaf*>(root);
+                    root = nullptr;
+                    head = nullptr;
+                    tail = nullptr;
+                }
+                else
+                {
+                    Inner* old = static_cast<Inner*>(root);
+                    root = old->children[0];
+                    delete old;
+                }
+            }
+            return true;
+        }
+
+        iterator begin()
+        {
+            return iterator(head, 0);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(head, 0);
+        }
+
+        iterator end()
+        {
+            return iterator();
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator();
+        }
+
+        /** \return an iterator to the first element not less than the key */
+        template<typename K>
+        iterator lower_bound(const K& key)
+        {
+            if(root == nullptr)
+            {
+                return end();
+            }
+            Leaf* leaf = find_leaf(key);
+            return iterator(leaf, lower(leaf->keys(), leaf->count, key));
+        }
+
+        template<typename K>
+        const_iterator lower_bound(const K& key) const
+        {
+            return const_cast<FlexBTreeMap*>(this)->lower_bound(key);
+        }
+
+        /** \return an iterator to the first element greater than the key */
+        template<typename K>
+        iterator upper_bound(const K& key)
+        {
+            if(root == nullptr)
+            {
+                return end();
+            }
+            Leaf* leaf = find_leaf(key);
+            return iterator(leaf, upper(leaf->keys(), leaf->count, key));
+        }
+
+        template<typename K>
+        const_iterator upper_bound(const K& key) const
+        {
+            return const_cast<FlexBTreeMap*>(this)->upper_bound(key);
+        }
+
+        /** Call the visitor with each key and value, in key order.
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            for(const Leaf* leaf = head; leaf != nullptr; leaf = leaf->next)
+            {
+                for(size_t i = 0; i < leaf->count; ++i)
+                {
+                    visitor(leaf->keys()[i], leaf->values()[i]);
+                }
+            }
+        }
+
+        /** Call the visitor with each key and value in [low, high), in key order.
+          * \param the lowest key to visit
+          * \param the key to stop before
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename K1, typename K2, typename Visitor>
+        void for_each_in_range(const K1& low, const K2& high, Visitor visitor) const
+        {
+            if(root == nullptr)
+            {
+                return;
+            }
+            const Leaf* leaf = find_leaf(low);
+            size_t i = lower(leaf->keys(), leaf->count, low);
+            for(; leaf != nullptr; leaf = leaf->next, i = 0)
+            {
+                for(; i < leaf->count; ++i)
+                {
+                    if(!(leaf->keys()[i] < high))
+                    {
+                        return;
+                    }
+                    visitor(leaf->keys()[i], leaf->values()[i]);
+                }
+            }
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return true if there are no elements */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** Remove every element. */
+        void clear()
+        {
+            if(root != nullptr)
+            {
+                free_node(root);
+            }
+            root = nullptr;
+            head = nullptr;
+            tail = nullptr;
+            _size = 0;
+        }
+
+        /** Print each key and value, in key order. */
+        void print() const
+        {
+            for_each([](const key_t& key, const value_t& data)
+            {
+                ioc << key << ": " << data << IOCtrl::endl;
+            });
+        }
+
+        ~FlexBTreeMap()
+        {
+            clear();
+        }
+
+    private:
+        /** Destroy the chain of leaves, when there are no inner nodes yet. */
+        void free_leaves()
+        {
+            while(head != nullptr)
+            {
+                Leaf* next = head->next;
+                free_node(head);
+                head = next;
+            }
+            tail = nullptr;
+            root = nullptr;
+            _size = 0;
+        }
+};
+
+#endif // PAWLIB_FLEXBTREEMAP_HPP
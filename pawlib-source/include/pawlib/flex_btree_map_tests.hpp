@@ -0,0 +1,694 @@
+/** Tests for FlexBTreeMap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXBTREEMAP_TESTS_HPP
+#define PAWLIB_FLEXBTREEMAP_TESTS_HPP
+
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "pawlib/flex_btree_map.hpp"
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** A FlexBTreeMap with four keys per node, so even small tests build
+  * deep trees, and exercise every split, borrow, and merge. */
+typedef FlexBTreeMap<int, int, 16> SmallNodeBTree;
+
+/** Check that a FlexBTreeMap holds exactly the same elements as a std::map.
+  * \param the tree
+  * \param the model
+  * \return true if they match */
+template<typename tree_t, typename key_t, typename value_t>
+bool btree_matches(const tree_t& tree, const std::map<key_t, value_t>& model)
+{
+    if(tree.size() != model.size())
+    {
+        return false;
+    }
+    auto expected = model.begin();
+    for(auto entry : tree)
+    {
+        if(expected == model.end() || !(entry.key == expected->first)
+           || !(entry.value == expected->second))
+        {
+            return false;
+        }
+        ++expected;
+    }
+    return expected == model.end();
+}
+
+// P-tB7101
+class TestFlexBTreeMap_InsertFind : public Test
+{
+    public:
+        TestFlexBTreeMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Insert & Find";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " random keys, and ensure each is found and the elements come out in order.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(1101);
+            std::map<int, int> model;
+            SmallNodeBTree small;
+            FlexBTreeMap<int, int> tree;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = static_cast<int>(rng() % (count * 4)) - count;
+                bool inserted = model.emplace(key, i).second;
+                PL_ASSERT_EQUAL(small.insert(key, i), inserted);
+                PL_ASSERT_EQUAL(tree.insert(key, i), inserted);
+            }
+            PL_ASSERT_TRUE(btree_matches(small, model));
+            PL_ASSERT_TRUE(btree_matches(tree, model));
+
+            for(int key = -count; key < count * 3; ++key)
+            {
+                auto it = model.find(key);
+                int* value = tree.find(key);
+                if(it == model.end())
+                {
+                    PL_ASSERT_TRUE(value == nullptr);
+                    PL_ASSERT_FALSE(small.contains(key));
+                }
+                else
+                {
+                    PL_ASSERT_TRUE(value != nullptr);
+                    PL_ASSERT_EQUAL(*value, it->second);
+                    PL_ASSERT_EQUAL(*small.find(key), it->second);
+                }
+            }
+            return true;
+        }
+
+        ~TestFlexBTreeMap_InsertFind(){}
+
+    private:
+        static const int count = 5000;
+};
+
+// P-tB7102
+class TestFlexBTreeMap_Remove : public Test
+{
+    public:
+        TestFlexBTreeMap_Remove(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Mix random inserts and removals, checking against std::map, then remove everything.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(1102);
+            std::map<int, int> model;
+            SmallNodeBTree tree;
+            for(int i = 0; i < rounds; ++i)
+            {
+                int key = static_cast<int>(rng() % 1000);
+                if(rng() % 3 == 0)
+                {
+                    PL_ASSERT_EQUAL(tree.remove(key), model.erase(key) == 1);
+                }
+                else
+                {
+                    PL_ASSERT_EQUAL(tree.insert(key, i), model.emplace(key, i).second);
+                }
+                if(i % 1000 == 0)
+                {
+                    PL_ASSERT_TRUE(btree_matches(tree, model));
+                }
+            }
+            PL_ASSERT_TRUE(btree_matches(tree, model));
+
+            // Remove in order from the front, which always borrows or merges left.
+            while(!model.empty())
+            {
+                PL_ASSERT_TRUE(tree.remove(model.begin()->first));
+                model.erase(model.begin());
+            }
+            PL_ASSERT_TRUE(tree.empty());
+            PL_ASSERT_TRUE(tree.begin() == tree.end());
+            PL_ASSERT_FALSE(tree.remove(5));
+            // The tree is still usable once empty.
+            tree[5] = 25;
+            PL_ASSERT_EQUAL(*tree.find(5), 25);
+            return true;
+        }
+
+        ~TestFlexBTreeMap_Remove(){}
+
+    private:
+        static const int rounds = 20000;
+};
+
+// P-tB7103
+class TestFlexBTreeMap_Range : public Test
+{
+    public:
+        TestFlexBTreeMap_Range(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Ranges";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure lower_bound(), upper_bound(), and for_each_in_range() match std::map across leaf boundaries.";
+        }
+
+        bool run() override
+        {
+            std::map<int, int> model;
+            SmallNodeBTree tree;
+            // Even keys only, so odd bounds fall between elements.
+            for(int i = 0; i < 500; ++i)
+            {
+                model[i * 2] = i;
+                tree[i * 2] = i;
+            }
+
+            for(int bound = -3; bound < 1003; ++bound)
+            {
+                auto lower = tree.lower_bound(bound);
+                auto model_lower = model.lower_bound(bound);
+                PL_ASSERT_EQUAL(lower == tree.end(), model_lower == model.end());
+                if(model_lower != model.end())
+                {
+                    PL_ASSERT_EQUAL(lower.key(), model_lower->first);
+                }
+
+                auto upper = tree.upper_bound(bound);
+                auto model_upper = model.upper_bound(bound);
+                PL_ASSERT_EQUAL(upper == tree.end(), model_upper == model.end());
+                if(model_upper != model.end())
+                {
+                    PL_ASSERT_EQUAL(upper.key(), model_upper->first);
+                }
+            }
+
+            int visited = 0;
+            int sum = 0;
+            tree.for_each_in_range(101, 301, [&](const int& key, const int& value)
+            {
+                ++visited;
+                sum += value;
+                (void)key;
+            });
+            // Keys 102 through 300, or values 51 through 150.
+            PL_ASSERT_EQUAL(visited, 100);
+            PL_ASSERT_EQUAL(sum, 10050);
+
+            // Iterators can write through to the values.
+            for(auto entry : tree)
+            {
+                entry.value = -entry.key;
+            }
+            PL_ASSERT_EQUAL(*tree.find(998), -998);
+
+            const SmallNodeBTree& view = tree;
+            SmallNodeBTree::const_iterator it = view.lower_bound(997);
+            PL_ASSERT_EQUAL((*it).key, 998);
+            ++it;
+            PL_ASSERT_TRUE(it == view.end());
+            return true;
+        }
+
+        ~TestFlexBTreeMap_Range(){}
+};
+
+// P-tB7104
+class TestFlexBTreeMap_BulkLoad : public Test
+{
+    public:
+        TestFlexBTreeMap_BulkLoad(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Bulk Load";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Bulk load sorted elements of every count up to 300, then insert and remove from the result. Ensure unsorted input is rejected.";
+        }
+
+        bool run() override
+        {
+            for(int n = 0; n <= 300; ++n)
+            {
+                std::vector<std::pair<int, int>> input;
+                std::map<int, int> model;
+                for(int i = 0; i < n; ++i)
+                {
+                    input.emplace_back(i * 3, i);
+                    model[i * 3] = i;
+                }
+                SmallNodeBTree tree;
+                tree.bulk_load(input.begin(), input.end());
+                PL_ASSERT_TRUE(btree_matches(tree, model));
+
+                // The loaded tree is balanced enough to keep changing.
+                for(int i = 0; i < n; i += 2)
+                {
+                    tree.insert(i * 3 + 1, -i);
+                    model[i * 3 + 1] = -i;
+                    tree.remove(i * 3);
+                    model.erase(i * 3);
+                }
+                PL_ASSERT_TRUE(btree_matches(tree, model));
+            }
+
+            std::vector<std::pair<int, int>> unsorted = {{1, 1}, {3, 3}, {2, 2}};
+            SmallNodeBTree tree;
+            tree[7] = 7;
+            bool threw = false;
+            try
+            {
+                tree.bulk_load(unsorted.begin(), unsorted.end());
+            }
+            catch(std::invalid_argument&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            PL_ASSERT_TRUE(tree.empty());
+            return true;
+        }
+
+        ~TestFlexBTreeMap_BulkLoad(){}
+};
+
+// P-tB7105
+class TestFlexBTreeMap_Strings : public Test
+{
+    public:
+        TestFlexBTreeMap_Strings(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Onestring Keys";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Store onestring keys and values, look them up by const char*, and copy the map.";
+        }
+
+        bool run() override
+        {
+            std::map<onestring, onestring> model;
+            FlexBTreeMap<onestring, onestring, 64> tree;
+            for(int i = 0; i < 400; ++i)
+            {
+                onestring key = stdutils::itos((i * 7919) % 400).c_str();
+                onestring value = stdutils::itos(i).c_str();
+                tree.insert(key, value);
+                model.emplace(key, value);
+            }
+            for(int i = 0; i < 400; i += 3)
+            {
+                onestring key = stdutils::itos(i).c_str();
+                tree.remove(key);
+                model.erase(key);
+            }
+            PL_ASSERT_TRUE(btree_matches(tree, model));
+
+            PL_ASSERT_TRUE(tree.contains("1"));
+            PL_ASSERT_FALSE(tree.contains("3"));
+            onestring out;
+            PL_ASSERT_TRUE(tree.retrieve("10", &out));
+            PL_ASSERT_EQUAL(out, model.find("10")->second);
+
+            FlexBTreeMap<onestring, onestring, 64> copy(tree);
+            tree.clear();
+            PL_ASSERT_TRUE(btree_matches(copy, model));
+            return true;
+        }
+
+        ~TestFlexBTreeMap_Strings(){}
+};
+
+// P-tB7106
+class TestFlexBTreeMap_Emplace : public Test
+{
+    public:
+        TestFlexBTreeMap_Emplace(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Emplace";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Store move-only values with try_emplace(), insert_or_assign(), and operator[].";
+        }
+
+        bool run() override
+        {
+            FlexBTreeMap<int, std::unique_ptr<int>, 16> tree;
+            for(int i = 0; i < 100; ++i)
+            {
+                PL_ASSERT_TRUE(tree.try_emplace(i, new int(i)).second);
+            }
+            std::unique_ptr<int> spare(new int(-1));
+            PL_ASSERT_FALSE(tree.try_emplace(0, std::move(spare)).second);
+            PL_ASSERT_TRUE(spare != nullptr);
+
+            PL_ASSERT_FALSE(tree.insert_or_assign(1, std::unique_ptr<int>(new int(100))).second);
+            PL_ASSERT_EQUAL(**(tree.find(1)), 100);
+            PL_ASSERT_TRUE(tree[200] == nullptr);
+
+            for(int i = 2; i < 100; ++i)
+            {
+                PL_ASSERT_EQUAL(**(tree.find(i)), i);
+            }
+            return true;
+        }
+
+        ~TestFlexBTreeMap_Emplace(){}
+};
+
+/** Fills a map with the benchmark keys, 0, 2, 4..., in a scrambled order.
+  * \param the map to fill, with an insert(key, value) function
+  * \param the number of keys */
+template<typename map_t>
+void btree_bench_fill(map_t& map, int count)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        int key = static_cast<int>((static_cast<unsigned int>(i) * 7919u) % static_cast<unsigned int>(count));
+        map.insert(key * 2, key);
+    }
+}
+
+/** A std::map with the insert(key, value) signature of the PawLIB maps. */
+class BTreeBenchStdMap : public std::map<int, int>
+{
+    public:
+        bool insert(int key, int value)
+        {
+            return emplace(key, value).second;
+        }
+
+        bool contains(int key) const
+        {
+            return find(key) != end();
+        }
+};
+
+// P-tB7107*, P-tB7108*
+template<typename map_t>
+class TestFlexBTreeMap_LookupOther : public Test
+{
+    public:
+        explicit TestFlexBTreeMap_LookupOther(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + " present and missing keys in a " + name + ".";
+        }
+
+        bool pre() override
+        {
+            btree_bench_fill(map, count);
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < count * 2; ++i)
+            {
+                found += static_cast<int>(map.contains(i * 7 % (count * 2)));
+            }
+            return found == count;
+        }
+
+        ~TestFlexBTreeMap_LookupOther(){}
+
+    private:
+        static const int count = 100000;
+        testdoc_t name;
+        map_t map;
+
+};
+
+// P-tB7107, P-tB7108
+class TestFlexBTreeMap_Lookup : public Test
+{
+    public:
+        TestFlexBTreeMap_Lookup(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + " present and missing keys in a FlexBTreeMap.";
+        }
+
+        bool pre() override
+        {
+            btree_bench_fill(map, count);
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < count * 2; ++i)
+            {
+                found += static_cast<int>(map.contains(i * 7 % (count * 2)));
+            }
+            return found == count;
+        }
+
+        ~TestFlexBTreeMap_Lookup(){}
+
+    private:
+        static const int count = 100000;
+        FlexBTreeMap<int, int> map;
+};
+
+// P-tB7109*
+class TestFlexBTreeMap_ScanStd : public Test
+{
+    public:
+        TestFlexBTreeMap_ScanStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::map: Ordered Scan";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sum the values of all " + stdutils::itos(count) + " elements of a std::map, in order.";
+        }
+
+        bool pre() override
+        {
+            btree_bench_fill(map, count);
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(auto& element : map)
+            {
+                sum += element.second;
+            }
+            return sum > 0;
+        }
+
+        ~TestFlexBTreeMap_ScanStd(){}
+
+    private:
+        static const int count = 100000;
+        BTreeBenchStdMap map;
+};
+
+// P-tB7109
+class TestFlexBTreeMap_Scan : public Test
+{
+    public:
+        TestFlexBTreeMap_Scan(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Ordered Scan";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sum the values of all " + stdutils::itos(count) + " elements of a FlexBTreeMap, in order.";
+        }
+
+        bool pre() override
+        {
+            btree_bench_fill(map, count);
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            map.for_each([&sum](const int&, const int& value){ sum += value; });
+            return sum > 0;
+        }
+
+        ~TestFlexBTreeMap_Scan(){}
+
+    private:
+        static const int count = 100000;
+        FlexBTreeMap<int, int> map;
+};
+
+// P-tB7110*
+class TestFlexBTreeMap_InsertStd : public Test
+{
+    public:
+        TestFlexBTreeMap_InsertStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::map: Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " scrambled keys into an empty std::map.";
+        }
+
+        bool run() override
+        {
+            BTreeBenchStdMap map;
+            btree_bench_fill(map, count);
+            return map.size() == static_cast<size_t>(count);
+        }
+
+        ~TestFlexBTreeMap_InsertStd(){}
+
+    private:
+        static const int count = 10000;
+};
+
+// P-tB7110
+class TestFlexBTreeMap_Insert : public Test
+{
+    public:
+        TestFlexBTreeMap_Insert(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexBTreeMap: Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " scrambled keys into an empty FlexBTreeMap.";
+        }
+
+        bool run() override
+        {
+            FlexBTreeMap<int, int> map;
+            btree_bench_fill(map, count);
+            return map.size() == static_cast<size_t>(count);
+        }
+
+        ~TestFlexBTreeMap_Insert(){}
+
+    private:
+        static const int count = 10000;
+};
+
+class TestSuite_FlexBTreeMap : public TestSuite
+{
+    public:
+        explicit TestSuite_FlexBTreeMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: FlexBTreeMap Tests";
+        }
+
+        ~TestSuite_FlexBTreeMap(){}
+};
+
+#endif // PAWLIB_FLEXBTREEMAP_TESTS_HPP
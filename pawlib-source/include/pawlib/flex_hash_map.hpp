@@ -0,0 +1,282 @@
+/** FlexHashMap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An unordered map, stored flat in an open-addressing hash table.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXHASHMAP_HPP
+#define PAWLIB_FLEXHASHMAP_HPP
+
+#include <utility>
+
+#include "pawlib/flex_hash_table.hpp"
+
+/** An unordered map, similar to std::unordered_map, stored in a
+  * FlexHashTable. Lookups take any key type which hash_t can hash
+  * consistently with the stored keys, and equal_t can compare against them,
+  * so (for example) onestring keys may be looked up by const char*.
+  * Pointers to values remain valid until the map grows or is rehashed.
+  * \param the key type
+  * \param the value type
+  * \param the hash function type
+  * \param the key equality type */
+template<typename key_t, typename value_t,
+         typename hash_t = FlexHash, typename equal_t = FlexEqual>
+class FlexHashMap
+{
+    private:
+        struct Slot
+        {
+            key_t key;
+            value_t data;
+
+            /// Constructs the key and the value in place.
+            template<typename K, typename... Args>
+            explicit Slot(K&& theKey, Args&&... args)
+            :key(std::forward<K>(theKey)), data(std::forward<Args>(args)...)
+            {}
+
+            Slot(const Slot&) = default;
+            Slot(Slot&&) = default;
+        };
+
+        struct KeyOf
+        {
+            static const key_t& get(const Slot& slot)
+            {
+                return slot.key;
+            }
+        };
+
+        FlexHashTable<Slot, KeyOf, hash_t, equal_t> table;
+
+        template<typename K, typename... Args>
+        std::pair<value_t*, bool> emplace_key(K&& key, Args&&... args)
+        {
+            bool inserted = false;
+            Slot* slot = table.insert(key, inserted,
+                std::forward<K>(key), std::forward<Args>(args)...);
+            return std::pair<value_t*, bool>(&(slot->data), inserted);
+        }
+
+        template<typename K, typename M>
+        std::pair<value_t*, bool> assign_key(K&& key, M&& data)
+        {
+            Slot* slot = table.find(key);
+            if(slot != nullptr)
+            {
+                slot->data = std::forward<M>(data);
+                return std::pair<value_t*, bool>(&(slot->data), false);
+            }
+            return emplace_key(std::forward<K>(key), std::forward<M>(data));
+        }
+
+    public:
+        FlexHashMap() = default;
+
+        /** Create a map with room for the given number of elements.
+          * \param the number of elements to reserve room for */
+        explicit FlexHashMap(size_t count)
+        {
+            table.reserve(count);
+        }
+
+        /** Insert the key and value, unless the key already exists.
+          * \param the key
+          * \param the value
+          * \return true if inserted */
+        bool insert(const key_t& key, const value_t& data)
+        {
+            return emplace_key(key, data).second;
+        }
+
+        bool insert(key_t&& key, value_t&& data)
+        {
+            return emplace_key(std::move(key), std::move(data)).second;
+        }
+
+        /** Construct the value in place from the given arguments, unless
+          * the key already exists, in which case nothing is constructed.
+          * \param the key
+          * \param the arguments to construct the value from
+          * \return the value with that key, and whether it was inserted */
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(const key_t& key, Args&&... args)
+        {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<value_t*, bool> try_emplace(key_t&& key, Args&&... args)
+        {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        /** Insert the key and value, or assign the value if the key exists.
+          * \param the key
+          * \param the value
+          * \return the value with that key, and whether it was inserted */
+        template<typename M>
+        std::pair<value_t*, bool> insert_or_assign(const key_t& key, M&& data)
+        {
+            return assign_key(key, std::forward<M>(data));
+        }
+
+        template<typename M>
+        std::pair<value_t*, bool> insert_or_assign(key_t&& key, M&& data)
+        {
+            return assign_key(std::move(key), std::forward<M>(data));
+        }
+
+        /** Access the value with the given key, default-constructing
+          * it first if the key doesn't exist.
+          * \param the key
+          * \return a reference to the value */
+        value_t& operator[](const key_t& key)
+        {
+            return *(emplace_key(key).first);
+        }
+
+        value_t& operator[](key_t&& key)
+        {
+            return *(emplace_key(std::move(key)).first);
+        }
+
+        /** Find the value with the given key.
+          * \param the key
+          * \return a pointer to the value, or nullptr if there is none */
+        template<typename K>
+        value_t* find(const K& key)
+        {
+            Slot* slot = table.find(key);
+            return slot ? &(slot->data) : nullptr;
+        }
+
+        template<typename K>
+        const value_t* find(const K& key) const
+        {
+            const Slot* slot = table.find(key);
+            return slot ? &(slot->data) : nullptr;
+        }
+
+        /** \return true if the given key exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return table.find(key) != nullptr;
+        }
+
+        /** Remove the element with the given key. This leaves a tombstone
+          * behind, unless it can tell that no other key probed past it.
+          * \param the key
+          * \return true if the key existed */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            return table.remove(key);
+        }
+
+        /** Make room for the given number of elements, so that inserting
+          * them doesn't grow the map.
+          * \param the number of elements */
+        void reserve(size_t count)
+        {
+            table.reserve(count);
+        }
+
+        /** Rebuild the map, dropping tombstones, at the smallest capacity
+          * holding both the current elements and the given number.
+          * \param the number of elements to make room for */
+        void rehash(size_t count = 0)
+        {
+            table.rehash(count);
+        }
+
+        /** Call the visitor with each key and value, in no particular order.
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            auto each = [&visitor](const Slot& slot)
+            {
+                visitor(static_cast<const key_t&>(slot.key), slot.data);
+            };
+            table.for_each(each);
+        }
+
+        /** Call the visitor with each key and value, in no particular order,
+          * allowing it to change the values.
+          * \param the visitor, which takes (const key_t&, value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor)
+        {
+            auto each = [&visitor](Slot& slot)
+            {
+                visitor(static_cast<const key_t&>(slot.key), slot.data);
+            };
+            table.for_each(each);
+        }
+
+        /** Remove every element, keeping the memory. */
+        void clear()
+        {
+            table.clear();
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return table.size();
+        }
+
+        /** \return true if there are no elements */
+        bool empty() const
+        {
+            return table.size() == 0;
+        }
+
+        /** \return the number of slots in the table */
+        size_t capacity() const
+        {
+            return table.capacity();
+        }
+};
+
+#endif // PAWLIB_FLEXHASHMAP_HPP
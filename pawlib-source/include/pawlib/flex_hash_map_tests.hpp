@@ -0,0 +1,707 @@
+/** Tests for FlexHashMap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXHASHMAP_TESTS_HPP
+#define PAWLIB_FLEXHASHMAP_TESTS_HPP
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "pawlib/flex_hash_map.hpp"
+#include "pawlib/flex_hash_set.hpp"
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Scrambles the sequence 0, 1, 2... into distinct benchmark keys.
+  * \param the index of the key
+  * \return the key */
+inline int hash_bench_key(int i)
+{
+    return static_cast<int>(static_cast<unsigned int>(i) * 2654435761u);
+}
+
+// P-tB7001
+class TestFlexHashMap_InsertFind : public Test
+{
+    public:
+        TestFlexHashMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Insert & Find";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " elements, growing the table from empty, and find each of them.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                PL_ASSERT_TRUE(map.insert(hash_bench_key(i), i));
+            }
+            // Duplicate keys are rejected, and the value is kept.
+            PL_ASSERT_FALSE(map.insert(hash_bench_key(7), 0));
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(count));
+            // The table never fills past seven-eighths.
+            PL_ASSERT_LESS_EQUAL(map.size(), map.capacity() - map.capacity() / 8);
+
+            for(int i = 0; i < count; ++i)
+            {
+                int* value = map.find(hash_bench_key(i));
+                PL_ASSERT_TRUE(value != nullptr);
+                PL_ASSERT_EQUAL(*value, i);
+            }
+            PL_ASSERT_TRUE(map.find(hash_bench_key(count)) == nullptr);
+
+            int visited = 0;
+            map.for_each([&visited](const int&, int&){ ++visited; });
+            PL_ASSERT_EQUAL(visited, count);
+
+            // Through a const map, the visitor only sees const values.
+            const FlexHashMap<int, int>& constMap = map;
+            bool allConst = true;
+            constMap.for_each([&allConst](const int&, auto& value)
+            {
+                allConst = allConst && std::is_const<std::remove_reference_t<decltype(value)>>::value;
+            });
+            PL_ASSERT_TRUE(allConst);
+            return true;
+        }
+
+        ~TestFlexHashMap_InsertFind(){}
+
+    private:
+        static const int count = 10000;
+};
+
+// P-tB7002
+class TestFlexHashMap_Remove : public Test
+{
+    public:
+        TestFlexHashMap_Remove(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Remove & Rehash";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Churn inserts and removals through a reserved map, and ensure tombstones neither break lookups nor grow the table.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, int> map(live);
+            size_t capacity = map.capacity();
+
+            // Keep a sliding window of live keys, so removals leave tombstones.
+            for(int i = 0; i < rounds; ++i)
+            {
+                map.insert(i, i);
+                if(i >= live)
+                {
+                    PL_ASSERT_TRUE(map.remove(i - live));
+                }
+            }
+            PL_ASSERT_FALSE(map.remove(0));
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(live));
+            // Tombstones were reused or purged in place.
+            PL_ASSERT_EQUAL(map.capacity(), capacity);
+
+            for(int i = 0; i < rounds; ++i)
+            {
+                PL_ASSERT_EQUAL(map.contains(i), (i >= rounds - live));
+            }
+
+            map.clear();
+            PL_ASSERT_TRUE(map.empty());
+            map.rehash();
+            PL_ASSERT_EQUAL(map.capacity(), 0u);
+            // The map is still usable after releasing its memory.
+            map[5] = 25;
+            PL_ASSERT_EQUAL(*map.find(5), 25);
+            return true;
+        }
+
+        ~TestFlexHashMap_Remove(){}
+
+    private:
+        static const int live = 90;
+        static const int rounds = 20000;
+};
+
+// P-tB7003
+class TestFlexHashMap_Heterogeneous : public Test
+{
+    public:
+        TestFlexHashMap_Heterogeneous(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Heterogeneous Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up and remove onestring keys by const char* and std::string.";
+        }
+
+        bool run() override
+        {
+            FlexHash hash;
+            onestring unicode = "Ünïcødé";
+            PL_ASSERT_EQUAL(hash(unicode), hash("Ünïcødé"));
+            PL_ASSERT_EQUAL(hash(onestring("cat")), hash(std::string("cat")));
+
+            FlexHashMap<onestring, int> map;
+            map.insert("cat", 1);
+            map.insert(unicode, 2);
+            map["mouse"] = 3;
+
+            PL_ASSERT_EQUAL(*map.find("cat"), 1);
+            PL_ASSERT_EQUAL(*map.find("Ünïcødé"), 2);
+            PL_ASSERT_EQUAL(*map.find(std::string("mouse")), 3);
+            PL_ASSERT_TRUE(map.find("horse") == nullptr);
+
+            PL_ASSERT_TRUE(map.remove("cat"));
+            PL_ASSERT_FALSE(map.contains("cat"));
+            return true;
+        }
+
+        ~TestFlexHashMap_Heterogeneous(){}
+};
+
+// P-tB7004
+class TestFlexHashMap_Emplace : public Test
+{
+    public:
+        TestFlexHashMap_Emplace(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Emplace";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Store move-only values with try_emplace(), insert_or_assign() and operator[], across several rehashes.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, std::unique_ptr<int>> map;
+            for(int i = 0; i < count; ++i)
+            {
+                auto result = map.try_emplace(i, new int(i));
+                PL_ASSERT_TRUE(result.second);
+            }
+
+            // An existing key leaves the argument alone.
+            std::unique_ptr<int> spare(new int(-1));
+            auto result = map.try_emplace(0, std::move(spare));
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_TRUE(spare != nullptr);
+
+            result = map.insert_or_assign(1, std::unique_ptr<int>(new int(100)));
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_EQUAL(**(map.find(1)), 100);
+
+            PL_ASSERT_TRUE(map[count + 1] == nullptr);
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(count + 1));
+            for(int i = 2; i < count; ++i)
+            {
+                PL_ASSERT_EQUAL(**(map.find(i)), i);
+            }
+            return true;
+        }
+
+        ~TestFlexHashMap_Emplace(){}
+
+    private:
+        static const int count = 200;
+};
+
+// P-tB7005
+class TestFlexHashMap_Copy : public Test
+{
+    public:
+        TestFlexHashMap_Copy(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Copy & Move";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a copied map is independent of the original, and a moved map keeps its elements.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, onestring> map;
+            for(int i = 0; i < 100; ++i)
+            {
+                map.insert(i, onestring("value"));
+            }
+            map.remove(1);
+
+            FlexHashMap<int, onestring> copy(map);
+            PL_ASSERT_EQUAL(copy.size(), map.size());
+            *(copy.find(0)) = "changed";
+            copy.remove(2);
+            PL_ASSERT_EQUAL(*(map.find(0)), "value");
+            PL_ASSERT_TRUE(map.contains(2));
+            PL_ASSERT_FALSE(copy.contains(1));
+
+            FlexHashMap<int, onestring> moved(std::move(copy));
+            PL_ASSERT_EQUAL(*(moved.find(0)), "changed");
+            PL_ASSERT_EQUAL(moved.size(), 98u);
+
+            map = moved;
+            PL_ASSERT_FALSE(map.contains(2));
+            return true;
+        }
+
+        ~TestFlexHashMap_Copy(){}
+};
+
+// P-tB7006
+class TestFlexHashSet_Basic : public Test
+{
+    public:
+        TestFlexHashSet_Basic(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashSet: Insert, Find & Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert, find, and remove onestrings in a FlexHashSet.";
+        }
+
+        bool run() override
+        {
+            FlexHashSet<onestring> set;
+            PL_ASSERT_TRUE(set.insert("red"));
+            PL_ASSERT_TRUE(set.insert("green"));
+            PL_ASSERT_FALSE(set.insert("red"));
+            PL_ASSERT_EQUAL(set.size(), 2u);
+
+            PL_ASSERT_TRUE(set.contains("green"));
+            PL_ASSERT_FALSE(set.contains("blue"));
+            PL_ASSERT_TRUE(set.remove("green"));
+            PL_ASSERT_FALSE(set.contains("green"));
+
+            FlexHashSet<int> numbers(1000);
+            size_t capacity = numbers.capacity();
+            for(int i = 0; i < 1000; ++i)
+            {
+                numbers.insert(i);
+            }
+            // Reserving made room for every element.
+            PL_ASSERT_EQUAL(numbers.capacity(), capacity);
+            int sum = 0;
+            numbers.for_each([&sum](const int& i){ sum += i; });
+            PL_ASSERT_EQUAL(sum, 499500);
+            return true;
+        }
+
+        ~TestFlexHashSet_Basic(){}
+};
+
+// P-tB7007*
+class TestFlexHashMap_InsertStd : public Test
+{
+    public:
+        TestFlexHashMap_InsertStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::unordered_map: Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " elements into an empty std::unordered_map.";
+        }
+
+        bool run() override
+        {
+            std::unordered_map<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                map.emplace(hash_bench_key(i), i);
+            }
+            return map.size() == static_cast<size_t>(count);
+        }
+
+        ~TestFlexHashMap_InsertStd(){}
+
+    private:
+        static const int count = 10000;
+};
+
+// P-tB7007
+class TestFlexHashMap_Insert : public Test
+{
+    public:
+        TestFlexHashMap_Insert(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " elements into an empty FlexHashMap.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert(hash_bench_key(i), i);
+            }
+            return map.size() == static_cast<size_t>(count);
+        }
+
+        ~TestFlexHashMap_Insert(){}
+
+    private:
+        static const int count = 10000;
+};
+
+// P-tB7008*, P-tB7009*
+class TestFlexHashMap_LookupStd : public Test
+{
+    public:
+        explicit TestFlexHashMap_LookupStd(bool hit)
+        : offset(hit ? 0 : count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return offset ? "std::unordered_map: Lookup Miss" : "std::unordered_map: Lookup Hit";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + (offset ? " missing" : " present") + " keys in a std::unordered_map.";
+        }
+
+        bool pre() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.emplace(hash_bench_key(i), i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                found += static_cast<int>(map.count(hash_bench_key(i + offset)));
+            }
+            return found == (offset ? 0 : count);
+        }
+
+        ~TestFlexHashMap_LookupStd(){}
+
+    private:
+        static const int count = 10000;
+        int offset;
+        std::unordered_map<int, int> map;
+};
+
+// P-tB7008, P-tB7009
+class TestFlexHashMap_Lookup : public Test
+{
+    public:
+        explicit TestFlexHashMap_Lookup(bool hit)
+        : offset(hit ? 0 : count)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return offset ? "FlexHashMap: Lookup Miss" : "FlexHashMap: Lookup Hit";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + (offset ? " missing" : " present") + " keys in a FlexHashMap.";
+        }
+
+        bool pre() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert(hash_bench_key(i), i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                found += static_cast<int>(map.contains(hash_bench_key(i + offset)));
+            }
+            return found == (offset ? 0 : count);
+        }
+
+        ~TestFlexHashMap_Lookup(){}
+
+    private:
+        static const int count = 10000;
+        int offset;
+        FlexHashMap<int, int> map;
+};
+
+// P-tB7010*
+class TestFlexHashMap_RemoveStd : public Test
+{
+    public:
+        TestFlexHashMap_RemoveStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::unordered_map: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Remove all " + stdutils::itos(count) + " elements from a std::unordered_map.";
+        }
+
+        bool janitor() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.emplace(hash_bench_key(i), i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.erase(hash_bench_key(i));
+            }
+            return map.empty();
+        }
+
+        ~TestFlexHashMap_RemoveStd(){}
+
+    private:
+        static const int count = 10000;
+        std::unordered_map<int, int> map;
+};
+
+// P-tB7010
+class TestFlexHashMap_RemoveBench : public Test
+{
+    public:
+        TestFlexHashMap_RemoveBench(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Remove all " + stdutils::itos(count) + " elements from a FlexHashMap.";
+        }
+
+        bool janitor() override
+        {
+            // Rebuild, so every run starts without tombstones.
+            map.rehash(count);
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert(hash_bench_key(i), i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.remove(hash_bench_key(i));
+            }
+            return map.empty();
+        }
+
+        ~TestFlexHashMap_RemoveBench(){}
+
+    private:
+        static const int count = 10000;
+        FlexHashMap<int, int> map;
+};
+
+// P-tB7011*
+class TestFlexHashMap_LookupMap : public Test
+{
+    public:
+        TestFlexHashMap_LookupMap(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Lookup Hit";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + " present keys in a Map.";
+        }
+
+        bool pre() override
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert(hash_bench_key(i), i);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int found = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                found += static_cast<int>(map.contains(hash_bench_key(i)));
+            }
+            return found == count;
+        }
+
+        ~TestFlexHashMap_LookupMap(){}
+
+    private:
+        static const int count = 10000;
+        Map<int, int> map;
+};
+
+// P-tB7012
+class TestFlexHashMap_SelfInsert : public Test
+{
+    public:
+        TestFlexHashMap_SelfInsert(){}
+
+        testdoc_t get_title() override
+        {
+            return "FlexHashMap: Insert From Own Element";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert copies of values already in the map, across several rehashes, which must not read them after they move.";
+        }
+
+        bool run() override
+        {
+            FlexHashMap<int, std::string> map;
+            // Long enough to be stored on the heap.
+            map.insert(0, std::string("a value much too long for the small string buffer"));
+            for(int i = 1; i < count; ++i)
+            {
+                auto result = map.try_emplace(i, *(map.find(i - 1)));
+                PL_ASSERT_TRUE(result.second);
+            }
+            for(int i = 1; i < count; ++i)
+            {
+                map.insert_or_assign(count + i, *(map.find(i)));
+            }
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(count * 2 - 1));
+            for(int i = 0; i < count * 2; ++i)
+            {
+                if(i != count)
+                {
+                    PL_ASSERT_EQUAL(*(map.find(i)), *(map.find(0)));
+                }
+            }
+            return true;
+        }
+
+        ~TestFlexHashMap_SelfInsert(){}
+
+    private:
+        static const int count = 500;
+};
+
+class TestSuite_FlexHashMap : public TestSuite
+{
+    public:
+        explicit TestSuite_FlexHashMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: FlexHashMap Tests";
+        }
+
+        ~TestSuite_FlexHashMap(){}
+};
+
+#endif // PAWLIB_FLEXHASHMAP_TESTS_HPP
@@ -0,0 +1,166 @@
+/** FlexHashSet [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An unordered set, stored flat in an open-addressing hash table.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXHASHSET_HPP
+#define PAWLIB_FLEXHASHSET_HPP
+
+#include <utility>
+
+#include "pawlib/flex_hash_table.hpp"
+
+/** An unordered set, similar to std::unordered_set, stored in a
+  * FlexHashTable. Like FlexHashMap, lookups take any key type which
+  * hash_t and equal_t accept.
+  * \param the element type
+  * \param the hash function type
+  * \param the equality type */
+template<typename key_t, typename hash_t = FlexHash, typename equal_t = FlexEqual>
+class FlexHashSet
+{
+    private:
+        struct KeyOf
+        {
+            static const key_t& get(const key_t& key)
+            {
+                return key;
+            }
+        };
+
+        FlexHashTable<key_t, KeyOf, hash_t, equal_t> table;
+
+    public:
+        FlexHashSet() = default;
+
+        /** Create a set with room for the given number of elements.
+          * \param the number of elements to reserve room for */
+        explicit FlexHashSet(size_t count)
+        {
+            table.reserve(count);
+        }
+
+        /** Insert the element, unless it already exists.
+          * \param the element
+          * \return true if inserted */
+        bool insert(const key_t& key)
+        {
+            bool inserted = false;
+            table.insert(key, inserted, key);
+            return inserted;
+        }
+
+        bool insert(key_t&& key)
+        {
+            bool inserted = false;
+            table.insert(key, inserted, std::move(key));
+            return inserted;
+        }
+
+        /** \return true if the given element exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return table.find(key) != nullptr;
+        }
+
+        /** Remove the given element.
+          * \param the element
+          * \return true if it existed */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            return table.remove(key);
+        }
+
+        /** Make room for the given number of elements.
+          * \param the number of elements */
+        void reserve(size_t count)
+        {
+            table.reserve(count);
+        }
+
+        /** Rebuild the set, dropping tombstones, at the smallest capacity
+          * holding both the current elements and the given number.
+          * \param the number of elements to make room for */
+        void rehash(size_t count = 0)
+        {
+            table.rehash(count);
+        }
+
+        /** Call the visitor with each element, in no particular order.
+          * \param the visitor, which takes a const key_t& */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            auto each = [&visitor](const key_t& key)
+            {
+                visitor(key);
+            };
+            table.for_each(each);
+        }
+
+        /** Remove every element, keeping the memory. */
+        void clear()
+        {
+            table.clear();
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return table.size();
+        }
+
+        /** \return true if there are no elements */
+        bool empty() const
+        {
+            return table.size() == 0;
+        }
+
+        /** \return the number of slots in the table */
+        size_t capacity() const
+        {
+            return table.capacity();
+        }
+};
+
+#endif // PAWLIB_FLEXHASHSET_HPP
@@ -0,0 +1,676 @@
+/** FlexHashTable [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * The open-addressing hash table behind FlexHashMap and FlexHashSet.
+  * Elements are stored flat, alongside one control byte each, and
+  * lookups compare sixteen control bytes at a time.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXHASHTABLE_HPP
+#define PAWLIB_FLEXHASHTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "pawlib/onestring.hpp"
+
+/** The default hash for FlexHashMap and FlexHashSet.
+  * Integers, enums, and pointers are run through a 64-bit finalizer, so
+  * keys which differ only in a few bits still spread across the table.
+  * onestring, std::string, and c-strings all hash their bytes the same way,
+  * so any of them may be used to look up a onestring key. */
+struct FlexHash
+{
+    /** Mixes the bits of a 64-bit value.
+      * \param the value to mix
+      * \return the mixed value */
+    static size_t mix(uint64_t h)
+    {
+        // MurmurHash3's 64-bit finalizer.
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    template<typename T, typename = typename std::enable_if<
+        std::is_integral<T>::value || std::is_enum<T>::value>::type>
+    size_t operator()(T key) const
+    {
+        return mix(static_cast<uint64_t>(key));
+    }
+
+    template<typename T>
+    size_t operator()(T* ptr) const
+    {
+        return mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)));
+    }
+
+    size_t operator()(const char* str) const
+    {
+        return mix(onestring::hash(str, strlen(str)));
+    }
+
+    size_t operator()(char* str) const
+    {
+        return mix(onestring::hash(str, strlen(str)));
+    }
+
+    size_t operator()(const std::string& str) const
+    {
+        return mix(onestring::hash(str.data(), str.size()));
+    }
+
+    size_t operator()(const onestring& str) const
+    {
+        return mix(str.hash());
+    }
+};
+
+/** The default equality for FlexHashMap and FlexHashSet.
+  * Compares a stored key against a lookup key with operator==. */
+struct FlexEqual
+{
+    template<typename A, typename B>
+    bool operator()(const A& stored, const B& key) const
+    {
+        return stored == key;
+    }
+};
+
+/** An open-addressing hash table, in the style of SwissTable.
+  * The table is split into groups of sixteen slots. Each slot has a control
+  * byte, which is either EMPTY, DELETED (a tombstone), or the low seven
+  * bits of the hash of the element in it. A lookup compares the control
+  * bytes of a whole group at once, and only compares keys on a match.
+  * \param the type stored in each slot
+  * \param a type with a static get(const slot_t&), returning the key
+  * \param the hash function type
+  * \param the key equality type */
+template<typename slot_t, typename key_of_t, typename hash_t, typename equal_t>
+class FlexHashTable
+{
+    public:
+        /// The number of slots in a group.
+        static const size_t GROUP = 16;
+
+        /// Returned by index lookups which find nothing.
+        static const size_t npos = static_cast<size_t>(-1);
+
+        FlexHashTable()
+        :ctrl(nullptr), slots(nullptr), _capacity(0), _size(0), growth_left(0)
+        {}
+
+        FlexHashTable(const FlexHashTable& cpy)
+        :ctrl(nullptr), slots(nullptr), _capacity(0), _size(0), growth_left(0),
+         hasher(cpy.hasher), equal(cpy.equal)
+        {
+            if(cpy._capacity == 0)
+            {
+                return;
+            }
+            allocate(cpy._capacity);
+            // Copy every element into the same slot, so nothing is rehashed.
+            for(size_t i = 0; i < _capacity; ++i)
+            {
+                if(cpy.ctrl[i] >= 0)
+                {
+                    new (slots + i) slot_t(static_cast<const slot_t&>(cpy.slots[i]));
+                    ctrl[i] = cpy.ctrl[i];
+                    ++_size;
+                }
+                else if(cpy.ctrl[i] == DELETED)
+                {
+                    ctrl[i] = DELETED;
+                }
+            }
+            growth_left = cpy.growth_left;
+        }
+
+        FlexHashTable(FlexHashTable&& mov)
+        :ctrl(mov.ctrl), slots(mov.slots), _capacity(mov._capacity),
+         _size(mov._size), growth_left(mov.growth_left),
+         hasher(std::move(mov.hasher)), equal(std::move(mov.equal))
+        {
+            mov.ctrl = nullptr;
+            mov.slots = nullptr;
+            mov._capacity = 0;
+            mov._size = 0;
+            mov.growth_left = 0;
+        }
+
+        FlexHashTable& operator=(FlexHashTable rhs)
+        {
+            swap(rhs);
+            return *this;
+        }
+
+        void swap(FlexHashTable& other)
+        {
+            std::swap(ctrl, other.ctrl);
+            std::swap(slots, other.slots);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(growth_left, other.growth_left);
+            std::swap(hasher, other.hasher);
+            std::swap(equal, other.equal);
+        }
+
+        /** Find the slot holding the given key.
+          * \param the key to look for, of any type hash_t and equal_t accept
+          * \return the slot, or nullptr if the key isn't in the table */
+        template<typename K>
+        slot_t* find(const K& key) const
+        {
+            size_t index = find_index(key, hasher(key));
+            return (index == npos) ? nullptr : slots + index;
+        }
+
+        /** Insert a slot constructed from the given arguments,
+          * unless the key is already in the table. Nothing is constructed
+          * if the key is found.
+          * \param the key to insert, which args must construct a slot for
+          * \param set to whether the slot was inserted
+          * \param the arguments to construct the slot from
+          * \return the new slot, or the existing slot with that key */
+        template<typename K, typename... Args>
+        slot_t* insert(const K& key, bool& inserted, Args&&... args)
+        {
+            size_t hash = hasher(key);
+            size_t index = find_index(key, hash);
+            if(index != npos)
+            {
+                inserted = false;
+                return slots + index;
+            }
+
+            // Reusing a tombstone doesn't use up any room, so only grow
+            // if the new element needs an empty slot and there is none left.
+            if(growth_left == 0 &&
+               (_capacity == 0 || ctrl[find_free(hash)] == EMPTY))
+            {
+                // The arguments may refer to an element of this table, which
+                // growing would move, so build the new slot from them first.
+                slot_t slot(std::forward<Args>(args)...);
+                grow();
+                slot_t* placed = place(hash, std::move(slot));
+                inserted = true;
+                return placed;
+            }
+            slot_t* placed = place(hash, std::forward<Args>(args)...);
+            inserted = true;
+            return placed;
+        }
+
+        /** Remove the slot with the given key.
+          * \param the key to remove
+          * \return true if the key was in the table */
+        template<typename K>
+        bool remove(const K& key)
+        {
+            size_t index = find_index(key, hasher(key));
+            if(index == npos)
+            {
+                return false;
+            }
+            slots[index].~slot_t();
+            /* If the group still has an empty slot, no probe has ever passed
+             * through it, so the slot can simply become empty again.
+             * Otherwise, we leave a tombstone so later probes keep going. */
+            if(match_empty(ctrl + (index - index % GROUP)) != 0)
+            {
+                ctrl[index] = EMPTY;
+                ++growth_left;
+            }
+            else
+            {
+                ctrl[index] = DELETED;
+            }
+            --_size;
+            return true;
+        }
+
+        /** Ensure the table can hold the given number of elements
+          * without growing.
+          * \param the number of elements */
+        void reserve(size_t count)
+        {
+            size_t needed = capacity_for(count);
+            if(needed > _capacity)
+            {
+                resize(needed);
+            }
+        }
+
+        /** Rebuild the table, dropping all tombstones, with the smallest
+          * capacity which holds both the current elements and the given
+          * number of elements. A capacity of zero releases all memory.
+          * \param the number of elements to make room for */
+        void rehash(size_t count = 0)
+        {
+            size_t needed = capacity_for(count > _size ? count : _size);
+            if(needed == 0)
+            {
+                deallocate();
+            }
+            else
+            {
+                resize(needed);
+            }
+        }
+
+        /** Remove every element, keeping the memory. */
+        void clear()
+        {
+            destroy_all();
+            if(_capacity > 0)
+            {
+                memset(ctrl, EMPTY, _capacity);
+            }
+            _size = 0;
+            growth_left = max_load(_capacity);
+        }
+
+        /** Call the given visitor with every slot, in storage order.
+          * \param the visitor, which takes a const slot_t& */
+        template<typename Visitor>
+        void for_each(Visitor& visitor) const
+        {
+            for(size_t g = 0; g < _capacity; g += GROUP)
+            {
+                uint32_t mask = match_full(ctrl + g);
+                while(mask != 0)
+                {
+                    visitor(static_cast<const slot_t&>(slots[g + lowest_bit(mask)]));
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        /** Call the given visitor with every slot, in storage order.
+          * \param the visitor, which takes a slot_t& */
+        template<typename Visitor>
+        void for_each(Visitor& visitor)
+        {
+            for(size_t g = 0; g < _capacity; g += GROUP)
+            {
+                uint32_t mask = match_full(ctrl + g);
+                while(mask != 0)
+                {
+                    visitor(slots[g + lowest_bit(mask)]);
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return the number of slots */
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        ~FlexHashTable()
+        {
+            deallocate();
+        }
+
+    private:
+        typedef int8_t ctrl_t;
+
+        static const ctrl_t EMPTY = -128;
+        static const ctrl_t DELETED = -2;
+
+        /// The control bytes, one per slot.
+        ctrl_t* ctrl;
+        /// The slots, which directly follow the control bytes in memory.
+        slot_t* slots;
+        /// The number of slots, always zero or a power of two of at least GROUP.
+        size_t _capacity;
+        /// The number of elements.
+        size_t _size;
+        /// The number of empty slots which may still be filled before growing.
+        size_t growth_left;
+
+        hash_t hasher;
+        equal_t equal;
+
+        /** \return the seven bits of the hash stored in a control byte */
+        static ctrl_t h2(size_t hash)
+        {
+            return static_cast<ctrl_t>(hash & 0x7F);
+        }
+
+        /** \return the group a hash starts probing from */
+        size_t h1(size_t hash) const
+        {
+            return (hash >> 7) & (_capacity / GROUP - 1);
+        }
+
+        /** \return the most elements a table of the given capacity holds */
+        static size_t max_load(size_t capacity)
+        {
+            // 7/8ths full. The rest stay empty, so every probe terminates.
+            return capacity - capacity / 8;
+        }
+
+        /** \return the smallest capacity which holds the given elements */
+        static size_t capacity_for(size_t count)
+        {
+            if(count == 0)
+            {
+                return 0;
+            }
+            size_t capacity = GROUP;
+            while(max_load(capacity) < count)
+            {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        static unsigned int lowest_bit(uint32_t mask)
+        {
+            return static_cast<unsigned int>(__builtin_ctz(mask));
+        }
+
+#if defined(__SSE2__)
+        static __m128i load(const ctrl_t* group)
+        {
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        }
+
+        /** \return a bitmask of the slots in the group whose control byte is h */
+        static uint32_t match(const ctrl_t* group, ctrl_t h)
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_set1_epi8(h), load(group))));
+        }
+
+        /** \return a bitmask of the empty slots in the group */
+        static uint32_t match_empty(const ctrl_t* group)
+        {
+            return match(group, EMPTY);
+        }
+
+        /** \return a bitmask of the empty or deleted slots in the group */
+        static uint32_t match_free(const ctrl_t* group)
+        {
+            // Both EMPTY and DELETED are less than -1; full slots are not.
+            return static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmplt_epi8(load(group), _mm_set1_epi8(-1))));
+        }
+
+        /** \return a bitmask of the full slots in the group */
+        static uint32_t match_full(const ctrl_t* group)
+        {
+            // Only full slots have the sign bit clear.
+            return static_cast<uint32_t>(~_mm_movemask_epi8(load(group))) & 0xFFFF;
+        }
+#else
+        static uint32_t match(const ctrl_t* group, ctrl_t h)
+        {
+            uint32_t mask = 0;
+            for(size_t i = 0; i < GROUP; ++i)
+            {
+                mask |= static_cast<uint32_t>(group[i] == h) << i;
+            }
+            return mask;
+        }
+
+        static uint32_t match_empty(const ctrl_t* group)
+        {
+            return match(group, EMPTY);
+        }
+
+        static uint32_t match_free(const ctrl_t* group)
+        {
+            uint32_t mask = 0;
+            for(size_t i = 0; i < GROUP; ++i)
+            {
+                mask |= static_cast<uint32_t>(group[i] < -1) << i;
+            }
+            return mask;
+        }
+
+        static uint32_t match_full(const ctrl_t* group)
+        {
+            uint32_t mask = 0;
+            for(size_t i = 0; i < GROUP; ++i)
+            {
+                mask |= static_cast<uint32_t>(group[i] >= 0) << i;
+            }
+            return mask;
+        }
+#endif
+
+        /** Find the index of the slot holding the given key.
+          * \param the key
+          * \param the hash of the key
+          * \return the index, or npos */
+        template<typename K>
+        size_t find_index(const K& key, size_t hash) const
+        {
+            if(_capacity == 0)
+            {
+                return npos;
+            }
+            const size_t groups_mask = _capacity / GROUP - 1;
+            const ctrl_t h = h2(hash);
+            size_t group = h1(hash);
+            // Triangular probing visits every group of a power-of-two table.
+            for(size_t step = 1; ; ++step)
+            {
+                const ctrl_t* ctrl_group = ctrl + group * GROUP;
+                uint32_t mask = match(ctrl_group, h);
+                while(mask != 0)
+                {
+                    size_t index = group * GROUP + lowest_bit(mask);
+                    if(equal(key_of_t::get(slots[index]), key))
+                    {
+                        return index;
+                    }
+                    mask &= mask - 1;
+                }
+                // An empty slot means the key was never placed further along.
+                if(match_empty(ctrl_group) != 0)
+                {
+                    return npos;
+                }
+                group = (group + step) & groups_mask;
+            }
+        }
+
+        /** Find the first empty or deleted slot along a hash's probe sequence.
+          * The table must have at least one empty slot.
+          * \param the hash
+          * \return the index of the slot */
+        size_t find_free(size_t hash) const
+        {
+            const size_t groups_mask = _capacity / GROUP - 1;
+            size_t group = h1(hash);
+            for(size_t step = 1; ; ++step)
+            {
+                uint32_t mask = match_free(ctrl + group * GROUP);
+                if(mask != 0)
+                {
+                    return group * GROUP + lowest_bit(mask);
+                }
+                group = (group + step) & groups_mask;
+            }
+        }
+
+        /** Construct a slot in the first free slot for the hash, which
+          * there must be room for.
+          * \param the hash of the slot's key
+          * \param the arguments to construct the slot from
+          * \return the new slot */
+        template<typename... Args>
+        slot_t* place(size_t hash, Args&&... args)
+        {
+            size_t index = find_free(hash);
+            // Construct first, so the table is untouched if it throws.
+            new (slots + index) slot_t(std::forward<Args>(args)...);
+            if(ctrl[index] == EMPTY)
+            {
+                --growth_left;
+            }
+            ctrl[index] = h2(hash);
+            ++_size;
+            return slots + index;
+        }
+
+        /** Make room for one more element. If the table is no more than
+          * 25/32nds full without its tombstones, it is rebuilt at the same
+          * size instead, which clears them out. */
+        void grow()
+        {
+            if(_capacity > 0 && _size * 32 <= _capacity * 25)
+            {
+                resize(_capacity);
+            }
+            else
+            {
+                resize(_capacity == 0 ? GROUP : _capacity * 2);
+            }
+        }
+
+        /** Allocate the control bytes and slots for an empty table.
+          * \param the number of slots */
+        void allocate(size_t capacity)
+        {
+            size_t offset = (capacity + alignof(slot_t) - 1)
+                            / alignof(slot_t) * alignof(slot_t);
+            void* block = ::operator new(offset + capacity * sizeof(slot_t),
+                                         std::align_val_t(block_align()));
+            ctrl = static_cast<ctrl_t*>(block);
+            slots = reinterpret_cast<slot_t*>(static_cast<char*>(block) + offset);
+            memset(ctrl, EMPTY, capacity);
+            _capacity = capacity;
+            _size = 0;
+            growth_left = max_load(capacity);
+        }
+
+        /** Move every element into a new table with the given capacity.
+          * \param the new number of slots */
+        void resize(size_t capacity)
+        {
+            ctrl_t* old_ctrl = ctrl;
+            slot_t* old_slots = slots;
+            size_t old_capacity = _capacity;
+            size_t count = _size;
+
+            allocate(capacity);
+            for(size_t i = 0; i < old_capacity; ++i)
+            {
+                if(old_ctrl[i] >= 0)
+                {
+                    size_t hash = hasher(key_of_t::get(old_slots[i]));
+                    size_t index = find_free(hash);
+                    new (slots + index) slot_t(std::move(old_slots[i]));
+                    old_slots[i].~slot_t();
+                    ctrl[index] = h2(hash);
+                }
+            }
+            _size = count;
+            growth_left = max_load(capacity) - count;
+
+            if(old_ctrl != nullptr)
+            {
+                ::operator delete(old_ctrl, std::align_val_t(block_align()));
+            }
+        }
+
+        /** Destroy every element, without touching the control bytes. */
+        void destroy_all()
+        {
+            if(!std::is_trivially_destructible<slot_t>::value)
+            {
+                for(size_t i = 0; i < _capacity; ++i)
+                {
+                    if(ctrl[i] >= 0)
+                    {
+                        slots[i].~slot_t();
+                    }
+                }
+            }
+        }
+
+        /** Destroy every element and release all memory. */
+        void deallocate()
+        {
+            if(ctrl == nullptr)
+            {
+                return;
+            }
+            destroy_all();
+            ::operator delete(ctrl, std::align_val_t(block_align()));
+            ctrl = nullptr;
+            slots = nullptr;
+            _capacity = 0;
+            _size = 0;
+            growth_left = 0;
+        }
+
+        /** \return the alignment of the memory block */
+        static constexpr size_t block_align()
+        {
+            // The control bytes are loaded sixteen at a time.
+            return alignof(slot_t) > GROUP ? alignof(slot_t) : GROUP;
+        }
+};
+
+#endif // PAWLIB_FLEXHASHTABLE_HPP
@@ -1,5 +1,5 @@
 /** Map [PawLIB]
-  * Version: 0.1 (Experimental)
+  * Version: 0.2 (Experimental)
   *
   * A map/dictionary with a low dynamic allocation demand.
   *
@@ -44,14 +44,23 @@
 #ifndef PAWLIB_FLEXMAP_HPP
 #define PAWLIB_FLEXMAP_HPP
 
-#include <iosfwd>
-#include <ostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 #include "pawlib/avl_tree.hpp"
+#include "pawlib/iochannel.hpp"
+#include "pawlib/pawsort.hpp"
 
-using std::ostream;
-
-template<class TypeOfKey, class TypeToMap>
+/* Lookups take any key type which can be compared with TypeOfKey using
+ * operator< in both directions, so (for example) a Map with onestring
+ * keys can be searched with a const char* without building a onestring.
+ * No lookup copies a stored key or value.
+ *
+ * With order_stats set, the tree keeps the size of each subtree, which
+ * allows rank(), select(), and count_range() in O(log n). */
+template<class TypeOfKey, class TypeToMap, bool order_stats = false>
 class Map
 {
     private:
@@ -62,91 +71,532 @@ class Map
             //the data to store
             TypeToMap data;
 
-            //empty constructor, needed for creation in AVL_Tree
-            MapNode() { }
+            //constructs the key and the data in place
+            template<typename K, typename... Args>
+            explicit MapNode(K&& theKey, Args&&... args)
+            :key(std::forward<K>(theKey)), data(std::forward<Args>(args)...)
+            {}
 
-            //copy constructor
             MapNode(const MapNode&) = default;
+            MapNode(MapNode&&) = default;
 
-            //constructor used for retrieve method
-            explicit MapNode(TypeOfKey theKey)
-            {
-                key = theKey;
-            }
+            //compares by key, for the AVL_Tree
+            bool operator < (const MapNode& otherNode) const { return key < otherNode.key; }
+        };
 
-            //a MapNode contains a key and the data
-            MapNode(TypeOfKey theKey, TypeToMap theData)
+        //compares a lookup key against the key of a MapNode
+        template<typename K>
+        struct KeyProbe
+        {
+            const K& key;
+
+            explicit KeyProbe(const K& theKey)
+            :key(theKey)
+            {}
+
+            int operator()(const MapNode& node) const
             {
-                key = theKey;
-                data = theData;
+                if(key < node.key) { return -1; }
+                if(node.key < key) { return 1; }
+                return 0;
             }
-
-            //overrides the comparable operators for comparison in the AVL_Tree
-            bool operator < (const MapNode& otherNode) {return key < otherNode.key; }
-            bool operator > (const MapNode& otherNode) { return key > otherNode.key; }
-            bool operator == (const MapNode& otherNode) { return key == otherNode.key; }
-            bool operator != (const MapNode& otherNode) { return key != otherNode.key; }
         };
 
-        //override the output stream for printing possibilities in AVL_Tree
-        friend ostream& operator << (ostream& os, const MapNode& node) { os << node.data; return os; }
+        template<typename K>
+        static KeyProbe<K> probe(const K& key)
+        {
+            return KeyProbe<K>(key);
+        }
 
         //a map has an AVL_Tree
-        AVL_Tree<MapNode>* tree;
+        AVL_Tree<MapNode, order_stats> tree;
 
-        AVL_Tree<MapNode>* clone()
+        //inserts the couple unless the key exists, constructing the value in place
+        template<typename K, typename... Args>
+        std::pair<TypeToMap*, bool> emplace_key(K&& key, Args&&... args)
         {
-            return tree->clone();
+            bool inserted = false;
+            //the probe only reads the key before it is forwarded to the new node
+            MapNode* node = tree.insert_unique(probe(key), &inserted,
+                std::forward<K>(key), std::forward<Args>(args)...);
+            return std::pair<TypeToMap*, bool>(&(node->data), inserted);
         }
 
     public:
-        //empty constructor initializes the tree
-        Map()
+        //a key and a reference to its value, as returned by iterators
+        template<bool is_const>
+        struct basic_entry
+        {
+            const TypeOfKey& key;
+            typename std::conditional<is_const, const TypeToMap&, TypeToMap&>::type value;
+        };
+
+        //a bidirectional iterator over the elements, in key order
+        //it stays valid until its element is removed, or the map is compacted
+        template<bool is_const>
+        class basic_iterator
+        {
+            friend class Map;
+
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef basic_entry<is_const> value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef void pointer;
+                typedef basic_entry<is_const> reference;
+
+                basic_iterator() = default;
+
+                //allows converting an iterator to a const_iterator
+                template<bool other, typename = typename std::enable_if<is_const && !other>::type>
+                // cppcheck-suppress noExplicitConstructor
+                basic_iterator(const basic_iterator<other>& it)
+                :at(it.at)
+                {}
+
+                const TypeOfKey& key() const
+                {
+                    return at->key;
+                }
+
+                typename std::conditional<is_const, const TypeToMap&, TypeToMap&>::type value() const
+                {
+                    return at->data;
+                }
+
+                reference operator*() const
+                {
+                    return reference{key(), value()};
+                }
+
+                basic_iterator& operator++()
+                {
+                    ++at;
+                    return *this;
+                }
+
+                basic_iterator operator++(int)
+                {
+                    basic_iterator old = *this;
+                    ++at;
+                    return old;
+                }
+
+                basic_iterator& operator--()
+                {
+                    --at;
+                    return *this;
+                }
+
+                basic_iterator operator--(int)
+                {
+                    basic_iterator old = *this;
+                    --at;
+                    return old;
+                }
+
+                bool operator==(const basic_iterator& rhs) const
+                {
+                    return at == rhs.at;
+                }
+
+                bool operator!=(const basic_iterator& rhs) const
+                {
+                    return at != rhs.at;
+                }
+
+            private:
+                typedef typename AVL_Tree<MapNode, order_stats>::template basic_iterator<is_const> tree_iterator;
+
+                explicit basic_iterator(tree_iterator it)
+                :at(it)
+                {}
+
+                tree_iterator at;
+
+                template<bool> friend class basic_iterator;
+        };
+
+        typedef basic_iterator<false> iterator;
+        typedef basic_iterator<true> const_iterator;
+
+        Map() = default;
+        Map(const Map&) = default;
+        Map(Map&&) = default;
+        Map& operator=(const Map&) = default;
+        Map& operator=(Map&&) = default;
+
+        //insert the couple into the tree, unless the key already exists
+        //returns true if the couple was inserted
+        bool insert(const TypeOfKey& key, const TypeToMap& data)
+        {
+            return emplace_key(key, data).second;
+        }
+
+        bool insert(TypeOfKey&& key, TypeToMap&& data)
+        {
+            return emplace_key(std::move(key), std::move(data)).second;
+        }
+
+        //constructs the value from args in place, unless the key already exists
+        //the value is never constructed or moved from if the key exists
+        //returns the value with that key, and whether it was inserted
+        template<typename... Args>
+        std::pair<TypeToMap*, bool> try_emplace(const TypeOfKey& key, Args&&... args)
+        {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<TypeToMap*, bool> try_emplace(TypeOfKey&& key, Args&&... args)
+        {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        //inserts the couple, or assigns the value if the key already exists
+        //returns the value with that key, and whether it was inserted
+        template<typename M>
+        std::pair<TypeToMap*, bool> insert_or_assign(const TypeOfKey& key, M&& data)
+        {
+            MapNode* node = tree.search(probe(key));
+            if(node != nullptr)
+            {
+                node->data = std::forward<M>(data);
+                return std::pair<TypeToMap*, bool>(&(node->data), false);
+            }
+            return emplace_key(key, std::forward<M>(data));
+        }
+
+        template<typename M>
+        std::pair<TypeToMap*, bool> insert_or_assign(TypeOfKey&& key, M&& data)
+        {
+            MapNode* node = tree.search(probe(key));
+            if(node != nullptr)
+            {
+                node->data = std::forward<M>(data);
+                return std::pair<TypeToMap*, bool>(&(node->data), false);
+            }
+            return emplace_key(std::move(key), std::forward<M>(data));
+        }
+
+        //returns the value with the given key,
+        //default-constructing it first if the key does not exist
+        TypeToMap& operator[](const TypeOfKey& key)
+        {
+            return *(emplace_key(key).first);
+        }
+
+        TypeToMap& operator[](TypeOfKey&& key)
+        {
+            return *(emplace_key(std::move(key)).first);
+        }
+
+        //builds a map from a range of pairs (anything with first and second),
+        //which must be sorted by strictly increasing key
+        //the tree is built perfectly balanced in linear time, with no rotations
+        //throws std::invalid_argument if the keys are not strictly increasing
+        template<typename ForwardIt>
+        static Map from_sorted(ForwardIt first, ForwardIt last)
+        {
+            Map map;
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            map.tree.assign_sorted(n, [&first](size_t, auto place)
+            {
+                place(first->first, first->second);
+                ++first;
+            });
+            return map;
+        }
+
+        template<typename Range>
+        static Map from_sorted(const Range& range)
+        {
+            return from_sorted(std::begin(range), std::end(range));
+        }
+
+        //inserts every pair (anything with first and second) in the range,
+        //in any order, unless its key already exists
+        //if the range repeats a key, the first pair with that key is the one inserted
+        //returns the number of pairs inserted
+        template<typename ForwardIt>
+        size_t bulk_insert(ForwardIt first, ForwardIt last)
+        {
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            if(n == 0)
+            {
+                return 0;
+            }
+
+            //a few pairs are cheaper to insert one at a time than to rebuild the tree for
+            size_t depth = 1;
+            for(size_t s = tree.size(); s > 1; s >>= 1)
+            {
+                ++depth;
+            }
+            if(n * depth < tree.size())
+            {
+                size_t inserted = 0;
+                for(; first != last; ++first)
+                {
+                    inserted += emplace_key(first->first, first->second).second ? 1 : 0;
+                }
+                return inserted;
+            }
+
+            //sort the pairs by key, breaking ties by position so the first one wins
+            struct Entry
+            {
+                ForwardIt it;
+                size_t position;
+            };
+            std::unique_ptr<Entry[]> entries(new Entry[n]);
+            for(size_t i = 0; i < n; ++i, ++first)
+            {
+                entries[i].it = first;
+                entries[i].position = i;
+            }
+            if(n > 1)
+            {
+                pawsort::sort(entries.get(), entries.get() + n,
+                    [](const Entry& lhs, const Entry& rhs)
+                    {
+                        if(lhs.it->first < rhs.it->first) { return true; }
+                        if(rhs.it->first < lhs.it->first) { return false; }
+                        return lhs.position < rhs.position;
+                    });
+            }
+
+            //drop all but the first pair with each key
+            size_t unique = 1;
+            for(size_t i = 1; i < n; ++i)
+            {
+                if(entries[unique - 1].it->first < entries[i].it->first)
+                {
+                    entries[unique++] = entries[i];
+                }
+            }
+
+            return tree.merge_sorted(unique,
+                [&entries](size_t i)
+                {
+                    return probe(entries[i].it->first);
+                },
+                [&entries](size_t i, auto place)
+                {
+                    place(entries[i].it->first, entries[i].it->second);
+                });
+        }
+
+        template<typename Range>
+        size_t bulk_insert(const Range& range)
+        {
+            return bulk_insert(std::begin(range), std::end(range));
+        }
+
+        //returns a pointer to the value with the given key, or null if there is none
+        //the pointer remains valid until the next insertion or compact()
+        template<typename K>
+        TypeToMap* find(const K& key)
+        {
+            MapNode* node = tree.search(probe(key));
+            return node ? &(node->data) : nullptr;
+        }
+
+        template<typename K>
+        const TypeToMap* find(const K& key) const
+        {
+            const MapNode* node = tree.search(probe(key));
+            return node ? &(node->data) : nullptr;
+        }
+
+        iterator begin()
+        {
+            return iterator(tree.begin());
+        }
+
+        const_iterator begin() const
         {
-            tree = new AVL_Tree<MapNode>();
+            return const_iterator(tree.begin());
         }
 
-        Map(const Map& mapToCopy)
+        iterator end()
         {
-            tree = mapToCopy.clone();
+            return iterator(tree.end());
         }
 
-        //insert the couple into the tree
-        void insert(TypeOfKey key, TypeToMap data)
+        const_iterator end() const
         {
-            MapNode node(key, data);
-            tree->insert(node);
+            return const_iterator(tree.end());
+        }
+
+        //returns an iterator to the first element whose key is not less than the given key
+        template<typename K>
+        iterator lower_bound(const K& key)
+        {
+            return iterator(tree.lower_bound(probe(key)));
+        }
+
+        template<typename K>
+        const_iterator lower_bound(const K& key) const
+        {
+            return const_iterator(tree.lower_bound(probe(key)));
+        }
+
+        //returns an iterator to the first element whose key is greater than the given key
+        template<typename K>
+        iterator upper_bound(const K& key)
+        {
+            return iterator(tree.upper_bound(probe(key)));
+        }
+
+        template<typename K>
+        const_iterator upper_bound(const K& key) const
+        {
+            return const_iterator(tree.upper_bound(probe(key)));
+        }
+
+        //returns the range of elements with the given key, which holds at most one
+        template<typename K>
+        std::pair<iterator, iterator> equal_range(const K& key)
+        {
+            auto range = tree.equal_range(probe(key));
+            return std::pair<iterator, iterator>(iterator(range.first), iterator(range.second));
+        }
+
+        template<typename K>
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+        {
+            auto range = tree.equal_range(probe(key));
+            return std::pair<const_iterator, const_iterator>(const_iterator(range.first),
+                                                             const_iterator(range.second));
+        }
+
+        //returns the number of keys less than the given key
+        //requires order_stats
+        template<typename K>
+        size_t rank(const K& key) const
+        {
+            return tree.rank(probe(key));
+        }
+
+        //returns the element at the given position, in key order, counting from 0,
+        //or end() if there are not that many elements
+        //requires order_stats
+        iterator select(size_t position)
+        {
+            return iterator(tree.select(position));
+        }
+
+        const_iterator select(size_t position) const
+        {
+            return const_iterator(tree.select(position));
+        }
+
+        //returns the number of keys in [low, high), without visiting them
+        //requires order_stats
+        template<typename K1, typename K2>
+        size_t count_range(const K1& low, const K2& high) const
+        {
+            return tree.count_range(probe(low), probe(high));
+        }
+
+        //returns true if the given key exists
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return tree.search(probe(key)) != nullptr;
         }
 
         //remove the element, that has the given key, from the tree
-        void remove(TypeOfKey key)
+        //returns true if the key existed
+        template<typename K>
+        bool remove(const K& key)
         {
-            tree->remove(key);
+            return tree.erase(probe(key));
         }
 
         //retrieves the element that has the given key
-        //returns true if the element exists and sets the returnVal pointer equal to the elements data
+        //returns true if the element exists and copies the elements data into returnVal
         //returns false if not
-        bool retrieve(TypeOfKey key, TypeToMap* returnVal)
+        template<typename K>
+        bool retrieve(const K& key, TypeToMap* returnVal) const
         {
-            //holds the return value form the trees search method
-            MapNode data, temp(key);
-            //exists will be true if the key exists in the tree
-            bool exists = tree->retrieve(key, &data);
+            const TypeToMap* data = find(key);
             //if the element exists
-            if(exists)
+            if(data != nullptr)
             {
                 //set the return value equal to the elements data
-                *returnVal = data.data;
+                *returnVal = *data;
                 return true;
             }
             return false;
         }
 
-        //calls the tree pre-order print function
-        void print()
+        //calls the visitor with each key and value, in key order
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            tree.for_each([&visitor](const MapNode& node)
+            {
+                visitor(node.key, node.data);
+            });
+        }
+
+        //calls the visitor with each key and value in [low, high), in key order
+        //only the elements in the range, and the path to the first one, are visited
+        template<typename K1, typename K2, typename Visitor>
+        void for_each_in_range(const K1& low, const K2& high, Visitor visitor) const
+        {
+            tree.for_each_in_range(probe(low), probe(high), [&visitor](const MapNode& node)
+            {
+                visitor(node.key, node.data);
+            });
+        }
+
+        //returns the number of elements in the map
+        size_t size() const
+        {
+            return tree.size();
+        }
+
+        //returns true if the map is empty
+        bool empty() const
+        {
+            return tree.empty();
+        }
+
+        //removes every element from the map
+        void clear()
+        {
+            tree.clear();
+        }
+
+        //returns the number of elements the map has room for without growing
+        size_t capacity() const
         {
-            tree->print();
+            return tree.capacity();
+        }
+
+        //makes room for at least the given number of elements
+        void reserve(size_t elements)
+        {
+            tree.reserve(elements);
+        }
+
+        //lays the elements out in the given order for faster lookups,
+        //and releases any unused capacity
+        void compact(AVLLayout layout = AVLLayout::van_emde_boas)
+        {
+            tree.compact(layout);
+        }
+
+        //prints each key and value, in key order
+        void print() const
+        {
+            for_each([](const TypeOfKey& key, const TypeToMap& data)
+            {
+                ioc << key << ": " << data << IOCtrl::endl;
+            });
         }
 };
 
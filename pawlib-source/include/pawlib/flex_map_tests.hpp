@@ -0,0 +1,1530 @@
+/** Tests for Map [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_FLEXMAP_TESTS_HPP
+#define PAWLIB_FLEXMAP_TESTS_HPP
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Counts how often it is constructed, copied, and moved. */
+struct MapCounted
+{
+    static int constructs;
+    static int copies;
+    static int moves;
+
+    int value;
+
+    explicit MapCounted(int v = 0)
+    : value(v)
+    {
+        ++constructs;
+    }
+
+    MapCounted(const MapCounted& cpy)
+    : value(cpy.value)
+    {
+        ++copies;
+    }
+
+    MapCounted(MapCounted&& mov)
+    : value(mov.value)
+    {
+        ++moves;
+    }
+
+    MapCounted& operator=(const MapCounted& cpy)
+    {
+        value = cpy.value;
+        ++copies;
+        return *this;
+    }
+
+    MapCounted& operator=(MapCounted&& mov)
+    {
+        value = mov.value;
+        ++moves;
+        return *this;
+    }
+
+    static void reset()
+    {
+        constructs = 0;
+        copies = 0;
+        moves = 0;
+    }
+};
+
+// P-tB1101
+class TestMap_InsertFind : public Test
+{
+    public:
+        TestMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Insert & Find";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert " + stdutils::itos(count) + " elements in a scrambled order, and find each of them.";
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = (i * 7919) % count;
+                PL_ASSERT_TRUE(map.insert(key, key * 2));
+            }
+            // Duplicate keys are rejected, and the value is kept.
+            PL_ASSERT_FALSE(map.insert(5, 0));
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(count));
+
+            for(int i = 0; i < count; ++i)
+            {
+                int* value = map.find(i);
+                PL_ASSERT_TRUE(value != nullptr);
+                PL_ASSERT_EQUAL(*value, i * 2);
+            }
+            PL_ASSERT_TRUE(map.find(-1) == nullptr);
+            PL_ASSERT_FALSE(map.contains(count + 1));
+
+            // Elements are visited in key order.
+            int expected = 0;
+            bool ordered = true;
+            map.for_each([&](const int& key, const int&)
+            {
+                ordered = ordered && (key == expected++);
+            });
+            PL_ASSERT_TRUE(ordered);
+            return true;
+        }
+
+        ~TestMap_InsertFind(){}
+
+    private:
+        static const int count = 1000;
+};
+
+// P-tB1102
+class TestMap_Remove : public Test
+{
+    public:
+        TestMap_Remove(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Remove every other element, and ensure the rest are found and keep their addresses.";
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                map.insert(i, i);
+            }
+            int* kept = map.find(1);
+
+            for(int i = 0; i < count; i += 2)
+            {
+                PL_ASSERT_TRUE(map.remove(i));
+            }
+            PL_ASSERT_FALSE(map.remove(0));
+            PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(count / 2));
+
+            for(int i = 0; i < count; ++i)
+            {
+                PL_ASSERT_EQUAL(map.contains(i), (i % 2 == 1));
+            }
+            // Removing other elements does not move the stored values.
+            PL_ASSERT_TRUE(map.find(1) == kept);
+
+            map.clear();
+            PL_ASSERT_TRUE(map.empty());
+            // Nodes are reused after clearing.
+            map.insert(3, 9);
+            PL_ASSERT_EQUAL(*map.find(3), 9);
+            return true;
+        }
+
+        ~TestMap_Remove(){}
+
+    private:
+        static const int count = 500;
+};
+
+// P-tB1103
+class TestMap_Retrieve : public Test
+{
+    public:
+        TestMap_Retrieve(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Retrieve";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure retrieve() writes the value out when the key exists, and leaves it alone otherwise.";
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            map.insert(1, 10);
+            map.insert(2, 20);
+
+            int out = 0;
+            PL_ASSERT_TRUE(map.retrieve(2, &out));
+            PL_ASSERT_EQUAL(out, 20);
+            PL_ASSERT_FALSE(map.retrieve(3, &out));
+            PL_ASSERT_EQUAL(out, 20);
+            return true;
+        }
+
+        ~TestMap_Retrieve(){}
+};
+
+// P-tB1104
+class TestMap_Emplace : public Test
+{
+    public:
+        TestMap_Emplace(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Emplace";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure try_emplace(), insert_or_assign(), operator[] and find() never copy a stored value.";
+        }
+
+        bool run() override
+        {
+            Map<int, MapCounted> map;
+            MapCounted::reset();
+
+            auto result = map.try_emplace(1, 100);
+            PL_ASSERT_TRUE(result.second);
+            PL_ASSERT_EQUAL(result.first->value, 100);
+            // An existing key doesn't construct anything.
+            result = map.try_emplace(1, 200);
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_EQUAL(result.first->value, 100);
+            PL_ASSERT_EQUAL(MapCounted::constructs, 1);
+
+            map[2].value = 5;
+            PL_ASSERT_EQUAL(map[2].value, 5);
+
+            result = map.insert_or_assign(2, MapCounted(7));
+            PL_ASSERT_FALSE(result.second);
+            PL_ASSERT_EQUAL(map.find(2)->value, 7);
+            result = map.insert_or_assign(3, MapCounted(8));
+            PL_ASSERT_TRUE(result.second);
+
+            for(int i = 0; i < 100; ++i)
+            {
+                map.find(1 + i % 3);
+            }
+            PL_ASSERT_EQUAL(MapCounted::copies, 0);
+            // Only the two temporaries passed to insert_or_assign were moved.
+            PL_ASSERT_EQUAL(MapCounted::moves, 2);
+            return true;
+        }
+
+        ~TestMap_Emplace(){}
+};
+
+// P-tB1105
+class TestMap_Heterogeneous : public Test
+{
+    public:
+        TestMap_Heterogeneous(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Heterogeneous Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up, retrieve, and remove onestring keys by const char*.";
+        }
+
+        bool run() override
+        {
+            Map<onestring, int> map;
+            map.insert("cat", 1);
+            map.insert("dog", 2);
+            map["mouse"] = 3;
+
+            PL_ASSERT_TRUE(map.contains("dog"));
+            PL_ASSERT_EQUAL(*map.find("mouse"), 3);
+            PL_ASSERT_TRUE(map.find("horse") == nullptr);
+
+            int out = 0;
+            PL_ASSERT_TRUE(map.retrieve("cat", &out));
+            PL_ASSERT_EQUAL(out, 1);
+
+            PL_ASSERT_TRUE(map.remove("cat"));
+            PL_ASSERT_FALSE(map.contains("cat"));
+            return true;
+        }
+
+        ~TestMap_Heterogeneous(){}
+};
+
+// P-tB1106
+class TestMap_Copy : public Test
+{
+    public:
+        TestMap_Copy(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Copy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a copied map is independent of the original.";
+        }
+
+        bool run() override
+        {
+            Map<int, onestring> map;
+            for(int i = 0; i < 50; ++i)
+            {
+                map.insert(i, onestring("value"));
+            }
+
+            Map<int, onestring> copy(map);
+            PL_ASSERT_EQUAL(copy.size(), map.size());
+            *(copy.find(0)) = "changed";
+            copy.remove(1);
+            PL_ASSERT_EQUAL(*(map.find(0)), "value");
+            PL_ASSERT_TRUE(map.contains(1));
+
+            map = copy;
+            PL_ASSERT_EQUAL(*(map.find(0)), "changed");
+            PL_ASSERT_FALSE(map.contains(1));
+            PL_ASSERT_EQUAL(map.size(), 49u);
+            return true;
+        }
+
+        ~TestMap_Copy(){}
+};
+
+// P-tB1108
+class TestMap_Compact : public Test
+{
+    public:
+        TestMap_Compact(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Compact";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure compacting a map, in either layout, keeps its contents "
+                   "and releases its unused capacity.";
+        }
+
+        bool run() override
+        {
+            const AVLLayout layouts[] = {AVLLayout::breadth_first,
+                                         AVLLayout::van_emde_boas};
+            for(AVLLayout layout : layouts)
+            {
+                Map<int, onestring> map;
+                // Scrambled insertions, with removals leaving holes behind.
+                for(int i = 0; i < 1000; ++i)
+                {
+                    map.insert((i * 7919) % 1000, onestring(stdutils::itos(i)));
+                }
+                for(int i = 0; i < 1000; i += 3)
+                {
+                    map.remove(i);
+                }
+                PL_ASSERT_GREATER(map.capacity(), map.size());
+
+                map.compact(layout);
+                PL_ASSERT_EQUAL(map.capacity(), map.size());
+                int expected = 0;
+                bool ordered = true;
+                map.for_each([&expected, &ordered](const int& key, const onestring&)
+                {
+                    if(expected % 3 == 0)
+                    {
+                        ++expected;
+                    }
+                    ordered = ordered && (key == expected);
+                    ++expected;
+                });
+                PL_ASSERT_TRUE(ordered);
+                PL_ASSERT_EQUAL(expected, 999);
+                for(int i = 0; i < 1000; ++i)
+                {
+                    PL_ASSERT_EQUAL(map.contains(i), i % 3 != 0);
+                }
+
+                // The map must keep working after it is compacted.
+                for(int i = 0; i < 1000; i += 3)
+                {
+                    PL_ASSERT_TRUE(map.insert(i, onestring("back")));
+                }
+                map.remove(1);
+                PL_ASSERT_EQUAL(map.size(), 999u);
+                PL_ASSERT_EQUAL(*(map.find(3)), "back");
+                PL_ASSERT_FALSE(map.contains(1));
+            }
+            return true;
+        }
+
+        ~TestMap_Compact(){}
+};
+
+// P-tB1109
+class TestMap_Capacity : public Test
+{
+    public:
+        TestMap_Capacity(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Capacity";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure reserve() avoids growing, and compacting an empty map "
+                   "frees its nodes.";
+        }
+
+        bool run() override
+        {
+            Map<int, onestring> map;
+            PL_ASSERT_EQUAL(map.capacity(), 0u);
+            map.reserve(100);
+            PL_ASSERT_EQUAL(map.capacity(), 100u);
+
+            // Pointers stay valid while nothing grows the node array.
+            onestring* first = map.try_emplace(0, "zero").first;
+            for(int i = 1; i < 100; ++i)
+            {
+                map.insert(i, onestring(stdutils::itos(i)));
+            }
+            PL_ASSERT_EQUAL(map.capacity(), 100u);
+            PL_ASSERT_EQUAL(first, map.find(0));
+
+            // Growing moves every element, which must survive intact.
+            map.insert(100, onestring("hundred"));
+            PL_ASSERT_GREATER(map.capacity(), 100u);
+            PL_ASSERT_EQUAL(*(map.find(0)), "zero");
+            PL_ASSERT_EQUAL(*(map.find(99)), "99");
+
+            map.clear();
+            PL_ASSERT_GREATER(map.capacity(), 0u);
+            map.compact();
+            PL_ASSERT_EQUAL(map.capacity(), 0u);
+            PL_ASSERT_TRUE(map.insert(1, onestring("one")));
+            PL_ASSERT_EQUAL(*(map.find(1)), "one");
+            return true;
+        }
+
+        ~TestMap_Capacity(){}
+};
+
+// P-tB1111
+class TestMap_FromSorted : public Test
+{
+    public:
+        TestMap_FromSorted(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: From Sorted";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a map built from sorted pairs holds exactly those pairs, "
+                   "and that unsorted input is rejected.";
+        }
+
+        bool run() override
+        {
+            std::vector<std::pair<int, onestring>> pairs;
+            for(int i = 0; i < 1000; ++i)
+            {
+                pairs.emplace_back(i * 2, onestring(stdutils::itos(i)));
+            }
+
+            Map<int, onestring> map = Map<int, onestring>::from_sorted(pairs);
+            PL_ASSERT_EQUAL(map.size(), 1000u);
+            PL_ASSERT_EQUAL(map.capacity(), 1000u);
+            for(int i = 0; i < 1000; ++i)
+            {
+                PL_ASSERT_EQUAL(*(map.find(i * 2)), stdutils::itos(i));
+                PL_ASSERT_FALSE(map.contains(i * 2 + 1));
+            }
+
+            // The map must keep working after it is built.
+            PL_ASSERT_TRUE(map.insert(1, onestring("one")));
+            PL_ASSERT_TRUE(map.remove(0));
+            PL_ASSERT_EQUAL(*(map.find(1)), "one");
+
+            Map<int, onestring> none = Map<int, onestring>::from_sorted(pairs.begin(), pairs.begin());
+            PL_ASSERT_TRUE(none.empty());
+
+            // A repeated key is out of order too.
+            pairs[500].first = pairs[499].first;
+            bool threw = false;
+            try
+            {
+                Map<int, onestring>::from_sorted(pairs);
+            }
+            catch(std::invalid_argument&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            return true;
+        }
+
+        ~TestMap_FromSorted(){}
+};
+
+// P-tB1112
+class TestMap_BulkInsert : public Test
+{
+    public:
+        TestMap_BulkInsert(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Bulk Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure bulk_insert() merges unsorted pairs into a map, keeping "
+                   "existing keys and the first of any repeated key.";
+        }
+
+        bool run() override
+        {
+            Map<int, onestring> map;
+            for(int i = 0; i < 100; ++i)
+            {
+                map.insert(i * 10, onestring("old"));
+            }
+
+            // Scrambled keys from 0 to 1999, each appearing twice.
+            std::vector<std::pair<int, onestring>> pairs;
+            for(int i = 0; i < 4000; ++i)
+            {
+                pairs.emplace_back((i * 7) % 2000, onestring(i < 2000 ? "first" : "second"));
+            }
+
+            PL_ASSERT_EQUAL(map.bulk_insert(pairs), 1900u);
+            PL_ASSERT_EQUAL(map.size(), 2000u);
+            for(int i = 0; i < 2000; ++i)
+            {
+                PL_ASSERT_EQUAL(*(map.find(i)), (i % 10 == 0 && i < 1000) ? "old" : "first");
+            }
+
+            // A handful of pairs into a large map are inserted one at a time.
+            std::pair<int, onestring> few[] = {
+                {5000, onestring("new")}, {7, onestring("ignored")}};
+            PL_ASSERT_EQUAL(map.bulk_insert(few), 1u);
+            PL_ASSERT_EQUAL(*(map.find(5000)), "new");
+            PL_ASSERT_EQUAL(*(map.find(7)), "first");
+
+            int previous = -1;
+            bool ordered = true;
+            map.for_each([&previous, &ordered](const int& key, const onestring&)
+            {
+                ordered = ordered && (previous < key);
+                previous = key;
+            });
+            PL_ASSERT_TRUE(ordered);
+            return true;
+        }
+
+        ~TestMap_BulkInsert(){}
+};
+
+// P-tB1121
+class TestMap_BulkInsertThrow : public Test
+{
+    public:
+        TestMap_BulkInsertThrow(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Bulk Insert Throwing";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a bulk_insert() that throws partway through the merge "
+                   "leaves the existing pairs in the map.";
+        }
+
+        struct Fragile
+        {
+            onestring text;
+
+            Fragile() = default;
+            explicit Fragile(const char* str) : text(str) {}
+            // Empty the moved-from text, so a lost move shows up.
+            Fragile(Fragile&& rhs) : text(rhs.text)
+            {
+                rhs.text = "";
+            }
+            Fragile(const Fragile& rhs) : text(rhs.text)
+            {
+                if(text == "throw")
+                {
+                    throw std::runtime_error("Fragile: copy");
+                }
+            }
+        };
+
+        bool run() override
+        {
+            Map<int, Fragile> map;
+            for(int i = 0; i < 100; ++i)
+            {
+                map.insert(i * 10, Fragile("old"));
+            }
+
+            // The copy that throws comes after half the old pairs are merged.
+            // Reserve, so that growing the vector never copies that pair.
+            std::vector<std::pair<int, Fragile>> pairs;
+            pairs.reserve(1000);
+            for(int i = 0; i < 1000; ++i)
+            {
+                pairs.emplace_back(i * 10 + 5, Fragile(i == 500 ? "throw" : "new"));
+            }
+
+            bool thrown = false;
+            try
+            {
+                map.bulk_insert(pairs);
+            }
+            catch(const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            PL_ASSERT_TRUE(thrown);
+            PL_ASSERT_EQUAL(map.size(), 100u);
+            for(int i = 0; i < 100; ++i)
+            {
+                PL_ASSERT_EQUAL(map.find(i * 10)->text, "old");
+            }
+            return true;
+        }
+
+        ~TestMap_BulkInsertThrow(){}
+};
+
+// P-tB1122
+class TestMap_BulkInsertThrowCount : public Test
+{
+    public:
+        TestMap_BulkInsertThrowCount(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Bulk Insert Throwing Comparison";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure a bulk_insert() whose comparison throws while counting "
+                   "the new pairs leaves the map unchanged.";
+        }
+
+        /* Comparing a new key against an existing one throws, so sorting
+         * the new keys succeeds and the merge's first probe fails. */
+        struct TouchyKey
+        {
+            int value;
+            bool touchy;
+
+            bool operator<(const TouchyKey& rhs) const
+            {
+                if(touchy != rhs.touchy)
+                {
+                    throw std::runtime_error("TouchyKey: compare");
+                }
+                return value < rhs.value;
+            }
+        };
+
+        bool run() override
+        {
+            Map<TouchyKey, int> map;
+            for(int i = 0; i < 100; ++i)
+            {
+                map.insert(TouchyKey{i * 10, false}, i);
+            }
+
+            std::vector<std::pair<TouchyKey, int>> pairs;
+            for(int i = 0; i < 1000; ++i)
+            {
+                pairs.emplace_back(TouchyKey{i * 10 + 5, true}, -1);
+            }
+
+            bool thrown = false;
+            try
+            {
+                map.bulk_insert(pairs);
+            }
+            catch(const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            PL_ASSERT_TRUE(thrown);
+            PL_ASSERT_EQUAL(map.size(), 100u);
+            for(int i = 0; i < 100; ++i)
+            {
+                PL_ASSERT_EQUAL(*(map.find(TouchyKey{i * 10, false})), i);
+            }
+            return true;
+        }
+
+        ~TestMap_BulkInsertThrowCount(){}
+};
+
+// P-tB1115
+class TestMap_Iterate : public Test
+{
+    public:
+        TestMap_Iterate(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Iterate";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure iterators visit every element in key order, forwards "
+                   "and backwards, after many insertions and removals.";
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            PL_ASSERT_TRUE(map.begin() == map.end());
+            for(int i = 0; i < 2000; ++i)
+            {
+                map.insert((i * 7919) % 2000, i);
+                if(i % 5 == 4)
+                {
+                    map.remove((i * 31) % 2000);
+                }
+            }
+
+            int previous = -1;
+            size_t visited = 0;
+            for(auto entry : map)
+            {
+                PL_ASSERT_LESS(previous, entry.key);
+                PL_ASSERT_TRUE(map.contains(entry.key));
+                previous = entry.key;
+                ++visited;
+            }
+            PL_ASSERT_EQUAL(visited, map.size());
+
+            visited = 0;
+            for(auto it = map.end(); it != map.begin(); ++visited)
+            {
+                --it;
+                PL_ASSERT_GREATER(previous + 1, it.key());
+                previous = it.key() - 1;
+            }
+            PL_ASSERT_EQUAL(visited, map.size());
+
+            // Values can be changed through an iterator.
+            Map<int, int>::iterator first = map.begin();
+            first.value() = -1;
+            PL_ASSERT_EQUAL(*(map.find(first.key())), -1);
+
+            // Iterators survive the node array growing.
+            int key = first.key();
+            for(int i = 2000; i < 6000; ++i)
+            {
+                map.insert(i, i);
+            }
+            PL_ASSERT_EQUAL(first.key(), key);
+            PL_ASSERT_EQUAL(first.value(), -1);
+            return true;
+        }
+
+        ~TestMap_Iterate(){}
+};
+
+// P-tB1116
+class TestMap_Bounds : public Test
+{
+    public:
+        TestMap_Bounds(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Bounds";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure lower_bound(), upper_bound(), and equal_range() find "
+                   "the right elements, for keys present and absent.";
+        }
+
+        bool run() override
+        {
+            // onestring orders by length first, so the keys are all one length.
+            Map<onestring, int> map;
+            const char* names[] = {"bravo", "delta", "hotel", "oscar"};
+            for(int i = 0; i < 4; ++i)
+            {
+                map.insert(onestring(names[i]), i);
+            }
+
+            PL_ASSERT_EQUAL(map.lower_bound("delta").key(), "delta");
+            PL_ASSERT_EQUAL(map.upper_bound("delta").key(), "hotel");
+            PL_ASSERT_EQUAL(map.lower_bound("coral").key(), "delta");
+            PL_ASSERT_EQUAL(map.upper_bound("coral").key(), "delta");
+            PL_ASSERT_EQUAL(map.lower_bound("alpha").key(), "bravo");
+            PL_ASSERT_TRUE(map.lower_bound("tango") == map.end());
+            PL_ASSERT_TRUE(map.upper_bound("oscar") == map.end());
+
+            auto found = map.equal_range("hotel");
+            PL_ASSERT_EQUAL(found.first.key(), "hotel");
+            PL_ASSERT_EQUAL(found.second.key(), "oscar");
+            auto missing = map.equal_range("kilos");
+            PL_ASSERT_TRUE(missing.first == missing.second);
+            PL_ASSERT_EQUAL(missing.first.key(), "oscar");
+
+            const Map<onestring, int>& constMap = map;
+            Map<onestring, int>::const_iterator last = --constMap.end();
+            PL_ASSERT_EQUAL(last.key(), "oscar");
+            PL_ASSERT_EQUAL((*last).value, 3);
+            return true;
+        }
+
+        ~TestMap_Bounds(){}
+};
+
+// P-tB1117
+class TestMap_Range : public Test
+{
+    public:
+        TestMap_Range(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Range";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure for_each_in_range() visits exactly the keys in [low, high), in order.";
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            for(int i = 0; i < 1000; ++i)
+            {
+                map.insert(i * 2, i);
+            }
+
+            int expected = 100;
+            map.for_each_in_range(99, 200, [&expected](const int& key, const int& value)
+            {
+                if(key == expected && value == key / 2)
+                {
+                    expected += 2;
+                }
+            });
+            PL_ASSERT_EQUAL(expected, 200);
+
+            int visited = 0;
+            auto count = [&visited](const int&, const int&) { ++visited; };
+            map.for_each_in_range(500, 500, count);
+            map.for_each_in_range(600, 400, count);
+            map.for_each_in_range(5000, 6000, count);
+            PL_ASSERT_EQUAL(visited, 0);
+            map.for_each_in_range(-100, 4, count);
+            PL_ASSERT_EQUAL(visited, 2);
+            return true;
+        }
+
+        ~TestMap_Range(){}
+};
+
+// P-tB1119
+class TestMap_OrderStats : public Test
+{
+    public:
+        TestMap_OrderStats(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Order Statistics";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert and remove random keys, and ensure rank(), select(), and count_range() stay correct, including after copying, compacting, and bulk inserting.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(1119);
+            std::map<int, int> model;
+            Map<int, int, true> map;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = static_cast<int>(rng() % (count * 2));
+                if(rng() % 3 == 0)
+                {
+                    model.erase(key);
+                    map.remove(key);
+                }
+                else
+                {
+                    model.emplace(key, i);
+                    map.insert(key, i);
+                }
+                if(i % 250 == 0 && !check(map, model))
+                {
+                    return false;
+                }
+            }
+            PL_ASSERT_TRUE(check(map, model));
+
+            Map<int, int, true> copied = map;
+            PL_ASSERT_TRUE(check(copied, model));
+            map.compact();
+            PL_ASSERT_TRUE(check(map, model));
+
+            std::vector<std::pair<int, int>> more;
+            for(int i = 0; i < count; ++i)
+            {
+                more.emplace_back(static_cast<int>(rng() % (count * 4)), -i);
+            }
+            for(auto& pair : more)
+            {
+                model.emplace(pair.first, pair.second);
+            }
+            map.bulk_insert(more);
+            PL_ASSERT_TRUE(check(map, model));
+
+            // A map without order statistics is untouched by the option.
+            Map<int, int> plain;
+            plain.insert(1, 1);
+            PL_ASSERT_EQUAL(plain.size(), 1u);
+            return true;
+        }
+
+        ~TestMap_OrderStats(){}
+
+    private:
+        static const int count = 2000;
+
+        //checks every order statistic against the model
+        static bool check(const Map<int, int, true>& map, const std::map<int, int>& model)
+        {
+            size_t position = 0;
+            for(auto it = model.begin(); it != model.end(); ++it, ++position)
+            {
+                if(map.rank(it->first) != position || map.rank(it->first + 1) != position + 1)
+                {
+                    return false;
+                }
+                auto selected = map.select(position);
+                if(selected == map.end() || selected.key() != it->first)
+                {
+                    return false;
+                }
+            }
+            if(map.select(model.size()) != map.end())
+            {
+                return false;
+            }
+            for(int low = -5; low < count * 4; low += 97)
+            {
+                int high = low + 301;
+                size_t expected = static_cast<size_t>(std::distance(model.lower_bound(low), model.lower_bound(high)));
+                if(map.count_range(low, high) != expected || map.count_range(high, low) != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+};
+
+// P-tB1107*
+class TestMap_LookupStd : public Test
+{
+    public:
+        TestMap_LookupStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::map: Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up each of " + stdutils::itos(count) + " keys in a std::map.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map[i] = i;
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int sum = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                sum += map.find(i)->second;
+            }
+            return sum != 0;
+        }
+
+        ~TestMap_LookupStd(){}
+
+    private:
+        static const int count = 1000;
+        std::map<int, int> map;
+};
+
+// P-tB1107
+class TestMap_Lookup : public Test
+{
+    public:
+        TestMap_Lookup(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up each of " + stdutils::itos(count) + " keys in a Map.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map[i] = i;
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            int sum = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                sum += *map.find(i);
+            }
+            return sum != 0;
+        }
+
+        ~TestMap_Lookup(){}
+
+    private:
+        static const int count = 1000;
+        Map<int, int> map;
+};
+
+// P-tB1110, P-tB1110*
+class TestMap_ScatteredLookup : public Test
+{
+    public:
+        explicit TestMap_ScatteredLookup(bool compacted = false)
+        : compacted(compacted)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return compacted ? "Map: Compacted Lookup" : "Map: Scattered Lookup";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(count) + " keys in a Map built in "
+                   "scrambled order" + (compacted ? ", then compacted." : ".");
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map[(i * 7919) % count] = i;
+                }
+                if(compacted)
+                {
+                    map.compact();
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(int i = 0; i < count; ++i)
+            {
+                sum += *map.find((i * 7927) % count);
+            }
+            return sum != 0;
+        }
+
+        ~TestMap_ScatteredLookup(){}
+
+    private:
+        static const int count = 100000;
+        bool compacted;
+        Map<int, int> map;
+};
+
+// P-tB1113*, P-tB1114*
+class TestMap_BuildInsert : public Test
+{
+    public:
+        explicit TestMap_BuildInsert(bool sorted = true)
+        : sorted(sorted)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return sorted ? "Map: Insert Sorted" : "Map: Insert Unsorted";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a Map by inserting " + stdutils::itos(count) +
+                   (sorted ? " sorted" : " unsorted") + " pairs one at a time.";
+        }
+
+        bool pre() override
+        {
+            if(pairs.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    pairs.emplace_back(sorted ? i : (i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            for(const auto& pair : pairs)
+            {
+                map.insert(pair.first, pair.second);
+            }
+            return map.size() == pairs.size();
+        }
+
+        ~TestMap_BuildInsert(){}
+
+    private:
+        static const int count = 100000;
+        bool sorted;
+        std::vector<std::pair<int, int>> pairs;
+};
+
+// P-tB1113
+class TestMap_BuildFromSorted : public Test
+{
+    public:
+        TestMap_BuildFromSorted(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: From Sorted";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a Map from " + stdutils::itos(count) + " sorted pairs "
+                   "with from_sorted().";
+        }
+
+        bool pre() override
+        {
+            if(pairs.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    pairs.emplace_back(i, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            Map<int, int> map = Map<int, int>::from_sorted(pairs);
+            return map.size() == pairs.size();
+        }
+
+        ~TestMap_BuildFromSorted(){}
+
+    private:
+        static const int count = 100000;
+        std::vector<std::pair<int, int>> pairs;
+};
+
+// P-tB1114
+class TestMap_BuildBulkInsert : public Test
+{
+    public:
+        TestMap_BuildBulkInsert(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Bulk Insert";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a Map from " + stdutils::itos(count) + " unsorted pairs "
+                   "with bulk_insert().";
+        }
+
+        bool pre() override
+        {
+            if(pairs.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    pairs.emplace_back((i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            Map<int, int> map;
+            map.bulk_insert(pairs);
+            return map.size() == pairs.size();
+        }
+
+        ~TestMap_BuildBulkInsert(){}
+
+    private:
+        static const int count = 100000;
+        std::vector<std::pair<int, int>> pairs;
+};
+
+// P-tB1118*
+class TestMap_RangeStd : public Test
+{
+    public:
+        TestMap_RangeStd(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::map: Range Scan";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sum the values of " + stdutils::itos(width) + " consecutive keys, "
+                   "at " + stdutils::itos(scans) + " places in a std::map.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map[i] = i;
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(int s = 0; s < scans; ++s)
+            {
+                int low = (s * 7919) % (count - width);
+                auto end = map.lower_bound(low + width);
+                for(auto it = map.lower_bound(low); it != end; ++it)
+                {
+                    sum += it->second;
+                }
+            }
+            return sum != 0;
+        }
+
+        ~TestMap_RangeStd(){}
+
+    private:
+        static const int count = 100000;
+        static const int width = 100;
+        static const int scans = 1000;
+        std::map<int, int> map;
+};
+
+// P-tB1118
+class TestMap_RangeScan : public Test
+{
+    public:
+        TestMap_RangeScan(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Range Scan";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sum the values of " + stdutils::itos(width) + " consecutive keys, "
+                   "at " + stdutils::itos(scans) + " places in a Map.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map[i] = i;
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(int s = 0; s < scans; ++s)
+            {
+                int low = (s * 7919) % (count - width);
+                map.for_each_in_range(low, low + width, [&sum](const int&, const int& value)
+                {
+                    sum += value;
+                });
+            }
+            return sum != 0;
+        }
+
+        ~TestMap_RangeScan(){}
+
+    private:
+        static const int count = 100000;
+        static const int width = 100;
+        static const int scans = 1000;
+        Map<int, int> map;
+};
+
+// P-tB1120*
+class TestMap_PercentileWalk : public Test
+{
+    public:
+        TestMap_PercentileWalk(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Percentiles by Walking";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find every percentile of a Map of " + stdutils::itos(count) +
+                   " elements, by stepping an iterator from the beginning.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map.insert((i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(int p = 0; p < 100; ++p)
+            {
+                auto it = map.begin();
+                std::advance(it, static_cast<size_t>(p) * count / 100);
+                sum += it.key();
+            }
+            return sum > 0;
+        }
+
+        ~TestMap_PercentileWalk(){}
+
+    private:
+        static const int count = 100000;
+        Map<int, int> map;
+};
+
+// P-tB1120
+class TestMap_PercentileSelect : public Test
+{
+    public:
+        TestMap_PercentileSelect(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Percentiles by select()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find every percentile of a Map of " + stdutils::itos(count) +
+                   " elements, with order statistics.";
+        }
+
+        bool janitor() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map.insert((i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            long long sum = 0;
+            for(int p = 0; p < 100; ++p)
+            {
+                sum += map.select(static_cast<size_t>(p) * count / 100).key();
+            }
+            return sum > 0;
+        }
+
+        ~TestMap_PercentileSelect(){}
+
+    private:
+        static const int count = 100000;
+        Map<int, int, true> map;
+};
+
+class TestSuite_FlexMap : public TestSuite
+{
+    public:
+        explicit TestSuite_FlexMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: Map Tests";
+        }
+
+        ~TestSuite_FlexMap(){}
+};
+
+#endif // PAWLIB_FLEXMAP_TESTS_HPP
@@ -48,22 +48,31 @@
 #include "pawlib/base_flex_array.hpp"
 #include "pawlib/iochannel.hpp"
 
-template <typename type, bool raw_copy = false, bool factor_double = true>
-class FlexQueue : public Base_FlexArr<type, raw_copy, factor_double>
+template <typename type, bool raw_copy = false, bool factor_double = true,
+          typename alloc_t = std::allocator<type>>
+class FlexQueue : public Base_FlexArr<type, raw_copy, factor_double, alloc_t>
 {
     public:
         /** Create a new FlexQueue with the default capacity.
              */
         FlexQueue()
-        :Base_FlexArr<type, raw_copy, factor_double>()
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>()
         {}
 
         /** Create a new FlexQueue with the specified minimum capacity.
              * \param the minimum number of elements that the FlexQueue can contain.
              */
         // cppcheck-suppress noExplicitConstructor
-        FlexQueue(size_t numElements)
-        :Base_FlexArr<type, raw_copy, factor_double>(numElements)
+        FlexQueue(size_t numElements, const alloc_t& alloc = alloc_t())
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(numElements, alloc)
+        {}
+
+        /** Create a new FlexQueue with the default capacity, which allocates
+         * from the given allocator.
+         * \param the allocator to use
+         */
+        explicit FlexQueue(const alloc_t& alloc)
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(alloc)
         {}
 
         /** Adds the specified element to the FlexQueue.
@@ -50,17 +50,22 @@
 #include "pawlib/base_flex_array.hpp"
 #include "pawlib/iochannel.hpp"
 
-template <typename type, bool raw_copy = false, bool factor_double = true>
-class FlexStack : public Base_FlexArr<type, raw_copy, factor_double>
+template <typename type, bool raw_copy = false, bool factor_double = true,
+          typename alloc_t = std::allocator<type>>
+class FlexStack : public Base_FlexArr<type, raw_copy, factor_double, alloc_t>
 {
     public:
         FlexStack()
-        :Base_FlexArr<type, raw_copy, factor_double>()
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>()
         {}
 
         // cppcheck-suppress noExplicitConstructor
-        FlexStack(size_t numElements)
-        :Base_FlexArr<type, raw_copy, factor_double>(numElements)
+        FlexStack(size_t numElements, const alloc_t& alloc = alloc_t())
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(numElements, alloc)
+        {}
+
+        explicit FlexStack(const alloc_t& alloc)
+        :Base_FlexArr<type, raw_copy, factor_double, alloc_t>(alloc)
         {}
 
         /** Add the specified element to the FlexStack.
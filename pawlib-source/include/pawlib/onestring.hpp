@@ -50,10 +50,13 @@
 
 #include <algorithm>
 #include <cctype> // isspace()
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <istream>
+#include <memory_resource>
+#include <new>
 
 #include "pawlib/onechar.hpp"
 
@@ -81,9 +84,16 @@ class onestring
         /// The array of onechars
         onechar* internal;
 
+        /** The number of onechars the array was actually allocated with.
+         * This can briefly differ from _capacity while resizing. */
+        size_t _allocated;
+
         /// The cached c-string. We store this pointer to ensure it is cleaned up properly.
         mutable char* _c_str;
 
+        /// The memory resource the array of onechars is allocated from.
+        std::pmr::memory_resource* resource;
+
     public:
         /*******************************************
         * Constructors + Destructor
@@ -116,6 +126,13 @@ class onestring
         // cppcheck-suppress noExplicitConstructor
         onestring(const onechar& ch);
 
+        /**Create an empty onestring whose characters are allocated from the
+         * given memory resource, which must outlive the onestring.
+         * All other constructors use std::pmr::get_default_resource().
+         * Copies do not inherit the resource.
+         * \param the memory resource to allocate from */
+        explicit onestring(std::pmr::memory_resource* res);
+
         /**Destructor*/
         ~onestring();
 
@@ -129,6 +146,17 @@ class onestring
              * \param the number of elements to allocate space for */
         void allocate(size_t capacity);
 
+        /** Allocates and default-constructs an array of onechars
+             * from the memory resource.
+             * \param the number of onechars
+             * \return the new array */
+        onechar* make_array(size_t capacity);
+
+        /** Destroys and frees an array of onechars from make_array().
+             * \param the array
+             * \param the number of onechars it was allocated with */
+        void free_array(onechar* arr, size_t capacity);
+
         /** Shifts the contents of the onestring efficiently.
              * WARNING: Does not check for validity of shift, nor perform
              * expansions or shrinks. That is the responsibility of the caller.
@@ -139,6 +167,9 @@ class onestring
 
     public:
 
+        /** Returns the memory resource the onestring allocates from. */
+        std::pmr::memory_resource* get_resource() const { return resource; }
+
         /** Requests that the string capacity be expanded to accomidate
          * the given number of additional characters.
          * `s.expand(n)` is equivalent to `s.reserve(s.length() + n)`
@@ -257,6 +288,17 @@ class onestring
              */
         size_t size(size_t, size_t = 0) const;
 
+        /** Hashes the bytes of the equivalent c-string, without building it.
+             * This matches onestring::hash(const char*, size_t) on those bytes.
+             * \return the hash */
+        size_t hash() const;
+
+        /** Hashes a run of bytes, the same way onestring::hash() does.
+             * \param the bytes to hash
+             * \param the number of bytes
+             * \return the hash */
+        static size_t hash(const char*, size_t);
+
 
         /*******************************************
         * Comparison
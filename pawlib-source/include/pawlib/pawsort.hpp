@@ -45,11 +45,41 @@
 #ifndef PAWLIB_PAWSORT_HPP
 #define PAWLIB_PAWSORT_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* The sorting networks are compiled for AVX2 function by function, so that
+ * they can be chosen at runtime even when the rest is built for an older
+ * processor. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PAWLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
 
 namespace pawsort
 {
+    /* The array overloads below forward to these, which are defined further
+     * down; declaring them here lets ordinary lookup find them, since
+     * argument-dependent lookup does not apply to raw pointers. */
+    template<class RandomIt, class Compare>
+    static void introsort(RandomIt first, RandomIt last, Compare comp,
+                          int maxdepth = -1);
+    template<class RandomIt>
+    static void dual_pivot_quick_sort(RandomIt first, RandomIt last);
+    template<typename T> static void sift_down(T arr[], int left, int right);
+
     /** An implementation of the selection sort algorithm.
      * Seriously, why would you even want to use this?
      * Consider `insertion_sort` instead.
@@ -65,9 +95,9 @@ namespace pawsort
      */
     template<typename T> inline static void swap(T& a, T& b)
     {
-        a ^= b;
-        b ^= a;
-        a ^= b;
+        T temp(std::move(a));
+        a = std::move(b);
+        b = std::move(temp);
     }
 
     template<typename T> static void selection_sort(T arr[], int len)
@@ -381,6 +411,366 @@ namespace pawsort
         }
     }
 
+    /* Sorting networks sort ranges of up to this many elements. */
+    static const std::ptrdiff_t NETWORK_SIZE = 64;
+
+    /** Whether network_sort can sort a range with a sorting network: the
+     * elements must be signed 32- or 64-bit integers, floats, or doubles,
+     * in a pointer or vector range, compared with std::less.
+     */
+    template<class RandomIt, class Compare> struct NetworkSortable
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type T;
+        static const bool value =
+            (std::is_pointer<RandomIt>::value ||
+             std::is_same<RandomIt, typename std::vector<T>::iterator>::value) &&
+            (std::is_same<Compare, std::less<>>::value ||
+             std::is_same<Compare, std::less<T>>::value) &&
+            (sizeof(T) == 4 || sizeof(T) == 8) &&
+            ((std::is_integral<T>::value && std::is_signed<T>::value) ||
+             std::is_floating_point<T>::value);
+    };
+
+#if defined(PAWLIB_TARGET_AVX2)
+    /** A component of network_sort. Returns the mask for
+     * _mm256_blend_epi32 which takes the lanes with bit j of their index set.
+     */
+    constexpr int network_blend_mask(unsigned int j, unsigned int lanes)
+    {
+        const unsigned int WIDTH = 8 / lanes;
+        int mask = 0;
+        for (unsigned int i = 0; i < lanes; ++i)
+        {
+            if (i & j)
+            {
+                mask |= ((1 << WIDTH) - 1) << (i * WIDTH);
+            }
+        }
+        return mask;
+    }
+
+    /** A component of network_sort. The AVX2 operations on eight 32-bit
+     * keys, which are signed integers, or floats mapped to them.
+     */
+    struct NetworkLanes32
+    {
+        typedef int32_t key_t;
+        typedef __m256i vec_t;
+        static const unsigned int lanes = 8;
+
+        PAWLIB_TARGET_AVX2 static vec_t load(const key_t* keys)
+        {
+            return _mm256_load_si256(reinterpret_cast<const vec_t*>(keys));
+        }
+
+        PAWLIB_TARGET_AVX2 static void store(key_t* keys, vec_t v)
+        {
+            _mm256_store_si256(reinterpret_cast<vec_t*>(keys), v);
+        }
+
+        /* Flips every bit but the sign of negative floats, which are stored
+         * as sign and magnitude, so they compare as integers. Undoes itself.
+         */
+        PAWLIB_TARGET_AVX2 static vec_t encode_float(vec_t v)
+        {
+            const vec_t SIGN = _mm256_srai_epi32(v, 31);
+            return _mm256_xor_si256(v, _mm256_srli_epi32(SIGN, 1));
+        }
+
+        PAWLIB_TARGET_AVX2 static void minmax(vec_t& low, vec_t& high)
+        {
+            const vec_t MIN = _mm256_min_epi32(low, high);
+            high = _mm256_max_epi32(low, high);
+            low = MIN;
+        }
+
+        // Moves each lane i to lane i ^ M.
+        template<unsigned int M> PAWLIB_TARGET_AVX2 static vec_t permute(vec_t v)
+        {
+            if constexpr ((M & 4) != 0)
+            {
+                v = _mm256_permute4x64_epi64(v, 0x4E);
+            }
+            if constexpr ((M & 3) != 0)
+            {
+                constexpr int ORDER = (0 ^ (M & 3)) | (1 ^ (M & 3)) << 2 |
+                                  (2 ^ (M & 3)) << 4 | (3 ^ (M & 3)) << 6;
+                v = _mm256_shuffle_epi32(v, ORDER);
+            }
+            return v;
+        }
+    };
+
+    /** A component of network_sort. The AVX2 operations on four 64-bit
+     * keys, which are signed integers, or doubles mapped to them.
+     */
+    struct NetworkLanes64
+    {
+        typedef int64_t key_t;
+        typedef __m256i vec_t;
+        static const unsigned int lanes = 4;
+
+        PAWLIB_TARGET_AVX2 static vec_t load(const key_t* keys)
+        {
+            return _mm256_load_si256(reinterpret_cast<const vec_t*>(keys));
+        }
+
+        PAWLIB_TARGET_AVX2 static void store(key_t* keys, vec_t v)
+        {
+            _mm256_store_si256(reinterpret_cast<vec_t*>(keys), v);
+        }
+
+        // AVX2 has no 64-bit arithmetic shift, so the sign comes from a compare.
+        PAWLIB_TARGET_AVX2 static vec_t encode_float(vec_t v)
+        {
+            const vec_t SIGN = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+            return _mm256_xor_si256(v, _mm256_srli_epi64(SIGN, 1));
+        }
+
+        // AVX2 has no 64-bit min and max either.
+        PAWLIB_TARGET_AVX2 static void minmax(vec_t& low, vec_t& high)
+        {
+            const vec_t GREATER = _mm256_cmpgt_epi64(low, high);
+            const vec_t MIN = _mm256_blendv_epi8(low, high, GREATER);
+            high = _mm256_blendv_epi8(high, low, GREATER);
+            low = MIN;
+        }
+
+        // Moves each lane i to lane i ^ M.
+        template<unsigned int M> PAWLIB_TARGET_AVX2 static vec_t permute(vec_t v)
+        {
+            if constexpr ((M & 2) != 0)
+            {
+                v = _mm256_permute4x64_epi64(v, 0x4E);
+            }
+            if constexpr ((M & 1) != 0)
+            {
+                v = _mm256_shuffle_epi32(v, 0x4E);
+            }
+            return v;
+        }
+    };
+
+    /** A component of network_sort. Compares each lane i of a vector with
+     * lane i ^ M, and puts the lesser of each pair in the lane without bit
+     * j of its index set.
+     */
+    template<class Lanes, unsigned int M, unsigned int J>
+    PAWLIB_TARGET_AVX2 static typename Lanes::vec_t
+    network_exchange(typename Lanes::vec_t v)
+    {
+        typename Lanes::vec_t low = v;
+        typename Lanes::vec_t high = Lanes::template permute<M>(v);
+        Lanes::minmax(low, high);
+        constexpr int MASK = network_blend_mask(J, Lanes::lanes);
+        return _mm256_blend_epi32(low, high, MASK);
+    }
+
+    /** A component of network_sort. The half-cleaner steps of a bitonic
+     * merge, which compare each key i with key i ^ J, for each J from the
+     * one given down to 1.
+     */
+    template<class Lanes, unsigned int N, unsigned int J>
+    PAWLIB_TARGET_AVX2 static void
+    bitonic_clean(typename Lanes::vec_t* v)
+    {
+        if constexpr (J >= 1)
+        {
+            const unsigned int W = Lanes::lanes;
+            if constexpr (J < W)
+            {
+                for (unsigned int r = 0; r < N / W; ++r)
+                {
+                    v[r] = network_exchange<Lanes, J, J>(v[r]);
+                }
+            }
+            else
+            {
+                // The pairs are in different vectors, lane for lane.
+                for (unsigned int r = 0; r < N / W; ++r)
+                {
+                    if ((r & (J / W)) == 0)
+                    {
+                        Lanes::minmax(v[r], v[r + J / W]);
+                    }
+                }
+            }
+            bitonic_clean<Lanes, N, J / 2>(v);
+        }
+    }
+
+    /** A component of network_sort. Sorts N keys held in vectors with a
+     * bitonic sorting network, by merging sorted blocks of K / 2 keys into
+     * blocks of K, for each K from the one given up to N.
+     *
+     * Each merge first compares key i with key i ^ (K - 1), which reverses
+     * the second block, so no block needs to be sorted in descending order.
+     */
+    template<class Lanes, unsigned int N, unsigned int K = 2>
+    PAWLIB_TARGET_AVX2 static void
+    bitonic_merges(typename Lanes::vec_t* v)
+    {
+        if constexpr (K <= N)
+        {
+            const unsigned int W = Lanes::lanes;
+            if constexpr (K <= W)
+            {
+                for (unsigned int r = 0; r < N / W; ++r)
+                {
+                    v[r] = network_exchange<Lanes, K - 1, K / 2>(v[r]);
+                }
+            }
+            else
+            {
+                const unsigned int R = K / W;
+                for (unsigned int b = 0; b < N / W; b += R)
+                {
+                    for (unsigned int r = 0; r < R / 2; ++r)
+                    {
+                        typename Lanes::vec_t high =
+                            Lanes::template permute<W - 1>(v[b + R - 1 - r]);
+                        Lanes::minmax(v[b + r], high);
+                        v[b + R - 1 - r] = Lanes::template permute<W - 1>(high);
+                    }
+                }
+            }
+            bitonic_clean<Lanes, N, K / 4>(v);
+            bitonic_merges<Lanes, N, K * 2>(v);
+        }
+    }
+
+    /** A component of network_sort. Sorts N aligned keys in AVX2
+     * registers, mapping floating point keys to integers and back.
+     */
+    template<class Lanes, bool floating, unsigned int N>
+    PAWLIB_TARGET_AVX2 static void
+    network_sort_avx2(typename Lanes::key_t* keys)
+    {
+        typename Lanes::vec_t v[N / Lanes::lanes];
+        for (unsigned int r = 0; r < N / Lanes::lanes; ++r)
+        {
+            v[r] = Lanes::load(keys + r * Lanes::lanes);
+            if constexpr (floating)
+            {
+                v[r] = Lanes::encode_float(v[r]);
+            }
+        }
+        bitonic_merges<Lanes, N>(v);
+        for (unsigned int r = 0; r < N / Lanes::lanes; ++r)
+        {
+            if constexpr (floating)
+            {
+                v[r] = Lanes::encode_float(v[r]);
+            }
+            Lanes::store(keys + r * Lanes::lanes, v[r]);
+        }
+    }
+
+    /** A component of network_sort. Sorts from 2 to NETWORK_SIZE elements
+     * with an AVX2 sorting network. The elements are copied into a buffer
+     * padded to the next network size with the greatest key, which sorts
+     * to the end.
+     */
+    template<typename T> static void network_sort_avx2(T* first, size_t len)
+    {
+        const bool FLOATING = std::is_floating_point<T>::value;
+        typedef typename std::conditional<sizeof(T) == 4, NetworkLanes32,
+                                          NetworkLanes64>::type Lanes;
+        typedef typename Lanes::key_t key_t;
+
+        /* For floating point, the greatest key is a NaN with every bit set
+         * but the sign, which the sort maps back to itself. */
+        alignas(32) key_t keys[NETWORK_SIZE];
+        memcpy(keys, first, len * sizeof(T));
+        size_t n = 8;
+        while (n < len)
+        {
+            n *= 2;
+        }
+        std::fill(keys + len, keys + n, std::numeric_limits<key_t>::max());
+
+        switch (n)
+        {
+            case 8:
+                network_sort_avx2<Lanes, FLOATING, 8>(keys);
+                break;
+            case 16:
+                network_sort_avx2<Lanes, FLOATING, 16>(keys);
+                break;
+            case 32:
+                network_sort_avx2<Lanes, FLOATING, 32>(keys);
+                break;
+            default:
+                network_sort_avx2<Lanes, FLOATING, 64>(keys);
+                break;
+        }
+        memcpy(first, keys, len * sizeof(T));
+    }
+
+    /** A component of network_sort. Whether the processor supports AVX2,
+     * checked once.
+     */
+    static bool network_avx2()
+    {
+#if defined(__AVX2__)
+        return true;
+#else
+        static const bool SUPPORTED = __builtin_cpu_supports("avx2");
+        return SUPPORTED;
+#endif
+    }
+#endif
+
+    /** A component of introsort and dual_pivot_quick_sort. Sorts the
+     * elements in range [first; last) with a sorting network, if the range
+     * is small enough, its type is supported, and the processor supports
+     * AVX2. Otherwise, leaves the range alone.
+     *
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     * \return true if the range was sorted, else false
+     */
+    template<class Compare, class RandomIt>
+    static bool network_leaf(RandomIt first, RandomIt last)
+    {
+#if defined(PAWLIB_TARGET_AVX2)
+        if constexpr (NetworkSortable<RandomIt, Compare>::value)
+        {
+            const std::ptrdiff_t LEN = last - first;
+            if (LEN > 1 && LEN <= NETWORK_SIZE && network_avx2())
+            {
+                network_sort_avx2(&*first, LEN);
+                return true;
+            }
+        }
+#else
+        (void)first;
+        (void)last;
+#endif
+        return false;
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order, for
+     * ranges of at most NETWORK_SIZE elements, such as the small partitions
+     * left by quicksort.
+     *
+     * Signed 32- and 64-bit integers, floats, and doubles, in a pointer or
+     * vector range, are sorted with an AVX2 bitonic sorting network if the
+     * processor supports it. Anything else is sorted with insertion sort,
+     * as are ranges with more than NETWORK_SIZE elements.
+     *
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     */
+    template<class RandomIt>
+    static void network_sort(RandomIt first, RandomIt last)
+    {
+        if (last - first > 1 && !network_leaf<std::less<>>(first, last))
+        {
+            insertion_sort(first, last - 1, std::less<>());
+        }
+    }
+
     /** A component of introsort.
      * Returns median of three elements.
      * iterators should be in comp order :
@@ -499,6 +889,12 @@ namespace pawsort
         const int DIST_SIZE = 13;
         auto len = last - first + 1;
 
+        // Where there is a sorting network for the type, it is faster.
+        if (network_leaf<std::less<>>(first, last + 1))
+        {
+            return;
+        }
+
         // If size is less than threshold, use insertion sort.
         if (len < TINY_SIZE)
         {
@@ -657,6 +1053,12 @@ namespace pawsort
 
         const int LEN = last - first + 1;
 
+        // Where there is a sorting network for the type, it is faster.
+        if (network_leaf<Compare>(first, last + 1))
+        {
+            return;
+        }
+
         // If size is less than threshold, use insertion sort.
         if (LEN <= TINY_SIZE)
         {
@@ -809,7 +1211,7 @@ namespace pawsort
      */
     template<class RandomIt, class Compare>
     static void introsort(RandomIt first, RandomIt last, Compare comp,
-                          int maxdepth = -1)
+                          int maxdepth)
     {
         /* If the right index is smaller than the left,
         no matter, swap the indexes.*/
@@ -832,6 +1234,832 @@ namespace pawsort
         introsort_loop(first, last, comp, maxdepth);
     }
 
+    /* Parallel sorts will not split a range smaller than this, and sort it
+     * on one thread instead. Below this size, starting a thread costs more
+     * than it saves. */
+    static const std::ptrdiff_t PARALLEL_CUTOFF = 1 << 14;
+
+    /** Shares a fixed number of threads among the tasks of one parallel
+     * sort. A task which finds no thread free runs on the calling thread,
+     * so a sort never has more threads than it was given.
+     */
+    class SortTasks
+    {
+    public:
+        /** Create a task pool.
+         * \param the number of threads to use, including the calling thread,
+         * or 0 for one per core
+         */
+        explicit SortTasks(unsigned int threads)
+        : threadCount(threads > 0 ? threads : std::thread::hardware_concurrency()),
+          spare(threadCount > 1 ? static_cast<int>(threadCount) - 1 : 0)
+        {}
+
+        /** \return the number of threads in the pool, including the
+         * calling thread */
+        unsigned int threads() const { return threadCount > 0 ? threadCount : 1; }
+
+        /** Run two tasks, the first on a spare thread if there is one,
+         * and wait for both to finish.
+         * \param the first task
+         * \param the second task
+         */
+        template<class First, class Second>
+        void invoke(First&& first, Second&& second)
+        {
+            if (!claim())
+            {
+                first();
+                second();
+                return;
+            }
+
+            std::thread worker([this, &first] {
+                first();
+                spare.fetch_add(1, std::memory_order_release);
+            });
+            second();
+            worker.join();
+        }
+
+        /** Run a task for every index in a range, splitting the range
+         * among the spare threads.
+         * \param the first index
+         * \param one past the last index
+         * \param the task, which is passed each index
+         */
+        template<class Function>
+        void run_each(size_t begin, size_t end, Function& function)
+        {
+            if (end - begin == 1)
+            {
+                function(begin);
+                return;
+            }
+            size_t middle = begin + (end - begin) / 2;
+            invoke([&] { run_each(begin, middle, function); },
+                   [&] { run_each(middle, end, function); });
+        }
+
+    private:
+        /** Take a spare thread, if there is one.
+         * \return true if a thread was taken */
+        bool claim()
+        {
+            int count = spare.load(std::memory_order_relaxed);
+            while (count > 0)
+            {
+                if (spare.compare_exchange_weak(count, count - 1,
+                                                std::memory_order_acquire))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        unsigned int threadCount;
+        std::atomic<int> spare;
+    };
+
+    /** A component of parallel_sort. Partitions a range on several threads,
+     * so that the elements for which the predicate is true come first.
+     * Each thread partitions one piece of the range, and then the elements
+     * left on the wrong side of the overall boundary are swapped across it,
+     * also on several threads.
+     *
+     * \param the first element
+     * \param one past the last element
+     * \param the predicate
+     * \param the task pool
+     * \return the first element for which the predicate is false
+     */
+    template<class RandomIt, class Predicate>
+    static RandomIt parallel_partition(RandomIt first, RandomIt last,
+                                       Predicate pred, SortTasks& tasks)
+    {
+        const size_t LEN = last - first;
+        const size_t PIECES =
+            std::min<size_t>(tasks.threads(), LEN / PARALLEL_CUTOFF);
+        if (PIECES < 2)
+        {
+            return std::partition(first, last, pred);
+        }
+
+        // Partition each piece on its own...
+        std::vector<size_t> bounds(PIECES + 1);
+        std::vector<size_t> middles(PIECES);
+        for (size_t i = 0; i <= PIECES; ++i)
+        {
+            bounds[i] = LEN * i / PIECES;
+        }
+        auto partition_piece = [&](size_t i) {
+            middles[i] = std::partition(first + bounds[i],
+                                        first + bounds[i + 1], pred) - first;
+        };
+        tasks.run_each(0, PIECES, partition_piece);
+
+        // ...which tells us where the overall boundary falls.
+        size_t split = 0;
+        for (size_t i = 0; i < PIECES; ++i)
+        {
+            split += middles[i] - bounds[i];
+        }
+
+        /* Before the boundary, every piece may leave a run of elements which
+         * fail the predicate; after it, a run of elements which pass. There
+         * are as many of one as of the other, so we swap the n-th misplaced
+         * element before the boundary with the n-th one after it. */
+        std::vector<std::pair<size_t, size_t>> failing, passing;
+        size_t misplaced = 0;
+        for (size_t i = 0; i < PIECES; ++i)
+        {
+            size_t begin = middles[i];
+            size_t end = std::min(bounds[i + 1], split);
+            if (begin < end)
+            {
+                failing.emplace_back(begin, end);
+                misplaced += end - begin;
+            }
+            begin = std::max(bounds[i], split);
+            end = middles[i];
+            if (begin < end)
+            {
+                passing.emplace_back(begin, end);
+            }
+        }
+
+        // Find the position of the n-th misplaced element in a set of runs.
+        auto seek = [](const std::vector<std::pair<size_t, size_t>>& runs,
+                       size_t n, size_t& run) {
+            run = 0;
+            while (n >= runs[run].second - runs[run].first)
+            {
+                n -= runs[run].second - runs[run].first;
+                ++run;
+            }
+            return runs[run].first + n;
+        };
+
+        auto swap_piece = [&](size_t i) {
+            size_t from = misplaced * i / PIECES;
+            size_t count = misplaced * (i + 1) / PIECES - from;
+            if (count == 0)
+            {
+                return;
+            }
+            size_t f_run, p_run;
+            size_t f = seek(failing, from, f_run);
+            size_t p = seek(passing, from, p_run);
+            while (true)
+            {
+                std::iter_swap(first + f, first + p);
+                if (--count == 0)
+                {
+                    break;
+                }
+                if (++f == failing[f_run].second)
+                {
+                    f = failing[++f_run].first;
+                }
+                if (++p == passing[p_run].second)
+                {
+                    p = passing[++p_run].first;
+                }
+            }
+        };
+        if (misplaced > 0)
+        {
+            tasks.run_each(0, PIECES, swap_piece);
+        }
+
+        return first + split;
+    }
+
+    /** Loop for parallel_sort function.
+     * Range is from "first" to "last", excluded.
+     * \param first element to be sorted
+     * \param one past the last element to be sorted
+     * \param comparison function
+     * \param the task pool
+     * \param the maximum depth to allow recursion
+     */
+    template<class RandomIt, class Compare>
+    static void parallel_sort_loop(RandomIt first, RandomIt last,
+                                   Compare comp, SortTasks& tasks,
+                                   int maxdepth)
+    {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+        const std::ptrdiff_t LEN = last - first;
+
+        /* Small ranges, and ranges which have partitioned badly too many
+         * times, are left to introsort, which guards against the worst
+         * case with heap sort. */
+        if (LEN <= PARALLEL_CUTOFF || maxdepth == 0)
+        {
+            if (LEN > 1)
+            {
+                introsort(first, last - 1, comp);
+            }
+            return;
+        }
+
+        /* Take the pivot as the median of three medians-of-three, spread
+         * evenly across the range (Tukey's ninther). We copy it, since
+         * partitioning moves the elements around. */
+        const std::ptrdiff_t STEP = LEN / 8;
+        RandomIt m1 = median_of_three(first, first + STEP,
+                                      first + STEP * 2, comp);
+        RandomIt m2 = median_of_three(first + STEP * 3, first + STEP * 4,
+                                      first + STEP * 5, comp);
+        RandomIt m3 = median_of_three(first + STEP * 6, first + STEP * 7,
+                                      last - 1, comp);
+        const value_type pivot(*median_of_three(m1, m2, m3, comp));
+
+        RandomIt lower = parallel_partition(
+            first, last,
+            [&](const value_type& value) { return comp(value, pivot); },
+            tasks);
+
+        /* If few elements were less than the pivot, there may be many equal
+         * to it. Gather those next, since they need no more sorting. This
+         * keeps arrays with few unique values from degrading. */
+        RandomIt upper = lower;
+        if (lower - first < LEN / 8)
+        {
+            upper = parallel_partition(
+                lower, last,
+                [&](const value_type& value) { return !comp(pivot, value); },
+                tasks);
+        }
+
+        tasks.invoke(
+            [&] { parallel_sort_loop(first, lower, comp, tasks, maxdepth - 1); },
+            [&] { parallel_sort_loop(upper, last, comp, tasks, maxdepth - 1); });
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order, on
+     * several threads. Each range is partitioned around a pivot on several
+     * threads, and the two parts are sorted as separate tasks, until they
+     * are small enough to finish with introsort.
+     *
+     * The comparison function may be called from several threads at once,
+     * and must not throw.
+     *
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     * \param comparison function.
+     * \param the number of threads to use, or 0 for one per core.
+     */
+    template<class RandomIt, class Compare>
+    static void parallel_sort(RandomIt first, RandomIt last, Compare comp,
+                              unsigned int threads = 0)
+    {
+        const std::ptrdiff_t LEN = last - first;
+        if (LEN < 2)
+        {
+            return;
+        }
+
+        SortTasks tasks(threads);
+        if (tasks.threads() == 1)
+        {
+            introsort(first, last - 1, comp);
+            return;
+        }
+        parallel_sort_loop(first, last, comp, tasks,
+                           static_cast<int>(log2(LEN)) * 2);
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order, on
+     * one thread per core.
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     */
+    template<class RandomIt>
+    static void parallel_sort(RandomIt first, RandomIt last)
+    {
+        parallel_sort(first, last, std::less<>());
+    }
+
+    /** A component of parallel_stable_sort. Merges two sorted ranges into
+     * another range, by moving. Large merges are split in two around the
+     * middle element of the longer range, and the halves are merged as
+     * separate tasks.
+     *
+     * \param the first element of the first range
+     * \param one past the last element of the first range
+     * \param the first element of the second range
+     * \param one past the last element of the second range
+     * \param the first element of the output
+     * \param comparison function
+     * \param the task pool
+     */
+    template<class InputIt, class OutputIt, class Compare>
+    static void parallel_merge(InputIt first1, InputIt last1, InputIt first2,
+                               InputIt last2, OutputIt out, Compare comp,
+                               SortTasks& tasks)
+    {
+        const std::ptrdiff_t LEN1 = last1 - first1;
+        const std::ptrdiff_t LEN2 = last2 - first2;
+        if (LEN1 + LEN2 <= PARALLEL_CUTOFF)
+        {
+            /* Moving through std::merge would pass the comparison function
+             * rvalues, so we merge by hand. */
+            while (first1 != last1 && first2 != last2)
+            {
+                if (comp(*first2, *first1))
+                {
+                    *out = std::move(*first2);
+                    ++first2;
+                }
+                else
+                {
+                    *out = std::move(*first1);
+                    ++first1;
+                }
+                ++out;
+            }
+            out = std::move(first1, last1, out);
+            std::move(first2, last2, out);
+            return;
+        }
+
+        /* To keep the merge stable, elements of the second range which are
+         * equal to a split element of the first must land after it, and
+         * elements of the first range equal to one of the second, before. */
+        InputIt middle1, middle2;
+        if (LEN1 >= LEN2)
+        {
+            middle1 = first1 + LEN1 / 2;
+            middle2 = std::lower_bound(first2, last2, *middle1, comp);
+        }
+        else
+        {
+            middle2 = first2 + LEN2 / 2;
+            middle1 = std::upper_bound(first1, last1, *middle2, comp);
+        }
+        OutputIt middle_out = out + (middle1 - first1) + (middle2 - first2);
+
+        tasks.invoke(
+            [&] {
+                parallel_merge(first1, middle1, first2, middle2, out, comp,
+                               tasks);
+            },
+            [&] {
+                parallel_merge(middle1, last1, middle2, last2, middle_out,
+                               comp, tasks);
+            });
+    }
+
+    /** Loop for parallel_stable_sort function. Sorts a range, using a
+     * second range of the same length as scratch space, and leaves the
+     * result in whichever was asked for. The two halves leave theirs in
+     * the other one, so each level of merging moves between the two.
+     *
+     * \param the first element to be sorted
+     * \param the first element of the scratch space
+     * \param the number of elements
+     * \param comparison function
+     * \param the task pool
+     * \param true to leave the result in the scratch space
+     */
+    template<class RandomIt, class BufferIt, class Compare>
+    static void merge_sort_loop(RandomIt first, BufferIt buffer,
+                                std::ptrdiff_t len, Compare comp,
+                                SortTasks& tasks, bool to_buffer)
+    {
+        if (len <= PARALLEL_CUTOFF)
+        {
+            std::stable_sort(first, first + len, comp);
+            if (to_buffer)
+            {
+                std::move(first, first + len, buffer);
+            }
+            return;
+        }
+
+        const std::ptrdiff_t HALF = len / 2;
+        tasks.invoke(
+            [&] {
+                merge_sort_loop(first, buffer, HALF, comp, tasks, !to_buffer);
+            },
+            [&] {
+                merge_sort_loop(first + HALF, buffer + HALF, len - HALF, comp,
+                                tasks, !to_buffer);
+            });
+
+        if (to_buffer)
+        {
+            parallel_merge(first, first + HALF, first + HALF, first + len,
+                           buffer, comp, tasks);
+        }
+        else
+        {
+            parallel_merge(buffer, buffer + HALF, buffer + HALF, buffer + len,
+                           first, comp, tasks);
+        }
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order, on
+     * several threads, keeping equal elements in their original order.
+     * The two halves of each range are sorted as separate tasks, and then
+     * merged on several threads, through a buffer as long as the range.
+     *
+     * The comparison function may be called from several threads at once,
+     * and must not throw.
+     *
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     * \param comparison function.
+     * \param the number of threads to use, or 0 for one per core.
+     */
+    template<class RandomIt, class Compare>
+    static void parallel_stable_sort(RandomIt first, RandomIt last,
+                                     Compare comp, unsigned int threads = 0)
+    {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+        SortTasks tasks(threads);
+        if (last - first <= PARALLEL_CUTOFF || tasks.threads() == 1)
+        {
+            std::stable_sort(first, last, comp);
+            return;
+        }
+
+        /* Move the elements into the buffer, and sort them from there back
+         * into place. The buffer never needs a default constructor. */
+        std::vector<value_type> buffer(std::make_move_iterator(first),
+                                       std::make_move_iterator(last));
+        merge_sort_loop(buffer.begin(), first, last - first, comp, tasks,
+                        true);
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order, on
+     * one thread per core, keeping equal elements in their original order.
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     */
+    template<class RandomIt>
+    static void parallel_stable_sort(RandomIt first, RandomIt last)
+    {
+        parallel_stable_sort(first, last, std::less<>());
+    }
+
+    /** A component of radix_sort. Maps a key to an unsigned integer of the
+     * same width, which sorts in the same order as the key.
+     *
+     * Signed integers have their sign bit flipped, so that negative numbers
+     * come first. Positive floating point numbers have their sign bit set,
+     * and negative ones have every bit flipped, since they are stored as
+     * sign and magnitude. -0.0 sorts before 0.0, and NaNs sort at either
+     * end, by their sign.
+     */
+    template<typename Key> struct RadixKey
+    {
+        static_assert((std::is_integral<Key>::value &&
+                       !std::is_same<Key, bool>::value) ||
+                          std::is_floating_point<Key>::value,
+                      "radix_sort keys must be integers or floating point");
+        static_assert(!std::is_floating_point<Key>::value ||
+                          sizeof(Key) == 4 || sizeof(Key) == 8,
+                      "radix_sort supports only 32- and 64-bit floating "
+                      "point keys");
+
+        typedef typename std::conditional<
+            std::is_integral<Key>::value,
+            std::make_unsigned<Key>,
+            std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>>::type::type
+            bits_t;
+
+        static const unsigned int width = sizeof(bits_t) * 8;
+
+        static bits_t encode(Key key)
+        {
+            const bits_t SIGN = bits_t(1) << (width - 1);
+            if constexpr (std::is_floating_point<Key>::value)
+            {
+                bits_t bits;
+                memcpy(&bits, &key, sizeof(bits));
+                return (bits & SIGN) ? bits_t(~bits) : bits_t(bits | SIGN);
+            }
+            else if constexpr (std::is_signed<Key>::value)
+            {
+                return static_cast<bits_t>(key) ^ SIGN;
+            }
+            else
+            {
+                return key;
+            }
+        }
+    };
+
+    /* Radix sorts leave ranges this small to a comparison sort. */
+    static const std::ptrdiff_t RADIX_CUTOFF = 64;
+
+    /** A component of radix_sort. Counts the digits of a range of keys,
+     * for every digit position at once.
+     *
+     * \param the first element
+     * \param one past the last element
+     * \param the key function
+     * \param the counts, with (1 << digit_bits) for each digit position
+     */
+    template<unsigned int digit_bits, class RandomIt, class KeyFunction>
+    static void radix_count(RandomIt first, RandomIt last, KeyFunction& key,
+                            size_t* counts)
+    {
+        typedef typename std::decay<decltype(key(*first))>::type key_t;
+        typedef RadixKey<key_t> radix;
+        const unsigned int DIGITS = (radix::width + digit_bits - 1) / digit_bits;
+        const size_t RADIX = size_t(1) << digit_bits;
+        const size_t MASK = RADIX - 1;
+
+        for (; first != last; ++first)
+        {
+            const typename radix::bits_t BITS = radix::encode(key(*first));
+            for (unsigned int d = 0; d < DIGITS; ++d)
+            {
+                ++counts[d * RADIX + ((BITS >> (d * digit_bits)) & MASK)];
+            }
+        }
+    }
+
+    /** A component of radix_sort. Moves each element of a range to the next
+     * free position of the bucket for its digit, in order, so that elements
+     * with the same digit keep their order.
+     *
+     * \param the first element
+     * \param one past the last element
+     * \param the output
+     * \param the length of the output
+     * \param the key function
+     * \param the lowest bit of the digit
+     * \param the next free position in each bucket, which is advanced
+     */
+    template<unsigned int digit_bits, class InputIt, class OutputIt,
+             class KeyFunction>
+    static void radix_scatter(InputIt first, InputIt last, OutputIt out,
+                              size_t length, KeyFunction& key,
+                              unsigned int shift, size_t* offsets)
+    {
+        typedef typename std::iterator_traits<InputIt>::value_type value_type;
+        typedef typename std::decay<decltype(key(*first))>::type key_t;
+        typedef RadixKey<key_t> radix;
+        const size_t MASK = (size_t(1) << digit_bits) - 1;
+
+        /* Each bucket is written in order, but there are far more buckets
+         * than the hardware prefetcher can follow. Once a bucket's writes
+         * reach a new cache line, fetch the line after it. With 16-bit
+         * digits, there are too many buckets for this to help. */
+        const size_t LINE = sizeof(value_type) < 64 ? 64 / sizeof(value_type) : 1;
+        for (; first != last; ++first)
+        {
+            const size_t B = (radix::encode(key(*first)) >> shift) & MASK;
+            const size_t TO = offsets[B]++;
+            if (digit_bits <= 11 && TO % LINE == 0 && TO + LINE < length)
+            {
+                __builtin_prefetch(&out[TO + LINE], 1);
+            }
+            out[TO] = std::move(*first);
+        }
+    }
+
+    /** Loop for the radix_sort and parallel_radix_sort functions. Sorts by
+     * the least significant digit first, moving between the range and a
+     * buffer once for each digit position. Digit positions which are the
+     * same for every key are skipped.
+     *
+     * \param the first element
+     * \param one past the last element
+     * \param the key function
+     * \param the task pool, or nullptr to sort on this thread
+     */
+    template<unsigned int digit_bits, class RandomIt, class KeyFunction>
+    static void radix_sort_loop(RandomIt first, RandomIt last,
+                                KeyFunction& key, SortTasks* tasks)
+    {
+        static_assert(digit_bits >= 1 && digit_bits <= 16,
+                      "radix_sort digits must be from 1 to 16 bits");
+
+        typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+        typedef typename std::decay<decltype(key(*first))>::type key_t;
+        typedef RadixKey<key_t> radix;
+        const unsigned int DIGITS = (radix::width + digit_bits - 1) / digit_bits;
+        const size_t RADIX = size_t(1) << digit_bits;
+        const size_t MASK = RADIX - 1;
+
+        /* Below the cutoff, or with fewer elements than buckets, clearing
+         * and summing the counts would cost more than sorting. */
+        const std::ptrdiff_t LEN = last - first;
+        if (LEN <= std::max<std::ptrdiff_t>(RADIX_CUTOFF, RADIX))
+        {
+            std::stable_sort(first, last,
+                             [&](const value_type& a, const value_type& b) {
+                                 return radix::encode(key(a)) <
+                                        radix::encode(key(b));
+                             });
+            return;
+        }
+
+        /* In parallel, each thread takes one piece of the range, and keeps
+         * its own counts. Otherwise, the whole range is one piece. */
+        const size_t PIECES =
+            tasks ? std::max<size_t>(1, std::min<size_t>(tasks->threads(),
+                                                         LEN / PARALLEL_CUTOFF))
+                  : 1;
+        std::vector<size_t> bounds(PIECES + 1);
+        for (size_t i = 0; i <= PIECES; ++i)
+        {
+            bounds[i] = LEN * i / PIECES;
+        }
+
+        // Count every digit position of every piece in one pass.
+        std::vector<size_t> counts(PIECES * DIGITS * RADIX);
+        auto count_piece = [&](size_t i) {
+            radix_count<digit_bits>(first + bounds[i], first + bounds[i + 1],
+                                    key, &counts[i * DIGITS * RADIX]);
+        };
+        if (PIECES > 1)
+        {
+            tasks->run_each(0, PIECES, count_piece);
+        }
+        else
+        {
+            count_piece(0);
+        }
+
+        /* A digit position is trivial if every key has the same digit there,
+         * which is then the first key's digit. */
+        const typename radix::bits_t FIRST = radix::encode(key(*first));
+        std::vector<unsigned int> passes;
+        for (unsigned int d = 0; d < DIGITS; ++d)
+        {
+            const size_t B = (FIRST >> (d * digit_bits)) & MASK;
+            size_t total = 0;
+            for (size_t i = 0; i < PIECES; ++i)
+            {
+                total += counts[(i * DIGITS + d) * RADIX + B];
+            }
+            if (total != static_cast<size_t>(LEN))
+            {
+                passes.push_back(d);
+            }
+        }
+        if (passes.empty())
+        {
+            return;
+        }
+
+        std::unique_ptr<value_type[]> buffer(new value_type[LEN]);
+        std::vector<size_t> offsets(PIECES * RADIX);
+        bool in_buffer = false;
+        for (size_t p = 0; p < passes.size(); ++p)
+        {
+            const unsigned int D = passes[p];
+
+            /* After the first pass, the elements have moved, and each piece
+             * must count its digits again. */
+            if (p > 0 && PIECES > 1)
+            {
+                std::fill(counts.begin(), counts.end(), 0);
+                auto recount_piece = [&](size_t i) {
+                    size_t* piece_counts = &counts[(i * DIGITS + D) * RADIX];
+                    const unsigned int SHIFT = D * digit_bits;
+                    auto recount = [&](auto from, auto to) {
+                        for (; from != to; ++from)
+                        {
+                            ++piece_counts[(radix::encode(key(*from)) >> SHIFT)
+                                           & MASK];
+                        }
+                    };
+                    if (in_buffer)
+                    {
+                        recount(buffer.get() + bounds[i],
+                                buffer.get() + bounds[i + 1]);
+                    }
+                    else
+                    {
+                        recount(first + bounds[i], first + bounds[i + 1]);
+                    }
+                };
+                tasks->run_each(0, PIECES, recount_piece);
+            }
+
+            /* Each bucket starts after all of the buckets before it, and
+             * within a bucket, each piece after the pieces before it. */
+            size_t total = 0;
+            for (size_t b = 0; b < RADIX; ++b)
+            {
+                for (size_t i = 0; i < PIECES; ++i)
+                {
+                    offsets[i * RADIX + b] = total;
+                    total += counts[(i * DIGITS + D) * RADIX + b];
+                }
+            }
+
+            auto scatter_piece = [&](size_t i) {
+                if (in_buffer)
+                {
+                    radix_scatter<digit_bits>(
+                        buffer.get() + bounds[i], buffer.get() + bounds[i + 1],
+                        first, LEN, key, D * digit_bits, &offsets[i * RADIX]);
+                }
+                else
+                {
+                    radix_scatter<digit_bits>(
+                        first + bounds[i], first + bounds[i + 1],
+                        buffer.get(), LEN, key, D * digit_bits,
+                        &offsets[i * RADIX]);
+                }
+            };
+            if (PIECES > 1)
+            {
+                tasks->run_each(0, PIECES, scatter_piece);
+            }
+            else
+            {
+                scatter_piece(0);
+            }
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer)
+        {
+            std::move(buffer.get(), buffer.get() + LEN, first);
+        }
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order of the
+     * key of each, using a least-significant-digit radix sort. Elements with
+     * equal keys keep their order. The key must be an integer, or a 32- or
+     * 64-bit floating point number.
+     *
+     * The elements must be default constructible, since the sort moves them
+     * through a buffer as long as the range.
+     *
+     * \param the number of bits in each digit: 8 suits most keys, and 11 or
+     * 16 may be faster for wide keys in large ranges.
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     * \param the function returning the key of an element.
+     */
+    template<unsigned int digit_bits = 8, class RandomIt, class KeyFunction>
+    static void radix_sort(RandomIt first, RandomIt last, KeyFunction key)
+    {
+        radix_sort_loop<digit_bits>(first, last, key, nullptr);
+    }
+
+    /** Sorts the numbers in range [first; last) in ascending order, using a
+     * least-significant-digit radix sort.
+     * \param the number of bits in each digit
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     */
+    template<unsigned int digit_bits = 8, class RandomIt>
+    static void radix_sort(RandomIt first, RandomIt last)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+        radix_sort<digit_bits>(first, last,
+                               [](const value_type& value) { return value; });
+    }
+
+    /** Sorts the elements in range [first; last) in ascending order of the
+     * key of each, as radix_sort does, on several threads. Each thread
+     * counts and moves the digits of one piece of the range.
+     *
+     * The key function may be called from several threads at once.
+     *
+     * \param the number of bits in each digit
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     * \param the function returning the key of an element.
+     * \param the number of threads to use, or 0 for one per core.
+     */
+    template<unsigned int digit_bits = 8, class RandomIt, class KeyFunction>
+    static void parallel_radix_sort(RandomIt first, RandomIt last,
+                                    KeyFunction key, unsigned int threads = 0)
+    {
+        SortTasks tasks(threads);
+        radix_sort_loop<digit_bits>(first, last, key,
+                                    tasks.threads() > 1 ? &tasks : nullptr);
+    }
+
+    /** Sorts the numbers in range [first; last) in ascending order, as
+     * radix_sort does, on one thread per core.
+     * \param the number of bits in each digit
+     * \param the first element
+     * \param the last element, excluded in sorting.
+     */
+    template<unsigned int digit_bits = 8, class RandomIt>
+    static void parallel_radix_sort(RandomIt first, RandomIt last)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+        parallel_radix_sort<digit_bits>(
+            first, last, [](const value_type& value) { return value; });
+    }
+
     /** A component of heap sort. Should only be called from within
      * `heap_sort()`, so use that function to sort an array using
      * the heap sort algorithm.
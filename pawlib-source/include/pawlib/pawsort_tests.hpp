@@ -43,6 +43,16 @@
 #define PAWLIB_PAWSORT_TESTS_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(PAWLIB_PARALLEL_STL)
+#include <execution>
+#endif
 
 #include "pawlib/goldilocks.hpp"
 #include "pawlib/pawsort.hpp"
@@ -102,19 +112,20 @@ public:
     };
 
 protected:
-    // CHANGE ME: This is the size of the array. Must be a multiple of 10.
-    static const int test_size = 10000;
-    // CHANGE ME: This is the type of array to generate.
+    // This is the size of the array. Must be a multiple of 10.
+    const int test_size;
+    // This is the type of array to generate.
     TestArrayType arrayType;
-    int start_arr[test_size];
-    int test_arr[test_size];
+    std::vector<int> start_arr;
+    std::vector<int> test_arr;
 
     testdoc_t title;
     testdoc_t docs;
 
 public:
     // cppcheck-suppress uninitMemberVar
-    explicit TestSort(TestArrayType type) : arrayType(type)
+    explicit TestSort(TestArrayType type, int size = 10000)
+    : test_size(size), arrayType(type), start_arr(size), test_arr(size)
     {
         // We'll initialize titles and doc strings in the constructor.
         switch (arrayType)
@@ -531,7 +542,7 @@ public:
 
     bool run() override
     {
-        std::sort(std::begin(test_arr), std::end(test_arr));
+        std::sort(test_arr.begin(), test_arr.end());
 
         // Verify sorting.
         for (int i = 1; i < test_size; ++i)
@@ -558,7 +569,7 @@ public:
 
     bool run() override
     {
-        pawsort::introsort(test_arr, 0, test_size - 1);
+        pawsort::introsort(test_arr.data(), 0, test_size - 1);
         // Verify sorting.
         for (int i = 1; i < test_size; ++i)
         {
@@ -585,7 +596,7 @@ public:
 
     bool run() override
     {
-        pawsort::dual_pivot_quick_sort(test_arr, 0, test_size - 1);
+        pawsort::dual_pivot_quick_sort(test_arr.data(), 0, test_size - 1);
         // Verify sorting.
         for (int i = 1; i < test_size; ++i)
         {
@@ -613,7 +624,7 @@ public:
     bool run() override
     {
         /* Test sorting from index to test_size - 1 - index*/
-        pawsort::insertion_sort(test_arr, INDEX, test_size - 1 - INDEX);
+        pawsort::insertion_sort(test_arr.data(), INDEX, test_size - 1 - INDEX);
 
         // Verify sorting.
         for (int i = 1 + INDEX; i < test_size - INDEX; ++i)
@@ -645,8 +656,8 @@ public:
     bool run() override
     {
         /* Test sorting in range [index, test_size - index)*/
-        auto first = std::begin(test_arr) + INDEX;
-        auto last = std::begin(test_arr) + test_size - INDEX;
+        auto first = test_arr.begin() + INDEX;
+        auto last = test_arr.begin() + test_size - INDEX;
         pawsort::sort(first, last);
 
         // Verify sorting.
@@ -715,6 +726,541 @@ private:
     const int INDEX = 100;
 };
 
+/* The parallel sorts are tested on arrays large enough to be split among
+ * several threads, and with at least four threads even on one core, so
+ * that every part of them runs. */
+class TestParallelSort : public TestSort
+{
+protected:
+    static const int parallel_test_size = 100000;
+    const unsigned int threads;
+
+    bool is_sorted()
+    {
+        for (int i = 1; i < test_size; ++i)
+        {
+            if (test_arr[i] < test_arr[i - 1])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit TestParallelSort(TestArrayType type)
+    : TestSort(type, parallel_test_size),
+      threads(std::max(4u, std::thread::hardware_concurrency()))
+    {}
+
+    virtual ~TestParallelSort() {}
+};
+
+class TestPawSortParallel : public TestParallelSort
+{
+public:
+    explicit TestPawSortParallel(TestArrayType type) : TestParallelSort(type)
+    {}
+
+    testdoc_t get_title() override { return title + " (parallel_sort)"; }
+
+    bool run() override
+    {
+        pawsort::parallel_sort(test_arr.begin(), test_arr.end(),
+                               std::less<>(), threads);
+        return is_sorted();
+    }
+
+    ~TestPawSortParallel() {}
+};
+
+class TestStdSortLarge : public TestParallelSort
+{
+public:
+    explicit TestStdSortLarge(TestArrayType type) : TestParallelSort(type) {}
+
+    testdoc_t get_title() override { return title + " (std::sort)"; }
+
+    bool run() override
+    {
+        std::sort(test_arr.begin(), test_arr.end());
+        return is_sorted();
+    }
+
+    ~TestStdSortLarge() {}
+};
+
+#if defined(PAWLIB_PARALLEL_STL)
+class TestStdSortParallel : public TestParallelSort
+{
+public:
+    explicit TestStdSortParallel(TestArrayType type) : TestParallelSort(type)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return title + " (std::sort, std::execution::par)";
+    }
+
+    bool run() override
+    {
+        std::sort(std::execution::par, test_arr.begin(), test_arr.end());
+        return is_sorted();
+    }
+
+    ~TestStdSortParallel() {}
+};
+#endif
+
+/* Stable sorts are tested on records of each value and its original index,
+ * compared by value alone, so that the indices show whether equal values
+ * kept their order. */
+class TestParallelStableSort : public TestParallelSort
+{
+protected:
+    typedef std::pair<int, int> record_t;
+    std::vector<record_t> records;
+
+    static bool less_value(const record_t& a, const record_t& b)
+    {
+        return a.first < b.first;
+    }
+
+    bool is_stable()
+    {
+        for (int i = 1; i < test_size; ++i)
+        {
+            if (records[i].first < records[i - 1].first ||
+                (records[i].first == records[i - 1].first &&
+                 records[i].second < records[i - 1].second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit TestParallelStableSort(TestArrayType type)
+    : TestParallelSort(type), records(parallel_test_size)
+    {}
+
+    bool janitor() override
+    {
+        TestSort::janitor();
+        for (int i = 0; i < test_size; ++i)
+        {
+            records[i] = record_t(test_arr[i], i);
+        }
+        return true;
+    }
+
+    virtual ~TestParallelStableSort() {}
+};
+
+class TestPawStableSortParallel : public TestParallelStableSort
+{
+public:
+    explicit TestPawStableSortParallel(TestArrayType type)
+    : TestParallelStableSort(type)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return title + " (parallel_stable_sort)";
+    }
+
+    bool run() override
+    {
+        pawsort::parallel_stable_sort(records.begin(), records.end(),
+                                      less_value, threads);
+        return is_stable();
+    }
+
+    ~TestPawStableSortParallel() {}
+};
+
+class TestStdStableSort : public TestParallelStableSort
+{
+public:
+    explicit TestStdStableSort(TestArrayType type)
+    : TestParallelStableSort(type)
+    {}
+
+    testdoc_t get_title() override { return title + " (std::stable_sort)"; }
+
+    bool run() override
+    {
+        std::stable_sort(records.begin(), records.end(), less_value);
+        return is_stable();
+    }
+
+    ~TestStdStableSort() {}
+};
+
+#if defined(PAWLIB_PARALLEL_STL)
+class TestStdStableSortParallel : public TestParallelStableSort
+{
+public:
+    explicit TestStdStableSortParallel(TestArrayType type)
+    : TestParallelStableSort(type)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return title + " (std::stable_sort, std::execution::par)";
+    }
+
+    bool run() override
+    {
+        std::stable_sort(std::execution::par, records.begin(), records.end(),
+                         less_value);
+        return is_stable();
+    }
+
+    ~TestStdStableSortParallel() {}
+};
+#endif
+
+class TestPawRadixSortParallel : public TestParallelSort
+{
+public:
+    explicit TestPawRadixSortParallel(TestArrayType type)
+    : TestParallelSort(type)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return title + " (parallel_radix_sort)";
+    }
+
+    bool run() override
+    {
+        pawsort::parallel_radix_sort(test_arr.begin(), test_arr.end(),
+                                     [](int v) { return v; }, threads);
+        return is_sorted();
+    }
+
+    ~TestPawRadixSortParallel() {}
+};
+
+/* Sorts of numeric keys are compared on uniformly random keys of each
+ * width, generated by xorshift from a fixed seed, so every run sorts the
+ * same keys. */
+template<typename T>
+class TestRandomKeys : public Test
+{
+protected:
+    const size_t test_size;
+    std::vector<T> start_arr;
+    std::vector<T> test_arr;
+    testdoc_t title;
+
+    bool is_sorted()
+    {
+        return std::is_sorted(test_arr.begin(), test_arr.end());
+    }
+
+public:
+    TestRandomKeys(const testdoc_t& type_name, size_t size)
+    : test_size(size), start_arr(size), test_arr(size),
+      title("PawSort: Random " + type_name + ", " + std::to_string(size))
+    {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < test_size; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                // Spread over both signs and many exponents.
+                start_arr[i] = static_cast<T>(static_cast<int64_t>(state)) /
+                               static_cast<T>(state % 1000000 + 1);
+            }
+            else
+            {
+                start_arr[i] = static_cast<T>(state);
+            }
+        }
+    }
+
+    testdoc_t get_docs() override
+    {
+        return "Sorts uniformly random keys.";
+    }
+
+    bool janitor() override
+    {
+        test_arr = start_arr;
+        return true;
+    }
+
+    virtual ~TestRandomKeys() {}
+};
+
+template<typename T>
+class TestIntrosortKeys : public TestRandomKeys<T>
+{
+public:
+    TestIntrosortKeys(const testdoc_t& type_name, size_t size)
+    : TestRandomKeys<T>(type_name, size)
+    {}
+
+    testdoc_t get_title() override { return this->title + " (introsort)"; }
+
+    bool run() override
+    {
+        pawsort::sort(this->test_arr.begin(), this->test_arr.end());
+        return this->is_sorted();
+    }
+
+    ~TestIntrosortKeys() {}
+};
+
+template<typename T, unsigned int digit_bits>
+class TestRadixSortKeys : public TestRandomKeys<T>
+{
+public:
+    TestRadixSortKeys(const testdoc_t& type_name, size_t size)
+    : TestRandomKeys<T>(type_name, size)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return this->title + " (radix_sort, " + std::to_string(digit_bits) +
+               "-bit digits)";
+    }
+
+    bool run() override
+    {
+        pawsort::radix_sort<digit_bits>(this->test_arr.begin(),
+                                        this->test_arr.end());
+        return this->is_sorted();
+    }
+
+    ~TestRadixSortKeys() {}
+};
+
+template<typename T>
+class TestParallelRadixSortKeys : public TestRandomKeys<T>
+{
+public:
+    TestParallelRadixSortKeys(const testdoc_t& type_name, size_t size)
+    : TestRandomKeys<T>(type_name, size)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return this->title + " (parallel_radix_sort)";
+    }
+
+    bool run() override
+    {
+        pawsort::parallel_radix_sort(
+            this->test_arr.begin(), this->test_arr.end(),
+            [](T v) { return v; },
+            std::max(4u, std::thread::hardware_concurrency()));
+        return this->is_sorted();
+    }
+
+    ~TestParallelRadixSortKeys() {}
+};
+
+/* Records are sorted by a 64-bit key extracted from each, and carry their
+ * original index, so that the indices show whether equal keys kept their
+ * order. Keys are drawn from a small range so that many are equal. */
+class TestRadixRecords : public TestRandomKeys<uint64_t>
+{
+protected:
+    struct record_t
+    {
+        uint64_t key;
+        size_t index;
+    };
+    std::vector<record_t> records;
+
+    static uint64_t get_key(const record_t& r) { return r.key; }
+
+    bool is_stable()
+    {
+        for (size_t i = 1; i < test_size; ++i)
+        {
+            if (records[i].key < records[i - 1].key ||
+                (records[i].key == records[i - 1].key &&
+                 records[i].index < records[i - 1].index))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit TestRadixRecords(size_t size)
+    : TestRandomKeys<uint64_t>("Records", size), records(size)
+    {}
+
+    bool janitor() override
+    {
+        for (size_t i = 0; i < test_size; ++i)
+        {
+            records[i] = record_t{start_arr[i] % (test_size / 4), i};
+        }
+        return true;
+    }
+
+    virtual ~TestRadixRecords() {}
+};
+
+class TestStdStableSortRecords : public TestRadixRecords
+{
+public:
+    explicit TestStdStableSortRecords(size_t size) : TestRadixRecords(size) {}
+
+    testdoc_t get_title() override { return title + " (std::stable_sort)"; }
+
+    bool run() override
+    {
+        std::stable_sort(records.begin(), records.end(),
+                         [](const record_t& a, const record_t& b) {
+                             return a.key < b.key;
+                         });
+        return is_stable();
+    }
+
+    ~TestStdStableSortRecords() {}
+};
+
+template<unsigned int digit_bits>
+class TestRadixSortRecords : public TestRadixRecords
+{
+public:
+    explicit TestRadixSortRecords(size_t size) : TestRadixRecords(size) {}
+
+    testdoc_t get_title() override
+    {
+        return title + " (radix_sort, " + std::to_string(digit_bits) +
+               "-bit digits)";
+    }
+
+    bool run() override
+    {
+        pawsort::radix_sort<digit_bits>(records.begin(), records.end(),
+                                        get_key);
+        return is_stable();
+    }
+
+    ~TestRadixSortRecords() {}
+};
+
+template<typename T>
+class TestStdSortKeys : public TestRandomKeys<T>
+{
+public:
+    TestStdSortKeys(const testdoc_t& type_name, size_t size)
+    : TestRandomKeys<T>(type_name, size)
+    {}
+
+    testdoc_t get_title() override { return this->title + " (std::sort)"; }
+
+    bool run() override
+    {
+        std::sort(this->test_arr.begin(), this->test_arr.end());
+        return this->is_sorted();
+    }
+
+    ~TestStdSortKeys() {}
+};
+
+/* Leaf sorts are timed on many small blocks of random keys, as they are
+ * used on the small partitions at the bottom of introsort. */
+template<typename T>
+class TestLeafSort : public TestRandomKeys<T>
+{
+protected:
+    static const size_t leaf_test_size = 1 << 16;
+    const size_t block;
+
+    bool is_sorted_blocks()
+    {
+        for (size_t i = 0; i + block <= this->test_size; i += block)
+        {
+            auto first = this->test_arr.begin() + i;
+            if (!std::is_sorted(first, first + block))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    TestLeafSort(const testdoc_t& type_name, size_t block_size)
+    : TestRandomKeys<T>(type_name, leaf_test_size), block(block_size)
+    {
+        this->title = "PawSort: Random " + type_name + ", blocks of " +
+                      std::to_string(block);
+    }
+
+    testdoc_t get_docs() override
+    {
+        return "Sorts each block of uniformly random keys.";
+    }
+
+    virtual ~TestLeafSort() {}
+};
+
+template<typename T>
+class TestNetworkSortLeaf : public TestLeafSort<T>
+{
+public:
+    TestNetworkSortLeaf(const testdoc_t& type_name, size_t block_size)
+    : TestLeafSort<T>(type_name, block_size)
+    {}
+
+    testdoc_t get_title() override { return this->title + " (network_sort)"; }
+
+    bool run() override
+    {
+        for (size_t i = 0; i + this->block <= this->test_size; i += this->block)
+        {
+            auto first = this->test_arr.begin() + i;
+            pawsort::network_sort(first, first + this->block);
+        }
+        return this->is_sorted_blocks();
+    }
+
+    ~TestNetworkSortLeaf() {}
+};
+
+template<typename T>
+class TestInsertionSortLeaf : public TestLeafSort<T>
+{
+public:
+    TestInsertionSortLeaf(const testdoc_t& type_name, size_t block_size)
+    : TestLeafSort<T>(type_name, block_size)
+    {}
+
+    testdoc_t get_title() override
+    {
+        return this->title + " (insertion_sort)";
+    }
+
+    bool run() override
+    {
+        for (size_t i = 0; i + this->block <= this->test_size; i += this->block)
+        {
+            auto first = this->test_arr.begin() + i;
+            pawsort::insertion_sort(first, first + this->block - 1,
+                                    std::less<>());
+        }
+        return this->is_sorted_blocks();
+    }
+
+    ~TestInsertionSortLeaf() {}
+};
+
 class TestSuite_Pawsort : public TestSuite
 {
 public:
@@ -0,0 +1,570 @@
+/** PersistentMap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An immutable ordered map, whose versions share structure.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_PERSISTENTMAP_HPP
+#define PAWLIB_PERSISTENTMAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "pawlib/iochannel.hpp"
+
+/** An immutable ordered map, stored in an AVL tree whose nodes are shared
+  * between versions. Copying a PersistentMap takes a snapshot in constant
+  * time, without copying any elements. insert() and remove() never change
+  * the map they are called on; they return a new version, which copies
+  * only the O(log n) nodes on the path to the change, and shares every
+  * other node with the old version.
+  *
+  * Nodes are reference counted, and freed when the last version using them
+  * is destroyed. The counts are atomic, so versions may be handed to, read
+  * by, and destroyed on other threads, as long as each PersistentMap object
+  * itself is only used by one thread at a time.
+  *
+  * Like Map, lookups take any key type which can be compared with key_t
+  * using operator< in both directions. Pointers to values are valid for as
+  * long as the version they were found in exists.
+  *
+  * If copying a key or value throws, the operation has no effect: the
+  * nodes already copied for the new version are released.
+  * \param the key type, which must be copyable
+  * \param the value type, which must be copyable */
+template<typename key_t, typename value_t>
+class PersistentMap
+{
+    private:
+        struct Node
+        {
+            std::atomic<uint32_t> refs;
+            int8_t height;
+            Node* left;
+            Node* right;
+            const key_t key;
+            const value_t value;
+
+            template<typename K, typename V>
+            Node(K&& k, V&& v, Node* l, Node* r)
+            :refs(1), height(static_cast<int8_t>(1 + (heightOf(l) > heightOf(r) ? heightOf(l) : heightOf(r)))),
+             left(l), right(r), key(std::forward<K>(k)), value(std::forward<V>(v))
+            {}
+        };
+
+        static int heightOf(const Node* node)
+        {
+            return (node != nullptr) ? node->height : 0;
+        }
+
+        /** \return another reference to the node */
+        static Node* retain(Node* node)
+        {
+            if(node != nullptr)
+            {
+                node->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+            return node;
+        }
+
+        /** Drop a reference, freeing the node and releasing its children if
+          * it was the last one. */
+        static void release(Node* node)
+        {
+            while(node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Recurse on one side and loop on the other, so a long chain
+                // of freed nodes never runs deeper than the tree is tall.
+                release(node->left);
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+
+        /** Owns one counted reference, and releases it when destroyed unless
+          * it has been handed on with take(). The helpers below pass and
+          * return these, and build each child in its own statement, so a
+          * throwing key or value copy releases every node made so far. */
+        class NodeRef
+        {
+            public:
+                explicit NodeRef(Node* node = nullptr)
+                :node(node)
+                {}
+
+                NodeRef(NodeRef&& mov)
+                :node(mov.take())
+                {}
+
+                NodeRef(const NodeRef&) = delete;
+                NodeRef& operator=(const NodeRef&) = delete;
+                NodeRef& operator=(NodeRef&&) = delete;
+
+                ~NodeRef()
+                {
+                    release(node);
+                }
+
+                Node* get() const
+                {
+                    return node;
+                }
+
+                Node* operator->() const
+                {
+                    return node;
+                }
+
+                /** \return the reference, which the caller now owns */
+                Node* take()
+                {
+                    Node* taken = node;
+                    node = nullptr;
+                    return taken;
+                }
+
+            private:
+                Node* node;
+        };
+
+        /** Make a node, taking ownership of both children. */
+        template<typename K, typename V>
+        static NodeRef make(K&& key, V&& value, NodeRef left, NodeRef right)
+        {
+            NodeRef node(new Node(std::forward<K>(key), std::forward<V>(value), left.get(), right.get()));
+            // Only now that the node exists do the children belong to it.
+            left.take();
+            right.take();
+            return node;
+        }
+
+        /** Make a balanced subtree from an element and two subtrees whose
+          * heights differ by at most two, taking ownership of both. Only new
+          * nodes are built; the nodes rotated out are copied, never changed. */
+        static NodeRef balance(const key_t& key, const value_t& value, NodeRef left, NodeRef right)
+        {
+            int difference = heightOf(left.get()) - heightOf(right.get());
+            if(difference > 1)
+            {
+                const Node* l = left.get();
+                if(heightOf(l->left) >= heightOf(l->right))
+                {
+                    // Single right rotation.
+                    NodeRef newRight = make(key, value, NodeRef(retain(l->right)), std::move(right));
+                    return make(l->key, l->value, NodeRef(retain(l->left)), std::move(newRight));
+                }
+                // Double rotation: the left child's right child rises to the top.
+                const Node* lr = l->right;
+                NodeRef newLeft = make(l->key, l->value, NodeRef(retain(l->left)), NodeRef(retain(lr->left)));
+                NodeRef newRight = make(key, value, NodeRef(retain(lr->right)), std::move(right));
+                return make(lr->key, lr->value, std::move(newLeft), std::move(newRight));
+            }
+            if(difference < -1)
+            {
+                const Node* r = right.get();
+                if(heightOf(r->right) >= heightOf(r->left))
+                {
+                    // Single left rotation.
+                    NodeRef newLeft = make(key, value, std::move(left), NodeRef(retain(r->left)));
+                    return make(r->key, r->value, std::move(newLeft), NodeRef(retain(r->right)));
+                }
+                // Double rotation: the right child's left child rises to the top.
+                const Node* rl = r->left;
+                NodeRef newLeft = make(key, value, std::move(left), NodeRef(retain(rl->left)));
+                NodeRef newRight = make(r->key, r->value, NodeRef(retain(rl->right)), NodeRef(retain(r->right)));
+                return make(rl->key, rl->value, std::move(newLeft), std::move(newRight));
+            }
+            return make(key, value, std::move(left), std::move(right));
+        }
+
+        /** \return the subtree with the key inserted, or with its value
+          * replaced if assign is set, as a new reference. If nothing changes,
+          * the original subtree is returned, and changed is left false. */
+        template<typename K, typename V>
+        static NodeRef insert(Node* node, K&& key, V&& value, bool assign,
+                              bool& inserted, bool& changed)
+        {
+            if(node == nullptr)
+            {
+                NodeRef made = make(std::forward<K>(key), std::forward<V>(value), NodeRef(), NodeRef());
+                inserted = true;
+                changed = true;
+                return made;
+            }
+            if(key < node->key)
+            {
+                NodeRef left = insert(node->left, std::forward<K>(key), std::forward<V>(value),
+                                      assign, inserted, changed);
+                if(!changed)
+                {
+                    return NodeRef(retain(node));
+                }
+                return balance(node->key, node->value, std::move(left), NodeRef(retain(node->right)));
+            }
+            if(node->key < key)
+            {
+                NodeRef right = insert(node->right, std::forward<K>(key), std::forward<V>(value),
+                                       assign, inserted, changed);
+                if(!changed)
+                {
+                    return NodeRef(retain(node));
+                }
+                return balance(node->key, node->value, NodeRef(retain(node->left)), std::move(right));
+            }
+            if(!assign)
+            {
+                return NodeRef(retain(node));
+            }
+            NodeRef made = make(node->key, std::forward<V>(value), NodeRef(retain(node->left)), NodeRef(retain(node->right)));
+            changed = true;
+            return made;
+        }
+
+        /** \return the subtree without its smallest element, as a new reference */
+        static NodeRef removeMin(Node* node)
+        {
+            if(node->left == nullptr)
+            {
+                return NodeRef(retain(node->right));
+            }
+            NodeRef left = removeMin(node->left);
+            return balance(node->key, node->value, std::move(left), NodeRef(retain(node->right)));
+        }
+
+        /** \return the subtree without the key, as a new reference */
+        template<typename K>
+        static NodeRef remove(Node* node, const K& key, bool& removed)
+        {
+            if(node == nullptr)
+            {
+                return NodeRef();
+            }
+            if(key < node->key)
+            {
+                NodeRef left = remove(node->left, key, removed);
+                if(!removed)
+                {
+                    return NodeRef(retain(node));
+                }
+                return balance(node->key, node->value, std::move(left), NodeRef(retain(node->right)));
+            }
+            if(node->key < key)
+            {
+                NodeRef right = remove(node->right, key, removed);
+                if(!removed)
+                {
+                    return NodeRef(retain(node));
+                }
+                return balance(node->key, node->value, NodeRef(retain(node->left)), std::move(right));
+            }
+            removed = true;
+            if(node->left == nullptr)
+            {
+                return NodeRef(retain(node->right));
+            }
+            if(node->right == nullptr)
+            {
+                return NodeRef(retain(node->left));
+            }
+            // The successor takes this node's place. It stays alive, since
+            // the old version still holds it.
+            const Node* successor = node->right;
+            while(successor->left != nullptr)
+            {
+                successor = successor->left;
+            }
+            NodeRef right = removeMin(node->right);
+            return balance(successor->key, successor->value, NodeRef(retain(node->left)), std::move(right));
+        }
+
+        /** \return a perfectly balanced subtree of the next n pairs, as a new
+          * reference. prev is the last key placed, for checking the order. */
+        template<typename ForwardIt>
+        static NodeRef build(ForwardIt& it, size_t n, const key_t*& prev)
+        {
+            if(n == 0)
+            {
+                return NodeRef();
+            }
+            size_t leftCount = n / 2;
+            NodeRef left = build(it, leftCount, prev);
+            if(prev != nullptr && !(*prev < it->first))
+            {
+                throw std::invalid_argument("PersistentMap: keys are not in strictly increasing order");
+            }
+            ForwardIt at = it;
+            ++it;
+            // The new node's key is only known once it exists, so hold the
+            // input key until the right subtree is built.
+            prev = &(at->first);
+            NodeRef right = build(it, n - leftCount - 1, prev);
+            NodeRef node = make(at->first, at->second, std::move(left), std::move(right));
+            prev = &(node->key);
+            return node;
+        }
+
+        template<typename Visitor>
+        static void inOrder(const Node* node, Visitor& visitor)
+        {
+            while(node != nullptr)
+            {
+                inOrder(node->left, visitor);
+                visitor(node->key, node->value);
+                node = node->right;
+            }
+        }
+
+        template<typename K1, typename K2, typename Visitor>
+        static void inRange(const Node* node, const K1& low, const K2& high, Visitor& visitor)
+        {
+            while(node != nullptr)
+            {
+                // Only descend into the sides which can hold keys in range.
+                bool aboveLow = !(node->key < low);
+                bool belowHigh = node->key < high;
+                if(aboveLow && belowHigh)
+                {
+                    inRange(node->left, low, high, visitor);
+                    visitor(node->key, node->value);
+                    node = node->right;
+                }
+                else
+                {
+                    node = aboveLow ? node->left : node->right;
+                }
+            }
+        }
+
+        PersistentMap(Node* node, size_t size)
+        :root(node), _size(size)
+        {}
+
+        Node* root;
+        size_t _size;
+
+    public:
+        PersistentMap()
+        :root(nullptr), _size(0)
+        {}
+
+        /** Take a snapshot, in constant time. */
+        PersistentMap(const PersistentMap& cpy)
+        :root(retain(cpy.root)), _size(cpy._size)
+        {}
+
+        PersistentMap(PersistentMap&& mov)
+        :root(mov.root), _size(mov._size)
+        {
+            mov.root = nullptr;
+            mov._size = 0;
+        }
+
+        PersistentMap& operator=(const PersistentMap& rhs)
+        {
+            Node* old = root;
+            root = retain(rhs.root);
+            _size = rhs._size;
+            release(old);
+            return *this;
+        }
+
+        PersistentMap& operator=(PersistentMap&& rhs)
+        {
+            if(&rhs != this)
+            {
+                std::swap(root, rhs.root);
+                std::swap(_size, rhs._size);
+            }
+            return *this;
+        }
+
+        /** Build a map from a range of pairs (anything with first and
+          * second), which must be sorted by strictly increasing key.
+          * The tree is built perfectly balanced, in linear time.
+          * \throws std::invalid_argument if the keys are not strictly increasing */
+        template<typename ForwardIt>
+        static PersistentMap from_sorted(ForwardIt first, ForwardIt last)
+        {
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            const key_t* prev = nullptr;
+            NodeRef node = build(first, n, prev);
+            return PersistentMap(node.take(), n);
+        }
+
+        template<typename Range>
+        static PersistentMap from_sorted(const Range& range)
+        {
+            return from_sorted(std::begin(range), std::end(range));
+        }
+
+        /** \return a version with the key and value inserted, or this same
+          * version if the key already exists */
+        [[nodiscard]] PersistentMap insert(const key_t& key, const value_t& value) const
+        {
+            bool inserted = false;
+            bool changed = false;
+            NodeRef node = insert(root, key, value, false, inserted, changed);
+            return PersistentMap(node.take(), _size + (inserted ? 1 : 0));
+        }
+
+        /** \return a version with the key and value inserted, or with the
+          * value replaced if the key already exists */
+        [[nodiscard]] PersistentMap insert_or_assign(const key_t& key, const value_t& value) const
+        {
+            bool inserted = false;
+            bool changed = false;
+            NodeRef node = insert(root, key, value, true, inserted, changed);
+            return PersistentMap(node.take(), _size + (inserted ? 1 : 0));
+        }
+
+        /** \return a version without the given key, or this same version if
+          * the key does not exist */
+        template<typename K>
+        [[nodiscard]] PersistentMap remove(const K& key) const
+        {
+            bool removed = false;
+            NodeRef node = remove(root, key, removed);
+            return PersistentMap(node.take(), _size - (removed ? 1 : 0));
+        }
+
+        /** \return a pointer to the value with the given key, or nullptr
+          * The pointer is valid as long as this version exists. */
+        template<typename K>
+        const value_t* find(const K& key) const
+        {
+            const Node* node = root;
+            while(node != nullptr)
+            {
+                if(key < node->key)
+                {
+                    node = node->left;
+                }
+                else if(node->key < key)
+                {
+                    node = node->right;
+                }
+                else
+                {
+                    return &(node->value);
+                }
+            }
+            return nullptr;
+        }
+
+        /** \return true if the given key exists */
+        template<typename K>
+        bool contains(const K& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        /** Copy the value with the given key into returnVal.
+          * \return true if the key exists, else false, leaving returnVal alone */
+        template<typename K>
+        bool retrieve(const K& key, value_t* returnVal) const
+        {
+            const value_t* value = find(key);
+            if(value != nullptr)
+            {
+                *returnVal = *value;
+                return true;
+            }
+            return false;
+        }
+
+        /** Call the visitor with each key and value, in key order.
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            inOrder(root, visitor);
+        }
+
+        /** Call the visitor with each key and value in [low, high), in key
+          * order, visiting only the subtrees which can hold keys in range.
+          * \param the lowest key to visit
+          * \param the key to stop before
+          * \param the visitor, which takes (const key_t&, const value_t&) */
+        template<typename K1, typename K2, typename Visitor>
+        void for_each_in_range(const K1& low, const K2& high, Visitor visitor) const
+        {
+            inRange(root, low, high, visitor);
+        }
+
+        /** \return true if both maps are the same version, or versions
+          * which share their whole tree */
+        bool shares(const PersistentMap& other) const
+        {
+            return root == other.root;
+        }
+
+        /** \return the number of elements */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return true if there are no elements */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** Print each key and value, in key order. */
+        void print() const
+        {
+            for_each([](const key_t& key, const value_t& value)
+            {
+                ioc << key << ": " << value << IOCtrl::endl;
+            });
+        }
+
+        ~PersistentMap()
+        {
+            release(root);
+        }
+};
+
+#endif // PAWLIB_PERSISTENTMAP_HPP
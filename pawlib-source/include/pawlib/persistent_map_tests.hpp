@@ -0,0 +1,614 @@
+/** Tests for PersistentMap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_PERSISTENTMAP_TESTS_HPP
+#define PAWLIB_PERSISTENTMAP_TESTS_HPP
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "pawlib/flex_map.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/persistent_map.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Check that a PersistentMap holds exactly the same elements as a std::map.
+  * \param the persistent map
+  * \param the model
+  * \return true if they match */
+template<typename key_t, typename value_t>
+bool persistent_matches(const PersistentMap<key_t, value_t>& map, const std::map<key_t, value_t>& model)
+{
+    if(map.size() != model.size())
+    {
+        return false;
+    }
+    auto expected = model.begin();
+    bool matches = true;
+    map.for_each([&](const key_t& key, const value_t& value)
+    {
+        if(expected == model.end() || !(key == expected->first) || !(value == expected->second))
+        {
+            matches = false;
+            return;
+        }
+        ++expected;
+    });
+    return matches && expected == model.end();
+}
+
+// P-tB7301
+class TestPersistentMap_InsertFind : public Test
+{
+    public:
+        TestPersistentMap_InsertFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Insert & Find";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert and assign " + stdutils::itos(count) + " random keys, and ensure each is found and the elements come out in order.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(7301);
+            std::map<int, int> model;
+            PersistentMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                int key = static_cast<int>(rng() % (count * 4)) - count;
+                if(i % 4 == 0)
+                {
+                    model[key] = i;
+                    map = map.insert_or_assign(key, i);
+                }
+                else
+                {
+                    bool inserted = model.emplace(key, i).second;
+                    PersistentMap<int, int> next = map.insert(key, i);
+                    // Inserting an existing key gives back the same version.
+                    PL_ASSERT_EQUAL(next.shares(map), !inserted);
+                    map = std::move(next);
+                }
+            }
+            PL_ASSERT_TRUE(persistent_matches(map, model));
+
+            for(int key = -count; key < count * 3; ++key)
+            {
+                auto it = model.find(key);
+                const int* value = map.find(key);
+                if(it == model.end())
+                {
+                    PL_ASSERT_TRUE(value == nullptr);
+                    PL_ASSERT_FALSE(map.contains(key));
+                }
+                else
+                {
+                    PL_ASSERT_TRUE(value != nullptr);
+                    PL_ASSERT_EQUAL(*value, it->second);
+                    int copied = 0;
+                    PL_ASSERT_TRUE(map.retrieve(key, &copied));
+                    PL_ASSERT_EQUAL(copied, it->second);
+                }
+            }
+            return true;
+        }
+
+        ~TestPersistentMap_InsertFind(){}
+
+    private:
+        static const int count = 2000;
+};
+
+// P-tB7302
+class TestPersistentMap_Remove : public Test
+{
+    public:
+        TestPersistentMap_Remove(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Remove";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Remove every key of " + stdutils::itos(count) + " in scrambled order, checking the map after each step.";
+        }
+
+        bool run() override
+        {
+            std::map<int, int> model;
+            PersistentMap<int, int> map;
+            for(int i = 0; i < count; ++i)
+            {
+                model.emplace(i, i * 3);
+                map = map.insert(i, i * 3);
+            }
+
+            // Removing a missing key gives back the same version.
+            PersistentMap<int, int> same = map.remove(count + 1);
+            PL_ASSERT_TRUE(same.shares(map));
+
+            for(int i = 0; i < count; ++i)
+            {
+                int key = (i * 7919) % count;
+                model.erase(key);
+                map = map.remove(key);
+                PL_ASSERT_FALSE(map.contains(key));
+                if(i % 50 == 0)
+                {
+                    PL_ASSERT_TRUE(persistent_matches(map, model));
+                }
+            }
+            PL_ASSERT_TRUE(map.empty());
+            return true;
+        }
+
+        ~TestPersistentMap_Remove(){}
+
+    private:
+        static const int count = 1000;
+};
+
+// P-tB7303
+class TestPersistentMap_Versions : public Test
+{
+    public:
+        TestPersistentMap_Versions(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Versions";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Make " + stdutils::itos(count) + " versions by random updates, and ensure every old version is unchanged.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(7303);
+            std::vector<PersistentMap<int, int>> versions;
+            std::vector<std::map<int, int>> models;
+            versions.emplace_back();
+            models.emplace_back();
+            for(int i = 0; i < count; ++i)
+            {
+                // Branch off a random earlier version, not just the latest.
+                size_t from = rng() % versions.size();
+                PersistentMap<int, int> map = versions[from];
+                std::map<int, int> model = models[from];
+                int key = static_cast<int>(rng() % 200);
+                switch(rng() % 3)
+                {
+                    case 0:
+                        map = map.insert(key, i);
+                        model.emplace(key, i);
+                        break;
+                    case 1:
+                        map = map.insert_or_assign(key, i);
+                        model[key] = i;
+                        break;
+                    default:
+                        map = map.remove(key);
+                        model.erase(key);
+                        break;
+                }
+                versions.push_back(std::move(map));
+                models.push_back(std::move(model));
+            }
+
+            for(size_t i = 0; i < versions.size(); ++i)
+            {
+                PL_ASSERT_TRUE(persistent_matches(versions[i], models[i]));
+            }
+
+            // Drop the versions in scrambled order; the survivors must not
+            // be affected by freeing the nodes they shared.
+            for(size_t i = 0; i < versions.size(); i += 2)
+            {
+                versions[(i * 7919) % versions.size()] = PersistentMap<int, int>();
+                models[(i * 7919) % versions.size()].clear();
+            }
+            for(size_t i = 0; i < versions.size(); ++i)
+            {
+                PL_ASSERT_TRUE(persistent_matches(versions[i], models[i]));
+            }
+            return true;
+        }
+
+        ~TestPersistentMap_Versions(){}
+
+    private:
+        static const int count = 500;
+};
+
+// P-tB7304
+class TestPersistentMap_Range : public Test
+{
+    public:
+        TestPersistentMap_Range(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: From Sorted & Range";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a map from sorted pairs, visit ranges of it, and ensure unsorted pairs are rejected.";
+        }
+
+        bool run() override
+        {
+            std::vector<std::pair<int, int>> pairs;
+            std::map<int, int> model;
+            for(int i = 0; i < count; ++i)
+            {
+                pairs.emplace_back(i * 2, i);
+                model.emplace(i * 2, i);
+            }
+            PersistentMap<int, int> map = PersistentMap<int, int>::from_sorted(pairs);
+            PL_ASSERT_TRUE(persistent_matches(map, model));
+
+            for(int low = -3; low < count * 2 + 3; low += 37)
+            {
+                int high = low + 101;
+                std::vector<int> visited;
+                map.for_each_in_range(low, high, [&visited](const int& key, const int&)
+                {
+                    visited.push_back(key);
+                });
+                std::vector<int> expected;
+                for(auto it = model.lower_bound(low); it != model.lower_bound(high); ++it)
+                {
+                    expected.push_back(it->first);
+                }
+                PL_ASSERT_TRUE(visited == expected);
+            }
+
+            pairs.emplace_back(0, 0);
+            bool threw = false;
+            try
+            {
+                PersistentMap<int, int> bad = PersistentMap<int, int>::from_sorted(pairs);
+            }
+            catch(const std::invalid_argument&)
+            {
+                threw = true;
+            }
+            PL_ASSERT_TRUE(threw);
+            return true;
+        }
+
+        ~TestPersistentMap_Range(){}
+
+    private:
+        static const int count = 1000;
+};
+
+// P-tB7305
+class TestPersistentMap_Strings : public Test
+{
+    public:
+        TestPersistentMap_Strings(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Strings";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Update a snapshot of a map with onestring keys and values, and ensure the original is unchanged.";
+        }
+
+        bool run() override
+        {
+            PersistentMap<onestring, onestring> original;
+            original = original.insert("alpha", "one");
+            original = original.insert("bravo", "two");
+            original = original.insert("delta", "four");
+
+            PersistentMap<onestring, onestring> snapshot = original;
+            PL_ASSERT_TRUE(snapshot.shares(original));
+            snapshot = snapshot.insert_or_assign("alpha", "uno");
+            snapshot = snapshot.insert("charl", "three");
+            snapshot = snapshot.remove("delta");
+
+            PL_ASSERT_EQUAL(original.size(), 3u);
+            PL_ASSERT_TRUE(*original.find("alpha") == "one");
+            PL_ASSERT_FALSE(original.contains("charl"));
+            PL_ASSERT_TRUE(original.contains("delta"));
+
+            PL_ASSERT_EQUAL(snapshot.size(), 3u);
+            PL_ASSERT_TRUE(*snapshot.find("alpha") == "uno");
+            PL_ASSERT_TRUE(*snapshot.find("charl") == "three");
+            PL_ASSERT_FALSE(snapshot.contains("delta"));
+            return true;
+        }
+
+        ~TestPersistentMap_Strings(){}
+};
+
+// P-tB7307
+class TestPersistentMap_ThrowingCopy : public Test
+{
+    public:
+        TestPersistentMap_ThrowingCopy(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Throwing Copy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Make copying a value throw at every point of insert(), "
+                   "insert_or_assign(), and remove(), and ensure the map is unchanged "
+                   "and no values are leaked.";
+        }
+
+        /* Counts the live values, and throws on the copy after copiesLeft
+         * more have been made, unless copiesLeft is negative. */
+        struct Counted
+        {
+            inline static int live = 0;
+            inline static int copiesLeft = -1;
+            int value;
+
+            explicit Counted(int v) : value(v) { ++live; }
+
+            Counted(const Counted& rhs) : value(rhs.value)
+            {
+                if(copiesLeft == 0)
+                {
+                    throw std::runtime_error("Counted: copy");
+                }
+                if(copiesLeft > 0)
+                {
+                    --copiesLeft;
+                }
+                ++live;
+            }
+
+            ~Counted() { --live; }
+        };
+
+        typedef PersistentMap<int, Counted> map_t;
+
+        /* Retry the update with a larger copy budget each time, until it
+         * succeeds, checking after every failure that the map still matches
+         * the model and that nothing was leaked. */
+        template<typename Update>
+        bool update_or_unchanged(map_t& map, const std::map<int, int>& model, Update update, int& failures)
+        {
+            int baseline = Counted::live;
+            for(int budget = 0; ; ++budget)
+            {
+                Counted::copiesLeft = budget;
+                try
+                {
+                    map_t updated = update(map);
+                    Counted::copiesLeft = -1;
+                    map = updated;
+                    return true;
+                }
+                catch(const std::runtime_error&)
+                {
+                    Counted::copiesLeft = -1;
+                }
+                ++failures;
+                if(Counted::live != baseline || map.size() != model.size())
+                {
+                    return false;
+                }
+                for(const auto& pair : model)
+                {
+                    const Counted* found = map.find(pair.first);
+                    if(found == nullptr || found->value != pair.second)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        bool run() override
+        {
+            {
+                map_t map;
+                std::map<int, int> model;
+                int failures = 0;
+                // Ascending keys rotate on most inserts, and removing the
+                // smallest keys rotates on the way back.
+                for(int key = 0; key < 64; ++key)
+                {
+                    PL_ASSERT_TRUE(update_or_unchanged(map, model,
+                        [key](const map_t& m) { return m.insert(key, Counted(key)); }, failures));
+                    model[key] = key;
+                }
+                for(int key = 0; key < 64; key += 3)
+                {
+                    PL_ASSERT_TRUE(update_or_unchanged(map, model,
+                        [key](const map_t& m) { return m.insert_or_assign(key, Counted(-key)); }, failures));
+                    model[key] = -key;
+                }
+                for(int key = 0; key < 48; ++key)
+                {
+                    PL_ASSERT_TRUE(update_or_unchanged(map, model,
+                        [key](const map_t& m) { return m.remove(key); }, failures));
+                    model.erase(key);
+                }
+                PL_ASSERT_GREATER(failures, 0);
+            }
+            PL_ASSERT_EQUAL(Counted::live, 0);
+            return true;
+        }
+
+        ~TestPersistentMap_ThrowingCopy(){}
+};
+
+// P-tB7306
+class TestPersistentMap_Snapshot : public Test
+{
+    public:
+        TestPersistentMap_Snapshot(){}
+
+        testdoc_t get_title() override
+        {
+            return "PersistentMap: Snapshot & Update";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Take " + stdutils::itos(updates) + " snapshots of a map of " + stdutils::itos(count) +
+                   " elements, updating one key after each.";
+        }
+
+        bool pre() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map = map.insert((i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            PersistentMap<int, int> current = map;
+            for(int i = 0; i < updates; ++i)
+            {
+                PersistentMap<int, int> snapshot = current;
+                current = snapshot.insert_or_assign((i * 7) % count, i);
+            }
+            return current.size() == static_cast<size_t>(count);
+        }
+
+        ~TestPersistentMap_Snapshot(){}
+
+    private:
+        static const int count = 10000;
+        static const int updates = 1000;
+        PersistentMap<int, int> map;
+};
+
+// P-tB7306*
+class TestPersistentMap_SnapshotCopy : public Test
+{
+    public:
+        TestPersistentMap_SnapshotCopy(){}
+
+        testdoc_t get_title() override
+        {
+            return "Map: Snapshot & Update";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Copy a Map of " + stdutils::itos(count) + " elements " + stdutils::itos(updates) +
+                   " times, updating one key after each.";
+        }
+
+        bool pre() override
+        {
+            if(map.empty())
+            {
+                for(int i = 0; i < count; ++i)
+                {
+                    map.insert((i * 7919) % count, i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            Map<int, int> current = map;
+            for(int i = 0; i < updates; ++i)
+            {
+                Map<int, int> snapshot = current;
+                current.insert_or_assign((i * 7) % count, i);
+            }
+            return current.size() == static_cast<size_t>(count);
+        }
+
+        ~TestPersistentMap_SnapshotCopy(){}
+
+    private:
+        static const int count = 10000;
+        static const int updates = 1000;
+        Map<int, int> map;
+};
+
+class TestSuite_PersistentMap : public TestSuite
+{
+    public:
+        explicit TestSuite_PersistentMap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: PersistentMap Tests";
+        }
+
+        ~TestSuite_PersistentMap(){}
+};
+
+#endif // PAWLIB_PERSISTENTMAP_TESTS_HPP
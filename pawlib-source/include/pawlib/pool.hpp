@@ -46,12 +46,14 @@
 #ifndef PAWLIB_POOL_HPP
 #define PAWLIB_POOL_HPP
 
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <iostream>
 
 #include "pawlib/constants.hpp"
 #include "pawlib/flex_stack.hpp"
+#include "pawlib/iochannel.hpp"
 
 //Signals and callbacks.
 #include "cpgf/gcallbacklist.h"
@@ -62,6 +64,57 @@
 template<typename T> class pool_ref;
 template<typename T> class pool_obj;
 
+/* Pool telemetry is compiled out unless PAWLIB_POOL_TELEMETRY is defined
+ * (see the POOL_TELEMETRY build option). One in every
+ * PAWLIB_POOL_TELEMETRY_SAMPLE calls to create() is timed. */
+#ifndef PAWLIB_POOL_TELEMETRY_SAMPLE
+#define PAWLIB_POOL_TELEMETRY_SAMPLE 64
+#endif
+
+/** A snapshot of a Pool's usage counters, from Pool::telemetry().
+ * All values are zero if telemetry is compiled out. */
+struct pool_telemetry
+{
+    /// The number of live objects.
+    uint32_t live = 0;
+    /// The greatest number of live objects at once.
+    uint32_t high_water = 0;
+    /// The number of objects created.
+    uint64_t creates = 0;
+    /// The number of objects destroyed.
+    uint64_t destroys = 0;
+    /// The number of objects which couldn't be created, as the pool was full.
+    uint64_t failed_creates = 0;
+    /// The number of calls to create() which were timed.
+    uint64_t latency_samples = 0;
+    /// The total time of all timed calls to create(), in nanoseconds.
+    uint64_t latency_total_ns = 0;
+    /// The longest timed call to create(), in nanoseconds.
+    uint64_t latency_max_ns = 0;
+    /// The number of seconds the counters cover.
+    double seconds = 0;
+
+    /** Returns the number of objects created per second. */
+    double create_rate() const
+    {
+        return (seconds > 0) ? creates / seconds : 0;
+    }
+
+    /** Returns the number of objects destroyed per second. */
+    double destroy_rate() const
+    {
+        return (seconds > 0) ? destroys / seconds : 0;
+    }
+
+    /** Returns the mean time of the timed calls to create(),
+     * in nanoseconds. */
+    double mean_latency_ns() const
+    {
+        return latency_samples ?
+            static_cast<double>(latency_total_ns) / latency_samples : 0;
+    }
+};
+
 class e_pool_full : public std::exception
 {
     virtual const char* what() const throw()
@@ -113,20 +166,185 @@ class Pool
         /// The maximum number of objects in the pool.
         uint32_t pool_size;
 
+        /** The packed occupancy bitmap. Bit (i % 64) of word (i / 64) is set
+         * when the object at index i is live. */
+        uint64_t* occupancy;
+        /// The number of 64-bit words in the occupancy bitmap.
+        uint32_t occupancy_words;
+
         /* The stack of available indexes. */
         FlexStack<uint32_t> index_available;
 
         /// If failsafe is on, we'll ignore create and access failures.
         bool failsafe;
 
+#ifdef PAWLIB_POOL_TELEMETRY
+        typedef std::chrono::steady_clock telemetry_clock_t;
+
+        /// The usage counters.
+        pool_telemetry stats;
+        /// When the usage counters were last reset.
+        telemetry_clock_t::time_point stats_since;
+        /// The number of calls to create() until the next timed one.
+        uint32_t sample_countdown;
+
+        /** Times a call to create() from construction to destruction,
+         * if one is due to be sampled. */
+        class latency_sample
+        {
+            public:
+                explicit latency_sample(Pool& pool)
+                :pool(pool), due(--pool.sample_countdown == 0),
+                 start(due ? telemetry_clock_t::now()
+                           : telemetry_clock_t::time_point())
+                {}
+
+                ~latency_sample()
+                {
+                    if(due)
+                    {
+                        pool.note_latency(telemetry_clock_t::now() - start);
+                    }
+                }
+
+            private:
+                Pool& pool;
+                bool due;
+                telemetry_clock_t::time_point start;
+        };
+
+        void note_latency(telemetry_clock_t::duration elapsed)
+        {
+            uint64_t ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    elapsed).count());
+            ++stats.latency_samples;
+            stats.latency_total_ns += ns;
+            if(ns > stats.latency_max_ns)
+            {
+                stats.latency_max_ns = ns;
+            }
+            sample_countdown = PAWLIB_POOL_TELEMETRY_SAMPLE;
+        }
+#else
+        /// Compiled out; does nothing.
+        class latency_sample
+        {
+            public:
+                explicit latency_sample(Pool&) {}
+        };
+#endif
+
+        /** Count objects created. Compiles to nothing without telemetry.
+         * \param the number of objects */
+        inline void note_created(uint32_t n)
+        {
+#ifdef PAWLIB_POOL_TELEMETRY
+            stats.creates += n;
+            stats.live += n;
+            if(stats.live > stats.high_water)
+            {
+                stats.high_water = stats.live;
+            }
+#else
+            (void)n;
+#endif
+        }
+
+        /** Count objects destroyed. Compiles to nothing without telemetry.
+         * \param the number of objects */
+        inline void note_destroyed(uint32_t n)
+        {
+#ifdef PAWLIB_POOL_TELEMETRY
+            stats.destroys += n;
+            stats.live -= n;
+#else
+            (void)n;
+#endif
+        }
+
+        /** Count objects which couldn't be created because the pool was
+         * full. Compiles to nothing without telemetry.
+         * \param the number of objects */
+        inline void note_failed(uint32_t n)
+        {
+#ifdef PAWLIB_POOL_TELEMETRY
+            stats.failed_creates += n;
+#else
+            (void)n;
+#endif
+        }
+
         void populate_stack()
         {
-            for(uint32_t i = 0; i < pool_size; ++i)
+            /* Push in reverse, so the lowest indexes are handed out first.
+             * This keeps live objects packed toward the front of the
+             * occupancy bitmap. */
+            for(uint32_t i = pool_size; i > 0; --i)
             {
-                index_available.push(i);
+                index_available.push(i - 1);
             }
         }
 
+        /** Mark the object at the given index as live in the bitmap.
+         * \param the index of the object */
+        inline void mark_live(uint32_t loc)
+        {
+            occupancy[loc >> 6] |= (uint64_t(1) << (loc & 63));
+        }
+
+        /** Mark the object at the given index as dead in the bitmap.
+         * \param the index of the object */
+        inline void mark_dead(uint32_t loc)
+        {
+            occupancy[loc >> 6] &= ~(uint64_t(1) << (loc & 63));
+        }
+
+        /** Check that the reference belongs to this pool and points to
+         * a valid index, throwing the appropriate exception if not.
+         * \param the pool reference to validate */
+        void validate_ref(poolref_t& rf)
+        {
+            // If the reference does not belong to the pool.
+            if(rf.pool_ptr != this)
+            {
+                // Throw a foreign reference error.
+                throw e_pool_foreign_ref();
+            }
+            /* Else if the reference points to an invalid index (such as when
+                * the reference was returned from an create() on a full, failsafe
+                * pool. */
+            else if(rf.getIndex() == INVALID_INDEX)
+            {
+                throw e_pool_invalid_ref();
+            }
+        }
+
+        /** Deinitialize the object at the given index, and return the
+         * index to the available stack. Does NOT validate the index.
+         * \param the index of the object to deinitialize */
+        void release(uint32_t loc)
+        {
+            try
+            {
+                /* Mark this index as up for grabs. We must do this now,
+                * before the reference is invalidated. */
+                index_available.push(loc);
+            }
+            catch(std::length_error&)
+            {
+                // Just don't bother pushing.
+            }
+
+            mark_dead(loc);
+            note_destroyed(1);
+
+            // Deinitialize the object.
+            pool_root[loc].deinit();
+            /* References are invalidated via the signal dispatched from
+                * pool_obj<T>::deinit(). */
+        }
+
         /** Find the next open position in the pool.
          * Return INVALID_INDEX if none found. */
         uint32_t find_open()
@@ -145,6 +363,52 @@ class Pool
             }
         }
 
+        /** Determine how many of n objects can be created, throwing
+         * e_pool_full if not all n fit and the pool is not failsafe.
+         * References that won't be created are made invalid.
+         * \param the array of n pool references
+         * \param the number of objects requested
+         * \return the number of objects to create
+         */
+        uint32_t reserve_n(poolref_t refs[], uint32_t n)
+        {
+            uint32_t count = n;
+            if(index_available.length() < n)
+            {
+                if(!failsafe)
+                {
+                    // Create nothing, so a failed bulk create has no effect.
+                    note_failed(n);
+                    throw e_pool_full();
+                }
+                count = index_available.length();
+                note_failed(n - count);
+            }
+
+            // Mark the leftover references as invalid.
+            for(uint32_t i = count; i < n; ++i)
+            {
+                refs[i] = poolref_t(this);
+            }
+
+            return count;
+        }
+
+        /** Point an existing pool reference at the object at the given
+         * index, in place. This avoids the temporary reference that
+         * assigning from create() would connect to the object's signal.
+         * \param the pool reference to repoint
+         * \param the index of the object
+         */
+        void attach(poolref_t& rf, uint32_t loc)
+        {
+            rf.disconnect();
+            rf.pool_ptr = this;
+            rf.index = loc;
+            object_signal(loc)->add(
+                cpgf::makeCallback(&rf, &pool_ref<T>::invalidate));
+        }
+
         poolobjsignal_t* object_signal(uint32_t loc)
         {
             return &(pool_root[loc].signal_deinit);
@@ -153,15 +417,19 @@ class Pool
     public:
         /** Define an empty Pool. */
         Pool()
-        :pool_size(0), failsafe(false), pool_root(nullptr)
-        {}
+        :pool_root(nullptr), pool_size(0), occupancy(nullptr),
+         occupancy_words(0), failsafe(false)
+        {
+            reset_telemetry();
+        }
 
         /** Define a new Pool of size n.
              * \param the maximum number of objects in the pool
              * \param whether to throw an exception on create() if pool is full
              */
         Pool(const uint32_t n, bool fs=false)
-        :pool_size(n), failsafe(fs)
+        :pool_root(nullptr), pool_size(n), occupancy(nullptr),
+         occupancy_words(0), failsafe(fs)
         {
             /* If the specified size is also the maximum valid integer,
                 * which we reserved for our invalid index marker, use one less.
@@ -175,7 +443,12 @@ class Pool
             // We dynamically allocate all the space up front.
             pool_root = new poolobj_t[pool_size];
 
+            // One bit per object, rounded up to whole 64-bit words.
+            occupancy_words = (pool_size >> 6) + ((pool_size & 63) ? 1 : 0);
+            occupancy = new uint64_t[occupancy_words]();
+
             populate_stack();
+            reset_telemetry();
         }
 
         // Copy constructor and copy assignment don't make sense for Pool!
@@ -188,11 +461,15 @@ class Pool
          */
         poolref_t create()
         {
+            // Times this call, if it's due to be sampled.
+            latency_sample sample(*this);
+
             // Try to find space in the pool.
             uint32_t loc = find_open();
             // If the pool is full...
             if(loc == INVALID_INDEX)
             {
+                note_failed(1);
                 // If we're in failsafe mode...
                 if(failsafe)
                 {
@@ -205,6 +482,8 @@ class Pool
 
             // Initiate the object.
             pool_root[loc].init();
+            mark_live(loc);
+            note_created(1);
 
             // Define and return a new pool reference.
             return poolref_t(this, loc, object_signal(loc));
@@ -219,11 +498,15 @@ class Pool
          */
         poolref_t create(const T& cpy)
         {
+            // Times this call, if it's due to be sampled.
+            latency_sample sample(*this);
+
             // Try to find space in the pool.
             uint32_t loc = find_open();
             // If the pool is full...
             if(loc == INVALID_INDEX)
             {
+                note_failed(1);
                 // If we're in failsafe mode...
                 if(failsafe)
                 {
@@ -237,6 +520,8 @@ class Pool
             /* Initiate that object using the passed object (i.e. from the
                 * constructor). */
             pool_root[loc].init(cpy);
+            mark_live(loc);
+            note_created(1);
 
             // Define and return a new pool reference.
             return poolref_t(this, loc, object_signal(loc));
@@ -248,24 +533,56 @@ class Pool
              */
         T& access(poolref_t& rf)
         {
-            // If the reference does not belong to the pool.
-            if(rf.pool_ptr != this)
-            {
-                // Throw a foreign reference error.
-                throw e_pool_foreign_ref();
-            }
-            /* Else if the reference points to an invalid index (such as when
-                * the reference was returned from an create() on a full, failsafe
-                * pool. */
-            else if(rf.getIndex() == INVALID_INDEX)
+            // Throws if the reference is foreign or invalid.
+            validate_ref(rf);
+            // Otherwise, we're good - return the stored object.
+            return pool_root[rf.getIndex()].object;
+        }
+
+        /** Create n new objects in our pool, using the object's
+         * default constructor. If the pool does not have room for all n,
+         * no objects are created and e_pool_full is thrown; in failsafe mode,
+         * as many as will fit are created, and the rest of the references
+         * are left invalid.
+         * \param the array of n pool references to assign to
+         * \param the number of objects to create
+         * \return the number of objects actually created
+         */
+        uint32_t create_n(poolref_t refs[], uint32_t n)
+        {
+            uint32_t count = reserve_n(refs, n);
+            for(uint32_t i = 0; i < count; ++i)
             {
-                throw e_pool_invalid_ref();
+                // reserve_n() guarantees there is room.
+                uint32_t loc = find_open();
+                pool_root[loc].init();
+                mark_live(loc);
+                attach(refs[i], loc);
             }
-            // Otherwise, we're good - return the stored object.
-            else
+            note_created(count);
+            return count;
+        }
+
+        /** Create n new objects in our pool, each copied from the
+         * given object. Follows the same rules as create_n(refs, n).
+         * \param the array of n pool references to assign to
+         * \param the number of objects to create
+         * \param the object to copy from
+         * \return the number of objects actually created
+         */
+        uint32_t create_n(poolref_t refs[], uint32_t n, const T& cpy)
+        {
+            uint32_t count = reserve_n(refs, n);
+            for(uint32_t i = 0; i < count; ++i)
             {
-                return pool_root[rf.getIndex()].object;
+                // reserve_n() guarantees there is room.
+                uint32_t loc = find_open();
+                pool_root[loc].init(cpy);
+                mark_live(loc);
+                attach(refs[i], loc);
             }
+            note_created(count);
+            return count;
         }
 
         /** Deinitialize the object in the pool at the given reference.
@@ -273,37 +590,85 @@ class Pool
              */
         void destroy(poolref_t& rf)
         {
-            // If the reference does not belong to the pool.
-            if(rf.pool_ptr != this)
+            // Throws if the reference is foreign or invalid.
+            validate_ref(rf);
+            // Otherwise, we're good - deinitialize the object.
+            release(rf.getIndex());
+        }
+
+        /** Deinitialize the objects at each of the given references.
+         * All references are validated before any object is destroyed,
+         * so an exception leaves the pool untouched. Invalid references
+         * are skipped if the pool is in failsafe mode.
+         * \param the array of pool references to the objects
+         * \param the number of references in the array
+         */
+        void destroy(poolref_t refs[], uint32_t n)
+        {
+            for(uint32_t i = 0; i < n; ++i)
             {
-                // Throw a foreign reference error.
-                throw e_pool_foreign_ref();
+                // Failsafe pools tolerate the invalid refs create_n left.
+                if(failsafe && refs[i].pool_ptr == this && refs[i].invalid())
+                {
+                    continue;
+                }
+                validate_ref(refs[i]);
             }
-            /* Else if the reference points to an invalid index (such as when
-                * the reference was returned from an create() on a full, failsafe
-                * pool. */
-            else if(rf.getIndex() == INVALID_INDEX)
+
+            for(uint32_t i = 0; i < n; ++i)
             {
-                throw e_pool_invalid_ref();
+                /* Skip invalid references, including duplicates that were
+                 * invalidated by an earlier destroy in this same call. */
+                if(!refs[i].invalid())
+                {
+                    release(refs[i].getIndex());
+                }
             }
-            // Otherwise, we're good - deinitialize the object.
-            else
+        }
+
+        /** Deinitialize every live object in the pool. All references to
+         * objects in the pool are invalidated. */
+        void destroy_all()
+        {
+            for(uint32_t w = 0; w < occupancy_words; ++w)
             {
-                try
+                uint64_t bits = occupancy[w];
+                // Skip 64 empty slots at a time.
+                while(bits)
                 {
-                    /* Mark this index as up for grabs. We must do this now,
-                    * before the reference is invalidated. */
-                    index_available.push(rf.getIndex());
+                    uint32_t loc = (w << 6) + __builtin_ctzll(bits);
+                    // Clear the lowest set bit.
+                    bits &= bits - 1;
+                    pool_root[loc].deinit();
+                    note_destroyed(1);
                 }
-                catch(std::length_error&)
+                occupancy[w] = 0;
+            }
+
+            // Every index is available again.
+            index_available.clear();
+            populate_stack();
+        }
+
+        /** Call the visitor on every live object in the pool, in index
+         * order. Empty regions of the pool are skipped 64 slots at a time,
+         * so the cost follows the number of live objects, not the capacity.
+         * Objects created by the visitor may or may not be visited.
+         * \param the visitor, callable as `visitor(T&)`
+         */
+        template<typename Visitor>
+        void for_each_live(Visitor visitor)
+        {
+            for(uint32_t w = 0; w < occupancy_words; ++w)
+            {
+                uint64_t bits = occupancy[w];
+                while(bits)
                 {
-                    // Just don't bother pushing.
+                    uint32_t loc = (w << 6) + __builtin_ctzll(bits);
+                    // Clear the lowest set bit.
+                    bits &= bits - 1;
+                    visitor(pool_root[loc].object);
                 }
-
-                // Deinitialize the object.
-                pool_root[rf.getIndex()].deinit();
-                /* References are invalidated via the signal dispatched from
-                    * pool_obj<T>::deinit(). */
             }
         }
 
@@ -316,10 +681,76 @@ class Pool
             return (sizeof(poolobj_t)*pool_size);
         }
 
+        /// Whether telemetry was compiled in (PAWLIB_POOL_TELEMETRY).
+#ifdef PAWLIB_POOL_TELEMETRY
+        static constexpr bool telemetry_enabled = true;
+#else
+        static constexpr bool telemetry_enabled = false;
+#endif
+
+        /** Returns a snapshot of the pool's usage counters, covering the
+         * time since the pool was created or reset_telemetry() was called.
+         * If telemetry is compiled out, every value is zero. */
+        pool_telemetry telemetry() const
+        {
+#ifdef PAWLIB_POOL_TELEMETRY
+            pool_telemetry snapshot = stats;
+            snapshot.seconds = std::chrono::duration<double>(
+                telemetry_clock_t::now() - stats_since).count();
+            return snapshot;
+#else
+            return pool_telemetry();
+#endif
+        }
+
+        /** Restart the usage counters. The live count is kept, and becomes
+         * the new high-water mark. */
+        void reset_telemetry()
+        {
+#ifdef PAWLIB_POOL_TELEMETRY
+            uint32_t live = stats.live;
+            stats = pool_telemetry();
+            stats.live = live;
+            stats.high_water = live;
+            stats_since = telemetry_clock_t::now();
+            sample_countdown = PAWLIB_POOL_TELEMETRY_SAMPLE;
+#endif
+        }
+
+        /** Print the usage counters to IOChannel, or a note that telemetry
+         * is compiled out.
+         * \param the name to print the pool under
+         * \param the category to print under (default=IOCat::debug) */
+        void dump_telemetry(const char* name = "Pool",
+                            IOCat cat = IOCat::debug) const
+        {
+            if(!telemetry_enabled)
+            {
+                ioc << cat << name << ": Telemetry is disabled. "
+                    << "Build with POOL_TELEMETRY=1." << IOCtrl::endl;
+                return;
+            }
+            pool_telemetry t = telemetry();
+            ioc << cat << name << " telemetry (over " << t.seconds << " s)"
+                << IOCtrl::n
+                << "  Live:           " << t.live << " / " << pool_size
+                << IOCtrl::n
+                << "  High water:     " << t.high_water << IOCtrl::n
+                << "  Creates:        " << t.creates
+                << " (" << t.create_rate() << "/s)" << IOCtrl::n
+                << "  Destroys:       " << t.destroys
+                << " (" << t.destroy_rate() << "/s)" << IOCtrl::n
+                << "  Failed creates: " << t.failed_creates << IOCtrl::n
+                << "  Create latency: " << t.mean_latency_ns()
+                << " ns mean, " << t.latency_max_ns << " ns max ("
+                << t.latency_samples << " samples)" << IOCtrl::endl;
+        }
+
         ~Pool()
         {
             // Deallocate and destroy the entire pool.
             delete[] pool_root;
+            delete[] occupancy;
         }
 };
 
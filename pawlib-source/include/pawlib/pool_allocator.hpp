@@ -0,0 +1,310 @@
+/** Pool Allocator [PawLIB]
+  * Version: 0.1
+  *
+  * Fixed-size block pools, and adapters which route the node allocations
+  * of standard and Flex containers to them, through either the C++ Allocator
+  * requirements or std::pmr::memory_resource.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+
+#ifndef PAWLIB_POOL_ALLOCATOR_HPP
+#define PAWLIB_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+/** A growable pool of fixed-size, uninitialized memory blocks.
+ * Like Pool, dynamic allocation is front-loaded: blocks are carved out of
+ * large slabs, and freed blocks are recycled through an intrusive free list
+ * without ever returning to the system until release() or destruction.
+ *
+ * This is a separate pool rather than a wrapper around Pool, because Pool
+ * can't serve an allocator: it holds a fixed number of objects of one type,
+ * constructs each one in create(), and hands out pool_ref handles instead
+ * of pointers. An allocator needs raw, uninitialized storage for whatever
+ * type it is rebound to, from a pool which grows on demand.
+ * Not thread-safe. */
+class BlockPool
+{
+    public:
+        /** Define a new BlockPool.
+         * \param the size of each block in bytes
+         * \param the alignment of each block (a power of two)
+         * \param the number of blocks in the first slab. Each new slab
+         * doubles this, up to max_slab_blocks.
+         */
+        explicit BlockPool(size_t block_size,
+                           size_t block_align = alignof(std::max_align_t),
+                           uint32_t slab_blocks = 32);
+
+        // Copy constructor and copy assignment don't make sense for BlockPool!
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        /** Get an uninitialized block from the pool.
+         * \return a pointer to the block */
+        inline void* allocate()
+        {
+            // Recycle a freed block first.
+            if(free_list != nullptr)
+            {
+                FreeBlock* block = free_list;
+                free_list = block->next;
+                return block;
+            }
+            // Otherwise, carve a new block from the current slab.
+            if(bump == bump_end)
+            {
+                grow();
+            }
+            void* block = bump;
+            bump += blocksize;
+            return block;
+        }
+
+        /** Return a block to the pool. The block must have come from
+         * this pool's allocate().
+         * \param the pointer to the block */
+        inline void deallocate(void* ptr) noexcept
+        {
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = free_list;
+            free_list = block;
+        }
+
+        /** Return every slab to the system at once. All blocks handed out
+         * by the pool become invalid. */
+        void release() noexcept;
+
+        /** Returns the size of each block in bytes. */
+        size_t block_size() const noexcept { return blocksize; }
+
+        /** Returns the alignment of each block. */
+        size_t block_align() const noexcept { return blockalign; }
+
+        /** Returns the number of bytes held from the system, including
+         * slab headers. */
+        size_t capacity() const noexcept { return held; }
+
+        /// The largest number of blocks allocated in a single slab.
+        static const uint32_t max_slab_blocks = 8192;
+
+        ~BlockPool();
+
+    private:
+        /// A block on the free list, stored in the block itself.
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        /// The header at the front of every slab.
+        struct Slab
+        {
+            Slab* next;
+            size_t bytes;
+        };
+
+        /// The size of each block, rounded up to its alignment.
+        size_t blocksize;
+        /// The alignment of each block.
+        size_t blockalign;
+        /// The size of the slab header, rounded up to the block alignment.
+        size_t header;
+        /// The number of blocks to put in the next slab.
+        uint32_t blocks_to_make;
+        /// The total number of bytes held in slabs.
+        size_t held;
+
+        /// The list of slabs, newest first.
+        Slab* slabs;
+        /// The list of freed blocks.
+        FreeBlock* free_list;
+        /// The next never-used block in the newest slab.
+        char* bump;
+        /// One past the last block in the newest slab.
+        char* bump_end;
+
+        /** Allocate a new slab, and point the bump pointer at it. */
+        void grow();
+};
+
+/** A std::pmr::memory_resource which serves small allocations from
+ * BlockPools, one per block size, and passes everything else upstream.
+ * Blocks carry no header: the size passed to deallocate() selects the pool.
+ * Not thread-safe. */
+class PoolResource : public std::pmr::memory_resource
+{
+    public:
+        /** Define a new PoolResource.
+         * \param the resource for allocations too large to pool */
+        explicit PoolResource(std::pmr::memory_resource* upstream =
+                                  std::pmr::new_delete_resource()) noexcept;
+
+        // Copy constructor and copy assignment don't make sense here!
+        PoolResource(const PoolResource&) = delete;
+        PoolResource& operator=(const PoolResource&) = delete;
+
+        /** Return every pooled block to the system at once.
+         * Upstream allocations are not affected. */
+        void release() noexcept;
+
+        /** Returns the resource used for allocations too large to pool. */
+        std::pmr::memory_resource* upstream_resource() const noexcept
+        {
+            return upstream;
+        }
+
+        /// The largest allocation, in bytes, which will be pooled.
+        static const size_t max_pooled = 1024;
+
+        /// The largest number of distinct block sizes which will be pooled.
+        static const size_t max_pools = 16;
+
+        ~PoolResource();
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other)
+            const noexcept override;
+
+    private:
+        /// The resource for allocations too large to pool.
+        std::pmr::memory_resource* upstream;
+
+        /** The pools, created on demand. Node-based containers use only a
+         * handful of distinct sizes, so a short linear search is cheapest. */
+        BlockPool* pools[max_pools];
+        /// The number of pools in use.
+        size_t pool_count;
+
+        /** Find (or create) the pool serving the given request.
+         * \param the number of bytes requested
+         * \param the alignment requested
+         * \param whether to create the pool if it doesn't exist
+         * \return the pool, or nullptr if the request can't be pooled
+         */
+        BlockPool* find_pool(size_t bytes, size_t alignment, bool create);
+};
+
+/** A C++ Allocator which routes allocations to a PoolResource.
+ * For use with node-based containers, such as std::list and std::map,
+ * and with the Flex data structures. The memory comes from BlockPool
+ * slabs, not from Pool; see BlockPool for why.
+ *
+ * All rebound copies of a PoolAllocator share the same PoolResource, which
+ * must outlive every container using it. There is no default constructor,
+ * so the resource must be passed to the container explicitly:
+ *
+ *     PoolResource nodes;
+ *     std::list<int, PoolAllocator<int>> lst{PoolAllocator<int>(nodes)};
+ */
+template<typename T>
+class PoolAllocator
+{
+    // Rebound allocators must be able to copy our resource.
+    template<typename U> friend class PoolAllocator;
+
+    public:
+        typedef T value_type;
+
+        /** Define a new PoolAllocator.
+         * \param the resource to allocate from */
+        explicit PoolAllocator(PoolResource& res) noexcept
+        :resource(&res)
+        {}
+
+        /** Rebinding copy constructor.
+         * \param the allocator to share a resource with */
+        template<typename U>
+        // cppcheck-suppress noExplicitConstructor
+        PoolAllocator(const PoolAllocator<U>& cpy) noexcept
+        :resource(cpy.resource)
+        {}
+
+        /** Allocate uninitialized storage for n objects.
+         * \param the number of objects
+         * \return a pointer to the storage */
+        T* allocate(size_t n)
+        {
+            if(n > std::numeric_limits<size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(
+                resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /** Return storage for n objects.
+         * \param the pointer from allocate()
+         * \param the number of objects passed to allocate() */
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            resource->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        /** Returns the resource this allocator uses. */
+        PoolResource* get_resource() const noexcept
+        {
+            return resource;
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U>& rhs) const noexcept
+        {
+            return resource == rhs.resource;
+        }
+
+        template<typename U>
+        bool operator!=(const PoolAllocator<U>& rhs) const noexcept
+        {
+            return resource != rhs.resource;
+        }
+
+    private:
+        /// The resource we allocate from.
+        PoolResource* resource;
+};
+
+#endif // PAWLIB_POOL_ALLOCATOR_HPP
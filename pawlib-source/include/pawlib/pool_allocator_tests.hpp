@@ -0,0 +1,423 @@
+/** Tests for Pool Allocator [PawLIB]
+  * Version: 0.1
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_POOL_ALLOCATOR_TESTS_HPP
+#define PAWLIB_POOL_ALLOCATOR_TESTS_HPP
+
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pawlib/flex_array.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/pool_allocator.hpp"
+#include "pawlib/stdutils.hpp"
+
+// P-tB1701
+class TestBlockPool_Recycle : public Test
+{
+    public:
+        TestBlockPool_Recycle(){}
+
+        testdoc_t get_title() override
+        {
+            return "BlockPool: Recycle Blocks";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Allocate " + stdutils::itos(iters) + " aligned blocks across several slabs, free them, and ensure they are reused.";
+        }
+
+        bool run() override
+        {
+            BlockPool blocks(24, 64, 4);
+            PL_ASSERT_EQUAL(blocks.block_size(), 64u);
+
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = blocks.allocate();
+                // Every block must honor the requested alignment.
+                PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(ptrs[i]) % 64, 0u);
+            }
+            size_t held = blocks.capacity();
+
+            for(size_t i = 0; i < iters; ++i)
+            {
+                blocks.deallocate(ptrs[i]);
+            }
+            // The most recently freed block is handed out first.
+            PL_ASSERT_TRUE(blocks.allocate() == ptrs[iters - 1]);
+            for(size_t i = 1; i < iters; ++i)
+            {
+                blocks.allocate();
+            }
+            // Reusing every block shouldn't have needed another slab.
+            PL_ASSERT_EQUAL(blocks.capacity(), held);
+
+            blocks.release();
+            PL_ASSERT_EQUAL(blocks.capacity(), 0u);
+            return true;
+        }
+
+        ~TestBlockPool_Recycle(){}
+
+    private:
+        static const size_t iters = 100;
+        void* ptrs[iters];
+};
+
+// P-tB1702
+class TestPoolAllocator_StdContainers : public Test
+{
+    public:
+        TestPoolAllocator_StdContainers(){}
+
+        testdoc_t get_title() override
+        {
+            return "PoolAllocator: Standard Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill a std::list, std::map, and std::unordered_map using PoolAllocator, and check their contents.";
+        }
+
+        bool run() override
+        {
+            PoolResource nodes;
+            {
+                std::list<int, PoolAllocator<int>> lst{PoolAllocator<int>(nodes)};
+                std::map<int, int, std::less<int>,
+                    PoolAllocator<std::pair<const int, int>>>
+                    map{PoolAllocator<std::pair<const int, int>>(nodes)};
+                std::unordered_map<int, int, std::hash<int>,
+                    std::equal_to<int>,
+                    PoolAllocator<std::pair<const int, int>>>
+                    umap{PoolAllocator<std::pair<const int, int>>(nodes)};
+
+                for(int i = 0; i < iters; ++i)
+                {
+                    lst.push_back(i);
+                    map[i] = i * 2;
+                    umap[i] = i * 3;
+                }
+                // Free every other element, so the next round recycles them.
+                for(int i = 0; i < iters; i += 2)
+                {
+                    map.erase(i);
+                    umap.erase(i);
+                }
+                lst.remove_if([](int n){ return n % 2 == 0; });
+                for(int i = 0; i < iters; i += 2)
+                {
+                    map[i] = i * 2;
+                    umap[i] = i * 3;
+                }
+
+                PL_ASSERT_EQUAL(lst.size(), static_cast<size_t>(iters / 2));
+                PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(iters));
+                PL_ASSERT_EQUAL(umap.size(), static_cast<size_t>(iters));
+                for(int i = 0; i < iters; ++i)
+                {
+                    PL_ASSERT_EQUAL(map[i], i * 2);
+                    PL_ASSERT_EQUAL(umap[i], i * 3);
+                }
+                PL_ASSERT_TRUE(lst.get_allocator().get_resource() == &nodes);
+            }
+            return true;
+        }
+
+        ~TestPoolAllocator_StdContainers(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1703
+class TestPoolResource_Pmr : public Test
+{
+    public:
+        TestPoolResource_Pmr(){}
+
+        testdoc_t get_title() override
+        {
+            return "PoolResource: Polymorphic Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill a std::pmr::map of std::pmr::strings, and a large std::pmr::vector which must be passed upstream.";
+        }
+
+        bool run() override
+        {
+            PoolResource nodes;
+            {
+                std::pmr::map<int, std::pmr::string> map(&nodes);
+                std::pmr::vector<int> vec(&nodes);
+
+                for(int i = 0; i < iters; ++i)
+                {
+                    // Long enough to defeat the small string optimization.
+                    map.emplace(i, std::pmr::string(
+                        "pool-allocated string number " + std::to_string(i)));
+                    vec.push_back(i);
+                }
+
+                PL_ASSERT_EQUAL(map.size(), static_cast<size_t>(iters));
+                PL_ASSERT_EQUAL(vec.size(), static_cast<size_t>(iters));
+                PL_ASSERT_TRUE(map[7] == "pool-allocated string number 7");
+                PL_ASSERT_TRUE(map.at(7).get_allocator().resource() == &nodes);
+                PL_ASSERT_EQUAL(vec[iters - 1], iters - 1);
+            }
+            PL_ASSERT_TRUE(nodes.is_equal(nodes));
+            return true;
+        }
+
+        ~TestPoolResource_Pmr(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1704
+class TestPoolAllocator_FlexArray : public Test
+{
+    public:
+        TestPoolAllocator_FlexArray(){}
+
+        testdoc_t get_title() override
+        {
+            return "PoolAllocator: FlexArray";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Grow, copy, and move FlexArrays of std::string using PoolAllocator.";
+        }
+
+        bool run() override
+        {
+            typedef PoolAllocator<std::string> alloc_t;
+            PoolResource nodes;
+            {
+                FlexArray<std::string, false, true, alloc_t> arr{alloc_t(nodes)};
+                for(int i = 0; i < iters; ++i)
+                {
+                    arr.push(std::to_string(i));
+                }
+
+                FlexArray<std::string, false, true, alloc_t> cpy(arr);
+                FlexArray<std::string, false, true, alloc_t> mov(std::move(cpy));
+
+                PL_ASSERT_EQUAL(mov.length(), static_cast<size_t>(iters));
+                for(int i = 0; i < iters; ++i)
+                {
+                    PL_ASSERT_TRUE(mov[i] == std::to_string(i));
+                }
+            }
+            return true;
+        }
+
+        ~TestPoolAllocator_FlexArray(){}
+
+    private:
+        static const int iters = 100;
+};
+
+// P-tB1705*
+class TestStdAllocator_ListChurn : public Test
+{
+    public:
+        TestStdAllocator_ListChurn(){}
+
+        testdoc_t get_title() override
+        {
+            return "std::allocator: List Churn";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Push and pop " + stdutils::itos(iters) + " nodes through a std::list using std::allocator.";
+        }
+
+        bool run() override
+        {
+            std::list<int> lst;
+            for(int r = 0; r < 3; ++r)
+            {
+                for(int i = 0; i < iters; ++i)
+                {
+                    lst.push_back(i);
+                }
+                while(!lst.empty())
+                {
+                    lst.pop_front();
+                }
+            }
+            return true;
+        }
+
+        ~TestStdAllocator_ListChurn(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1705
+class TestPoolAllocator_ListChurn : public Test
+{
+    public:
+        TestPoolAllocator_ListChurn(){}
+
+        testdoc_t get_title() override
+        {
+            return "PoolAllocator: List Churn";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Push and pop " + stdutils::itos(iters) + " nodes through a std::list using PoolAllocator.";
+        }
+
+        bool run() override
+        {
+            std::list<int, PoolAllocator<int>> lst{PoolAllocator<int>(nodes)};
+            for(int r = 0; r < 3; ++r)
+            {
+                for(int i = 0; i < iters; ++i)
+                {
+                    lst.push_back(i);
+                }
+                while(!lst.empty())
+                {
+                    lst.pop_front();
+                }
+            }
+            return true;
+        }
+
+        ~TestPoolAllocator_ListChurn(){}
+
+    private:
+        static const int iters = 1000;
+        PoolResource nodes;
+};
+
+// P-tB1706
+class TestPoolResource_FlexArrayMove : public Test
+{
+    public:
+        TestPoolResource_FlexArrayMove(){}
+
+        testdoc_t get_title() override
+        {
+            return "PoolResource: FlexArray Move Assignment";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Move-assign FlexArrays using std::pmr::polymorphic_allocator, between "
+                   "arrays on the same resource and on different ones.";
+        }
+
+        bool run() override
+        {
+            typedef std::pmr::polymorphic_allocator<std::string> alloc_t;
+            typedef FlexArray<std::string, false, true, alloc_t> array_t;
+            PoolResource first;
+            PoolResource second;
+            {
+                array_t source{alloc_t(&first)};
+                for(int i = 0; i < iters; ++i)
+                {
+                    // Long enough to defeat the small string optimization.
+                    source.push("pool-allocated string number " + std::to_string(i));
+                }
+
+                // The same resource, so the array is stolen.
+                array_t same{alloc_t(&first)};
+                same = std::move(source);
+                PL_ASSERT_EQUAL(same.length(), static_cast<size_t>(iters));
+
+                // A different resource, so the elements are moved one by one.
+                array_t other{alloc_t(&second)};
+                other.push("replaced");
+                other = std::move(same);
+                PL_ASSERT_EQUAL(other.length(), static_cast<size_t>(iters));
+                for(int i = 0; i < iters; ++i)
+                {
+                    PL_ASSERT_TRUE(other[i] == "pool-allocated string number " + std::to_string(i));
+                }
+                other.push("after the move");
+                PL_ASSERT_EQUAL(other.length(), static_cast<size_t>(iters + 1));
+            }
+            return true;
+        }
+
+        ~TestPoolResource_FlexArrayMove(){}
+
+    private:
+        static const int iters = 100;
+};
+
+class TestSuite_PoolAllocator : public TestSuite
+{
+    public:
+        explicit TestSuite_PoolAllocator(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: Pool Allocator Tests";
+        }
+
+        ~TestSuite_PoolAllocator(){}
+};
+
+#endif // PAWLIB_POOL_ALLOCATOR_TESTS_HPP
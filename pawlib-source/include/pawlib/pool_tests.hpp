@@ -128,8 +128,9 @@ class TestPool_ThriceFillAlloc : public Test
 class TestPool_ThriceFill : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_ThriceFill(){}
+        TestPool_ThriceFill()
+        :pool(nullptr), refs(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -225,8 +226,8 @@ class TestPool_Create : public Test
             COPY_FAILSAFE
         };
 
-        // cppcheck-suppress uninitMemberVar
         explicit TestPool_Create(TestPoolCreateMode mode)
+        :pool(nullptr)
         {
             switch(mode)
             {
@@ -351,8 +352,9 @@ class TestPool_Create : public Test
 class TestPool_Access : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_Access(){}
+        TestPool_Access()
+        :pool(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -427,8 +429,9 @@ class TestPool_Access : public Test
 class TestPool_Destroy : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_Destroy(){}
+        TestPool_Destroy()
+        :pool(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -513,9 +516,8 @@ class TestPool_Exception : public Test
             POOL_DES_FOREIGN_REF
         };
 
-        // cppcheck-suppress uninitMemberVar
         explicit TestPool_Exception(FailTestType ex)
-        :type(ex)
+        :type(ex), pool(nullptr)
         {
             switch(type)
             {
@@ -701,6 +703,402 @@ class TestPool_Exception : public Test
         testdoc_t docs;
 };
 
+// P-tB160E, P-tB160F
+class TestPool_CreateN : public Test
+{
+    public:
+        explicit TestPool_CreateN(bool fs)
+        :failsafe(fs), pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            if(failsafe)
+            {
+                return "Pool: Bulk Create, Failsafe Overflow";
+            }
+            return "Pool: Bulk Create";
+        }
+
+        testdoc_t get_docs() override
+        {
+            if(failsafe)
+            {
+                return "Bulk create " + stdutils::itos(iters) + " objects in a failsafe pool with room for half, and ensure the remaining references are invalid.";
+            }
+            return "Bulk create " + stdutils::itos(iters) + " objects in a pool with create_n().";
+        }
+
+        bool pre() override
+        {
+            refs = new pool_ref<DummyClass>[iters];
+            pool = new Pool<DummyClass>(failsafe ? iters / 2 : iters, failsafe);
+            return true;
+        }
+
+        bool janitor() override
+        {
+            pool->destroy_all();
+            return true;
+        }
+
+        bool run() override
+        {
+            uint32_t made = 0;
+            try
+            {
+                made = pool->create_n(refs, iters, DummyClass(5,4,3,2,1));
+            }
+            catch(e_pool_full&)
+            {
+                return false;
+            }
+
+            uint32_t expected = (failsafe ? iters / 2 : iters);
+            if(made != expected)
+            {
+                return false;
+            }
+
+            for(uint32_t i = 0; i < iters; ++i)
+            {
+                // Only the created references should be valid.
+                if(refs[i].invalid() != (i >= expected))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestPool_CreateN(){}
+
+    private:
+        static const uint32_t iters = 100;
+
+        bool failsafe;
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1610
+class TestPool_DestroyMany : public Test
+{
+    public:
+        TestPool_DestroyMany()
+        :pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Bulk Destroy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Bulk create and destroy " + stdutils::itos(iters) + " objects in a pool three times.";
+        }
+
+        bool pre() override
+        {
+            refs = new pool_ref<DummyClass>[iters];
+            pool = new Pool<DummyClass>(iters);
+            return true;
+        }
+
+        bool run() override
+        {
+            for(int r = 0; r < 3; ++r)
+            {
+                try
+                {
+                    pool->create_n(refs, iters);
+                    pool->destroy(refs, iters);
+                }
+                catch(std::exception&)
+                {
+                    return false;
+                }
+
+                for(uint32_t i = 0; i < iters; ++i)
+                {
+                    if(!refs[i].invalid())
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestPool_DestroyMany(){}
+
+    private:
+        static const uint32_t iters = 100;
+
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1611
+class TestPool_DestroyAll : public Test
+{
+    public:
+        TestPool_DestroyAll()
+        :pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Destroy All";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill a " + stdutils::itos(iters) + "-object pool, destroy all objects at once, and ensure all references are invalidated and the pool can be refilled.";
+        }
+
+        bool pre() override
+        {
+            refs = new pool_ref<DummyClass>[iters];
+            pool = new Pool<DummyClass>(iters);
+            return true;
+        }
+
+        bool run() override
+        {
+            try
+            {
+                pool->create_n(refs, iters);
+                pool->destroy_all();
+            }
+            catch(std::exception&)
+            {
+                return false;
+            }
+
+            for(uint32_t i = 0; i < iters; ++i)
+            {
+                if(!refs[i].invalid())
+                {
+                    return false;
+                }
+            }
+
+            // The pool should be completely available again.
+            try
+            {
+                pool->create_n(refs, iters);
+                pool->destroy_all();
+            }
+            catch(e_pool_full&)
+            {
+                return false;
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestPool_DestroyAll(){}
+
+    private:
+        static const uint32_t iters = 100;
+
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1612, P-tS1612
+class TestPool_ForEachLive : public Test
+{
+    public:
+        explicit TestPool_ForEachLive(uint32_t size)
+        :pool_size(size), pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Visit Live Objects (" + stdutils::itos(pool_size) + ")";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Create " + stdutils::itos(live) + " scattered objects in a " + stdutils::itos(pool_size) + "-object pool, and visit only the live ones with for_each_live().";
+        }
+
+        bool pre() override
+        {
+            refs = new pool_ref<DummyClass>[live * 2];
+            pool = new Pool<DummyClass>(pool_size);
+
+            try
+            {
+                // Create twice as many as we need, and destroy every other.
+                pool->create_n(refs, live * 2);
+                for(uint32_t i = 0; i < live * 2; i += 2)
+                {
+                    pool->destroy(refs[i]);
+                }
+            }
+            catch(std::exception&)
+            {
+                return false;
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            uint32_t visited = 0;
+            pool->for_each_live([&visited](DummyClass& obj)
+            {
+                if(obj.alive())
+                {
+                    ++visited;
+                }
+            });
+            return (visited == live);
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestPool_ForEachLive(){}
+
+    private:
+        static const uint32_t live = 50;
+
+        uint32_t pool_size;
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1613
+class TestPool_Telemetry : public Test
+{
+    public:
+        TestPool_Telemetry(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Telemetry";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Create, destroy, and overfill a pool, and check its usage counters (or that they're all zero, if telemetry is compiled out).";
+        }
+
+        bool run() override
+        {
+            Pool<DummyClass> pool(iters, true);
+            pool_ref<DummyClass> refs[iters];
+
+            pool.create_n(refs, iters);
+            // The pool is full, so these fail.
+            pool.create();
+            pool.create(DummyClass(5));
+            pool.destroy(refs[0]);
+            pool.destroy(refs[1]);
+            pool.destroy_all();
+
+            pool_telemetry t = pool.telemetry();
+            pool.dump_telemetry("Test pool");
+
+            if(!Pool<DummyClass>::telemetry_enabled)
+            {
+                PL_ASSERT_EQUAL(t.creates, 0u);
+                PL_ASSERT_EQUAL(t.high_water, 0u);
+                PL_ASSERT_EQUAL(t.failed_creates, 0u);
+                return true;
+            }
+
+            PL_ASSERT_EQUAL(t.live, 0u);
+            PL_ASSERT_EQUAL(t.high_water, iters);
+            PL_ASSERT_EQUAL(t.creates, static_cast<uint64_t>(iters));
+            PL_ASSERT_EQUAL(t.destroys, static_cast<uint64_t>(iters));
+            PL_ASSERT_EQUAL(t.failed_creates, 2u);
+            PL_ASSERT_GREATER(t.seconds, 0.0);
+            PL_ASSERT_GREATER(t.create_rate(), 0.0);
+
+            // Enough single creates that some are sampled for latency.
+            for(uint32_t r = 0; r < PAWLIB_POOL_TELEMETRY_SAMPLE * 2; ++r)
+            {
+                pool_ref<DummyClass> rf = pool.create();
+                pool.destroy(rf);
+            }
+            PL_ASSERT_GREATER_EQUAL(pool.telemetry().latency_samples, 2u);
+
+            pool.reset_telemetry();
+            pool_ref<DummyClass> rf = pool.create();
+            t = pool.telemetry();
+            pool.destroy(rf);
+            PL_ASSERT_EQUAL(t.live, 1u);
+            PL_ASSERT_EQUAL(t.high_water, 1u);
+            PL_ASSERT_EQUAL(t.creates, 1u);
+            PL_ASSERT_EQUAL(t.destroys, 0u);
+            PL_ASSERT_EQUAL(t.latency_samples, 0u);
+            return true;
+        }
+
+        ~TestPool_Telemetry(){}
+
+    private:
+        static const uint32_t iters = 100;
+};
+
 class TestSuite_Pool : public TestSuite
 {
     public:
@@ -0,0 +1,1592 @@
+/** RoaringBitmap [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * A compressed bitmap of 32-bit integers, in the style of Roaring.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ROARINGBITMAP_HPP
+#define PAWLIB_ROARINGBITMAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+class RoaringView;
+
+/** A set of 32-bit integers, compressed in the style of Roaring bitmaps.
+  * The integers are split into chunks by their upper 16 bits, and each chunk
+  * is stored in whichever container suits it:
+  *
+  * - an array container holds up to 4096 sorted 16-bit values,
+  * - a bitmap container holds all 65536 bits of the chunk, in 1024 words,
+  * - a run container holds sorted runs of consecutive values.
+  *
+  * Array and bitmap containers are chosen automatically as a chunk grows and
+  * shrinks. Run containers come from add_range(), and from run_optimize(),
+  * which converts any chunk that would be smaller as runs.
+  *
+  * Union, intersection, and difference work chunk by chunk, merging arrays
+  * and runs directly, and combining bitmaps a word at a time (four at a time
+  * with AVX2).
+  *
+  * serialize() writes the standard Roaring format, which RoaringView can
+  * query in place, for example from a memory-mapped file. */
+class RoaringBitmap
+{
+    private:
+        enum class Kind : uint8_t
+        {
+            array,
+            bitmap,
+            run
+        };
+
+        struct Container
+        {
+            uint16_t key;
+            Kind kind;
+            // Up to 65536, so it needs more than 16 bits.
+            uint32_t cardinality;
+            // The sorted values of an array container, or the runs of a run
+            // container, as pairs of (start, length - 1).
+            std::vector<uint16_t> values;
+            // The 1024 words of a bitmap container.
+            std::vector<uint64_t> words;
+
+            Container(uint16_t key, Kind kind)
+            :key(key), kind(kind), cardinality(0)
+            {}
+        };
+
+        static const uint32_t arrayLimit = 4096;
+        static const size_t bitmapWords = 1024;
+
+        // The Roaring format's cookies, with and without run containers.
+        static const uint32_t cookieRuns = 12347;
+        static const uint32_t cookieNoRuns = 12346;
+
+        friend class RoaringView;
+
+        /** \return true if the container holds the given low 16 bits */
+        static bool holds(const Container& c, uint16_t low)
+        {
+            switch(c.kind)
+            {
+                case Kind::array:
+                    return std::binary_search(c.values.begin(), c.values.end(), low);
+                case Kind::bitmap:
+                    return (c.words[low >> 6] >> (low & 63)) & 1;
+                case Kind::run:
+                {
+                    size_t run = last_run_at_or_before(c, low);
+                    return run != SIZE_MAX && low - c.values[run * 2] <= c.values[run * 2 + 1];
+                }
+            }
+            return false;
+        }
+
+        /** \return the index of the last run starting at or before low, or SIZE_MAX */
+        static size_t last_run_at_or_before(const Container& c, uint16_t low)
+        {
+            size_t first = 0;
+            size_t last = c.values.size() / 2;
+            while(first < last)
+            {
+                size_t middle = first + (last - first) / 2;
+                if(c.values[middle * 2] <= low)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return (first == 0) ? SIZE_MAX : first - 1;
+        }
+
+        /** Set the bits [first, last] in the words. */
+        static void set_bits(uint64_t* words, uint32_t first, uint32_t last)
+        {
+            uint32_t firstWord = first >> 6;
+            uint32_t lastWord = last >> 6;
+            uint64_t firstMask = ~uint64_t(0) << (first & 63);
+            uint64_t lastMask = ~uint64_t(0) >> (63 - (last & 63));
+            if(firstWord == lastWord)
+            {
+                words[firstWord] |= firstMask & lastMask;
+                return;
+            }
+            words[firstWord] |= firstMask;
+            for(uint32_t w = firstWord + 1; w < lastWord; ++w)
+            {
+                words[w] = ~uint64_t(0);
+            }
+            words[lastWord] |= lastMask;
+        }
+
+        /** Clear the bits [first, last] in the words. */
+        static void clear_bits(uint64_t* words, uint32_t first, uint32_t last)
+        {
+            uint32_t firstWord = first >> 6;
+            uint32_t lastWord = last >> 6;
+            uint64_t firstMask = ~uint64_t(0) << (first & 63);
+            uint64_t lastMask = ~uint64_t(0) >> (63 - (last & 63));
+            if(firstWord == lastWord)
+            {
+                words[firstWord] &= ~(firstMask & lastMask);
+                return;
+            }
+            words[firstWord] &= ~firstMask;
+            for(uint32_t w = firstWord + 1; w < lastWord; ++w)
+            {
+                words[w] = 0;
+            }
+            words[lastWord] &= ~lastMask;
+        }
+
+        static uint32_t popcount_words(const uint64_t* words)
+        {
+            uint32_t total = 0;
+            for(size_t w = 0; w < bitmapWords; ++w)
+            {
+                total += static_cast<uint32_t>(__builtin_popcountll(words[w]));
+            }
+            return total;
+        }
+
+        enum class Op
+        {
+            or_op,
+            and_op,
+            and_not_op
+        };
+
+        /** Combine the 1024 words of b into a. */
+        template<Op op>
+        static void combine_words(uint64_t* a, const uint64_t* b)
+        {
+            size_t w = 0;
+#if defined(__AVX2__)
+            for(; w < bitmapWords; w += 4)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+                __m256i result;
+                if constexpr(op == Op::or_op) { result = _mm256_or_si256(x, y); }
+                else if constexpr(op == Op::and_op) { result = _mm256_and_si256(x, y); }
+                // andnot inverts its first argument.
+                else { result = _mm256_andnot_si256(y, x); }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + w), result);
+            }
+#endif
+            for(; w < bitmapWords; ++w)
+            {
+                if constexpr(op == Op::or_op) { a[w] |= b[w]; }
+                else if constexpr(op == Op::and_op) { a[w] &= b[w]; }
+                else { a[w] &= ~b[w]; }
+            }
+        }
+
+        /** \return the container's values as 1024 words */
+        static std::vector<uint64_t> to_words(const Container& c)
+        {
+            if(c.kind == Kind::bitmap)
+            {
+                return c.words;
+            }
+            std::vector<uint64_t> words(bitmapWords, 0);
+            if(c.kind == Kind::array)
+            {
+                for(uint16_t low : c.values)
+                {
+                    words[low >> 6] |= uint64_t(1) << (low & 63);
+                }
+            }
+            else
+            {
+                for(size_t r = 0; r < c.values.size(); r += 2)
+                {
+                    set_bits(words.data(), c.values[r], uint32_t(c.values[r]) + c.values[r + 1]);
+                }
+            }
+            return words;
+        }
+
+        /** \return an array or bitmap container, whichever suits the number of values */
+        static Container from_words(uint16_t key, std::vector<uint64_t>&& words, uint32_t cardinality)
+        {
+            if(cardinality > arrayLimit)
+            {
+                Container c(key, Kind::bitmap);
+                c.cardinality = cardinality;
+                c.words = std::move(words);
+                return c;
+            }
+            Container c(key, Kind::array);
+            c.cardinality = cardinality;
+            c.values.reserve(cardinality);
+            for(size_t w = 0; w < bitmapWords; ++w)
+            {
+                for(uint64_t word = words[w]; word != 0; word &= word - 1)
+                {
+                    c.values.push_back(static_cast<uint16_t>((w << 6) + static_cast<size_t>(__builtin_ctzll(word))));
+                }
+            }
+            return c;
+        }
+
+        /** \return an array or bitmap container, whichever suits the number of values */
+        static Container from_values(uint16_t key, std::vector<uint16_t>&& values)
+        {
+            uint32_t cardinality = static_cast<uint32_t>(values.size());
+            if(cardinality > arrayLimit)
+            {
+                std::vector<uint64_t> words(bitmapWords, 0);
+                for(uint16_t low : values)
+                {
+                    words[low >> 6] |= uint64_t(1) << (low & 63);
+                }
+                return from_words(key, std::move(words), cardinality);
+            }
+            Container c(key, Kind::array);
+            c.cardinality = cardinality;
+            c.values = std::move(values);
+            return c;
+        }
+
+        /** \return a run container from (start, length - 1) pairs */
+        static Container from_runs(uint16_t key, std::vector<uint16_t>&& runs)
+        {
+            Container c(key, Kind::run);
+            for(size_t r = 0; r < runs.size(); r += 2)
+            {
+                c.cardinality += uint32_t(runs[r + 1]) + 1;
+            }
+            c.values = std::move(runs);
+            return c;
+        }
+
+        /** Turn a run container into an array or bitmap container. */
+        static void unrun(Container& c)
+        {
+            c = from_words(c.key, to_words(c), c.cardinality);
+        }
+
+        /** Keep the array values for which keep() is true, in place. */
+        template<typename Keep>
+        static void filter(Container& array, Keep keep)
+        {
+            size_t kept = 0;
+            for(uint16_t low : array.values)
+            {
+                if(keep(low))
+                {
+                    array.values[kept++] = low;
+                }
+            }
+            array.values.resize(kept);
+            array.cardinality = static_cast<uint32_t>(kept);
+        }
+
+        /** Turn a container into a bitmap container, whatever its size. */
+        static void to_bitmap(Container& c)
+        {
+            c.words = to_words(c);
+            c.values = std::vector<uint16_t>();
+            c.kind = Kind::bitmap;
+        }
+
+        /** Recount a bitmap container which has changed, making it an array
+          * if it has shrunk. */
+        static void recount(Container& c)
+        {
+            c.cardinality = popcount_words(c.words.data());
+            if(c.cardinality <= arrayLimit)
+            {
+                c = from_words(c.key, std::move(c.words), c.cardinality);
+            }
+        }
+
+        /** Add the values of b to a, two containers with the same key. */
+        static void unite(Container& a, const Container& b)
+        {
+            if(a.kind == Kind::array && b.kind == Kind::array)
+            {
+                std::vector<uint16_t> values;
+                values.reserve(a.values.size() + b.values.size());
+                std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                               std::back_inserter(values));
+                a = from_values(a.key, std::move(values));
+                return;
+            }
+            if(a.kind == Kind::run && b.kind == Kind::run)
+            {
+                a = from_runs(a.key, merge_runs(a.values, b.values));
+                return;
+            }
+            // A full chunk absorbs anything.
+            if(a.cardinality == 65536 || b.cardinality == 65536)
+            {
+                if(b.cardinality == 65536)
+                {
+                    a = b;
+                }
+                return;
+            }
+            if(a.kind != Kind::bitmap)
+            {
+                to_bitmap(a);
+            }
+            unite_into(a, b);
+            recount(a);
+        }
+
+        /** Add the values of b to the words of bitmap a, without recounting. */
+        static void unite_into(Container& a, const Container& b)
+        {
+            switch(b.kind)
+            {
+                case Kind::array:
+                    for(uint16_t low : b.values)
+                    {
+                        a.words[low >> 6] |= uint64_t(1) << (low & 63);
+                    }
+                    break;
+                case Kind::bitmap:
+                    combine_words<Op::or_op>(a.words.data(), b.words.data());
+                    break;
+                case Kind::run:
+                    for(size_t r = 0; r < b.values.size(); r += 2)
+                    {
+                        set_bits(a.words.data(), b.values[r], uint32_t(b.values[r]) + b.values[r + 1]);
+                    }
+                    break;
+            }
+        }
+
+        /** Keep only the values of a which are also in b, two containers with
+          * the same key. */
+        static void intersect(Container& a, const Container& b)
+        {
+            if(a.kind == Kind::array && b.kind == Kind::array)
+            {
+                // Merge, writing behind the read position.
+                size_t kept = 0;
+                size_t j = 0;
+                for(size_t i = 0; i < a.values.size() && j < b.values.size(); )
+                {
+                    if(a.values[i] < b.values[j])
+                    {
+                        ++i;
+                    }
+                    else if(b.values[j] < a.values[i])
+                    {
+                        ++j;
+                    }
+                    else
+                    {
+                        a.values[kept++] = a.values[i];
+                        ++i;
+                        ++j;
+                    }
+                }
+                a.values.resize(kept);
+                a.cardinality = static_cast<uint32_t>(kept);
+                return;
+            }
+            if(a.kind == Kind::array)
+            {
+                filter(a, [&b](uint16_t low) { return holds(b, low); });
+                return;
+            }
+            if(b.kind == Kind::array)
+            {
+                Container array = b;
+                filter(array, [&a](uint16_t low) { return holds(a, low); });
+                a = std::move(array);
+                return;
+            }
+            if(a.kind == Kind::run && b.kind == Kind::run)
+            {
+                a = from_runs(a.key, intersect_runs(a.values, b.values));
+                return;
+            }
+            if(a.kind == Kind::run)
+            {
+                to_bitmap(a);
+            }
+            if(b.kind == Kind::bitmap)
+            {
+                combine_words<Op::and_op>(a.words.data(), b.words.data());
+            }
+            else
+            {
+                std::vector<uint64_t> other = to_words(b);
+                combine_words<Op::and_op>(a.words.data(), other.data());
+            }
+            recount(a);
+        }
+
+        /** Remove the values of b from a, two containers with the same key. */
+        static void subtract(Container& a, const Container& b)
+        {
+            if(a.kind == Kind::array)
+            {
+                filter(a, [&b](uint16_t low) { return !holds(b, low); });
+                return;
+            }
+            if(a.kind == Kind::run)
+            {
+                to_bitmap(a);
+            }
+            switch(b.kind)
+            {
+                case Kind::array:
+                    for(uint16_t low : b.values)
+                    {
+                        a.words[low >> 6] &= ~(uint64_t(1) << (low & 63));
+                    }
+                    break;
+                case Kind::bitmap:
+                    combine_words<Op::and_not_op>(a.words.data(), b.words.data());
+                    break;
+                case Kind::run:
+                    for(size_t r = 0; r < b.values.size(); r += 2)
+                    {
+                        clear_bits(a.words.data(), b.values[r], uint32_t(b.values[r]) + b.values[r + 1]);
+                    }
+                    break;
+            }
+            recount(a);
+        }
+
+        /** \return the union of two sorted lists of (start, length - 1) runs */
+        static std::vector<uint16_t> merge_runs(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b)
+        {
+            std::vector<uint16_t> runs;
+            size_t i = 0;
+            size_t j = 0;
+            while(i < a.size() || j < b.size())
+            {
+                // Take whichever run starts first.
+                const uint16_t* next;
+                if(j == b.size() || (i < a.size() && a[i] <= b[j]))
+                {
+                    next = &a[i];
+                    i += 2;
+                }
+                else
+                {
+                    next = &b[j];
+                    j += 2;
+                }
+                uint32_t start = next[0];
+                uint32_t end = start + next[1];
+                // Extend the last run if this one overlaps or touches it.
+                if(!runs.empty())
+                {
+                    uint32_t lastStart = runs[runs.size() - 2];
+                    uint32_t lastEnd = lastStart + runs.back();
+                    if(start <= lastEnd + 1)
+                    {
+                        runs.back() = static_cast<uint16_t>(std::max(lastEnd, end) - lastStart);
+                        continue;
+                    }
+                }
+                runs.push_back(static_cast<uint16_t>(start));
+                runs.push_back(static_cast<uint16_t>(end - start));
+            }
+            return runs;
+        }
+
+        /** \return the intersection of two sorted lists of (start, length - 1) runs */
+        static std::vector<uint16_t> intersect_runs(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b)
+        {
+            std::vector<uint16_t> runs;
+            size_t i = 0;
+            size_t j = 0;
+            while(i < a.size() && j < b.size())
+            {
+                uint32_t aEnd = uint32_t(a[i]) + a[i + 1];
+                uint32_t bEnd = uint32_t(b[j]) + b[j + 1];
+                uint32_t start = std::max<uint32_t>(a[i], b[j]);
+                uint32_t end = std::min(aEnd, bEnd);
+                if(start <= end)
+                {
+                    runs.push_back(static_cast<uint16_t>(start));
+                    runs.push_back(static_cast<uint16_t>(end - start));
+                }
+                // Move past whichever run ends first.
+                if(aEnd < bEnd)
+                {
+                    i += 2;
+                }
+                else
+                {
+                    j += 2;
+                }
+            }
+            return runs;
+        }
+
+        /** \return the number of runs the container's values form */
+        static size_t count_runs(const Container& c)
+        {
+            switch(c.kind)
+            {
+                case Kind::array:
+                {
+                    size_t runs = 0;
+                    for(size_t v = 0; v < c.values.size(); ++v)
+                    {
+                        if(v == 0 || c.values[v] != c.values[v - 1] + 1)
+                        {
+                            ++runs;
+                        }
+                    }
+                    return runs;
+                }
+                case Kind::bitmap:
+                {
+                    // A run starts at every set bit whose lower neighbor is clear.
+                    size_t runs = 0;
+                    uint64_t carry = 0;
+                    for(size_t w = 0; w < bitmapWords; ++w)
+                    {
+                        uint64_t word = c.words[w];
+                        runs += static_cast<size_t>(__builtin_popcountll(word & ~((word << 1) | carry)));
+                        carry = word >> 63;
+                    }
+                    return runs;
+                }
+                case Kind::run:
+                    return c.values.size() / 2;
+            }
+            return 0;
+        }
+
+        /** \return the bytes the container takes in the serialized form */
+        static size_t serialized_bytes(const Container& c)
+        {
+            switch(c.kind)
+            {
+                case Kind::array:
+                    return c.cardinality * 2;
+                case Kind::bitmap:
+                    return bitmapWords * 8;
+                case Kind::run:
+                    return 2 + c.values.size() * 2;
+            }
+            return 0;
+        }
+
+        /** \return the runs of an array or bitmap container's values */
+        static std::vector<uint16_t> runs_of(const Container& c)
+        {
+            std::vector<uint16_t> runs;
+            auto extend = [&runs](uint16_t low)
+            {
+                if(!runs.empty() && uint32_t(runs[runs.size() - 2]) + runs.back() + 1 == low)
+                {
+                    ++runs.back();
+                }
+                else
+                {
+                    runs.push_back(low);
+                    runs.push_back(0);
+                }
+            };
+            if(c.kind == Kind::array)
+            {
+                for(uint16_t low : c.values)
+                {
+                    extend(low);
+                }
+            }
+            else
+            {
+                for_each_in(c, 0, [&extend](uint32_t low) { extend(static_cast<uint16_t>(low)); });
+            }
+            return runs;
+        }
+
+        /** Call the visitor with each value in the container, ORed with high. */
+        template<typename Visitor>
+        static void for_each_in(const Container& c, uint32_t high, Visitor&& visitor)
+        {
+            switch(c.kind)
+            {
+                case Kind::array:
+                    for(uint16_t low : c.values)
+                    {
+                        visitor(high | low);
+                    }
+                    break;
+                case Kind::bitmap:
+                    for(size_t w = 0; w < bitmapWords; ++w)
+                    {
+                        for(uint64_t word = c.words[w]; word != 0; word &= word - 1)
+                        {
+                            visitor(high | static_cast<uint32_t>((w << 6) + static_cast<size_t>(__builtin_ctzll(word))));
+                        }
+                    }
+                    break;
+                case Kind::run:
+                    for(size_t r = 0; r < c.values.size(); r += 2)
+                    {
+                        // Count the lows in a wider type, so a run ending at 0xFFFF ends.
+                        uint32_t end = uint32_t(c.values[r]) + c.values[r + 1];
+                        for(uint32_t low = c.values[r]; low <= end; ++low)
+                        {
+                            visitor(high | low);
+                        }
+                    }
+                    break;
+            }
+        }
+
+        /** \return the index of the container with the key, or where it would go */
+        size_t position(uint16_t key) const
+        {
+            size_t first = 0;
+            size_t last = containers.size();
+            while(first < last)
+            {
+                size_t middle = first + (last - first) / 2;
+                if(containers[middle].key < key)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return first;
+        }
+
+        /** Merge another bitmap's containers into these, chunk by chunk.
+          * keepLeft and keepRight say whether a chunk only one side has is kept. */
+        template<typename Combine>
+        void merge(const RoaringBitmap& other, bool keepLeft, bool keepRight, Combine combine)
+        {
+            std::vector<Container> result;
+            result.reserve(containers.size() + (keepRight ? other.containers.size() : 0));
+            size_t i = 0;
+            size_t j = 0;
+            while(i < containers.size() || j < other.containers.size())
+            {
+                if(j == other.containers.size() ||
+                   (i < containers.size() && containers[i].key < other.containers[j].key))
+                {
+                    if(keepLeft)
+                    {
+                        result.push_back(std::move(containers[i]));
+                    }
+                    ++i;
+                }
+                else if(i == containers.size() || other.containers[j].key < containers[i].key)
+                {
+                    if(keepRight)
+                    {
+                        result.push_back(other.containers[j]);
+                    }
+                    ++j;
+                }
+                else
+                {
+                    combine(containers[i], other.containers[j]);
+                    if(containers[i].cardinality > 0)
+                    {
+                        result.push_back(std::move(containers[i]));
+                    }
+                    ++i;
+                    ++j;
+                }
+            }
+            containers = std::move(result);
+        }
+
+        std::vector<Container> containers;
+
+    public:
+        /** A forward iterator over the values, in increasing order. */
+        class const_iterator
+        {
+            friend class RoaringBitmap;
+
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef uint32_t value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const uint32_t* pointer;
+                typedef uint32_t reference;
+
+                const_iterator()
+                :bitmap(nullptr), container(0), index(0), value(0)
+                {}
+
+                uint32_t operator*() const
+                {
+                    return value;
+                }
+
+                const_iterator& operator++()
+                {
+                    seek((value & 0xFFFF) + 1);
+                    return *this;
+                }
+
+                const_iterator operator++(int)
+                {
+                    const_iterator old = *this;
+                    ++(*this);
+                    return old;
+                }
+
+                bool operator==(const const_iterator& rhs) const
+                {
+                    return container == rhs.container && value == rhs.value;
+                }
+
+                bool operator!=(const const_iterator& rhs) const
+                {
+                    return !(*this == rhs);
+                }
+
+            private:
+                const_iterator(const RoaringBitmap* of, size_t at)
+                :bitmap(of), container(at), index(0), value(0)
+                {
+                    seek(0);
+                }
+
+                /* Move to the first value whose low bits are at least low,
+                 * in this container or a later one. */
+                void seek(uint32_t low)
+                {
+                    while(container < bitmap->containers.size())
+                    {
+                        const Container& c = bitmap->containers[container];
+                        uint32_t high = uint32_t(c.key) << 16;
+                        if(low < 65536)
+                        {
+                            switch(c.kind)
+                            {
+                                case Kind::array:
+                                    // The index only ever moves forward.
+                                    while(index < c.values.size() && c.values[index] < low)
+                                    {
+                                        ++index;
+                                    }
+                                    if(index < c.values.size())
+                                    {
+                                        value = high | c.values[index];
+                                        return;
+                                    }
+                                    break;
+                                case Kind::bitmap:
+                                {
+                                    size_t w = low >> 6;
+                                    uint64_t word = c.words[w] & (~uint64_t(0) << (low & 63));
+                                    while(word == 0 && ++w < bitmapWords)
+                                    {
+                                        word = c.words[w];
+                                    }
+                                    if(word != 0)
+                                    {
+                                        value = high | static_cast<uint32_t>((w << 6) + static_cast<size_t>(__builtin_ctzll(word)));
+                                        return;
+                                    }
+                                    break;
+                                }
+                                case Kind::run:
+                                    while(index < c.values.size() && uint32_t(c.values[index]) + c.values[index + 1] < low)
+                                    {
+                                        index += 2;
+                                    }
+                                    if(index < c.values.size())
+                                    {
+                                        value = high | std::max<uint32_t>(low, c.values[index]);
+                                        return;
+                                    }
+                                    break;
+                            }
+                        }
+                        ++container;
+                        index = 0;
+                        low = 0;
+                    }
+                    value = 0;
+                }
+
+                const RoaringBitmap* bitmap;
+                size_t container;
+                // The position in an array container's values or a run container's runs.
+                size_t index;
+                uint32_t value;
+        };
+
+        typedef const_iterator iterator;
+
+        RoaringBitmap(){}
+
+        /** Copy the values of a serialized bitmap. */
+        explicit RoaringBitmap(const RoaringView& view);
+
+        /** Add a value.
+          * \return true if it was not already there */
+        bool add(uint32_t value)
+        {
+            uint16_t key = static_cast<uint16_t>(value >> 16);
+            uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+            size_t at = position(key);
+            if(at == containers.size() || containers[at].key != key)
+            {
+                Container c(key, Kind::array);
+                c.values.push_back(low);
+                c.cardinality = 1;
+                containers.insert(containers.begin() + static_cast<std::ptrdiff_t>(at), std::move(c));
+                return true;
+            }
+            Container& c = containers[at];
+            if(c.kind == Kind::run)
+            {
+                if(holds(c, low))
+                {
+                    return false;
+                }
+                unrun(c);
+            }
+            if(c.kind == Kind::array)
+            {
+                auto it = std::lower_bound(c.values.begin(), c.values.end(), low);
+                if(it != c.values.end() && *it == low)
+                {
+                    return false;
+                }
+                if(c.cardinality < arrayLimit)
+                {
+                    c.values.insert(it, low);
+                    ++c.cardinality;
+                    return true;
+                }
+                // A full array becomes a bitmap.
+                std::vector<uint64_t> words = to_words(c);
+                words[low >> 6] |= uint64_t(1) << (low & 63);
+                c = from_words(key, std::move(words), c.cardinality + 1);
+                return true;
+            }
+            uint64_t& word = c.words[low >> 6];
+            uint64_t bit = uint64_t(1) << (low & 63);
+            if(word & bit)
+            {
+                return false;
+            }
+            word |= bit;
+            ++c.cardinality;
+            return true;
+        }
+
+        /** Add every value in [first, last), as runs.
+          * \param the first value
+          * \param one past the last value, up to 2^32 */
+        void add_range(uint64_t first, uint64_t last)
+        {
+            if(last > (uint64_t(1) << 32) || first > last)
+            {
+                throw std::out_of_range("RoaringBitmap: range out of bounds");
+            }
+            for(uint64_t start = first; start < last; )
+            {
+                uint16_t key = static_cast<uint16_t>(start >> 16);
+                uint64_t chunkEnd = std::min(last, (uint64_t(key) + 1) << 16);
+                std::vector<uint16_t> run{static_cast<uint16_t>(start & 0xFFFF),
+                                          static_cast<uint16_t>(chunkEnd - start - 1)};
+                Container added = from_runs(key, std::move(run));
+                size_t at = position(key);
+                if(at == containers.size() || containers[at].key != key)
+                {
+                    containers.insert(containers.begin() + static_cast<std::ptrdiff_t>(at), std::move(added));
+                }
+                else
+                {
+                    unite(containers[at], added);
+                }
+                start = chunkEnd;
+            }
+        }
+
+        /** Remove a value.
+          * \return true if it was there */
+        bool remove(uint32_t value)
+        {
+            uint16_t key = static_cast<uint16_t>(value >> 16);
+            uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+            size_t at = position(key);
+            if(at == containers.size() || containers[at].key != key || !holds(containers[at], low))
+            {
+                return false;
+            }
+            Container& c = containers[at];
+            if(c.kind == Kind::run)
+            {
+                unrun(c);
+            }
+            if(c.kind == Kind::array)
+            {
+                c.values.erase(std::lower_bound(c.values.begin(), c.values.end(), low));
+            }
+            else
+            {
+                c.words[low >> 6] &= ~(uint64_t(1) << (low & 63));
+            }
+            --c.cardinality;
+            if(c.cardinality == 0)
+            {
+                containers.erase(containers.begin() + static_cast<std::ptrdiff_t>(at));
+            }
+            else if(c.kind == Kind::bitmap && c.cardinality <= arrayLimit)
+            {
+                // A bitmap which has shrunk becomes an array.
+                c = from_words(key, std::move(c.words), c.cardinality);
+            }
+            return true;
+        }
+
+        /** \return true if the value is in the bitmap */
+        bool contains(uint32_t value) const
+        {
+            uint16_t key = static_cast<uint16_t>(value >> 16);
+            size_t at = position(key);
+            return at < containers.size() && containers[at].key == key &&
+                   holds(containers[at], static_cast<uint16_t>(value & 0xFFFF));
+        }
+
+        /** \return the number of values */
+        uint64_t cardinality() const
+        {
+            uint64_t total = 0;
+            for(const Container& c : containers)
+            {
+                total += c.cardinality;
+            }
+            return total;
+        }
+
+        /** \return true if there are no values */
+        bool empty() const
+        {
+            return containers.empty();
+        }
+
+        /** Remove every value. */
+        void clear()
+        {
+            containers.clear();
+        }
+
+        /** Convert each chunk to runs if that would be smaller, or from runs
+          * if that would not.
+          * \return true if any chunk changed */
+        bool run_optimize()
+        {
+            bool changed = false;
+            for(Container& c : containers)
+            {
+                size_t runBytes = 2 + count_runs(c) * 4;
+                size_t otherBytes = (c.cardinality > arrayLimit) ? bitmapWords * 8 : c.cardinality * 2;
+                if(c.kind != Kind::run && runBytes < otherBytes)
+                {
+                    c = from_runs(c.key, runs_of(c));
+                    changed = true;
+                }
+                else if(c.kind == Kind::run && runBytes >= otherBytes)
+                {
+                    unrun(c);
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        /** Add every value of another bitmap. */
+        RoaringBitmap& operator|=(const RoaringBitmap& other)
+        {
+            merge(other, true, true, unite);
+            return *this;
+        }
+
+        /** Keep only the values also in another bitmap. */
+        RoaringBitmap& operator&=(const RoaringBitmap& other)
+        {
+            merge(other, false, false, intersect);
+            return *this;
+        }
+
+        /** Remove every value of another bitmap. */
+        RoaringBitmap& operator-=(const RoaringBitmap& other)
+        {
+            merge(other, true, false, subtract);
+            return *this;
+        }
+
+        /** \return true if both hold exactly the same values, however they are stored */
+        bool operator==(const RoaringBitmap& other) const
+        {
+            if(containers.size() != other.containers.size())
+            {
+                return false;
+            }
+            for(size_t i = 0; i < containers.size(); ++i)
+            {
+                const Container& a = containers[i];
+                const Container& b = other.containers[i];
+                if(a.key != b.key || a.cardinality != b.cardinality)
+                {
+                    return false;
+                }
+                bool same = (a.kind == b.kind && a.kind != Kind::bitmap) ? (a.values == b.values)
+                                                                         : (to_words(a) == to_words(b));
+                if(!same)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const RoaringBitmap& other) const
+        {
+            return !(*this == other);
+        }
+
+        /** Call the visitor with each value, in increasing order.
+          * \param the visitor, which takes a uint32_t */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            for(const Container& c : containers)
+            {
+                for_each_in(c, uint32_t(c.key) << 16, visitor);
+            }
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, containers.size());
+        }
+
+        /** \return the number of bytes serialize() writes */
+        size_t serialized_size() const
+        {
+            bool runs = has_runs();
+            size_t n = containers.size();
+            size_t bytes = runs ? 4 + (n + 7) / 8 : 8;
+            bytes += n * 4;
+            if(!runs || n >= 4)
+            {
+                bytes += n * 4;
+            }
+            for(const Container& c : containers)
+            {
+                bytes += serialized_bytes(c);
+            }
+            return bytes;
+        }
+
+        /** Write the bitmap in the standard Roaring format, which is
+          * little-endian and may be read on any platform.
+          * \param where to write, which must have room for serialized_size() bytes
+          * \return the number of bytes written */
+        size_t serialize(unsigned char* out) const
+        {
+            bool runs = has_runs();
+            size_t n = containers.size();
+            unsigned char* p = out;
+            if(runs)
+            {
+                put32(p, cookieRuns | static_cast<uint32_t>((n - 1) << 16));
+                p += 4;
+                std::memset(p, 0, (n + 7) / 8);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    if(containers[i].kind == Kind::run)
+                    {
+                        p[i / 8] = static_cast<unsigned char>(p[i / 8] | (1 << (i % 8)));
+                    }
+                }
+                p += (n + 7) / 8;
+            }
+            else
+            {
+                put32(p, cookieNoRuns);
+                put32(p + 4, static_cast<uint32_t>(n));
+                p += 8;
+            }
+            for(const Container& c : containers)
+            {
+                put16(p, c.key);
+                put16(p + 2, static_cast<uint16_t>(c.cardinality - 1));
+                p += 4;
+            }
+            if(!runs || n >= 4)
+            {
+                size_t offset = static_cast<size_t>(p - out) + n * 4;
+                for(const Container& c : containers)
+                {
+                    put32(p, static_cast<uint32_t>(offset));
+                    p += 4;
+                    offset += serialized_bytes(c);
+                }
+            }
+            for(const Container& c : containers)
+            {
+                switch(c.kind)
+                {
+                    case Kind::array:
+                        for(uint16_t low : c.values)
+                        {
+                            put16(p, low);
+                            p += 2;
+                        }
+                        break;
+                    case Kind::bitmap:
+                        for(uint64_t word : c.words)
+                        {
+                            put32(p, static_cast<uint32_t>(word));
+                            put32(p + 4, static_cast<uint32_t>(word >> 32));
+                            p += 8;
+                        }
+                        break;
+                    case Kind::run:
+                        put16(p, static_cast<uint16_t>(c.values.size() / 2));
+                        p += 2;
+                        for(uint16_t half : c.values)
+                        {
+                            put16(p, half);
+                            p += 2;
+                        }
+                        break;
+                }
+            }
+            return static_cast<size_t>(p - out);
+        }
+
+    private:
+        bool has_runs() const
+        {
+            for(const Container& c : containers)
+            {
+                if(c.kind == Kind::run)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void put16(unsigned char* p, uint16_t value)
+        {
+            p[0] = static_cast<unsigned char>(value);
+            p[1] = static_cast<unsigned char>(value >> 8);
+        }
+
+        static void put32(unsigned char* p, uint32_t value)
+        {
+            put16(p, static_cast<uint16_t>(value));
+            put16(p + 2, static_cast<uint16_t>(value >> 16));
+        }
+};
+
+/** A read-only view of a bitmap in the serialized Roaring format, which is
+  * queried in place, without copying or decoding the containers. The buffer
+  * must outlive the view.
+  *
+  * The headers are checked once, when the view is made, so that no query can
+  * read past the end of the buffer. */
+class RoaringView
+{
+    public:
+        /** \throws std::invalid_argument if the buffer is not a valid serialized bitmap */
+        RoaringView(const unsigned char* data, size_t length)
+        :data(data), length(length), n(0), runFlags(nullptr), header(nullptr), offsets(nullptr)
+        {
+            need(0, 4);
+            uint32_t cookie = get32(data);
+            size_t p;
+            if((cookie & 0xFFFF) == RoaringBitmap::cookieRuns)
+            {
+                n = (cookie >> 16) + 1;
+                runFlags = data + 4;
+                p = 4 + (n + 7) / 8;
+            }
+            else if(cookie == RoaringBitmap::cookieNoRuns)
+            {
+                need(4, 4);
+                n = get32(data + 4);
+                if(n > 65536)
+                {
+                    throw std::invalid_argument("RoaringView: too many containers");
+                }
+                p = 8;
+            }
+            else
+            {
+                throw std::invalid_argument("RoaringView: not a Roaring bitmap");
+            }
+            need(p, n * 4);
+            header = data + p;
+            p += n * 4;
+            if(runFlags == nullptr || n >= 4)
+            {
+                need(p, n * 4);
+                offsets = data + p;
+                p += n * 4;
+            }
+
+            // Check that every container fits, and find their offsets when
+            // the format leaves them out (only ever for fewer than four).
+            size_t offset = p;
+            for(size_t i = 0; i < n; ++i)
+            {
+                if(i > 0 && key(i) <= key(i - 1))
+                {
+                    throw std::invalid_argument("RoaringView: keys out of order");
+                }
+                if(offsets != nullptr)
+                {
+                    offset = get32(offsets + i * 4);
+                }
+                else
+                {
+                    smallOffsets[i] = static_cast<uint32_t>(offset);
+                }
+                size_t bytes;
+                if(is_run(i))
+                {
+                    need(offset, 2);
+                    bytes = 2 + size_t(get16(data + offset)) * 4;
+                }
+                else
+                {
+                    bytes = (cardinality(i) > RoaringBitmap::arrayLimit) ? RoaringBitmap::bitmapWords * 8
+                                                                         : cardinality(i) * 2;
+                }
+                need(offset, bytes);
+                if(is_run(i))
+                {
+                    // A run past 0xFFFF would reach into the next key's values.
+                    for(size_t r = 0; r < get16(data + offset); ++r)
+                    {
+                        const unsigned char* run = data + offset + 2 + r * 4;
+                        if(uint32_t(get16(run)) + get16(run + 2) > 0xFFFF)
+                        {
+                            throw std::invalid_argument("RoaringView: run out of range");
+                        }
+                    }
+                }
+                offset += bytes;
+            }
+        }
+
+        /** \return true if the value is in the bitmap */
+        bool contains(uint32_t value) const
+        {
+            uint16_t wanted = static_cast<uint16_t>(value >> 16);
+            uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+            size_t first = 0;
+            size_t last = n;
+            while(first < last)
+            {
+                size_t middle = first + (last - first) / 2;
+                if(key(middle) < wanted)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            if(first == n || key(first) != wanted)
+            {
+                return false;
+            }
+            const unsigned char* c = container(first);
+            if(is_run(first))
+            {
+                // Find the last run starting at or before low.
+                size_t runs = get16(c);
+                size_t lo = 0;
+                size_t hi = runs;
+                while(lo < hi)
+                {
+                    size_t middle = lo + (hi - lo) / 2;
+                    if(get16(c + 2 + middle * 4) <= low)
+                    {
+                        lo = middle + 1;
+                    }
+                    else
+                    {
+                        hi = middle;
+                    }
+                }
+                return lo > 0 && low - get16(c + 2 + (lo - 1) * 4) <= get16(c + 4 + (lo - 1) * 4);
+            }
+            if(cardinality(first) > RoaringBitmap::arrayLimit)
+            {
+                // Little-endian words put bit i in byte i / 8.
+                return (c[low >> 3] >> (low & 7)) & 1;
+            }
+            size_t lo = 0;
+            size_t hi = cardinality(first);
+            while(lo < hi)
+            {
+                size_t middle = lo + (hi - lo) / 2;
+                uint16_t v = get16(c + middle * 2);
+                if(v == low)
+                {
+                    return true;
+                }
+                if(v < low)
+                {
+                    lo = middle + 1;
+                }
+                else
+                {
+                    hi = middle;
+                }
+            }
+            return false;
+        }
+
+        /** \return the number of values */
+        uint64_t cardinality() const
+        {
+            uint64_t total = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                total += cardinality(i);
+            }
+            return total;
+        }
+
+        /** \return true if there are no values */
+        bool empty() const
+        {
+            return n == 0;
+        }
+
+        /** Call the visitor with each value, in increasing order.
+          * \param the visitor, which takes a uint32_t */
+        template<typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                uint32_t high = uint32_t(key(i)) << 16;
+                const unsigned char* c = container(i);
+                if(is_run(i))
+                {
+                    size_t runs = get16(c);
+                    for(size_t r = 0; r < runs; ++r)
+                    {
+                        uint32_t start = get16(c + 2 + r * 4);
+                        uint32_t end = start + get16(c + 4 + r * 4);
+                        for(uint32_t low = start; low <= end; ++low)
+                        {
+                            visitor(high | low);
+                        }
+                    }
+                }
+                else if(cardinality(i) > RoaringBitmap::arrayLimit)
+                {
+                    for(size_t w = 0; w < RoaringBitmap::bitmapWords; ++w)
+                    {
+                        uint64_t word = uint64_t(get32(c + w * 8)) | (uint64_t(get32(c + w * 8 + 4)) << 32);
+                        for(; word != 0; word &= word - 1)
+                        {
+                            visitor(high | static_cast<uint32_t>((w << 6) + static_cast<size_t>(__builtin_ctzll(word))));
+                        }
+                    }
+                }
+                else
+                {
+                    for(size_t v = 0; v < cardinality(i); ++v)
+                    {
+                        visitor(high | get16(c + v * 2));
+                    }
+                }
+            }
+        }
+
+    private:
+        friend class RoaringBitmap;
+
+        static uint16_t get16(const unsigned char* p)
+        {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        static uint32_t get32(const unsigned char* p)
+        {
+            return uint32_t(get16(p)) | (uint32_t(get16(p + 2)) << 16);
+        }
+
+        /** Throw unless the buffer holds the given bytes. */
+        void need(size_t offset, size_t bytes) const
+        {
+            if(offset > length || bytes > length - offset)
+            {
+                throw std::invalid_argument("RoaringView: truncated bitmap");
+            }
+        }
+
+        uint16_t key(size_t i) const
+        {
+            return get16(header + i * 4);
+        }
+
+        uint32_t cardinality(size_t i) const
+        {
+            return uint32_t(get16(header + i * 4 + 2)) + 1;
+        }
+
+        bool is_run(size_t i) const
+        {
+            return runFlags != nullptr && ((runFlags[i / 8] >> (i % 8)) & 1);
+        }
+
+        const unsigned char* container(size_t i) const
+        {
+            return data + ((offsets != nullptr) ? get32(offsets + i * 4) : smallOffsets[i]);
+        }
+
+        const unsigned char* data;
+        size_t length;
+        size_t n;
+        const unsigned char* runFlags;
+        const unsigned char* header;
+        const unsigned char* offsets;
+        // The offsets of the containers, when the format leaves them out.
+        uint32_t smallOffsets[3];
+};
+
+inline RoaringBitmap::RoaringBitmap(const RoaringView& view)
+{
+    containers.reserve(view.n);
+    for(size_t i = 0; i < view.n; ++i)
+    {
+        const unsigned char* c = view.container(i);
+        uint16_t key = view.key(i);
+        uint32_t cardinality = view.cardinality(i);
+        if(view.is_run(i))
+        {
+            std::vector<uint16_t> runs(size_t(RoaringView::get16(c)) * 2);
+            for(size_t h = 0; h < runs.size(); ++h)
+            {
+                runs[h] = RoaringView::get16(c + 2 + h * 2);
+            }
+            containers.push_back(from_runs(key, std::move(runs)));
+        }
+        else if(cardinality > arrayLimit)
+        {
+            Container bitmap(key, Kind::bitmap);
+            bitmap.cardinality = cardinality;
+            bitmap.words.resize(bitmapWords);
+            for(size_t w = 0; w < bitmapWords; ++w)
+            {
+                bitmap.words[w] = uint64_t(RoaringView::get32(c + w * 8)) |
+                                  (uint64_t(RoaringView::get32(c + w * 8 + 4)) << 32);
+            }
+            containers.push_back(std::move(bitmap));
+        }
+        else
+        {
+            Container array(key, Kind::array);
+            array.cardinality = cardinality;
+            array.values.resize(cardinality);
+            for(size_t v = 0; v < cardinality; ++v)
+            {
+                array.values[v] = RoaringView::get16(c + v * 2);
+            }
+            containers.push_back(std::move(array));
+        }
+    }
+}
+
+/** \return the values in either */
+inline RoaringBitmap operator|(RoaringBitmap lhs, const RoaringBitmap& rhs)
+{
+    lhs |= rhs;
+    return lhs;
+}
+
+/** \return the values in both */
+inline RoaringBitmap operator&(RoaringBitmap lhs, const RoaringBitmap& rhs)
+{
+    lhs &= rhs;
+    return lhs;
+}
+
+/** \return the values in lhs but not rhs */
+inline RoaringBitmap operator-(RoaringBitmap lhs, const RoaringBitmap& rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+#endif // PAWLIB_ROARINGBITMAP_HPP
@@ -0,0 +1,812 @@
+/** Tests for RoaringBitmap [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ROARINGBITMAP_TESTS_HPP
+#define PAWLIB_ROARINGBITMAP_TESTS_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/roaring_bitmap.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Check that a RoaringBitmap holds exactly the values of a std::set,
+  * whether iterated, visited, counted, or looked up.
+  * \param the bitmap
+  * \param the model
+  * \return true if they match */
+inline bool roaring_matches(const RoaringBitmap& bitmap, const std::set<uint32_t>& model)
+{
+    if(bitmap.cardinality() != model.size() || bitmap.empty() != model.empty())
+    {
+        return false;
+    }
+    if(!std::equal(bitmap.begin(), bitmap.end(), model.begin(), model.end()))
+    {
+        return false;
+    }
+    std::vector<uint32_t> visited;
+    bitmap.for_each([&visited](uint32_t value) { visited.push_back(value); });
+    if(!std::equal(visited.begin(), visited.end(), model.begin(), model.end()))
+    {
+        return false;
+    }
+    for(uint32_t value : model)
+    {
+        // Check the neighbors too, which are often missing.
+        if(!bitmap.contains(value) ||
+           bitmap.contains(value + 1) != (model.count(value + 1) > 0) ||
+           bitmap.contains(value - 1) != (model.count(value - 1) > 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Check that a serialized bitmap reads back exactly, both in place and
+  * when copied out.
+  * \param the bitmap
+  * \param the model
+  * \return true if they match */
+inline bool roaring_round_trips(const RoaringBitmap& bitmap, const std::set<uint32_t>& model)
+{
+    std::vector<unsigned char> buffer(bitmap.serialized_size());
+    if(bitmap.serialize(buffer.data()) != buffer.size())
+    {
+        return false;
+    }
+    RoaringView view(buffer.data(), buffer.size());
+    if(view.cardinality() != model.size() || view.empty() != model.empty())
+    {
+        return false;
+    }
+    std::vector<uint32_t> visited;
+    view.for_each([&visited](uint32_t value) { visited.push_back(value); });
+    if(!std::equal(visited.begin(), visited.end(), model.begin(), model.end()))
+    {
+        return false;
+    }
+    for(uint32_t value : model)
+    {
+        if(!view.contains(value) || view.contains(value + 1) != (model.count(value + 1) > 0))
+        {
+            return false;
+        }
+    }
+    RoaringBitmap copy(view);
+    return copy == bitmap && roaring_matches(copy, model);
+}
+
+// P-tB8201
+class TestRoaringBitmap_AddRemove : public Test
+{
+    public:
+        TestRoaringBitmap_AddRemove(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Add, Remove & Contains";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Add and remove " + stdutils::itos(changes) + " random values, sparse in some chunks "
+                   "and dense in others, and ensure the bitmap matches a std::set.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(8201);
+            RoaringBitmap bitmap;
+            std::set<uint32_t> model;
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+            PL_ASSERT_FALSE(bitmap.remove(7));
+
+            // Fill one chunk past the array limit, so it becomes a bitmap.
+            for(uint32_t i = 0; i < 6000; ++i)
+            {
+                uint32_t value = (3u << 16) | (i * 7 % 65536);
+                PL_ASSERT_EQUAL(bitmap.add(value), model.insert(value).second);
+            }
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+
+            for(int i = 0; i < changes; ++i)
+            {
+                // Mostly chunk 3, plus a few sparse chunks and the extremes.
+                uint32_t value;
+                switch(i % 4)
+                {
+                    case 0:
+                    case 1:
+                        value = (3u << 16) | (rng() % 65536);
+                        break;
+                    case 2:
+                        value = static_cast<uint32_t>(rng() % 64) << 20 | (rng() % 1024);
+                        break;
+                    default:
+                        value = (i & 4) ? 0xFFFFFFFFu - (rng() % 16) : (rng() % 16);
+                        break;
+                }
+                if(rng() % 3 == 0)
+                {
+                    PL_ASSERT_EQUAL(bitmap.remove(value), model.erase(value) > 0);
+                }
+                else
+                {
+                    PL_ASSERT_EQUAL(bitmap.add(value), model.insert(value).second);
+                }
+            }
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+
+            // Empty chunk 3 again, so it shrinks back through an array.
+            for(uint32_t low = 0; low < 65536; ++low)
+            {
+                uint32_t value = (3u << 16) | low;
+                PL_ASSERT_EQUAL(bitmap.remove(value), model.erase(value) > 0);
+                if(low == 60000)
+                {
+                    PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+                }
+            }
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+
+            bitmap.clear();
+            PL_ASSERT_TRUE(bitmap.empty());
+            PL_ASSERT_TRUE(bitmap.begin() == bitmap.end());
+            return true;
+        }
+
+        ~TestRoaringBitmap_AddRemove(){}
+
+    private:
+        static const int changes = 100000;
+};
+
+/** Fill a bitmap and a model with one of several shapes of data, so that
+  * the set operations meet every kind of container.
+  * \param which shape
+  * \param the bitmap
+  * \param the model */
+inline void roaring_fill(int shape, RoaringBitmap& bitmap, std::set<uint32_t>& model)
+{
+    std::mt19937 rng(static_cast<uint32_t>(8202 + shape));
+    auto add = [&bitmap, &model](uint32_t value)
+    {
+        bitmap.add(value);
+        model.insert(value);
+    };
+    auto add_range = [&bitmap, &model](uint32_t first, uint32_t last)
+    {
+        bitmap.add_range(first, last);
+        for(uint32_t value = first; value < last; ++value)
+        {
+            model.insert(value);
+        }
+    };
+    switch(shape)
+    {
+        // Sparse, in arrays.
+        case 0:
+            for(int i = 0; i < 3000; ++i)
+            {
+                add(static_cast<uint32_t>(rng() % (1 << 19)));
+            }
+            break;
+        // Dense, in bitmaps.
+        case 1:
+            for(int i = 0; i < 100000; ++i)
+            {
+                add(static_cast<uint32_t>(rng() % (1 << 18)));
+            }
+            break;
+        // Runs.
+        case 2:
+            for(uint32_t start = 1000; start < (1 << 19); start += 30000)
+            {
+                add_range(start, start + 9000);
+            }
+            break;
+        // All of the above, and a full chunk.
+        default:
+            for(int i = 0; i < 2000; ++i)
+            {
+                add(static_cast<uint32_t>(rng() % (1 << 19)));
+            }
+            for(int i = 0; i < 40000; ++i)
+            {
+                add((2u << 16) | static_cast<uint32_t>(rng() % 65536));
+            }
+            add_range(5u << 16, 6u << 16);
+            add_range(70000, 140000);
+            break;
+    }
+}
+
+// P-tB8202
+class TestRoaringBitmap_SetOperations : public Test
+{
+    public:
+        TestRoaringBitmap_SetOperations(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Union, Intersection & Difference";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Combine sparse, dense, run, and mixed bitmaps in every pairing, and "
+                   "ensure the results match the std::set algorithms.";
+        }
+
+        bool run() override
+        {
+            for(int left = 0; left < shapes; ++left)
+            {
+                for(int right = 0; right < shapes; ++right)
+                {
+                    RoaringBitmap a;
+                    RoaringBitmap b;
+                    std::set<uint32_t> modelA;
+                    std::set<uint32_t> modelB;
+                    roaring_fill(left, a, modelA);
+                    roaring_fill(right, b, modelB);
+                    if(left == right)
+                    {
+                        // Make the sides differ, but still overlap.
+                        b.run_optimize();
+                        b.add_range(200000, 300000);
+                        for(uint32_t value = 200000; value < 300000; ++value)
+                        {
+                            modelB.insert(value);
+                        }
+                    }
+
+                    std::set<uint32_t> expected;
+                    std::set_union(modelA.begin(), modelA.end(), modelB.begin(), modelB.end(),
+                                   std::inserter(expected, expected.end()));
+                    PL_ASSERT_TRUE(roaring_matches(a | b, expected));
+
+                    expected.clear();
+                    std::set_intersection(modelA.begin(), modelA.end(), modelB.begin(), modelB.end(),
+                                          std::inserter(expected, expected.end()));
+                    PL_ASSERT_TRUE(roaring_matches(a & b, expected));
+
+                    expected.clear();
+                    std::set_difference(modelA.begin(), modelA.end(), modelB.begin(), modelB.end(),
+                                        std::inserter(expected, expected.end()));
+                    PL_ASSERT_TRUE(roaring_matches(a - b, expected));
+                }
+            }
+
+            // Combining with itself or an empty bitmap.
+            RoaringBitmap a;
+            std::set<uint32_t> model;
+            roaring_fill(3, a, model);
+            RoaringBitmap none;
+            PL_ASSERT_TRUE(roaring_matches(a | a, model));
+            PL_ASSERT_TRUE(roaring_matches(a & a, model));
+            PL_ASSERT_TRUE((a - a).empty());
+            PL_ASSERT_TRUE(roaring_matches(a | none, model));
+            PL_ASSERT_TRUE((a & none).empty());
+            PL_ASSERT_TRUE(roaring_matches(a - none, model));
+            return true;
+        }
+
+        ~TestRoaringBitmap_SetOperations(){}
+
+    private:
+        static const int shapes = 4;
+};
+
+// P-tB8203
+class TestRoaringBitmap_Runs : public Test
+{
+    public:
+        TestRoaringBitmap_Runs(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Ranges & Run Optimization";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Add ranges across chunk boundaries, convert chunks to and from runs, "
+                   "and change runs one value at a time.";
+        }
+
+        bool run() override
+        {
+            RoaringBitmap bitmap;
+            std::set<uint32_t> model;
+            bitmap.add_range(65000, 200000);
+            bitmap.add_range(199990, 200010);
+            bitmap.add_range(300, 300);
+            for(uint32_t value = 65000; value < 200010; ++value)
+            {
+                model.insert(value);
+            }
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+            PL_ASSERT_FALSE(bitmap.run_optimize());
+
+            // Change the runs one value at a time.
+            PL_ASSERT_TRUE(bitmap.remove(100000));
+            model.erase(100000);
+            PL_ASSERT_FALSE(bitmap.add(100001));
+            PL_ASSERT_TRUE(bitmap.add(64999));
+            model.insert(64999);
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+
+            // Unrunning them made them larger, so optimizing shrinks them.
+            size_t before = bitmap.serialized_size();
+            RoaringBitmap copy = bitmap;
+            PL_ASSERT_TRUE(bitmap.run_optimize());
+            PL_ASSERT_LESS(bitmap.serialized_size(), before);
+            PL_ASSERT_TRUE(bitmap == copy);
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+
+            // Scattered values are smaller left alone.
+            RoaringBitmap scattered;
+            for(uint32_t value = 0; value < 100000; value += 3)
+            {
+                scattered.add(value);
+            }
+            PL_ASSERT_FALSE(scattered.run_optimize());
+
+            // A range over the whole domain.
+            RoaringBitmap everything;
+            everything.add_range(0, uint64_t(1) << 32);
+            PL_ASSERT_EQUAL(everything.cardinality(), uint64_t(1) << 32);
+            PL_ASSERT_TRUE(everything.contains(0xFFFFFFFFu));
+            PL_ASSERT_TRUE((everything & bitmap) == bitmap);
+
+            try
+            {
+                bitmap.add_range(5, (uint64_t(1) << 32) + 1);
+                return false;
+            }
+            catch(std::out_of_range&) {}
+            return true;
+        }
+
+        ~TestRoaringBitmap_Runs(){}
+};
+
+// P-tB8204
+class TestRoaringBitmap_Serialize : public Test
+{
+    public:
+        TestRoaringBitmap_Serialize(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Serialize & View";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Serialize bitmaps with and without runs, query them in place, copy them "
+                   "back, and reject damaged buffers.";
+        }
+
+        bool run() override
+        {
+            RoaringBitmap empty;
+            PL_ASSERT_TRUE(roaring_round_trips(empty, std::set<uint32_t>()));
+
+            for(int shape = 0; shape < 4; ++shape)
+            {
+                RoaringBitmap bitmap;
+                std::set<uint32_t> model;
+                roaring_fill(shape, bitmap, model);
+                PL_ASSERT_TRUE(roaring_round_trips(bitmap, model));
+                bitmap.run_optimize();
+                PL_ASSERT_TRUE(roaring_round_trips(bitmap, model));
+            }
+
+            // Runs in fewer than four chunks leave out the offsets.
+            RoaringBitmap few;
+            std::set<uint32_t> model;
+            few.add_range(10, 20);
+            few.add(1u << 20);
+            for(uint32_t value = 10; value < 20; ++value)
+            {
+                model.insert(value);
+            }
+            model.insert(1u << 20);
+            PL_ASSERT_TRUE(roaring_round_trips(few, model));
+
+            // The format is fixed: the cookie comes first, little-endian.
+            std::vector<unsigned char> buffer(few.serialized_size());
+            few.serialize(buffer.data());
+            PL_ASSERT_EQUAL(buffer[0] | (buffer[1] << 8), 12347);
+
+            // Truncating the buffer anywhere is caught.
+            for(size_t length = 0; length < buffer.size(); ++length)
+            {
+                try
+                {
+                    RoaringView view(buffer.data(), length);
+                    return false;
+                }
+                catch(std::invalid_argument&) {}
+            }
+            buffer[0] = 0;
+            try
+            {
+                RoaringView view(buffer.data(), buffer.size());
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+            return true;
+        }
+
+        ~TestRoaringBitmap_Serialize(){}
+};
+
+// P-tB8208
+class TestRoaringBitmap_RunsAtEnd : public Test
+{
+    public:
+        TestRoaringBitmap_RunsAtEnd(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Runs Ending at UINT32_MAX";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Visit a run ending at the last value, in the bitmap and in a view, "
+                   "and reject a serialized run which passes the end of its chunk.";
+        }
+
+        bool run() override
+        {
+            RoaringBitmap bitmap;
+            bitmap.add_range(0xFFFFFF00u, uint64_t(1) << 32);
+            bitmap.run_optimize();
+
+            uint64_t count = 0;
+            uint32_t last = 0;
+            bitmap.for_each([&](uint32_t value){ ++count; last = value; });
+            PL_ASSERT_EQUAL(count, uint64_t(256));
+            PL_ASSERT_EQUAL(last, 0xFFFFFFFFu);
+
+            std::vector<unsigned char> buffer(bitmap.serialized_size());
+            bitmap.serialize(buffer.data());
+            RoaringView view(buffer.data(), buffer.size());
+            count = 0;
+            view.for_each([&](uint32_t value){ ++count; last = value; });
+            PL_ASSERT_EQUAL(count, uint64_t(256));
+            PL_ASSERT_EQUAL(last, 0xFFFFFFFFu);
+
+            // One run chunk: cookie, run flags, header, run count, then the
+            // run's start and length. Stretch the length past 0xFFFF.
+            RoaringBitmap small;
+            small.add_range(10, 20);
+            small.run_optimize();
+            buffer.assign(small.serialized_size(), 0);
+            small.serialize(buffer.data());
+            PL_ASSERT_EQUAL(buffer.size(), size_t(15));
+            buffer[13] = 0xFF;
+            buffer[14] = 0xFF;
+            try
+            {
+                RoaringView bad(buffer.data(), buffer.size());
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+            return true;
+        }
+
+        ~TestRoaringBitmap_RunsAtEnd(){}
+};
+
+// P-tB8209
+class TestRoaringBitmap_MixedUnion : public Test
+{
+    public:
+        TestRoaringBitmap_MixedUnion(){}
+
+        testdoc_t get_title() override
+        {
+            return "RoaringBitmap: Mixed Kind Union";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Unite small containers of different kinds, with |= and with "
+                   "add_range() onto an array, and read the result back from a view.";
+        }
+
+        bool run() override
+        {
+            RoaringBitmap bitmap;
+            std::set<uint32_t> model;
+            bitmap.add(5);
+            bitmap.add_range(10, 20);
+            model.insert(5);
+            for(uint32_t value = 10; value < 20; ++value)
+            {
+                model.insert(value);
+            }
+            PL_ASSERT_TRUE(roaring_matches(bitmap, model));
+            PL_ASSERT_LESS(bitmap.serialized_size(), size_t(8192));
+
+            std::vector<unsigned char> buffer(bitmap.serialized_size());
+            bitmap.serialize(buffer.data());
+            RoaringView view(buffer.data(), buffer.size());
+            PL_ASSERT_TRUE(view.contains(5));
+            PL_ASSERT_TRUE(view.contains(12));
+            PL_ASSERT_FALSE(view.contains(7));
+            PL_ASSERT_TRUE(roaring_round_trips(bitmap, model));
+
+            // An array united with a run, each in a separate bitmap.
+            RoaringBitmap runs;
+            runs.add_range(1000, 1100);
+            runs.run_optimize();
+            RoaringBitmap values;
+            values.add(3);
+            values.add(2000);
+            values |= runs;
+            std::set<uint32_t> united = {3, 2000};
+            for(uint32_t value = 1000; value < 1100; ++value)
+            {
+                united.insert(value);
+            }
+            PL_ASSERT_TRUE(roaring_matches(values, united));
+            PL_ASSERT_LESS(values.serialized_size(), size_t(8192));
+            PL_ASSERT_TRUE(roaring_round_trips(values, united));
+            return true;
+        }
+
+        ~TestRoaringBitmap_MixedUnion(){}
+};
+
+/** A sorted std::vector of values, with the operations the RoaringBitmap
+  * benchmarks use. Values must be added in increasing order. */
+class RoaringBenchVector : public std::vector<uint32_t>
+{
+    public:
+        void add(uint32_t value)
+        {
+            push_back(value);
+        }
+
+        bool contains(uint32_t value) const
+        {
+            return std::binary_search(begin(), end(), value);
+        }
+
+        RoaringBenchVector& operator&=(const RoaringBenchVector& other)
+        {
+            RoaringBenchVector result;
+            result.reserve(std::min(size(), other.size()));
+            std::set_intersection(begin(), end(), other.begin(), other.end(), std::back_inserter(result));
+            swap(result);
+            return *this;
+        }
+
+        uint64_t cardinality() const
+        {
+            return size();
+        }
+};
+
+// P-tB8205, P-tB8205*
+template<typename bits_t>
+class TestRoaringBitmap_IntersectSparse : public Test
+{
+    public:
+        explicit TestRoaringBitmap_IntersectSparse(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Intersect Sparse";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Intersect two " + name + "s of " + stdutils::itos(count) +
+                   " values spread over a range of a hundred million.";
+        }
+
+        bool pre() override
+        {
+            if(a.cardinality() == 0)
+            {
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    a.add(i * 997);
+                    b.add(i * 997 + (i % 2));
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            bits_t result = a;
+            result &= b;
+            return result.cardinality() == count / 2;
+        }
+
+        ~TestRoaringBitmap_IntersectSparse(){}
+
+    private:
+        static const uint32_t count = 100000;
+        testdoc_t name;
+        bits_t a;
+        bits_t b;
+};
+
+// P-tB8206, P-tB8206*
+template<typename bits_t>
+class TestRoaringBitmap_IntersectDense : public Test
+{
+    public:
+        explicit TestRoaringBitmap_IntersectDense(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Intersect Dense";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Intersect two " + name + "s holding every second and every third value below " +
+                   stdutils::itos(count) + ".";
+        }
+
+        bool pre() override
+        {
+            if(a.cardinality() == 0)
+            {
+                for(uint32_t i = 0; i < count; i += 2)
+                {
+                    a.add(i);
+                }
+                for(uint32_t i = 0; i < count; i += 3)
+                {
+                    b.add(i);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            bits_t result = a;
+            result &= b;
+            return result.cardinality() == (count + 5) / 6;
+        }
+
+        ~TestRoaringBitmap_IntersectDense(){}
+
+    private:
+        static const uint32_t count = 1 << 22;
+        testdoc_t name;
+        bits_t a;
+        bits_t b;
+};
+
+// P-tB8207, P-tB8207*
+template<typename bits_t>
+class TestRoaringBitmap_Contains : public Test
+{
+    public:
+        explicit TestRoaringBitmap_Contains(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Contains";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up " + stdutils::itos(lookups) + " values in a " + name + " of " +
+                   stdutils::itos(count) + " values.";
+        }
+
+        bool pre() override
+        {
+            if(bits.cardinality() == 0)
+            {
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    bits.add(i * 31);
+                }
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            uint32_t found = 0;
+            for(uint32_t i = 0; i < lookups; ++i)
+            {
+                found += bits.contains(i * 7919 % (count * 31)) ? 1 : 0;
+            }
+            return found > 0;
+        }
+
+        ~TestRoaringBitmap_Contains(){}
+
+    private:
+        static const uint32_t count = 1000000;
+        static const uint32_t lookups = 100000;
+        testdoc_t name;
+        bits_t bits;
+};
+
+class TestSuite_RoaringBitmap : public TestSuite
+{
+    public:
+        explicit TestSuite_RoaringBitmap(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: RoaringBitmap Tests";
+        }
+
+        ~TestSuite_RoaringBitmap(){}
+};
+
+#endif // PAWLIB_ROARINGBITMAP_TESTS_HPP
@@ -0,0 +1,195 @@
+/** Small Object Allocator [PawLIB]
+  * Version: 0.1
+  *
+  * A general-purpose allocator for small objects, which serves each
+  * request from a pool of fixed-size blocks chosen by size class.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_SMALL_OBJECT_ALLOCATOR_HPP
+#define PAWLIB_SMALL_OBJECT_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "pawlib/pool_allocator.hpp"
+
+/** A general-purpose allocator for objects of up to max_small bytes.
+ * Each request is rounded up to one of a fixed set of size classes, and
+ * served from that class's BlockPool. Because the size (and alignment)
+ * passed to deallocate() select the same class again, blocks carry no
+ * header. Larger or over-aligned requests go to the global operator new.
+ *
+ * It is also a std::pmr::memory_resource, so it may back onestring, or
+ * the Flex data structures via std::pmr::polymorphic_allocator.
+ * Not thread-safe. */
+class SmallObjectAllocator : public std::pmr::memory_resource
+{
+    public:
+        /// The largest request, in bytes, served from a size class.
+        static const size_t max_small = 1024;
+
+        /// The number of size classes.
+        static const size_t class_count = 21;
+
+        /// The size of each class in bytes, smallest first.
+        static const size_t class_sizes[class_count];
+
+        SmallObjectAllocator();
+
+        // Copy constructor and copy assignment don't make sense here!
+        SmallObjectAllocator(const SmallObjectAllocator&) = delete;
+        SmallObjectAllocator& operator=(const SmallObjectAllocator&) = delete;
+
+        /** Allocate uninitialized memory.
+         * \param the number of bytes
+         * \param the alignment, a power of two (optional)
+         * \return a pointer to the memory */
+        inline void* allocate(size_t size,
+                              size_t align = alignof(std::max_align_t))
+        {
+            // Don't call size_class() twice; this is the hot path.
+            if(size < align)
+            {
+                size = align;
+            }
+            if(size > max_small || align > alignof(std::max_align_t))
+            {
+                return allocate_large(size, align);
+            }
+            return pools[class_lookup[(size + 7) >> 3]]->allocate();
+        }
+
+        /** Return memory from allocate(). The size and alignment must be
+         * the same as were passed to allocate().
+         * \param the pointer from allocate()
+         * \param the number of bytes
+         * \param the alignment (optional) */
+        inline void deallocate(void* ptr, size_t size,
+                               size_t align = alignof(std::max_align_t))
+        {
+            if(size < align)
+            {
+                size = align;
+            }
+            if(size > max_small || align > alignof(std::max_align_t))
+            {
+                deallocate_large(ptr, size, align);
+                return;
+            }
+            pools[class_lookup[(size + 7) >> 3]]->deallocate(ptr);
+        }
+
+        /** Allocate and construct an object.
+         * \param the arguments to the object's constructor
+         * \return a pointer to the new object */
+        template<typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            void* mem = allocate(sizeof(T), alignof(T));
+            try
+            {
+                return new (mem) T(std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                deallocate(mem, sizeof(T), alignof(T));
+                throw;
+            }
+        }
+
+        /** Destroy and free an object from create().
+         * \param the object (may be nullptr) */
+        template<typename T>
+        void destroy(T* obj)
+        {
+            if(obj == nullptr) { return; }
+            obj->~T();
+            deallocate(obj, sizeof(T), alignof(T));
+        }
+
+        /** Find the size class which would serve a request.
+         * \param the number of bytes
+         * \param the alignment (optional)
+         * \return the index of the size class, or class_count if
+         * the request is served by operator new */
+        static size_t size_class(size_t size,
+                                 size_t align = alignof(std::max_align_t));
+
+        /** Return every small block to the system at once.
+         * All memory from allocate() and create() becomes invalid,
+         * except large requests, which must still be freed. */
+        void release() noexcept;
+
+        /** Returns the number of bytes held from the system for the
+         * size classes. This does not include large requests. */
+        size_t capacity() const noexcept;
+
+        /** Returns the number of bytes held from the system for one
+         * size class.
+         * \param the index of the size class */
+        size_t capacity(size_t size_class) const noexcept;
+
+        ~SmallObjectAllocator();
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other)
+            const noexcept override;
+
+    private:
+        /// The number of entries in the lookup table, one per 8 bytes.
+        static const size_t lookup_size = (max_small >> 3) + 1;
+
+        /** The size class for each request size, indexed by the
+         * size in bytes divided by 8, rounded up. */
+        static const uint8_t class_lookup[lookup_size];
+
+        /// The pool for each size class.
+        BlockPool* pools[class_count];
+
+        void* allocate_large(size_t size, size_t align);
+        void deallocate_large(void* ptr, size_t size, size_t align) noexcept;
+};
+
+#endif // PAWLIB_SMALL_OBJECT_ALLOCATOR_HPP
@@ -0,0 +1,656 @@
+/** Tests for Small Object Allocator [PawLIB]
+  * Version: 0.1
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_SMALL_OBJECT_ALLOCATOR_TESTS_HPP
+#define PAWLIB_SMALL_OBJECT_ALLOCATOR_TESTS_HPP
+
+#include <memory_resource>
+
+#include "pawlib/flex_array.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/small_object_allocator.hpp"
+#include "pawlib/stdutils.hpp"
+
+/** Generates the same sequence of request sizes for every benchmark,
+ * so that both sides of a comparison do identical work. */
+class SmallObjectWorkload
+{
+    public:
+        /** Fill the workload.
+         * \param the number of requests
+         * \param the largest request size */
+        SmallObjectWorkload(size_t count, size_t max_size)
+        :count(count), sizes(new size_t[count]), slots(new size_t[count])
+        {
+            uint32_t state = 2463534242u;
+            for(size_t i = 0; i < count; ++i)
+            {
+                // xorshift32 is plenty random for choosing sizes.
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                // Skew towards smaller requests, as real programs do.
+                size_t size = (state % max_size) + 1;
+                sizes[i] = (state & 0x100) ? size : (size >> 2) + 1;
+                slots[i] = (state >> 9) % count;
+            }
+        }
+
+        SmallObjectWorkload(const SmallObjectWorkload&) = delete;
+        SmallObjectWorkload& operator=(const SmallObjectWorkload&) = delete;
+
+        ~SmallObjectWorkload()
+        {
+            delete[] sizes;
+            delete[] slots;
+        }
+
+        /// The number of requests.
+        size_t count;
+        /// The size of each request.
+        size_t* sizes;
+        /// A pseudo-random index for each request, for scattered frees.
+        size_t* slots;
+};
+
+// P-tB1801
+class TestSmallObject_SizeClasses : public Test
+{
+    public:
+        TestSmallObject_SizeClasses(){}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Size Classes";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure every request size from 1 to 1024 bytes maps to a large enough, properly aligned block.";
+        }
+
+        bool run() override
+        {
+            SmallObjectAllocator small;
+            for(size_t size = 1; size <= SmallObjectAllocator::max_small; ++size)
+            {
+                size_t c = SmallObjectAllocator::size_class(size, 1);
+                PL_ASSERT_LESS(c, SmallObjectAllocator::class_count);
+                PL_ASSERT_GREATER_EQUAL(SmallObjectAllocator::class_sizes[c], size);
+                // The class below must have been too small.
+                if(c > 0)
+                {
+                    PL_ASSERT_LESS(SmallObjectAllocator::class_sizes[c - 1], size);
+                }
+
+                void* ptr = small.allocate(size);
+                PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(ptr)
+                                % alignof(std::max_align_t), 0u);
+                small.deallocate(ptr, size);
+            }
+
+            // Too large or too strictly aligned for any class.
+            PL_ASSERT_EQUAL(SmallObjectAllocator::size_class(1025),
+                            SmallObjectAllocator::class_count);
+            PL_ASSERT_EQUAL(SmallObjectAllocator::size_class(64, 64),
+                            SmallObjectAllocator::class_count);
+            // Alignment larger than the size selects a larger class.
+            PL_ASSERT_EQUAL(SmallObjectAllocator::size_class(4, 8), 0u);
+            PL_ASSERT_EQUAL(SmallObjectAllocator::size_class(4, 16), 1u);
+            return true;
+        }
+
+        ~TestSmallObject_SizeClasses(){}
+};
+
+// P-tB1802
+class TestSmallObject_Recycle : public Test
+{
+    public:
+        TestSmallObject_Recycle(){}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Recycle & Large Requests";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Free and reallocate " + stdutils::itos(iters) + " blocks without growing, and serve large and over-aligned requests.";
+        }
+
+        bool run() override
+        {
+            SmallObjectAllocator small;
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = small.allocate(24);
+            }
+            size_t held = small.capacity();
+            PL_ASSERT_GREATER(held, 0u);
+            PL_ASSERT_EQUAL(held, small.capacity(
+                SmallObjectAllocator::size_class(24)));
+
+            for(size_t i = 0; i < iters; ++i)
+            {
+                small.deallocate(ptrs[i], 24);
+            }
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = small.allocate(24);
+            }
+            PL_ASSERT_EQUAL(small.capacity(), held);
+            for(size_t i = 0; i < iters; ++i)
+            {
+                small.deallocate(ptrs[i], 24);
+            }
+
+            void* large = small.allocate(4000);
+            void* aligned = small.allocate(48, 64);
+            PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+            // Neither should have touched the size classes.
+            PL_ASSERT_EQUAL(small.capacity(), held);
+            small.deallocate(large, 4000);
+            small.deallocate(aligned, 48, 64);
+
+            small.release();
+            PL_ASSERT_EQUAL(small.capacity(), 0u);
+            return true;
+        }
+
+        ~TestSmallObject_Recycle(){}
+
+    private:
+        static const size_t iters = 1000;
+        void* ptrs[iters];
+};
+
+// P-tB1803
+class TestSmallObject_CreateDestroy : public Test
+{
+    public:
+        TestSmallObject_CreateDestroy(){}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Create & Destroy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Construct objects in the allocator with arguments, and ensure they are destroyed.";
+        }
+
+        bool run() override
+        {
+            SmallObjectAllocator small;
+            int destroyed = 0;
+            Tracked* objs[iters];
+            for(int i = 0; i < iters; ++i)
+            {
+                objs[i] = small.create<Tracked>(i, &destroyed);
+            }
+            for(int i = 0; i < iters; ++i)
+            {
+                PL_ASSERT_EQUAL(objs[i]->value, i);
+                small.destroy(objs[i]);
+            }
+            PL_ASSERT_EQUAL(destroyed, iters);
+            // Destroying nothing is harmless.
+            small.destroy<Tracked>(nullptr);
+            return true;
+        }
+
+        ~TestSmallObject_CreateDestroy(){}
+
+    private:
+        static const int iters = 100;
+
+        struct Tracked
+        {
+            Tracked(int v, int* count)
+            :value(v), destroyed(count)
+            {}
+
+            ~Tracked()
+            {
+                ++(*destroyed);
+            }
+
+            int value;
+            int* destroyed;
+        };
+};
+
+// P-tB1804
+class TestSmallObject_Containers : public Test
+{
+    public:
+        TestSmallObject_Containers(){}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Backing Containers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Back a onestring and a FlexArray with the allocator.";
+        }
+
+        bool run() override
+        {
+            typedef std::pmr::polymorphic_allocator<int> alloc_t;
+            SmallObjectAllocator small;
+            {
+                onestring str(&small);
+                for(int i = 0; i < 40; ++i)
+                {
+                    str.append("ü");
+                }
+                PL_ASSERT_TRUE(str.get_resource() == &small);
+                PL_ASSERT_EQUAL(str.length(), 40u);
+
+                // Copies go back to the default resource.
+                onestring cpy(str);
+                PL_ASSERT_TRUE(cpy == str);
+                PL_ASSERT_TRUE(cpy.get_resource()
+                               == std::pmr::get_default_resource());
+
+                FlexArray<int, true, true, alloc_t> arr{alloc_t(&small)};
+                for(int i = 0; i < 100; ++i)
+                {
+                    arr.push(i);
+                }
+                PL_ASSERT_EQUAL(arr[99], 99);
+                PL_ASSERT_GREATER(small.capacity(), 0u);
+            }
+            return true;
+        }
+
+        ~TestSmallObject_Containers(){}
+};
+
+// P-tB1805
+class TestSmallObject_Fragmentation : public Test
+{
+    public:
+        TestSmallObject_Fragmentation()
+        :work(iters, 256), ptrs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Fragmentation";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Allocate " + stdutils::itos(iters) + " mixed-size blocks, free a scattered half, and ensure reallocating them needs no new memory.";
+        }
+
+        bool pre() override
+        {
+            ptrs = new void*[iters];
+            return true;
+        }
+
+        bool run() override
+        {
+            SmallObjectAllocator small;
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = small.allocate(work.sizes[i]);
+            }
+            size_t held = small.capacity();
+
+            // Free every other block, leaving holes throughout every slab.
+            for(size_t i = 0; i < iters; i += 2)
+            {
+                small.deallocate(ptrs[i], work.sizes[i]);
+            }
+            for(size_t i = 0; i < iters; i += 2)
+            {
+                ptrs[i] = small.allocate(work.sizes[i]);
+            }
+            // Every hole was refilled by a request of its own class.
+            PL_ASSERT_EQUAL(small.capacity(), held);
+
+            size_t requested = 0;
+            for(size_t i = 0; i < iters; ++i)
+            {
+                requested += work.sizes[i];
+                small.deallocate(ptrs[i], work.sizes[i]);
+            }
+            // Rounding and slab growth must not waste more than the data.
+            PL_ASSERT_LESS(held, requested * 2);
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] ptrs;
+            ptrs = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestSmallObject_Fragmentation(){}
+
+    private:
+        static const size_t iters = 10000;
+        SmallObjectWorkload work;
+        void** ptrs;
+};
+
+// P-tB1806*
+class TestNewDelete_Throughput : public Test
+{
+    public:
+        TestNewDelete_Throughput()
+        :work(iters, 512), ptrs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "new/delete: Small Object Throughput";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Allocate and free " + stdutils::itos(iters) + " mixed-size blocks, in batches, with operator new.";
+        }
+
+        bool pre() override
+        {
+            ptrs = new void*[iters];
+            return true;
+        }
+
+        bool run() override
+        {
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = ::operator new(work.sizes[i]);
+            }
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ::operator delete(ptrs[i]);
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] ptrs;
+            ptrs = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestNewDelete_Throughput(){}
+
+    private:
+        static const size_t iters = 1000;
+        SmallObjectWorkload work;
+        void** ptrs;
+};
+
+// P-tB1806
+class TestSmallObject_Throughput : public Test
+{
+    public:
+        TestSmallObject_Throughput()
+        :work(iters, 512), ptrs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Throughput";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Allocate and free " + stdutils::itos(iters) + " mixed-size blocks, in batches, with SmallObjectAllocator.";
+        }
+
+        bool pre() override
+        {
+            ptrs = new void*[iters];
+            return true;
+        }
+
+        bool run() override
+        {
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = small.allocate(work.sizes[i]);
+            }
+            for(size_t i = 0; i < iters; ++i)
+            {
+                small.deallocate(ptrs[i], work.sizes[i]);
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            delete[] ptrs;
+            ptrs = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestSmallObject_Throughput(){}
+
+    private:
+        static const size_t iters = 1000;
+        SmallObjectWorkload work;
+        SmallObjectAllocator small;
+        void** ptrs;
+};
+
+// P-tB1807*
+class TestNewDelete_Churn : public Test
+{
+    public:
+        TestNewDelete_Churn()
+        :work(iters, 512), ptrs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "new/delete: Small Object Churn";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Replace " + stdutils::itos(iters) + " randomly chosen blocks in a full working set, with operator new.";
+        }
+
+        bool pre() override
+        {
+            ptrs = new void*[iters];
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = ::operator new(work.sizes[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            // Free and replace scattered blocks, fragmenting the heap.
+            for(size_t i = 0; i < iters; ++i)
+            {
+                size_t slot = work.slots[i];
+                ::operator delete(ptrs[slot]);
+                ptrs[slot] = ::operator new(work.sizes[slot]);
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            if(ptrs != nullptr)
+            {
+                for(size_t i = 0; i < iters; ++i)
+                {
+                    ::operator delete(ptrs[i]);
+                }
+            }
+            delete[] ptrs;
+            ptrs = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestNewDelete_Churn(){}
+
+    private:
+        static const size_t iters = 1000;
+        SmallObjectWorkload work;
+        void** ptrs;
+};
+
+// P-tB1807
+class TestSmallObject_Churn : public Test
+{
+    public:
+        TestSmallObject_Churn()
+        :work(iters, 512), ptrs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "SmallObjectAllocator: Churn";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Replace " + stdutils::itos(iters) + " randomly chosen blocks in a full working set, with SmallObjectAllocator.";
+        }
+
+        bool pre() override
+        {
+            ptrs = new void*[iters];
+            for(size_t i = 0; i < iters; ++i)
+            {
+                ptrs[i] = small.allocate(work.sizes[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            // Free and replace scattered blocks, fragmenting the heap.
+            for(size_t i = 0; i < iters; ++i)
+            {
+                size_t slot = work.slots[i];
+                small.deallocate(ptrs[slot], work.sizes[slot]);
+                ptrs[slot] = small.allocate(work.sizes[slot]);
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            if(ptrs != nullptr)
+            {
+                for(size_t i = 0; i < iters; ++i)
+                {
+                    small.deallocate(ptrs[i], work.sizes[i]);
+                }
+            }
+            delete[] ptrs;
+            ptrs = nullptr;
+            return true;
+        }
+
+        bool postmortem() override
+        {
+            return post();
+        }
+
+        ~TestSmallObject_Churn(){}
+
+    private:
+        static const size_t iters = 1000;
+        SmallObjectWorkload work;
+        SmallObjectAllocator small;
+        void** ptrs;
+};
+
+class TestSuite_SmallObjectAllocator : public TestSuite
+{
+    public:
+        explicit TestSuite_SmallObjectAllocator(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: Small Object Allocator Tests";
+        }
+
+        ~TestSuite_SmallObjectAllocator(){}
+};
+
+#endif // PAWLIB_SMALL_OBJECT_ALLOCATOR_TESTS_HPP
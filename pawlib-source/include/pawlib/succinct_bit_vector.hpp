@@ -0,0 +1,396 @@
+/** SuccinctBitVector [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * A static bitvector with constant-time rank and fast select.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_SUCCINCTBITVECTOR_HPP
+#define PAWLIB_SUCCINCTBITVECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "pawlib/flex_bitset.hpp"
+
+/** A static bitvector, built once from a FlexBitset or from raw words,
+  * which answers rank (how many set bits come before a position) in
+  * constant time and select (where the kth set bit is) in near-constant
+  * time, for about 12.5% more space than the bits themselves.
+  *
+  * The bits are stored in blocks of 512 (eight words), each led by one
+  * counter word, so a rank query reads one counter and the words after it,
+  * which are next to it in memory. The counter holds the number of set bits
+  * before the block in its low 37 bits, and the number of set bits before
+  * the third, fifth, and seventh words of the block in three 9-bit fields
+  * above that, so at most two words are ever counted.
+  *
+  * Select samples the block holding every 4096th set bit, then searches the
+  * few blocks between two samples by their counters. */
+class SuccinctBitVector
+{
+    public:
+        /// Returned by select1() when there are not that many set bits.
+        static constexpr size_t npos = SIZE_MAX;
+
+        SuccinctBitVector()
+        :blocks(nullptr), blockCount(0), samples(nullptr), sampleCount(0), _size(0), _ones(0)
+        {}
+
+        /** Build from the first bits of an array of words, with bit i in
+          * bit (i % 64) of word (i / 64). Any bits in the last word past the
+          * given number are ignored.
+          * \param the words
+          * \param the number of bits
+          * \throws std::length_error if there are 2^37 bits or more */
+        SuccinctBitVector(const uint64_t* words, size_t bits)
+        :SuccinctBitVector()
+        {
+            build(words, bits);
+        }
+
+        /** Build from a FlexBitset. */
+        explicit SuccinctBitVector(const FlexBitset& bits)
+        :SuccinctBitVector(bits.data(), bits.size())
+        {}
+
+        SuccinctBitVector(const SuccinctBitVector& cpy)
+        :blocks(allocate(cpy.blockCount * blockWords)), blockCount(cpy.blockCount),
+         samples(nullptr), sampleCount(cpy.sampleCount), _size(cpy._size), _ones(cpy._ones)
+        {
+            if(blockCount > 0)
+            {
+                std::memcpy(blocks, cpy.blocks, blockCount * blockWords * sizeof(uint64_t));
+            }
+            if(sampleCount > 0)
+            {
+                samples = new uint32_t[sampleCount];
+                std::memcpy(samples, cpy.samples, sampleCount * sizeof(uint32_t));
+            }
+        }
+
+        SuccinctBitVector(SuccinctBitVector&& mov)
+        :SuccinctBitVector()
+        {
+            swap(mov);
+        }
+
+        SuccinctBitVector& operator=(SuccinctBitVector rhs)
+        {
+            swap(rhs);
+            return *this;
+        }
+
+        void swap(SuccinctBitVector& other)
+        {
+            std::swap(blocks, other.blocks);
+            std::swap(blockCount, other.blockCount);
+            std::swap(samples, other.samples);
+            std::swap(sampleCount, other.sampleCount);
+            std::swap(_size, other._size);
+            std::swap(_ones, other._ones);
+        }
+
+        /** \return the value of the bit at the given index, which must be less than size() */
+        bool test(size_t index) const
+        {
+            const uint64_t* block = blocks + (index >> 9) * blockWords;
+            return (block[1 + ((index >> 6) & 7)] >> (index & 63)) & 1;
+        }
+
+        bool operator[](size_t index) const
+        {
+            return test(index);
+        }
+
+        /** \return the number of set bits before the given index, which may
+          * be anything up to and including size() */
+        size_t rank1(size_t index) const
+        {
+            if(index == _size)
+            {
+                return _ones;
+            }
+            const uint64_t* block = blocks + (index >> 9) * blockWords;
+            uint64_t counter = block[0];
+            size_t word = (index >> 6) & 7;
+            size_t rank = static_cast<size_t>(counter & absoluteMask);
+            // The count before each pair of words, after the first pair.
+            size_t pair = word >> 1;
+            if(pair > 0)
+            {
+                rank += static_cast<size_t>((counter >> (absoluteBits + subBits * (pair - 1))) & subMask);
+            }
+            if(word & 1)
+            {
+                rank += static_cast<size_t>(__builtin_popcountll(block[word]));
+            }
+            uint64_t below = (uint64_t(1) << (index & 63)) - 1;
+            return rank + static_cast<size_t>(__builtin_popcountll(block[1 + word] & below));
+        }
+
+        /** \return the number of clear bits before the given index, which may
+          * be anything up to and including size() */
+        size_t rank0(size_t index) const
+        {
+            return index - rank1(index);
+        }
+
+        /** \return the index of the set bit with the given rank, counting
+          * from 0, or npos if there are not that many set bits */
+        size_t select1(size_t rank) const
+        {
+            if(rank >= _ones)
+            {
+                return npos;
+            }
+            // The sample gives the block of the nearest earlier multiple of
+            // sampleRate; the next sample bounds the search.
+            size_t sample = rank / sampleRate;
+            size_t low = samples[sample];
+            size_t high = (sample + 1 < sampleCount) ? samples[sample + 1] + 1 : blockCount;
+            // Find the last block with no more than rank set bits before it.
+            while(high - low > 1)
+            {
+                size_t middle = low + (high - low) / 2;
+                if(absolute(middle) <= rank)
+                {
+                    low = middle;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            const uint64_t* block = blocks + low * blockWords;
+            uint64_t counter = block[0];
+            size_t remaining = rank - static_cast<size_t>(counter & absoluteMask);
+            size_t word = 0;
+            // Skip whole pairs of words by the counter's fields.
+            for(size_t pair = 3; pair > 0; --pair)
+            {
+                size_t before = static_cast<size_t>((counter >> (absoluteBits + subBits * (pair - 1))) & subMask);
+                if(before <= remaining)
+                {
+                    word = pair * 2;
+                    remaining -= before;
+                    break;
+                }
+            }
+            size_t first = static_cast<size_t>(__builtin_popcountll(block[1 + word]));
+            if(remaining >= first)
+            {
+                remaining -= first;
+                ++word;
+            }
+            return (low << 9) + (word << 6) + select_in_word(block[1 + word], remaining);
+        }
+
+        /** \return the number of bits */
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /** \return true if there are no bits */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /** \return the number of set bits */
+        size_t ones() const
+        {
+            return _ones;
+        }
+
+        /** \return the number of bytes used, including the bits themselves */
+        size_t space() const
+        {
+            return blockCount * blockWords * sizeof(uint64_t) + sampleCount * sizeof(uint32_t);
+        }
+
+        ~SuccinctBitVector()
+        {
+            deallocate(blocks);
+            delete[] samples;
+        }
+
+    private:
+        static const size_t blockWords = 9;
+        static const unsigned int absoluteBits = 37;
+        static const unsigned int subBits = 9;
+        static const uint64_t absoluteMask = (uint64_t(1) << absoluteBits) - 1;
+        static const uint64_t subMask = (uint64_t(1) << subBits) - 1;
+        static const size_t sampleRate = 4096;
+        static const size_t alignment = 64;
+
+        static uint64_t* allocate(size_t words)
+        {
+            if(words == 0)
+            {
+                return nullptr;
+            }
+            return static_cast<uint64_t*>(::operator new(words * sizeof(uint64_t), std::align_val_t(alignment)));
+        }
+
+        static void deallocate(uint64_t* words)
+        {
+            if(words != nullptr)
+            {
+                ::operator delete(words, std::align_val_t(alignment));
+            }
+        }
+
+        /** \return the index, within the word, of the set bit with the given
+          * rank within the word, which must exist */
+        static size_t select_in_word(uint64_t word, size_t rank)
+        {
+#if defined(__BMI2__)
+            // Deposit a single bit at the position of the rank-th set bit.
+            return static_cast<size_t>(__builtin_ctzll(_pdep_u64(uint64_t(1) << rank, word)));
+#else
+            // Skip whole bytes by their counts, then clear bits within the byte.
+            size_t offset = 0;
+            while(true)
+            {
+                size_t inByte = static_cast<size_t>(__builtin_popcountll(word & 0xFF));
+                if(rank < inByte)
+                {
+                    break;
+                }
+                rank -= inByte;
+                word >>= 8;
+                offset += 8;
+            }
+            for(; rank > 0; --rank)
+            {
+                word &= word - 1;
+            }
+            return offset + static_cast<size_t>(__builtin_ctzll(word));
+#endif
+        }
+
+        /** \return the number of set bits before the given block */
+        size_t absolute(size_t block) const
+        {
+            return static_cast<size_t>(blocks[block * blockWords] & absoluteMask);
+        }
+
+        void build(const uint64_t* words, size_t bits)
+        {
+            if(bits >= (size_t(1) << absoluteBits))
+            {
+                throw std::length_error("SuccinctBitVector: too many bits");
+            }
+            size_t wordCount = (bits + 63) / 64;
+            blockCount = wordCount / 8 + 1;
+            blocks = allocate(blockCount * blockWords);
+            _size = bits;
+
+            size_t ones = 0;
+            for(size_t b = 0; b < blockCount; ++b)
+            {
+                uint64_t* block = blocks + b * blockWords;
+                uint64_t counter = ones;
+                size_t inBlock = 0;
+                for(size_t w = 0; w < 8; ++w)
+                {
+                    size_t source = b * 8 + w;
+                    uint64_t word = 0;
+                    if(source < wordCount)
+                    {
+                        word = words[source];
+                        // Drop the bits past the end of the last word.
+                        if(source == wordCount - 1 && (bits & 63) != 0)
+                        {
+                            word &= (uint64_t(1) << (bits & 63)) - 1;
+                        }
+                    }
+                    if(w > 0 && (w & 1) == 0)
+                    {
+                        counter |= static_cast<uint64_t>(inBlock) << (absoluteBits + subBits * ((w >> 1) - 1));
+                    }
+                    block[1 + w] = word;
+                    inBlock += static_cast<size_t>(__builtin_popcountll(word));
+                }
+                block[0] = counter;
+                ones += inBlock;
+            }
+            _ones = ones;
+
+            sampleCount = (ones + sampleRate - 1) / sampleRate;
+            if(sampleCount > 0)
+            {
+                samples = new uint32_t[sampleCount];
+                size_t next = 0;
+                for(size_t b = 0; b < blockCount && next < sampleCount; ++b)
+                {
+                    size_t end = (b + 1 < blockCount) ? absolute(b + 1) : ones;
+                    // Every sampled rank which falls in this block.
+                    while(next < sampleCount && next * sampleRate < end)
+                    {
+                        samples[next++] = static_cast<uint32_t>(b);
+                    }
+                }
+            }
+        }
+
+        // The blocks, each a counter word followed by eight words of bits.
+        // There is always one block past the last full one, so a rank at
+        // the very end has a counter to read.
+        uint64_t* blocks;
+        size_t blockCount;
+        // The block holding every sampleRate-th set bit.
+        uint32_t* samples;
+        size_t sampleCount;
+        size_t _size;
+        size_t _ones;
+};
+
+#endif // PAWLIB_SUCCINCTBITVECTOR_HPP
@@ -0,0 +1,338 @@
+/** Tests for SuccinctBitVector [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_SUCCINCTBITVECTOR_TESTS_HPP
+#define PAWLIB_SUCCINCTBITVECTOR_TESTS_HPP
+
+#include <random>
+#include <vector>
+
+#include "pawlib/flex_bitset.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/stdutils.hpp"
+#include "pawlib/succinct_bit_vector.hpp"
+
+/** Check every rank and select of a SuccinctBitVector against its source.
+  * \param the bitvector
+  * \param the bits it was built from
+  * \return true if they match */
+inline bool succinct_matches(const SuccinctBitVector& vector, const FlexBitset& bits)
+{
+    if(vector.size() != bits.size() || vector.ones() != bits.popcount())
+    {
+        return false;
+    }
+    size_t rank = 0;
+    for(size_t i = 0; i < bits.size(); ++i)
+    {
+        if(vector.rank1(i) != rank || vector.rank0(i) != i - rank || vector.test(i) != bits.test(i))
+        {
+            return false;
+        }
+        if(bits.test(i))
+        {
+            if(vector.select1(rank) != i)
+            {
+                return false;
+            }
+            ++rank;
+        }
+    }
+    return vector.rank1(bits.size()) == rank && vector.select1(rank) == SuccinctBitVector::npos;
+}
+
+// P-tB8101
+class TestSuccinctBitVector_Densities : public Test
+{
+    public:
+        TestSuccinctBitVector_Densities(){}
+
+        testdoc_t get_title() override
+        {
+            return "SuccinctBitVector: Rank & Select";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Check every rank and select of random bitvectors of " + stdutils::itos(count) +
+                   " bits, from empty to full.";
+        }
+
+        bool run() override
+        {
+            std::mt19937 rng(8101);
+            // Parts per thousand of bits set.
+            const int densities[] = {0, 1, 10, 500, 990, 1000};
+            for(int density : densities)
+            {
+                FlexBitset bits(count);
+                for(size_t i = 0; i < count; ++i)
+                {
+                    bits.set(i, static_cast<int>(rng() % 1000) < density);
+                }
+                SuccinctBitVector vector(bits);
+                if(!succinct_matches(vector, bits))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        ~TestSuccinctBitVector_Densities(){}
+
+    private:
+        // Enough for several select samples, and not a multiple of 64.
+        static const size_t count = 100003;
+};
+
+// P-tB8102
+class TestSuccinctBitVector_Edges : public Test
+{
+    public:
+        TestSuccinctBitVector_Edges(){}
+
+        testdoc_t get_title() override
+        {
+            return "SuccinctBitVector: Edges";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build bitvectors of sizes around word and block boundaries, with stray bits past the end, and copy them.";
+        }
+
+        bool run() override
+        {
+            SuccinctBitVector empty;
+            PL_ASSERT_EQUAL(empty.rank1(0), 0u);
+            PL_ASSERT_EQUAL(empty.select1(0), SuccinctBitVector::npos);
+
+            const size_t sizes[] = {1, 63, 64, 65, 511, 512, 513, 1024, 4095};
+            for(size_t size : sizes)
+            {
+                FlexBitset bits(size, true);
+                if(!succinct_matches(SuccinctBitVector(bits), bits))
+                {
+                    return false;
+                }
+            }
+
+            // Bits past the given size are ignored.
+            uint64_t words[2] = {~uint64_t(0), ~uint64_t(0)};
+            SuccinctBitVector partial(words, 70);
+            PL_ASSERT_EQUAL(partial.ones(), 70u);
+            PL_ASSERT_EQUAL(partial.rank1(70), 70u);
+            PL_ASSERT_EQUAL(partial.select1(70), SuccinctBitVector::npos);
+
+            FlexBitset bits(5000);
+            for(size_t i = 0; i < 5000; i += 3)
+            {
+                bits.set(i);
+            }
+            SuccinctBitVector original(bits);
+            SuccinctBitVector copied = original;
+            PL_ASSERT_TRUE(succinct_matches(copied, bits));
+            SuccinctBitVector moved = std::move(original);
+            PL_ASSERT_TRUE(succinct_matches(moved, bits));
+
+            // The counters and samples cost about an eighth of the bits.
+            FlexBitset large(1 << 20);
+            large.set_range(0, 1 << 19);
+            SuccinctBitVector index(large);
+            size_t bitBytes = (1 << 20) / 8;
+            PL_ASSERT_LESS(index.space(), bitBytes + bitBytes / 4);
+            return true;
+        }
+
+        ~TestSuccinctBitVector_Edges(){}
+};
+
+/** Rank and select by counting from the start of a FlexBitset. */
+class SuccinctBenchScan
+{
+    public:
+        explicit SuccinctBenchScan(const FlexBitset& bits)
+        :bits(bits)
+        {}
+
+        size_t rank1(size_t index) const
+        {
+            return bits.popcount(0, index);
+        }
+
+        size_t select1(size_t rank) const
+        {
+            const uint64_t* words = bits.data();
+            for(size_t w = 0; w < bits.words(); ++w)
+            {
+                size_t inWord = static_cast<size_t>(__builtin_popcountll(words[w]));
+                if(rank < inWord)
+                {
+                    uint64_t word = words[w];
+                    for(; rank > 0; --rank)
+                    {
+                        word &= word - 1;
+                    }
+                    return (w << 6) + static_cast<size_t>(__builtin_ctzll(word));
+                }
+                rank -= inWord;
+            }
+            return SuccinctBitVector::npos;
+        }
+
+    private:
+        const FlexBitset& bits;
+};
+
+/** The bits the SuccinctBitVector benchmarks query: about one in three set. */
+inline const FlexBitset& succinct_bench_bits()
+{
+    static FlexBitset bits;
+    if(bits.empty())
+    {
+        std::mt19937 rng(8103);
+        bits.resize(1 << 22);
+        for(size_t i = 0; i < bits.size(); ++i)
+        {
+            bits.set(i, rng() % 3 == 0);
+        }
+    }
+    return bits;
+}
+
+// P-tB8103, P-tB8103*
+template<typename index_t>
+class TestSuccinctBitVector_Rank : public Test
+{
+    public:
+        explicit TestSuccinctBitVector_Rank(const testdoc_t& name)
+        :name(name), index(succinct_bench_bits())
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Rank";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find the rank of " + stdutils::itos(queries) + " positions in " +
+                   stdutils::itos(succinct_bench_bits().size()) + " bits, with " + name + ".";
+        }
+
+        bool run() override
+        {
+            size_t total = 0;
+            size_t size = succinct_bench_bits().size();
+            for(size_t i = 0; i < queries; ++i)
+            {
+                total += index.rank1((i * 7919 * 64) % size);
+            }
+            return total > 0;
+        }
+
+        ~TestSuccinctBitVector_Rank(){}
+
+    private:
+        static const size_t queries = 1000;
+        testdoc_t name;
+        index_t index;
+};
+
+// P-tB8104, P-tB8104*
+template<typename index_t>
+class TestSuccinctBitVector_Select : public Test
+{
+    public:
+        explicit TestSuccinctBitVector_Select(const testdoc_t& name)
+        :name(name), index(succinct_bench_bits())
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Select";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find " + stdutils::itos(queries) + " set bits by rank in " +
+                   stdutils::itos(succinct_bench_bits().size()) + " bits, with " + name + ".";
+        }
+
+        bool run() override
+        {
+            size_t total = 0;
+            size_t ones = succinct_bench_bits().size() / 4;
+            for(size_t i = 0; i < queries; ++i)
+            {
+                total += index.select1((i * 7919 * 64) % ones);
+            }
+            return total > 0;
+        }
+
+        ~TestSuccinctBitVector_Select(){}
+
+    private:
+        static const size_t queries = 1000;
+        testdoc_t name;
+        index_t index;
+};
+
+class TestSuite_SuccinctBitVector : public TestSuite
+{
+    public:
+        explicit TestSuite_SuccinctBitVector(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: SuccinctBitVector Tests";
+        }
+
+        ~TestSuite_SuccinctBitVector(){}
+};
+
+#endif // PAWLIB_SUCCINCTBITVECTOR_TESTS_HPP
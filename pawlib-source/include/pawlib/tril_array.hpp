@@ -0,0 +1,330 @@
+/** TrilArray [PawLIB]
+  * Version: 0.1 (Experimental)
+  *
+  * An array of trileans, packed into two bit-planes, with Kleene logic
+  * across whole words at a time.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_TRILARRAY_HPP
+#define PAWLIB_TRILARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "pawlib/core_types.hpp"
+#include "pawlib/flex_bitset.hpp"
+
+/** An array of trileans, packed into two bit-planes: the bool plane holds
+  * the value of each certain trilean, and the uncertainty plane marks each
+  * maybe. A maybe always has its bool bit clear, so a true is a set bool
+  * bit, and a false is neither bit set.
+  *
+  * That takes two bits per trilean instead of a byte, and lets the Kleene
+  * operations work on 64 trileans per word, or 256 at a time when compiled
+  * with AVX2.
+  *
+  * A maybe keeps no boolean value, unlike a tril, so a tril read back from
+  * a maybe always has a certain() of false. */
+class TrilArray
+{
+    public:
+        TrilArray() = default;
+
+        /** Create an array of the given number of trileans.
+          * \param the number of trileans
+          * \param the value of every trilean */
+        explicit TrilArray(size_t count, const tril& value = tril())
+        :bools(count, value == true), maybes(count, ~value)
+        {}
+
+        /** Create an array holding a copy of the given trileans.
+          * \param the trileans
+          * \param the number of trileans */
+        TrilArray(const tril* values, size_t count)
+        :bools(count), maybes(count)
+        {
+            for(size_t i = 0; i < count; ++i)
+            {
+                set(i, values[i]);
+            }
+        }
+
+        /** \return the trilean at the given index, which must be less than size() */
+        tril get(size_t index) const
+        {
+            return maybes.test(index) ? tril(maybe) : tril(bools.test(index));
+        }
+
+        tril operator[](size_t index) const
+        {
+            return get(index);
+        }
+
+        /** Set the trilean at the given index, which must be less than size(). */
+        void set(size_t index, const tril& value)
+        {
+            bools.set(index, value == true);
+            maybes.set(index, ~value);
+        }
+
+        /** Append a trilean. */
+        void push_back(const tril& value)
+        {
+            bools.push_back(value == true);
+            maybes.push_back(~value);
+        }
+
+        /** Change the number of trileans. New trileans take the given value.
+          * \param the new number of trileans
+          * \param the value of new trileans */
+        void resize(size_t count, const tril& value = tril())
+        {
+            bools.resize(count, value == true);
+            maybes.resize(count, ~value);
+        }
+
+        /** Copy every trilean out, in order.
+          * \param where to write, which must have room for size() trileans */
+        void copy_to(tril* out) const
+        {
+            for(size_t i = 0; i < size(); ++i)
+            {
+                out[i] = get(i);
+            }
+        }
+
+        /** Remove every trilean. */
+        void clear()
+        {
+            bools.clear();
+            maybes.clear();
+        }
+
+        /** \return the number of trileans */
+        size_t size() const
+        {
+            return bools.size();
+        }
+
+        /** \return true if there are no trileans */
+        bool empty() const
+        {
+            return bools.empty();
+        }
+
+        /** \return the number of trileans which are certain true */
+        size_t count_true() const
+        {
+            return bools.popcount();
+        }
+
+        /** \return the number of trileans which are certain false */
+        size_t count_false() const
+        {
+            return size() - bools.popcount() - maybes.popcount();
+        }
+
+        /** \return the number of trileans which are maybe */
+        size_t count_maybe() const
+        {
+            return maybes.popcount();
+        }
+
+        /** \return the bool plane, with a bit set for each certain true */
+        const FlexBitset& bool_plane() const
+        {
+            return bools;
+        }
+
+        /** \return the uncertainty plane, with a bit set for each maybe */
+        const FlexBitset& uncertainty_plane() const
+        {
+            return maybes;
+        }
+
+        /** Kleene AND each trilean with the one at the same index in other.
+          * \throws std::invalid_argument if the sizes differ */
+        TrilArray& operator&=(const TrilArray& other)
+        {
+            combine<Op::and_op>(other);
+            return *this;
+        }
+
+        /** Kleene OR each trilean with the one at the same index in other.
+          * \throws std::invalid_argument if the sizes differ */
+        TrilArray& operator|=(const TrilArray& other)
+        {
+            combine<Op::or_op>(other);
+            return *this;
+        }
+
+        /** Kleene NOT every trilean: swap true and false, and leave maybe. */
+        TrilArray& negate()
+        {
+            uint64_t* b = bools.data();
+            const uint64_t* u = maybes.data();
+            size_t words = bools.words();
+            for(size_t i = 0; i < words; ++i)
+            {
+                b[i] = ~(b[i] | u[i]);
+            }
+            // Keep the bits past the end clear, as FlexBitset requires.
+            if(size() % 64 != 0)
+            {
+                b[words - 1] &= (uint64_t(1) << (size() % 64)) - 1;
+            }
+            return *this;
+        }
+
+        bool operator==(const TrilArray& other) const
+        {
+            return bools == other.bools && maybes == other.maybes;
+        }
+
+        bool operator!=(const TrilArray& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        enum class Op
+        {
+            and_op,
+            or_op
+        };
+
+        /* With the bool plane b and the uncertainty plane u,
+            * AND is true where both are true, and maybe where neither is
+            * false but the result is not true:
+            *     b = b1 & b2, u = (b1 | u1) & (b2 | u2) & ~b
+            * OR is true where either is true, and maybe where either is
+            * maybe but the result is not true:
+            *     b = b1 | b2, u = (u1 | u2) & ~b */
+        template<Op op>
+        static void combine_word(uint64_t& b1, uint64_t& u1, uint64_t b2, uint64_t u2)
+        {
+            if constexpr(op == Op::and_op)
+            {
+                uint64_t b = b1 & b2;
+                u1 = (b1 | u1) & (b2 | u2) & ~b;
+                b1 = b;
+            }
+            else
+            {
+                b1 = b1 | b2;
+                u1 = (u1 | u2) & ~b1;
+            }
+        }
+
+#if defined(__AVX2__)
+        template<Op op>
+        static void combine_vector(__m256i& b1, __m256i& u1, __m256i b2, __m256i u2)
+        {
+            if constexpr(op == Op::and_op)
+            {
+                __m256i b = _mm256_and_si256(b1, b2);
+                __m256i notFalse = _mm256_and_si256(_mm256_or_si256(b1, u1), _mm256_or_si256(b2, u2));
+                // andnot inverts its first argument.
+                u1 = _mm256_andnot_si256(b, notFalse);
+                b1 = b;
+            }
+            else
+            {
+                b1 = _mm256_or_si256(b1, b2);
+                u1 = _mm256_andnot_si256(b1, _mm256_or_si256(u1, u2));
+            }
+        }
+#endif
+
+        template<Op op>
+        void combine(const TrilArray& other)
+        {
+            if(other.size() != size())
+            {
+                throw std::invalid_argument("TrilArray: sizes differ");
+            }
+            uint64_t* b1 = bools.data();
+            uint64_t* u1 = maybes.data();
+            const uint64_t* b2 = other.bools.data();
+            const uint64_t* u2 = other.maybes.data();
+            size_t words = bools.words();
+            size_t i = 0;
+#if defined(__AVX2__)
+            for(; i + 4 <= words; i += 4)
+            {
+                __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(b1 + i));
+                __m256i u = _mm256_load_si256(reinterpret_cast<const __m256i*>(u1 + i));
+                combine_vector<op>(b, u,
+                                   _mm256_load_si256(reinterpret_cast<const __m256i*>(b2 + i)),
+                                   _mm256_load_si256(reinterpret_cast<const __m256i*>(u2 + i)));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(b1 + i), b);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(u1 + i), u);
+            }
+#endif
+            for(; i < words; ++i)
+            {
+                combine_word<op>(b1[i], u1[i], b2[i], u2[i]);
+            }
+        }
+
+        FlexBitset bools;
+        FlexBitset maybes;
+};
+
+/** \return the Kleene AND of two arrays of the same size */
+inline TrilArray operator&(TrilArray lhs, const TrilArray& rhs)
+{
+    lhs &= rhs;
+    return lhs;
+}
+
+/** \return the Kleene OR of two arrays of the same size */
+inline TrilArray operator|(TrilArray lhs, const TrilArray& rhs)
+{
+    lhs |= rhs;
+    return lhs;
+}
+
+#endif // PAWLIB_TRILARRAY_HPP
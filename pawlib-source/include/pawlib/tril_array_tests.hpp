@@ -0,0 +1,330 @@
+/** Tests for TrilArray [PawLIB]
+  * Version: 0.1
+  *
+  *
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2020 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_TRILARRAY_TESTS_HPP
+#define PAWLIB_TRILARRAY_TESTS_HPP
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "pawlib/core_types.hpp"
+#include "pawlib/goldilocks.hpp"
+#include "pawlib/goldilocks_assertions.hpp"
+#include "pawlib/stdutils.hpp"
+#include "pawlib/tril_array.hpp"
+
+// The Kleene operators fold at compile time.
+static_assert(kleene_and(tril(true), maybe) == maybe, "true AND maybe is maybe");
+static_assert(!kleene_and(tril(false), maybe), "false AND maybe is false");
+static_assert(kleene_or(tril(true), maybe) == true, "true OR maybe is true");
+static_assert(~kleene_or(tril(false), maybe), "false OR maybe is maybe");
+static_assert(kleene_not(tril(false)) == true, "NOT false is true");
+static_assert(~kleene_not(maybe), "NOT maybe is maybe");
+
+/** \return count random trileans, seeded by the given number */
+inline std::vector<tril> tril_array_values(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<tril> values(count);
+    for(tril& value : values)
+    {
+        switch(rng() % 3)
+        {
+            case 0:
+                value = false;
+                break;
+            case 1:
+                value = true;
+                break;
+            default:
+                value = maybe;
+                break;
+        }
+    }
+    return values;
+}
+
+// P-tB0201
+class TestTrilArray_Convert : public Test
+{
+    public:
+        TestTrilArray_Convert(){}
+
+        testdoc_t get_title() override
+        {
+            return "TrilArray: Convert & Count";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Convert trileans to and from a TrilArray, set and append them, "
+                   "and count each state.";
+        }
+
+        bool run() override
+        {
+            std::vector<tril> values = tril_array_values(1000, 201);
+            TrilArray array(values.data(), values.size());
+            PL_ASSERT_EQUAL(array.size(), values.size());
+
+            size_t trues = 0;
+            size_t falses = 0;
+            size_t maybes = 0;
+            bool same = true;
+            for(size_t i = 0; i < values.size(); ++i)
+            {
+                same = same && array[i] == values[i];
+                trues += (values[i] == true) ? 1 : 0;
+                falses += (values[i] == false) ? 1 : 0;
+                maybes += (values[i] == maybe) ? 1 : 0;
+            }
+            PL_ASSERT_TRUE(same);
+            PL_ASSERT_EQUAL(array.count_true(), trues);
+            PL_ASSERT_EQUAL(array.count_false(), falses);
+            PL_ASSERT_EQUAL(array.count_maybe(), maybes);
+
+            std::vector<tril> copied(array.size());
+            array.copy_to(copied.data());
+            for(size_t i = 0; i < values.size(); ++i)
+            {
+                same = same && copied[i] == values[i];
+            }
+            PL_ASSERT_TRUE(same);
+
+            // A maybe keeps no boolean value.
+            tril lastTrue(true, true);
+            array.set(3, lastTrue);
+            PL_ASSERT_TRUE(~array[3]);
+            PL_ASSERT_FALSE(array[3].certain());
+            PL_ASSERT_FALSE(array.bool_plane().test(3));
+            PL_ASSERT_TRUE(array.uncertainty_plane().test(3));
+            array.set(3, true);
+            PL_ASSERT_TRUE(array[3] == true);
+            PL_ASSERT_FALSE(array.uncertainty_plane().test(3));
+
+            TrilArray grown;
+            PL_ASSERT_TRUE(grown.empty());
+            grown.push_back(true);
+            grown.push_back(maybe);
+            grown.push_back(false);
+            grown.resize(100, maybe);
+            PL_ASSERT_EQUAL(grown.count_true(), static_cast<size_t>(1));
+            PL_ASSERT_EQUAL(grown.count_false(), static_cast<size_t>(1));
+            PL_ASSERT_EQUAL(grown.count_maybe(), static_cast<size_t>(98));
+
+            TrilArray filled(70, maybe);
+            PL_ASSERT_EQUAL(filled.count_maybe(), static_cast<size_t>(70));
+            filled.clear();
+            PL_ASSERT_TRUE(filled.empty());
+            return true;
+        }
+
+        ~TestTrilArray_Convert(){}
+};
+
+// P-tB0202
+class TestTrilArray_Logic : public Test
+{
+    public:
+        TestTrilArray_Logic(){}
+
+        testdoc_t get_title() override
+        {
+            return "TrilArray: Kleene Logic";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Check the Kleene truth tables for tril, then AND, OR, and NOT arrays "
+                   "of many sizes, and compare each trilean with the scalar result.";
+        }
+
+        bool run() override
+        {
+            // The truth tables, in the order false, maybe, true.
+            const tril states[3] = {tril(false), tril(maybe), tril(true)};
+            const int ands[3][3] = {{0, 0, 0}, {0, 1, 1}, {0, 1, 2}};
+            const int ors[3][3] = {{0, 1, 2}, {1, 1, 2}, {2, 2, 2}};
+            for(int a = 0; a < 3; ++a)
+            {
+                for(int b = 0; b < 3; ++b)
+                {
+                    PL_ASSERT_TRUE(kleene_and(states[a], states[b]) == states[ands[a][b]]);
+                    PL_ASSERT_TRUE(kleene_or(states[a], states[b]) == states[ors[a][b]]);
+                }
+                PL_ASSERT_TRUE(kleene_not(states[a]) == states[2 - a]);
+            }
+
+            // Sizes around the word and AVX2 boundaries.
+            const size_t sizes[] = {0, 1, 63, 64, 65, 255, 256, 257, 1000};
+            for(size_t size : sizes)
+            {
+                std::vector<tril> a = tril_array_values(size, 202);
+                std::vector<tril> b = tril_array_values(size, 203);
+                TrilArray arrayA(a.data(), a.size());
+                TrilArray arrayB(b.data(), b.size());
+                TrilArray anded = arrayA & arrayB;
+                TrilArray ored = arrayA | arrayB;
+                TrilArray negated = arrayA;
+                negated.negate();
+                bool same = true;
+                for(size_t i = 0; i < size; ++i)
+                {
+                    same = same && anded[i] == kleene_and(a[i], b[i]);
+                    same = same && ored[i] == kleene_or(a[i], b[i]);
+                    same = same && negated[i] == kleene_not(a[i]);
+                }
+                PL_ASSERT_TRUE(same);
+                // Negating keeps the bits past the end clear.
+                PL_ASSERT_EQUAL(negated.count_true() + negated.count_false() + negated.count_maybe(), size);
+                negated.negate();
+                PL_ASSERT_TRUE(negated == arrayA);
+            }
+
+            TrilArray shorter(10);
+            TrilArray longer(11);
+            try
+            {
+                shorter &= longer;
+                return false;
+            }
+            catch(std::invalid_argument&) {}
+            return true;
+        }
+
+        ~TestTrilArray_Logic(){}
+};
+
+/** A std::vector of tril, with the Kleene AND of TrilArray, one value at
+  * a time. */
+class TrilBenchVector : public std::vector<tril>
+{
+    public:
+        TrilBenchVector() = default;
+
+        TrilBenchVector(const tril* values, size_t count)
+        :std::vector<tril>(values, values + count)
+        {}
+
+        TrilBenchVector& operator&=(const TrilBenchVector& other)
+        {
+            for(size_t i = 0; i < size(); ++i)
+            {
+                (*this)[i] = kleene_and((*this)[i], other[i]);
+            }
+            return *this;
+        }
+
+        size_t count_maybe() const
+        {
+            size_t count = 0;
+            for(const tril& value : *this)
+            {
+                count += ~value ? 1 : 0;
+            }
+            return count;
+        }
+};
+
+// P-tB0203, P-tB0203*
+template<typename array_t>
+class TestTrilArray_And : public Test
+{
+    public:
+        explicit TestTrilArray_And(const testdoc_t& name)
+        :name(name)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return name + ": Kleene AND";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Kleene AND two " + name + "s of " + stdutils::itos(count) +
+                   " random trileans, and count the maybes.";
+        }
+
+        bool pre() override
+        {
+            std::vector<tril> a = tril_array_values(count, 2031);
+            std::vector<tril> b = tril_array_values(count, 2032);
+            first = array_t(a.data(), a.size());
+            second = array_t(b.data(), b.size());
+            return true;
+        }
+
+        bool run() override
+        {
+            array_t result = first;
+            result &= second;
+            return result.count_maybe() > 0;
+        }
+
+        ~TestTrilArray_And(){}
+
+    private:
+        static const size_t count = 1000000;
+        testdoc_t name;
+        array_t first;
+        array_t second;
+};
+
+class TestSuite_TrilArray : public TestSuite
+{
+    public:
+        explicit TestSuite_TrilArray(){}
+
+        void load_tests() override;
+
+        testdoc_t get_title() override
+        {
+            return "PawLIB: TrilArray Tests";
+        }
+
+        ~TestSuite_TrilArray(){}
+};
+
+#endif // PAWLIB_TRILARRAY_TESTS_HPP
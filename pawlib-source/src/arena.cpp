@@ -0,0 +1,140 @@
+#include "pawlib/arena.hpp"
+
+Arena::Arena(size_t block_size, std::pmr::memory_resource* upstream)
+:upstream(upstream), next_size(block_size), held(0), head(nullptr),
+ current(nullptr), cursor(nullptr), end(nullptr)
+{
+    if(next_size < sizeof(Block) * 2)
+    {
+        next_size = sizeof(Block) * 2;
+    }
+}
+
+void Arena::enter(Block* block) noexcept
+{
+    current = block;
+    if(block == nullptr)
+    {
+        cursor = nullptr;
+        end = nullptr;
+        return;
+    }
+    cursor = reinterpret_cast<char*>(block) + sizeof(Block);
+    end = reinterpret_cast<char*>(block) + block->bytes;
+}
+
+void* Arena::allocate_slow(size_t size, size_t align)
+{
+    /* Try the blocks we already have, left over from before a reset.
+     * A block which is too small for this request stays in the chain. */
+    Block* next = (current == nullptr) ? head : current->next;
+    while(next != nullptr)
+    {
+        enter(next);
+        uintptr_t start = (reinterpret_cast<uintptr_t>(cursor) + align - 1)
+            & ~(static_cast<uintptr_t>(align) - 1);
+        uintptr_t limit = reinterpret_cast<uintptr_t>(end);
+        if(start <= limit && size <= limit - start)
+        {
+            cursor = reinterpret_cast<char*>(start + size);
+            return reinterpret_cast<void*>(start);
+        }
+        next = next->next;
+    }
+
+    // Make sure even an oversized request fits in the new block.
+    size_t bytes = next_size;
+    size_t need = sizeof(Block) + size + align;
+    if(need < size)
+    {
+        throw std::bad_alloc();
+    }
+    if(bytes < need)
+    {
+        bytes = need;
+    }
+    if(next_size < max_block_size)
+    {
+        next_size *= 2;
+    }
+
+    Block* block = static_cast<Block*>(
+        upstream->allocate(bytes, alignof(std::max_align_t)));
+    block->bytes = bytes;
+    held += bytes;
+
+    // Append the block to the end of the chain.
+    block->next = nullptr;
+    if(head == nullptr)
+    {
+        head = block;
+    }
+    else
+    {
+        Block* last = (current == nullptr) ? head : current;
+        while(last->next != nullptr)
+        {
+            last = last->next;
+        }
+        last->next = block;
+    }
+
+    enter(block);
+    uintptr_t start = (reinterpret_cast<uintptr_t>(cursor) + align - 1)
+        & ~(static_cast<uintptr_t>(align) - 1);
+    cursor = reinterpret_cast<char*>(start + size);
+    return reinterpret_cast<void*>(start);
+}
+
+void Arena::rewind(const Marker& marker) noexcept
+{
+    // A savepoint from before the first block is the same as a reset.
+    if(marker.block == nullptr)
+    {
+        reset();
+        return;
+    }
+    current = marker.block;
+    cursor = marker.cursor;
+    end = reinterpret_cast<char*>(current) + current->bytes;
+}
+
+void Arena::reset() noexcept
+{
+    /* Park before the first block; the next allocation enters it
+     * through allocate_slow(), so there's nothing to walk here. */
+    current = nullptr;
+    cursor = nullptr;
+    end = nullptr;
+}
+
+void Arena::release() noexcept
+{
+    while(head != nullptr)
+    {
+        Block* next = head->next;
+        upstream->deallocate(head, head->bytes, alignof(std::max_align_t));
+        head = next;
+    }
+    held = 0;
+    reset();
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    return allocate(bytes, alignment);
+}
+
+void Arena::do_deallocate(void*, size_t, size_t)
+{}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other)
+    const noexcept
+{
+    return this == &other;
+}
+
+Arena::~Arena()
+{
+    release();
+}
@@ -0,0 +1,17 @@
+#include "pawlib/arena_tests.hpp"
+
+void TestSuite_Arena::load_tests()
+{
+    register_test("P-tB1901",
+        new TestArena_Bump());
+    register_test("P-tB1902",
+        new TestArena_Reset());
+    register_test("P-tB1903",
+        new TestArena_Savepoints());
+    register_test("P-tB1904",
+        new TestArena_Containers());
+
+    register_test("P-tB1905",
+        new TestArena_Temporaries(), true,
+        new TestArena_TemporariesHeap());
+}
@@ -0,0 +1,20 @@
+#include "pawlib/bit_stream.hpp"
+
+void BitWriter::append_long_varint(Cursor& c, uint64_t value, unsigned int groups)
+{
+    // The first eight bytes, then one or two more.
+    uint64_t continues = (groups > 8) ? 0x8080808080808080ULL : 0x0080808080808080ULL;
+    append64(c, spread7(value & low_mask(56)) | continues, 64);
+    if(groups > 8)
+    {
+        uint64_t rest = value >> 56;
+        if(rest < 0x80)
+        {
+            append(c, rest, 8);
+        }
+        else
+        {
+            append(c, (rest & 0x7F) | 0x80 | ((rest >> 7) << 8), 16);
+        }
+    }
+}
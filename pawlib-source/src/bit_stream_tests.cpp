@@ -0,0 +1,20 @@
+#include "pawlib/bit_stream_tests.hpp"
+
+void TestSuite_BitStream::load_tests()
+{
+    register_test("P-tB8301",
+        new TestBitStream_Bits());
+    register_test("P-tB8302",
+        new TestBitStream_Varint());
+    register_test("P-tB8303",
+        new TestBitStream_GammaRice());
+    register_test("P-tB8304",
+        new TestBitStream_FlexBit());
+
+    register_test("P-tB8305",
+        new TestBitStream_Encode<BitStreamBenchWriter>("BitWriter"), true,
+        new TestBitStream_Encode<BitStreamBenchBytes>("Bytewise LEB128"));
+    register_test("P-tB8306",
+        new TestBitStream_Decode<BitStreamBenchWriter>("BitReader"), true,
+        new TestBitStream_Decode<BitStreamBenchBytes>("Bytewise LEB128"));
+}
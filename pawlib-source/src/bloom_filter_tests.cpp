@@ -0,0 +1,28 @@
+#include "pawlib/bloom_filter_tests.hpp"
+
+void TestSuite_BloomFilter::load_tests()
+{
+    register_test("P-tB8401a",
+        new TestBloomFilter_InsertContains<BloomFilter<>>("BloomFilter"));
+    register_test("P-tB8401b",
+        new TestBloomFilter_InsertContains<BlockedBloomFilter<>>("BlockedBloomFilter"));
+    register_test("P-tB8402a",
+        new TestBloomFilter_FalsePositives<BloomFilter<>>("BloomFilter"));
+    register_test("P-tB8402b",
+        new TestBloomFilter_FalsePositives<BlockedBloomFilter<>>("BlockedBloomFilter"));
+    register_test("P-tB8403a",
+        new TestBloomFilter_Batch<BloomFilter<>>("BloomFilter"));
+    register_test("P-tB8403b",
+        new TestBloomFilter_Batch<BlockedBloomFilter<>>("BlockedBloomFilter"));
+    register_test("P-tB8404a",
+        new TestBloomFilter_Serialize<BloomFilter<>, BlockedBloomFilter<>>("BloomFilter"));
+    register_test("P-tB8404b",
+        new TestBloomFilter_Serialize<BlockedBloomFilter<>, BloomFilter<>>("BlockedBloomFilter"));
+
+    register_test("P-tB8405",
+        new TestBloomFilter_Lookup<BlockedBloomFilter<>>("BlockedBloomFilter"), true,
+        new TestBloomFilter_Lookup<BloomFilter<>>("BloomFilter"));
+    register_test("P-tB8406",
+        new TestBloomFilter_BatchLookup<BloomBenchBatch>("contains_many()"), true,
+        new TestBloomFilter_BatchLookup<BloomBenchSingle>("contains() one at a time"));
+}
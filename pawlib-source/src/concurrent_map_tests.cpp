@@ -0,0 +1,25 @@
+#include "pawlib/concurrent_map_tests.hpp"
+
+void TestSuite_ConcurrentMap::load_tests()
+{
+    register_test("P-tB7401",
+        new TestConcurrentMap_InsertFind());
+    register_test("P-tB7402",
+        new TestConcurrentMap_Snapshot());
+    register_test("P-tB7403",
+        new TestConcurrentMap_Readers());
+
+    // Reads scaling across threads, against a Map behind a reader-writer lock.
+    register_test("P-tB7404",
+        new TestConcurrentMap_ReadScaling<ConcurrentMap<int, int>>("ConcurrentMap", 1), true,
+        new TestConcurrentMap_ReadScaling<SharedMutexMap>("Locked Map", 1));
+    register_test("P-tB7405",
+        new TestConcurrentMap_ReadScaling<ConcurrentMap<int, int>>("ConcurrentMap", 2), true,
+        new TestConcurrentMap_ReadScaling<SharedMutexMap>("Locked Map", 2));
+    register_test("P-tB7406",
+        new TestConcurrentMap_ReadScaling<ConcurrentMap<int, int>>("ConcurrentMap", 4), true,
+        new TestConcurrentMap_ReadScaling<SharedMutexMap>("Locked Map", 4));
+    register_test("P-tB7407",
+        new TestConcurrentMap_ReadScaling<ConcurrentMap<int, int>>("ConcurrentMap", 8), true,
+        new TestConcurrentMap_ReadScaling<SharedMutexMap>("Locked Map", 8));
+}
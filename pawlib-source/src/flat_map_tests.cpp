@@ -0,0 +1,48 @@
+#include "pawlib/flat_map_tests.hpp"
+
+void TestSuite_FlatMap::load_tests()
+{
+    register_test("P-tB7201",
+        new TestFlatMap_InsertFind());
+    register_test("P-tB7202",
+        new TestFlatMap_Remove());
+    register_test("P-tB7203",
+        new TestFlatMap_Range());
+    register_test("P-tB7204",
+        new TestFlatMap_Bulk());
+    register_test("P-tB7205",
+        new TestFlatMap_Strings());
+    register_test("P-tB7206",
+        new TestFlatMap_Emplace());
+
+    // Lookups across sizes, against std::map and then Map, to show where
+    // FlatMap stops winning.
+    register_test("P-tB7207",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 16), true,
+        new TestFlatMap_Lookup<FlatBenchStdMap>("std::map", 16));
+    register_test("P-tB7208",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 256), true,
+        new TestFlatMap_Lookup<FlatBenchStdMap>("std::map", 256));
+    register_test("P-tB7209",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 4096), true,
+        new TestFlatMap_Lookup<FlatBenchStdMap>("std::map", 4096));
+    register_test("P-tB7210",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 65536), true,
+        new TestFlatMap_Lookup<FlatBenchStdMap>("std::map", 65536));
+    register_test("P-tB7211",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 16), true,
+        new TestFlatMap_Lookup<Map<int, int>>("Map", 16));
+    register_test("P-tB7212",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 256), true,
+        new TestFlatMap_Lookup<Map<int, int>>("Map", 256));
+    register_test("P-tB7213",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 4096), true,
+        new TestFlatMap_Lookup<Map<int, int>>("Map", 4096));
+    register_test("P-tB7214",
+        new TestFlatMap_Lookup<FlatMap<int, int>>("FlatMap", 65536), true,
+        new TestFlatMap_Lookup<Map<int, int>>("Map", 65536));
+
+    register_test("P-tB7215",
+        new TestFlatMap_Insert<FlatMap<int, int>>("FlatMap"), true,
+        new TestFlatMap_Insert<Map<int, int>>("Map"));
+}
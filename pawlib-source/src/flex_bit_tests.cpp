@@ -20,4 +20,9 @@ void TestSuite_FlexBit::load_tests()
     register_test("P-tB151",new TestFlexBit_ToString(ONEHUND));
     register_test("P-tS151",new TestFlexBit_ToString(TENMILL), false);
 
+    register_test("P-tB155", new TestFlexBit_Stream(ONEHUND * 1000));
+    register_test("P-tS155", new TestFlexBit_Stream(TENMILL), false);
+
+    register_test("P-tB156", new TestFlexBit_CopyShrink());
+
 }
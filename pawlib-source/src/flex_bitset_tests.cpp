@@ -0,0 +1,23 @@
+#include "pawlib/flex_bitset_tests.hpp"
+
+void TestSuite_FlexBitset::load_tests()
+{
+    register_test("P-tB8001",
+        new TestFlexBitset_Bits());
+    register_test("P-tB8002",
+        new TestFlexBitset_Ranges());
+    register_test("P-tB8003",
+        new TestFlexBitset_Bitwise());
+    register_test("P-tB8004",
+        new TestFlexBitset_Resize());
+
+    register_test("P-tB8005",
+        new TestFlexBitset_And<FlexBitset>("FlexBitset"), true,
+        new TestFlexBitset_And<BitsetBenchVector>("std::vector<bool>"));
+    register_test("P-tB8006",
+        new TestFlexBitset_Popcount<FlexBitset>("FlexBitset"), true,
+        new TestFlexBitset_Popcount<BitsetBenchVector>("std::vector<bool>"));
+    register_test("P-tB8007",
+        new TestFlexBitset_FindNext<FlexBitset>("FlexBitset"), true,
+        new TestFlexBitset_FindNext<BitsetBenchVector>("std::vector<bool>"));
+}
@@ -0,0 +1,30 @@
+#include "pawlib/flex_btree_map_tests.hpp"
+
+void TestSuite_FlexBTreeMap::load_tests()
+{
+    register_test("P-tB7101",
+        new TestFlexBTreeMap_InsertFind());
+    register_test("P-tB7102",
+        new TestFlexBTreeMap_Remove());
+    register_test("P-tB7103",
+        new TestFlexBTreeMap_Range());
+    register_test("P-tB7104",
+        new TestFlexBTreeMap_BulkLoad());
+    register_test("P-tB7105",
+        new TestFlexBTreeMap_Strings());
+    register_test("P-tB7106",
+        new TestFlexBTreeMap_Emplace());
+
+    register_test("P-tB7107",
+        new TestFlexBTreeMap_Lookup(), true,
+        new TestFlexBTreeMap_LookupOther<BTreeBenchStdMap>("std::map"));
+    register_test("P-tB7108",
+        new TestFlexBTreeMap_Lookup(), true,
+        new TestFlexBTreeMap_LookupOther<Map<int, int>>("Map"));
+    register_test("P-tB7109",
+        new TestFlexBTreeMap_Scan(), true,
+        new TestFlexBTreeMap_ScanStd());
+    register_test("P-tB7110",
+        new TestFlexBTreeMap_Insert(), true,
+        new TestFlexBTreeMap_InsertStd());
+}
@@ -0,0 +1,35 @@
+#include "pawlib/flex_hash_map_tests.hpp"
+
+void TestSuite_FlexHashMap::load_tests()
+{
+    register_test("P-tB7001",
+        new TestFlexHashMap_InsertFind());
+    register_test("P-tB7002",
+        new TestFlexHashMap_Remove());
+    register_test("P-tB7003",
+        new TestFlexHashMap_Heterogeneous());
+    register_test("P-tB7004",
+        new TestFlexHashMap_Emplace());
+    register_test("P-tB7005",
+        new TestFlexHashMap_Copy());
+    register_test("P-tB7006",
+        new TestFlexHashSet_Basic());
+    register_test("P-tB7012",
+        new TestFlexHashMap_SelfInsert());
+
+    register_test("P-tB7007",
+        new TestFlexHashMap_Insert(), true,
+        new TestFlexHashMap_InsertStd());
+    register_test("P-tB7008",
+        new TestFlexHashMap_Lookup(true), true,
+        new TestFlexHashMap_LookupStd(true));
+    register_test("P-tB7009",
+        new TestFlexHashMap_Lookup(false), true,
+        new TestFlexHashMap_LookupStd(false));
+    register_test("P-tB7010",
+        new TestFlexHashMap_RemoveBench(), true,
+        new TestFlexHashMap_RemoveStd());
+    register_test("P-tB7011",
+        new TestFlexHashMap_Lookup(true), true,
+        new TestFlexHashMap_LookupMap());
+}
@@ -0,0 +1,60 @@
+#include "pawlib/flex_map_tests.hpp"
+
+int MapCounted::constructs = 0;
+int MapCounted::copies = 0;
+int MapCounted::moves = 0;
+
+void TestSuite_FlexMap::load_tests()
+{
+    register_test("P-tB1101",
+        new TestMap_InsertFind());
+    register_test("P-tB1102",
+        new TestMap_Remove());
+    register_test("P-tB1103",
+        new TestMap_Retrieve());
+    register_test("P-tB1104",
+        new TestMap_Emplace());
+    register_test("P-tB1105",
+        new TestMap_Heterogeneous());
+    register_test("P-tB1106",
+        new TestMap_Copy());
+    register_test("P-tB1108",
+        new TestMap_Compact());
+    register_test("P-tB1109",
+        new TestMap_Capacity());
+    register_test("P-tB1111",
+        new TestMap_FromSorted());
+    register_test("P-tB1112",
+        new TestMap_BulkInsert());
+    register_test("P-tB1121",
+        new TestMap_BulkInsertThrow());
+    register_test("P-tB1122",
+        new TestMap_BulkInsertThrowCount());
+    register_test("P-tB1115",
+        new TestMap_Iterate());
+    register_test("P-tB1116",
+        new TestMap_Bounds());
+    register_test("P-tB1117",
+        new TestMap_Range());
+    register_test("P-tB1119",
+        new TestMap_OrderStats());
+
+    register_test("P-tB1107",
+        new TestMap_Lookup(), true,
+        new TestMap_LookupStd());
+    register_test("P-tB1110",
+        new TestMap_ScatteredLookup(true), true,
+        new TestMap_ScatteredLookup(false));
+    register_test("P-tB1113",
+        new TestMap_BuildFromSorted(), true,
+        new TestMap_BuildInsert(true));
+    register_test("P-tB1114",
+        new TestMap_BuildBulkInsert(), true,
+        new TestMap_BuildInsert(false));
+    register_test("P-tB1118",
+        new TestMap_RangeScan(), true,
+        new TestMap_RangeStd());
+    register_test("P-tB1120",
+        new TestMap_PercentileSelect(), true,
+        new TestMap_PercentileWalk());
+}
@@ -4,42 +4,55 @@
 * Constructors + Destructor
 *******************************************/
 onestring::onestring()
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     //assign('\0');
 }
 
 onestring::onestring(char ch)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     assign(ch);
 }
 
 onestring::onestring(const onechar& ochr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     assign(ochr);
 }
 
 onestring::onestring(const char* cstr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     assign(cstr);
 }
 
 onestring::onestring(const std::string& str)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     append(str);
 }
 
+onestring::onestring(std::pmr::memory_resource* res)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(res)
+{
+    allocate(this->_capacity);
+}
+
 onestring::onestring(const onestring& ostr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _allocated(0),
+ _c_str(0), resource(std::pmr::get_default_resource())
 {
     allocate(this->_capacity);
     assign(ostr);
@@ -54,7 +67,7 @@ onestring::~onestring()
 
     if (internal != nullptr)
     {
-        delete[] internal;
+        free_array(internal, _allocated);
     }
 }
 
@@ -62,6 +75,26 @@ onestring::~onestring()
 * Memory Management
 *******************************************/
 
+onechar* onestring::make_array(size_t capacity)
+{
+    onechar* arr = static_cast<onechar*>(
+        resource->allocate(capacity * sizeof(onechar), alignof(onechar)));
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        new (arr + i) onechar();
+    }
+    return arr;
+}
+
+void onestring::free_array(onechar* arr, size_t capacity)
+{
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        arr[i].~onechar();
+    }
+    resource->deallocate(arr, capacity * sizeof(onechar), alignof(onechar));
+}
+
 void onestring::allocate(size_t capacity)
 {
     this->_capacity = capacity;
@@ -73,7 +106,7 @@ void onestring::allocate(size_t capacity)
     }
 
     // Allocate a new array with the new size.
-    onechar* newArr = new onechar[this->_capacity];
+    onechar* newArr = make_array(this->_capacity);
 
     // If an old array exists...
     if(this->internal != nullptr)
@@ -84,12 +117,13 @@ void onestring::allocate(size_t capacity)
         }
 
         // Delete the old structure
-        delete[] internal;
+        free_array(internal, _allocated);
         this->internal = nullptr;
     }
 
     // Store the new structure.
     this->internal = newArr;
+    this->_allocated = this->_capacity;
 }
 
 void onestring::expand(size_t expansion)
@@ -363,6 +397,32 @@ size_t onestring::size(size_t len, size_t pos) const
     return bytes;
 }
 
+size_t onestring::hash() const
+{
+    // 64-bit FNV-1a, fed one onechar at a time.
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i = 0; i < _elements; ++i)
+    {
+        for(size_t j = 0; j < internal[i].size; ++j)
+        {
+            h ^= static_cast<unsigned char>(internal[i].internal[j]);
+            h *= 1099511628211ULL;
+        }
+    }
+    return static_cast<size_t>(h);
+}
+
+size_t onestring::hash(const char* bytes, size_t len)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i = 0; i < len; ++i)
+    {
+        h ^= static_cast<unsigned char>(bytes[i]);
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+}
+
 /*******************************************
 * Comparison
 ********************************************/
@@ -598,7 +658,7 @@ void onestring::clear()
 {
     if (_elements > 0)
     {
-        delete[] this->internal;
+        free_array(this->internal, _allocated);
         internal = nullptr;
         _capacity = 0;
         reserve(BASE_SIZE);
@@ -201,4 +201,476 @@ void TestSuite_Pawsort::load_tests()
         register_test("P-tB3066",
             new TestPawSortDPQS(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
             new TestPawSort(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+
+    register_test("P-tB3071a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_SORTED), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_SORTED));
+
+    register_test("P-tB3071c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_SORTED), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_SORTED));
+
+    register_test("P-tB3072a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_REVERSED), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_REVERSED));
+
+    register_test("P-tB3072c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_REVERSED), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_REVERSED));
+
+    register_test("P-tB3073a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NEARLY_2));
+
+    register_test("P-tB3073c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_NEARLY_2));
+
+    register_test("P-tB3074a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NEARLY_5));
+
+    register_test("P-tB3074c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_NEARLY_5));
+
+    register_test("P-tB3075a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_FEW_UNIQUE));
+
+    register_test("P-tB3075c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_FEW_UNIQUE));
+
+    register_test("P-tB3076a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_BLACK_SHEEP));
+
+    register_test("P-tB3076c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_BLACK_SHEEP));
+
+    register_test("P-tB3077a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB));
+
+    register_test("P-tB3077c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB));
+
+    register_test("P-tB3078a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_DROP));
+
+    register_test("P-tB3078c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_DOUBLE_DROP));
+
+    register_test("P-tB3079a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_STAIRS), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_STAIRS));
+
+    register_test("P-tB3079c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_STAIRS), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_STAIRS));
+
+    register_test("P-tB3080a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_MOUNTAIN));
+
+    register_test("P-tB3080c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_MOUNTAIN));
+
+    register_test("P-tB3081a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN));
+
+    register_test("P-tB3081c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN));
+
+    register_test("P-tB3082a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_EVEREST), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_EVEREST));
+
+    register_test("P-tB3082c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_EVEREST), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_EVEREST));
+
+    register_test("P-tB3083a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_CLIFF), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_CLIFF));
+
+    register_test("P-tB3083c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_CLIFF), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_CLIFF));
+
+    register_test("P-tB3084a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_SPIKE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_SPIKE));
+
+    register_test("P-tB3084c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_SPIKE), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_SPIKE));
+
+    register_test("P-tB3085a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_CHICKEN));
+
+    register_test("P-tB3085c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_CHICKEN));
+
+    register_test("P-tB3086a",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+
+    register_test("P-tB3086c",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
+        new TestStdStableSort(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+
+    // Radix sort each distribution, compared with std::sort.
+    register_test("P-tB3071e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_SORTED), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_SORTED));
+
+    register_test("P-tB3072e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_REVERSED), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_REVERSED));
+
+    register_test("P-tB3073e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NEARLY_2));
+
+    register_test("P-tB3074e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NEARLY_5));
+
+    register_test("P-tB3075e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_FEW_UNIQUE));
+
+    register_test("P-tB3076e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_BLACK_SHEEP));
+
+    register_test("P-tB3077e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB));
+
+    register_test("P-tB3078e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_DROP));
+
+    register_test("P-tB3079e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_STAIRS), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_STAIRS));
+
+    register_test("P-tB3080e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_MOUNTAIN));
+
+    register_test("P-tB3081e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN));
+
+    register_test("P-tB3082e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_EVEREST), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_EVEREST));
+
+    register_test("P-tB3083e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_CLIFF), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_CLIFF));
+
+    register_test("P-tB3084e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_SPIKE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_SPIKE));
+
+    register_test("P-tB3085e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_CHICKEN));
+
+    register_test("P-tB3086e",
+        new TestPawRadixSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
+        new TestStdSortLarge(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+
+    // Radix sort random keys of each width, compared with introsort.
+    register_test("P-tB3091a",
+        new TestRadixSortKeys<uint32_t, 8>("uint32", 1000000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 1000000));
+
+    register_test("P-tB3091b",
+        new TestRadixSortKeys<uint32_t, 11>("uint32", 1000000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 1000000));
+
+    register_test("P-tB3091c",
+        new TestRadixSortKeys<uint32_t, 16>("uint32", 1000000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 1000000));
+
+    register_test("P-tB3092a",
+        new TestRadixSortKeys<uint64_t, 8>("uint64", 1000000), true,
+        new TestIntrosortKeys<uint64_t>("uint64", 1000000));
+
+    register_test("P-tB3092b",
+        new TestRadixSortKeys<uint64_t, 11>("uint64", 1000000), true,
+        new TestIntrosortKeys<uint64_t>("uint64", 1000000));
+
+    register_test("P-tB3092c",
+        new TestRadixSortKeys<uint64_t, 16>("uint64", 1000000), true,
+        new TestIntrosortKeys<uint64_t>("uint64", 1000000));
+
+    register_test("P-tB3093a",
+        new TestRadixSortKeys<float, 8>("float", 1000000), true,
+        new TestIntrosortKeys<float>("float", 1000000));
+
+    register_test("P-tB3093b",
+        new TestRadixSortKeys<float, 11>("float", 1000000), true,
+        new TestIntrosortKeys<float>("float", 1000000));
+
+    register_test("P-tB3093c",
+        new TestRadixSortKeys<float, 16>("float", 1000000), true,
+        new TestIntrosortKeys<float>("float", 1000000));
+
+    register_test("P-tB3094a",
+        new TestRadixSortRecords<8>(1000000), true,
+        new TestStdStableSortRecords(1000000));
+
+    register_test("P-tB3094b",
+        new TestRadixSortRecords<11>(1000000), true,
+        new TestStdStableSortRecords(1000000));
+
+    register_test("P-tB3094c",
+        new TestRadixSortRecords<16>(1000000), true,
+        new TestStdStableSortRecords(1000000));
+
+    // Radix sort keys at several sizes, compared with introsort.
+    register_test("P-tB3095a",
+        new TestRadixSortKeys<uint32_t, 8>("uint32", 1000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 1000));
+
+    register_test("P-tB3095b",
+        new TestRadixSortKeys<uint32_t, 8>("uint32", 10000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 10000));
+
+    register_test("P-tB3095c",
+        new TestRadixSortKeys<uint32_t, 8>("uint32", 100000), true,
+        new TestIntrosortKeys<uint32_t>("uint32", 100000));
+
+    register_test("P-tB3096",
+        new TestParallelRadixSortKeys<uint64_t>("uint64", 1000000), true,
+        new TestRadixSortKeys<uint64_t, 8>("uint64", 1000000));
+
+    // Sort small blocks with sorting networks, compared with insertion sort.
+    register_test("P-tB3101a",
+        new TestNetworkSortLeaf<int32_t>("int32", 8), true,
+        new TestInsertionSortLeaf<int32_t>("int32", 8));
+
+    register_test("P-tB3101b",
+        new TestNetworkSortLeaf<int32_t>("int32", 16), true,
+        new TestInsertionSortLeaf<int32_t>("int32", 16));
+
+    register_test("P-tB3101c",
+        new TestNetworkSortLeaf<int32_t>("int32", 32), true,
+        new TestInsertionSortLeaf<int32_t>("int32", 32));
+
+    register_test("P-tB3101d",
+        new TestNetworkSortLeaf<int32_t>("int32", 64), true,
+        new TestInsertionSortLeaf<int32_t>("int32", 64));
+
+    register_test("P-tB3102a",
+        new TestNetworkSortLeaf<int64_t>("int64", 8), true,
+        new TestInsertionSortLeaf<int64_t>("int64", 8));
+
+    register_test("P-tB3102b",
+        new TestNetworkSortLeaf<int64_t>("int64", 16), true,
+        new TestInsertionSortLeaf<int64_t>("int64", 16));
+
+    register_test("P-tB3102c",
+        new TestNetworkSortLeaf<int64_t>("int64", 32), true,
+        new TestInsertionSortLeaf<int64_t>("int64", 32));
+
+    register_test("P-tB3102d",
+        new TestNetworkSortLeaf<int64_t>("int64", 64), true,
+        new TestInsertionSortLeaf<int64_t>("int64", 64));
+
+    register_test("P-tB3103a",
+        new TestNetworkSortLeaf<float>("float", 8), true,
+        new TestInsertionSortLeaf<float>("float", 8));
+
+    register_test("P-tB3103b",
+        new TestNetworkSortLeaf<float>("float", 16), true,
+        new TestInsertionSortLeaf<float>("float", 16));
+
+    register_test("P-tB3103c",
+        new TestNetworkSortLeaf<float>("float", 32), true,
+        new TestInsertionSortLeaf<float>("float", 32));
+
+    register_test("P-tB3103d",
+        new TestNetworkSortLeaf<float>("float", 64), true,
+        new TestInsertionSortLeaf<float>("float", 64));
+
+    register_test("P-tB3104a",
+        new TestNetworkSortLeaf<double>("double", 8), true,
+        new TestInsertionSortLeaf<double>("double", 8));
+
+    register_test("P-tB3104b",
+        new TestNetworkSortLeaf<double>("double", 16), true,
+        new TestInsertionSortLeaf<double>("double", 16));
+
+    register_test("P-tB3104c",
+        new TestNetworkSortLeaf<double>("double", 32), true,
+        new TestInsertionSortLeaf<double>("double", 32));
+
+    register_test("P-tB3104d",
+        new TestNetworkSortLeaf<double>("double", 64), true,
+        new TestInsertionSortLeaf<double>("double", 64));
+
+    // Introsort with sorting network leaves, compared with std::sort.
+    register_test("P-tB3105a",
+        new TestIntrosortKeys<int32_t>("int32", 1000000), true,
+        new TestStdSortKeys<int32_t>("int32", 1000000));
+
+    register_test("P-tB3105b",
+        new TestIntrosortKeys<int64_t>("int64", 1000000), true,
+        new TestStdSortKeys<int64_t>("int64", 1000000));
+
+    register_test("P-tB3105c",
+        new TestIntrosortKeys<float>("float", 1000000), true,
+        new TestStdSortKeys<float>("float", 1000000));
+
+    register_test("P-tB3105d",
+        new TestIntrosortKeys<double>("double", 1000000), true,
+        new TestStdSortKeys<double>("double", 1000000));
+
+#if defined(PAWLIB_PARALLEL_STL)
+    // Compare against the standard library's own parallel sorts.
+    register_test("P-tB3071b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_SORTED), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_SORTED));
+
+    register_test("P-tB3071d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_SORTED), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_SORTED));
+
+    register_test("P-tB3072b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_REVERSED), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_REVERSED));
+
+    register_test("P-tB3072d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_REVERSED), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_REVERSED));
+
+    register_test("P-tB3073b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2));
+
+    register_test("P-tB3073d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_2));
+
+    register_test("P-tB3074b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5));
+
+    register_test("P-tB3074d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_NEARLY_5));
+
+    register_test("P-tB3075b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE));
+
+    register_test("P-tB3075d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_FEW_UNIQUE));
+
+    register_test("P-tB3076b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP));
+
+    register_test("P-tB3076d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_BLACK_SHEEP));
+
+    register_test("P-tB3077b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB));
+
+    register_test("P-tB3077d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_CLIMB));
+
+    register_test("P-tB3078b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP));
+
+    register_test("P-tB3078d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_DROP));
+
+    register_test("P-tB3079b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_STAIRS), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_STAIRS));
+
+    register_test("P-tB3079d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_STAIRS), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_STAIRS));
+
+    register_test("P-tB3080b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN));
+
+    register_test("P-tB3080d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_MOUNTAIN));
+
+    register_test("P-tB3081b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN));
+
+    register_test("P-tB3081d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_DOUBLE_MOUNTAIN));
+
+    register_test("P-tB3082b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_EVEREST), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_EVEREST));
+
+    register_test("P-tB3082d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_EVEREST), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_EVEREST));
+
+    register_test("P-tB3083b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_CLIFF), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_CLIFF));
+
+    register_test("P-tB3083d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_CLIFF), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_CLIFF));
+
+    register_test("P-tB3084b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_SPIKE), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_SPIKE));
+
+    register_test("P-tB3084d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_SPIKE), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_SPIKE));
+
+    register_test("P-tB3085b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN));
+
+    register_test("P-tB3085d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_CHICKEN));
+
+    register_test("P-tB3086b",
+        new TestPawSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
+        new TestStdSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+
+    register_test("P-tB3086d",
+        new TestPawStableSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE), true,
+        new TestStdStableSortParallel(TestSort::TestArrayType::ARRAY_NIGHTMARE));
+#endif
 }
@@ -0,0 +1,21 @@
+#include "pawlib/persistent_map_tests.hpp"
+
+void TestSuite_PersistentMap::load_tests()
+{
+    register_test("P-tB7301",
+        new TestPersistentMap_InsertFind());
+    register_test("P-tB7302",
+        new TestPersistentMap_Remove());
+    register_test("P-tB7303",
+        new TestPersistentMap_Versions());
+    register_test("P-tB7304",
+        new TestPersistentMap_Range());
+    register_test("P-tB7305",
+        new TestPersistentMap_Strings());
+    register_test("P-tB7307",
+        new TestPersistentMap_ThrowingCopy());
+
+    register_test("P-tB7306",
+        new TestPersistentMap_Snapshot(), true,
+        new TestPersistentMap_SnapshotCopy());
+}
@@ -0,0 +1,151 @@
+#include "pawlib/pool_allocator.hpp"
+
+BlockPool::BlockPool(size_t block_size, size_t block_align,
+                     uint32_t slab_blocks)
+:blocksize(block_size), blockalign(block_align), header(0),
+ blocks_to_make(slab_blocks), held(0), slabs(nullptr), free_list(nullptr),
+ bump(nullptr), bump_end(nullptr)
+{
+    // Every block must be able to hold a free list link.
+    if(blockalign < alignof(FreeBlock))
+    {
+        blockalign = alignof(FreeBlock);
+    }
+    if(blocksize < sizeof(FreeBlock))
+    {
+        blocksize = sizeof(FreeBlock);
+    }
+    // Round the block size up, so every block in a slab stays aligned.
+    blocksize = (blocksize + blockalign - 1) & ~(blockalign - 1);
+    // The first block in a slab must come after the header, aligned.
+    header = (sizeof(Slab) + blockalign - 1) & ~(blockalign - 1);
+
+    if(blocks_to_make == 0)
+    {
+        blocks_to_make = 1;
+    }
+}
+
+void BlockPool::grow()
+{
+    size_t bytes = header + (blocksize * blocks_to_make);
+    // Align the slab itself to at least the block alignment.
+    size_t align = (blockalign > alignof(Slab)) ? blockalign : alignof(Slab);
+    Slab* slab = static_cast<Slab*>(
+        ::operator new(bytes, std::align_val_t(align)));
+
+    slab->next = slabs;
+    slab->bytes = bytes;
+    slabs = slab;
+    held += bytes;
+
+    // Blocks are handed out lazily, so a new slab is never walked up front.
+    bump = reinterpret_cast<char*>(slab) + header;
+    bump_end = reinterpret_cast<char*>(slab) + bytes;
+
+    // Next time make twice as many blocks, within reason.
+    if(blocks_to_make < max_slab_blocks)
+    {
+        blocks_to_make *= 2;
+    }
+}
+
+void BlockPool::release() noexcept
+{
+    size_t align = (blockalign > alignof(Slab)) ? blockalign : alignof(Slab);
+    while(slabs != nullptr)
+    {
+        Slab* next = slabs->next;
+        ::operator delete(slabs, std::align_val_t(align));
+        slabs = next;
+    }
+    held = 0;
+    free_list = nullptr;
+    bump = nullptr;
+    bump_end = nullptr;
+}
+
+BlockPool::~BlockPool()
+{
+    release();
+}
+
+PoolResource::PoolResource(std::pmr::memory_resource* upstream) noexcept
+:upstream(upstream), pools{}, pool_count(0)
+{}
+
+BlockPool* PoolResource::find_pool(size_t bytes, size_t alignment, bool create)
+{
+    // Anything too large or too strictly aligned goes upstream.
+    if(bytes > max_pooled || alignment > alignof(std::max_align_t))
+    {
+        return nullptr;
+    }
+
+    /* Round up to the requested alignment (at least a pointer's), so that
+     * every block in the pool satisfies any alignment up to that. */
+    size_t align = (alignment < alignof(void*)) ? alignof(void*) : alignment;
+    size_t size = (bytes + align - 1) & ~(align - 1);
+
+    for(size_t i = 0; i < pool_count; ++i)
+    {
+        if(pools[i]->block_size() == size && pools[i]->block_align() >= align)
+        {
+            return pools[i];
+        }
+    }
+
+    // If we're out of room for new sizes, the rest go upstream.
+    if(!create || pool_count == max_pools)
+    {
+        return nullptr;
+    }
+
+    pools[pool_count] = new BlockPool(size, align);
+    return pools[pool_count++];
+}
+
+void* PoolResource::do_allocate(size_t bytes, size_t alignment)
+{
+    BlockPool* pool = find_pool(bytes, alignment, true);
+    if(pool == nullptr)
+    {
+        return upstream->allocate(bytes, alignment);
+    }
+    return pool->allocate();
+}
+
+void PoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+{
+    /* The same size and alignment always map to the same pool, so
+     * a block needs no header to find its way home. */
+    BlockPool* pool = find_pool(bytes, alignment, false);
+    if(pool == nullptr)
+    {
+        upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    pool->deallocate(ptr);
+}
+
+bool PoolResource::do_is_equal(const std::pmr::memory_resource& other)
+    const noexcept
+{
+    return this == &other;
+}
+
+void PoolResource::release() noexcept
+{
+    for(size_t i = 0; i < pool_count; ++i)
+    {
+        pools[i]->release();
+    }
+}
+
+PoolResource::~PoolResource()
+{
+    for(size_t i = 0; i < pool_count; ++i)
+    {
+        delete pools[i];
+    }
+}
@@ -0,0 +1,21 @@
+#include "pawlib/pool_allocator_tests.hpp"
+
+void TestSuite_PoolAllocator::load_tests()
+{
+    register_test("P-tB1701",
+        new TestBlockPool_Recycle());
+
+    register_test("P-tB1702",
+        new TestPoolAllocator_StdContainers());
+    register_test("P-tB1703",
+        new TestPoolResource_Pmr());
+    register_test("P-tB1704",
+        new TestPoolAllocator_FlexArray());
+
+    register_test("P-tB1706",
+        new TestPoolResource_FlexArrayMove());
+
+    register_test("P-tB1705",
+        new TestPoolAllocator_ListChurn(), true,
+        new TestStdAllocator_ListChurn());
+}
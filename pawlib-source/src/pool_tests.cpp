@@ -32,4 +32,22 @@ void TestSuite_Pool::load_tests()
         new TestPool_Exception(TestPool_Exception::FailTestType::POOL_DES_DELETED_REF));
     register_test("P-tB160D",
         new TestPool_Exception(TestPool_Exception::FailTestType::POOL_DES_FOREIGN_REF));
+
+    register_test("P-tB160E",
+        new TestPool_CreateN(false));
+    register_test("P-tB160F",
+        new TestPool_CreateN(true));
+
+    register_test("P-tB1610",
+        new TestPool_DestroyMany());
+    register_test("P-tB1611",
+        new TestPool_DestroyAll());
+
+    register_test("P-tB1612",
+        new TestPool_ForEachLive(1000));
+    register_test("P-tS1612",
+        new TestPool_ForEachLive(1000000), false);
+
+    register_test("P-tB1613",
+        new TestPool_Telemetry());
 }
@@ -0,0 +1,27 @@
+#include "pawlib/roaring_bitmap_tests.hpp"
+
+void TestSuite_RoaringBitmap::load_tests()
+{
+    register_test("P-tB8201",
+        new TestRoaringBitmap_AddRemove());
+    register_test("P-tB8202",
+        new TestRoaringBitmap_SetOperations());
+    register_test("P-tB8203",
+        new TestRoaringBitmap_Runs());
+    register_test("P-tB8204",
+        new TestRoaringBitmap_Serialize());
+    register_test("P-tB8208",
+        new TestRoaringBitmap_RunsAtEnd());
+    register_test("P-tB8209",
+        new TestRoaringBitmap_MixedUnion());
+
+    register_test("P-tB8205",
+        new TestRoaringBitmap_IntersectSparse<RoaringBitmap>("RoaringBitmap"), true,
+        new TestRoaringBitmap_IntersectSparse<RoaringBenchVector>("sorted std::vector"));
+    register_test("P-tB8206",
+        new TestRoaringBitmap_IntersectDense<RoaringBitmap>("RoaringBitmap"), true,
+        new TestRoaringBitmap_IntersectDense<RoaringBenchVector>("sorted std::vector"));
+    register_test("P-tB8207",
+        new TestRoaringBitmap_Contains<RoaringBitmap>("RoaringBitmap"), true,
+        new TestRoaringBitmap_Contains<RoaringBenchVector>("sorted std::vector"));
+}
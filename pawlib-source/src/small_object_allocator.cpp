@@ -0,0 +1,111 @@
+#include "pawlib/small_object_allocator.hpp"
+
+/* Spacing is 16 bytes up to 128, then four classes per doubling, so no
+ * request above 128 bytes wastes more than a fifth of its block. Every class
+ * above 8 bytes is a multiple of 16, so all of those are aligned to
+ * std::max_align_t. */
+const size_t SmallObjectAllocator::class_sizes[class_count] = {
+    8, 16, 32, 48, 64, 80, 96, 112,
+    128, 160, 192, 224, 256, 320, 384, 448,
+    512, 640, 768, 896, 1024
+};
+
+// Generated from class_sizes: the smallest class of at least (i * 8) bytes.
+const uint8_t SmallObjectAllocator::class_lookup[lookup_size] = {
+     0,  0,  1,  2,  2,  3,  3,  4,  4,  5,  5,  6,  6,  7,  7,  8,
+     8,  9,  9,  9,  9, 10, 10, 10, 10, 11, 11, 11, 11, 12, 12, 12,
+    12, 13, 13, 13, 13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14,
+    14, 15, 15, 15, 15, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 16,
+    16, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17,
+    17, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+    20
+};
+
+SmallObjectAllocator::SmallObjectAllocator()
+:pools{}
+{
+    for(size_t i = 0; i < class_count; ++i)
+    {
+        size_t size = class_sizes[i];
+        size_t align = (size < alignof(std::max_align_t)) ?
+            size : alignof(std::max_align_t);
+        // Start each class with a slab of about a page.
+        size_t blocks = 4096 / size;
+        pools[i] = new BlockPool(size, align,
+            static_cast<uint32_t>((blocks < 4) ? 4 : blocks));
+    }
+}
+
+size_t SmallObjectAllocator::size_class(size_t size, size_t align)
+{
+    if(size < align)
+    {
+        size = align;
+    }
+    if(size > max_small || align > alignof(std::max_align_t))
+    {
+        return class_count;
+    }
+    return class_lookup[(size + 7) >> 3];
+}
+
+void* SmallObjectAllocator::allocate_large(size_t size, size_t align)
+{
+    return ::operator new(size, std::align_val_t(align));
+}
+
+void SmallObjectAllocator::deallocate_large(void* ptr, size_t size,
+                                            size_t align) noexcept
+{
+    ::operator delete(ptr, size, std::align_val_t(align));
+}
+
+void* SmallObjectAllocator::do_allocate(size_t bytes, size_t alignment)
+{
+    return allocate(bytes, alignment);
+}
+
+void SmallObjectAllocator::do_deallocate(void* ptr, size_t bytes,
+                                         size_t alignment)
+{
+    deallocate(ptr, bytes, alignment);
+}
+
+bool SmallObjectAllocator::do_is_equal(const std::pmr::memory_resource& other)
+    const noexcept
+{
+    return this == &other;
+}
+
+void SmallObjectAllocator::release() noexcept
+{
+    for(size_t i = 0; i < class_count; ++i)
+    {
+        pools[i]->release();
+    }
+}
+
+size_t SmallObjectAllocator::capacity() const noexcept
+{
+    size_t held = 0;
+    for(size_t i = 0; i < class_count; ++i)
+    {
+        held += pools[i]->capacity();
+    }
+    return held;
+}
+
+size_t SmallObjectAllocator::capacity(size_t size_class) const noexcept
+{
+    return (size_class < class_count) ? pools[size_class]->capacity() : 0;
+}
+
+SmallObjectAllocator::~SmallObjectAllocator()
+{
+    for(size_t i = 0; i < class_count; ++i)
+    {
+        delete pools[i];
+    }
+}
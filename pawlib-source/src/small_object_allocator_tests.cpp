@@ -0,0 +1,22 @@
+#include "pawlib/small_object_allocator_tests.hpp"
+
+void TestSuite_SmallObjectAllocator::load_tests()
+{
+    register_test("P-tB1801",
+        new TestSmallObject_SizeClasses());
+    register_test("P-tB1802",
+        new TestSmallObject_Recycle());
+    register_test("P-tB1803",
+        new TestSmallObject_CreateDestroy());
+    register_test("P-tB1804",
+        new TestSmallObject_Containers());
+    register_test("P-tB1805",
+        new TestSmallObject_Fragmentation());
+
+    register_test("P-tB1806",
+        new TestSmallObject_Throughput(), true,
+        new TestNewDelete_Throughput());
+    register_test("P-tB1807",
+        new TestSmallObject_Churn(), true,
+        new TestNewDelete_Churn());
+}
@@ -0,0 +1,16 @@
+#include "pawlib/succinct_bit_vector_tests.hpp"
+
+void TestSuite_SuccinctBitVector::load_tests()
+{
+    register_test("P-tB8101",
+        new TestSuccinctBitVector_Densities());
+    register_test("P-tB8102",
+        new TestSuccinctBitVector_Edges());
+
+    register_test("P-tB8103",
+        new TestSuccinctBitVector_Rank<SuccinctBitVector>("SuccinctBitVector"), true,
+        new TestSuccinctBitVector_Rank<SuccinctBenchScan>("Popcount Scan"));
+    register_test("P-tB8104",
+        new TestSuccinctBitVector_Select<SuccinctBitVector>("SuccinctBitVector"), true,
+        new TestSuccinctBitVector_Select<SuccinctBenchScan>("Popcount Scan"));
+}
@@ -0,0 +1,13 @@
+#include "pawlib/tril_array_tests.hpp"
+
+void TestSuite_TrilArray::load_tests()
+{
+    register_test("P-tB0201",
+        new TestTrilArray_Convert());
+    register_test("P-tB0202",
+        new TestTrilArray_Logic());
+
+    register_test("P-tB0203",
+        new TestTrilArray_And<TrilArray>("TrilArray"), true,
+        new TestTrilArray_And<TrilBenchVector>("std::vector<tril>"));
+}
@@ -45,15 +45,30 @@
 #include "pawlib/iochannel.hpp"
 
 // Include tests.
+#include "pawlib/arena_tests.hpp"
+#include "pawlib/bit_stream_tests.hpp"
+#include "pawlib/bloom_filter_tests.hpp"
+#include "pawlib/concurrent_map_tests.hpp"
 #include "pawlib/core_types_tests.hpp"
+#include "pawlib/flat_map_tests.hpp"
 #include "pawlib/flex_array_tests.hpp"
 #include "pawlib/flex_bit_tests.hpp"
+#include "pawlib/flex_bitset_tests.hpp"
+#include "pawlib/flex_btree_map_tests.hpp"
+#include "pawlib/flex_hash_map_tests.hpp"
+#include "pawlib/flex_map_tests.hpp"
 #include "pawlib/flex_queue_tests.hpp"
 #include "pawlib/flex_stack_tests.hpp"
-//#include "pawlib/pawsort_tests.hpp"
+#include "pawlib/pawsort_tests.hpp"
+#include "pawlib/persistent_map_tests.hpp"
 #include "pawlib/onestring_tests.hpp"
 #include "pawlib/onechar_tests.hpp"
+#include "pawlib/pool_allocator_tests.hpp"
 #include "pawlib/pool_tests.hpp"
+#include "pawlib/roaring_bitmap_tests.hpp"
+#include "pawlib/small_object_allocator_tests.hpp"
+#include "pawlib/succinct_bit_vector_tests.hpp"
+#include "pawlib/tril_array_tests.hpp"
 
 /** Temporary test code goes in this function ONLY.
   * All test code that is needed long term should be
@@ -76,14 +91,29 @@ int main(int argc, char* argv[])
 
     GoldilocksShell* shell = new GoldilocksShell(">> ");
     shell->register_suite<TestSuite_CoreTypes>("P-sB01");
+    shell->register_suite<TestSuite_TrilArray>("P-sB02");
     shell->register_suite<TestSuite_FlexArray>("P-sB10");
+    shell->register_suite<TestSuite_FlexMap>("P-sB11");
     shell->register_suite<TestSuite_FlexQueue>("P-sB12");
     shell->register_suite<TestSuite_FlexStack>("P-sB13");
     shell->register_suite<TestSuite_FlexBit>("P-sB15");
     shell->register_suite<TestSuite_Pool>("P-sB16");
-    //shell->register_suite<TestSuite_Pawsort>("P-sB30");
+    shell->register_suite<TestSuite_PoolAllocator>("P-sB17");
+    shell->register_suite<TestSuite_SmallObjectAllocator>("P-sB18");
+    shell->register_suite<TestSuite_Arena>("P-sB19");
+    shell->register_suite<TestSuite_Pawsort>("P-sB30");
     shell->register_suite<TestSuite_Onestring>("P-sB40");
     shell->register_suite<TestSuite_Onechar>("P-sB41");
+    shell->register_suite<TestSuite_FlexHashMap>("P-sB70");
+    shell->register_suite<TestSuite_FlexBTreeMap>("P-sB71");
+    shell->register_suite<TestSuite_FlatMap>("P-sB72");
+    shell->register_suite<TestSuite_PersistentMap>("P-sB73");
+    shell->register_suite<TestSuite_ConcurrentMap>("P-sB74");
+    shell->register_suite<TestSuite_FlexBitset>("P-sB80");
+    shell->register_suite<TestSuite_SuccinctBitVector>("P-sB81");
+    shell->register_suite<TestSuite_RoaringBitmap>("P-sB82");
+    shell->register_suite<TestSuite_BitStream>("P-sB83");
+    shell->register_suite<TestSuite_BloomFilter>("P-sB84");
 
     // If we got command-line arguments.
     if(argc > 1)